@@ -1356,6 +1356,15 @@ ARDOUR_UI::update_peak_thread_work ()
 	} else {
 		peak_thread_work_label.set_markup (X_(""));
 	}
+
+	SourceFactory::PeakBuildStats const ps (SourceFactory::peak_build_stats ());
+	if (ps.n_sources > 0 && ps.usec > 0) {
+		snprintf (buf, sizeof (buf), "%.1f", ps.n_samples / (double) ps.usec);
+		ArdourWidgets::set_tooltip (peak_thread_work_label,
+				string_compose (_("Pending: %1\nBuilt: %2 files, %3 Msamples/sec"), c, ps.n_sources, buf));
+	} else {
+		ArdourWidgets::set_tooltip (peak_thread_work_label, string_compose (_("Pending: %1"), c));
+	}
 }
 
 void
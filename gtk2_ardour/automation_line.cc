@@ -57,6 +57,7 @@
 
 #include "automation_line.h"
 #include "control_point.h"
+#include "editor_drag.h"
 #include "gui_thread.h"
 #include "rgb_macros.h"
 #include "public_editor.h"
@@ -94,6 +95,8 @@ AutomationLine::AutomationLine (const string&                              name,
 	, _offset (0)
 	, _maximum_time (max_samplepos)
 	, _fill (false)
+	, _materialized_x0 (-DBL_MAX)
+	, _materialized_x1 (DBL_MAX)
 	, _desc (desc)
 {
 	if (converter) {
@@ -122,6 +125,8 @@ AutomationLine::AutomationLine (const string&                              name,
 
 	line->Event.connect (sigc::mem_fun (*this, &AutomationLine::event_handler));
 
+	trackview.editor().HorizontalPositionChanged.connect (sigc::mem_fun (*this, &AutomationLine::horizontal_position_changed));
+
 	trackview.session()->register_with_memento_command_factory(alist->id(), this);
 
 	interpolation_changed (alist->interpolation ());
@@ -134,8 +139,10 @@ AutomationLine::~AutomationLine ()
 	delete group; // deletes child items
 
 	for (std::vector<ControlPoint *>::iterator i = control_points.begin(); i != control_points.end(); i++) {
-		(*i)->unset_item ();
-		delete *i;
+		if (*i) {
+			(*i)->unset_item ();
+			delete *i;
+		}
 	}
 	control_points.clear ();
 
@@ -165,7 +172,7 @@ AutomationLine::update_visibility ()
 		   when automation points have been removed (the line will still follow the shape of the
 		   old points).
 		*/
-		if (control_points.size() >= 2) {
+		if (_view_points.size() >= 2) {
 			line->show();
 		} else {
 			line->hide ();
@@ -173,10 +180,15 @@ AutomationLine::update_visibility ()
 
 		if (_visible & ControlPoints) {
 			for (vector<ControlPoint*>::iterator i = control_points.begin(); i != control_points.end(); ++i) {
-				(*i)->show ();
+				if (*i) {
+					(*i)->show ();
+				}
 			}
 		} else if (_visible & SelectedControlPoints) {
 			for (vector<ControlPoint*>::iterator i = control_points.begin(); i != control_points.end(); ++i) {
+				if (!*i) {
+					continue;
+				}
 				if ((*i)->selected()) {
 					(*i)->show ();
 				} else {
@@ -185,13 +197,18 @@ AutomationLine::update_visibility ()
 			}
 		} else {
 			for (vector<ControlPoint*>::iterator i = control_points.begin(); i != control_points.end(); ++i) {
-				(*i)->hide ();
+				if (*i) {
+					(*i)->hide ();
+				}
 			}
 		}
 
 	} else {
 		line->hide ();
 		for (vector<ControlPoint*>::iterator i = control_points.begin(); i != control_points.end(); ++i) {
+			if (!*i) {
+				continue;
+			}
 			if (_visible & ControlPoints) {
 				(*i)->show ();
 			} else {
@@ -245,7 +262,9 @@ AutomationLine::set_height (guint32 h)
 		double bsz = control_point_box_size();
 
 		for (vector<ControlPoint*>::iterator i = control_points.begin(); i != control_points.end(); ++i) {
-			(*i)->set_size (bsz);
+			if (*i) {
+				(*i)->set_size (bsz);
+			}
 		}
 
 		if (_fill) {
@@ -272,7 +291,7 @@ ControlPoint*
 AutomationLine::nth (uint32_t n)
 {
 	if (n < control_points.size()) {
-		return control_points[n];
+		return materialize (n);
 	} else {
 		return 0;
 	}
@@ -313,8 +332,8 @@ AutomationLine::modify_point_y (ControlPoint& cp, double y)
 
 	reset_line_coords (cp);
 
-	if (line_points.size() > 1) {
-		line->set_steps (line_points, is_stepped());
+	if (_view_points.size() > 1) {
+		update_line ();
 	}
 
 	update_pending = false;
@@ -329,12 +348,62 @@ AutomationLine::modify_point_y (ControlPoint& cp, double y)
 void
 AutomationLine::reset_line_coords (ControlPoint& cp)
 {
-	if (cp.view_index() < line_points.size()) {
-		line_points[cp.view_index()].x = cp.get_x ();
-		line_points[cp.view_index()].y = cp.get_y ();
+	if (cp.view_index() < _view_points.size()) {
+		_view_points[cp.view_index()].x = cp.get_x ();
+		_view_points[cp.view_index()].y = cp.get_y ();
 	}
 }
 
+/** Set the coordinates of the canvas line from the view points.
+ *  Where many points fall into a single pixel column only the first, last,
+ *  lowest and highest are kept; the line looks the same, but the number of
+ *  points to draw is bounded by the width of the line on screen.
+ */
+void
+AutomationLine::update_line ()
+{
+	const size_t vp = _view_points.size ();
+
+	line_points.clear ();
+
+	for (size_t i = 0; i < vp;) {
+		const double col = floor (_view_points[i].x);
+
+		size_t e = i + 1;
+		while (e < vp && floor (_view_points[e].x) == col) {
+			++e;
+		}
+
+		if (e - i <= 4) {
+			for (; i < e; ++i) {
+				line_points.push_back (ArdourCanvas::Duple (_view_points[i].x, _view_points[i].y));
+			}
+			continue;
+		}
+
+		size_t lo = i + 1;
+		size_t hi = i + 1;
+		for (size_t n = i + 2; n < e - 1; ++n) {
+			if (_view_points[n].y > _view_points[lo].y) {
+				lo = n;
+			}
+			if (_view_points[n].y < _view_points[hi].y) {
+				hi = n;
+			}
+		}
+
+		line_points.push_back (ArdourCanvas::Duple (_view_points[i].x, _view_points[i].y));
+		line_points.push_back (ArdourCanvas::Duple (_view_points[min (lo, hi)].x, _view_points[min (lo, hi)].y));
+		if (lo != hi) {
+			line_points.push_back (ArdourCanvas::Duple (_view_points[max (lo, hi)].x, _view_points[max (lo, hi)].y));
+		}
+		line_points.push_back (ArdourCanvas::Duple (_view_points[e - 1].x, _view_points[e - 1].y));
+		i = e;
+	}
+
+	line->set_steps (line_points, is_stepped());
+}
+
 bool
 AutomationLine::sync_model_with_view_points (list<ControlPoint*> cp)
 {
@@ -429,7 +498,7 @@ AutomationLine::start_drag_single (ControlPoint* cp, double x, float fraction)
 
 	if (cp->selected ()) {
 		for (vector<ControlPoint*>::iterator i = control_points.begin(); i != control_points.end(); ++i) {
-			if (*i != cp && (*i)->selected()) {
+			if (*i && *i != cp && (*i)->selected()) {
 				_drag_points.push_back (*i);
 			}
 		}
@@ -706,8 +775,8 @@ AutomationLine::drag_motion (double const x, float fraction, bool ignore_x, bool
 
 		/* update actual line coordinates (will queue a redraw) */
 
-		if (line_points.size() > 1) {
-			line->set_steps (line_points, is_stepped());
+		if (_view_points.size() > 1) {
+			update_line ();
 		}
 	}
 
@@ -759,7 +828,7 @@ AutomationLine::end_drag (bool with_push, uint32_t final_index)
 	if (moved) {
 		/* A point has moved as a result of sync (clamped to integer or boolean
 		   value), update line accordingly. */
-		line->set_steps (line_points, is_stepped());
+		update_line ();
 	}
 
 	trackview.editor().session()->add_command (
@@ -812,29 +881,27 @@ AutomationLine::sync_model_with_view_point (ControlPoint& cp)
 bool
 AutomationLine::control_points_adjacent (double xval, uint32_t & before, uint32_t& after)
 {
-	ControlPoint *bcp = 0;
-	ControlPoint *acp = 0;
+	bool have_before = false;
 	double unit_xval;
 
 	unit_xval = trackview.editor().sample_to_pixel_unrounded (xval);
 
-	for (vector<ControlPoint*>::iterator i = control_points.begin(); i != control_points.end(); ++i) {
+	for (uint32_t n = 0; n < _view_points.size(); ++n) {
 
-		if ((*i)->get_x() <= unit_xval) {
+		if (_view_points[n].x <= unit_xval) {
 
-			if (!bcp || (*i)->get_x() > bcp->get_x()) {
-				bcp = *i;
-				before = bcp->view_index();
+			if (!have_before || _view_points[n].x > _view_points[before].x) {
+				before = n;
+				have_before = true;
 			}
 
-		} else if ((*i)->get_x() > unit_xval) {
-			acp = *i;
-			after = acp->view_index();
-			break;
+		} else {
+			after = n;
+			return have_before;
 		}
 	}
 
-	return bcp && acp;
+	return false;
 }
 
 bool
@@ -899,8 +966,9 @@ AutomationLine::get_selectables (samplepos_t start, samplepos_t end, double botf
 	double const bot_track = (1 - topfrac) * trackview.current_height ();
 	double const top_track = (1 - botfrac) * trackview.current_height ();
 
-	for (vector<ControlPoint*>::iterator i = control_points.begin(); i != control_points.end(); ++i) {
-		double const model_when = (*(*i)->model())->when;
+	for (uint32_t n = 0; n < _view_points.size(); ++n) {
+		ViewPoint const& v (_view_points[n]);
+		double const model_when = (*v.model)->when;
 
 		/* model_when is relative to the start of the source, so we just need to add on the origin_b here
 		   (as it is the session sample position of the start of the source)
@@ -908,8 +976,8 @@ AutomationLine::get_selectables (samplepos_t start, samplepos_t end, double botf
 
 		samplepos_t const session_samples_when = _time_converter->to (model_when) + _time_converter->origin_b ();
 
-		if (session_samples_when >= start && session_samples_when <= end && (*i)->get_y() >= bot_track && (*i)->get_y() <= top_track) {
-			results.push_back (*i);
+		if (session_samples_when >= start && session_samples_when <= end && v.y >= bot_track && v.y <= top_track) {
+			results.push_back (nth (n));
 		}
 	}
 }
@@ -923,9 +991,7 @@ AutomationLine::get_inverted_selectables (Selection&, list<Selectable*>& /*resul
 void
 AutomationLine::set_selected_points (PointSelection const & points)
 {
-	for (vector<ControlPoint*>::iterator i = control_points.begin(); i != control_points.end(); ++i) {
-		(*i)->set_selected (false);
-	}
+	unselect_points ();
 
 	for (PointSelection::const_iterator i = points.begin(); i != points.end(); ++i) {
 		(*i)->set_selected (true);
@@ -940,12 +1006,25 @@ AutomationLine::set_selected_points (PointSelection const & points)
 	set_colors ();
 }
 
+/** Deselect all points, without creating control points for them */
+void
+AutomationLine::unselect_points ()
+{
+	for (vector<ControlPoint*>::iterator i = control_points.begin(); i != control_points.end(); ++i) {
+		if (*i) {
+			(*i)->set_selected (false);
+		}
+	}
+}
+
 void
 AutomationLine::set_colors ()
 {
 	set_line_color (UIConfiguration::instance().color ("automation line"));
 	for (vector<ControlPoint*>::iterator i = control_points.begin(); i != control_points.end(); ++i) {
-		(*i)->set_color ();
+		if (*i) {
+			(*i)->set_color ();
+		}
 	}
 }
 
@@ -972,6 +1051,7 @@ AutomationLine::reset_callback (const Evoral::ControlList& events)
 			delete *i;
 		}
 		control_points.clear ();
+		_view_points.clear ();
 		line->hide();
 		return;
 	}
@@ -979,12 +1059,17 @@ AutomationLine::reset_callback (const Evoral::ControlList& events)
 	/* hide all existing points, and the line */
 
 	for (vector<ControlPoint*>::iterator i = control_points.begin(); i != control_points.end(); ++i) {
-		(*i)->hide();
+		if (*i) {
+			(*i)->hide();
+		}
 	}
 
 	line->hide ();
 	np = events.size();
 
+	_view_points.clear ();
+	_view_points.reserve (np);
+
 	Evoral::ControlList& e = const_cast<Evoral::ControlList&> (events);
 
 	for (AutomationList::iterator ai = e.begin(); ai != e.end(); ++ai, ++pi) {
@@ -1018,7 +1103,7 @@ AutomationLine::reset_callback (const Evoral::ControlList& events)
 
 		ty = _height - (ty * _height);
 
-		add_visible_control_point (vp, pi, tx, ty, ai, np);
+		_view_points.push_back (ViewPoint (tx, ty, ai, pi));
 		vp++;
 	}
 
@@ -1030,29 +1115,12 @@ AutomationLine::reset_callback (const Evoral::ControlList& events)
 		delete cp;
 	}
 
-	if (!terminal_points_can_slide) {
-		control_points.back()->set_can_slide(false);
-	}
-
-	if (vp > 1) {
+	control_points.resize (vp, 0);
 
-		/* reset the line coordinates given to the CanvasLine */
-
-		while (line_points.size() < vp) {
-			line_points.push_back (ArdourCanvas::Duple (0,0));
-		}
-
-		while (line_points.size() > vp) {
-			line_points.pop_back ();
-		}
-
-		for (uint32_t n = 0; n < vp; ++n) {
-			line_points[n].x = control_points[n]->get_x();
-			line_points[n].y = control_points[n]->get_y();
-		}
-
-		line->set_steps (line_points, is_stepped());
+	update_control_points (true);
 
+	if (vp > 1) {
+		update_line ();
 		update_visibility ();
 	}
 
@@ -1263,9 +1331,9 @@ AutomationLine::model_to_view_coord (double& x, double& y) const
 void
 AutomationLine::interpolation_changed (AutomationList::InterpolationStyle style)
 {
-	if (line_points.size() > 1) {
+	if (_view_points.size() > 1) {
 		reset ();
-		line->set_steps(line_points, is_stepped());
+		update_line ();
 	}
 }
 
@@ -1275,14 +1343,14 @@ AutomationLine::add_visible_control_point (uint32_t view_index, uint32_t pi, dou
 {
 	ControlPoint::ShapeType shape;
 
-	if (view_index >= control_points.size()) {
+	if (!control_points[view_index]) {
 
-		/* make sure we have enough control points */
+		/* control points are only created when needed */
 
 		ControlPoint* ncp = new ControlPoint (*this);
 		ncp->set_size (control_point_box_size ());
 
-		control_points.push_back (ncp);
+		control_points[view_index] = ncp;
 	}
 
 	if (!terminal_points_can_slide) {
@@ -1305,6 +1373,11 @@ AutomationLine::add_visible_control_point (uint32_t view_index, uint32_t pi, dou
 		shape = ControlPoint::Full;
 	}
 
+	if (!terminal_points_can_slide && view_index == _view_points.size() - 1) {
+		/* the last point may not be the last of the model, if later ones are out of range */
+		control_points[view_index]->set_can_slide (false);
+	}
+
 	control_points[view_index]->reset (tx, ty, model, view_index, shape);
 
 	/* finally, control visibility */
@@ -1316,6 +1389,99 @@ AutomationLine::add_visible_control_point (uint32_t view_index, uint32_t pi, dou
 	}
 }
 
+ControlPoint*
+AutomationLine::materialize (uint32_t n)
+{
+	if (!control_points[n]) {
+		ViewPoint const& v (_view_points[n]);
+		add_visible_control_point (n, v.pi, v.x, v.y, v.model, alist->size ());
+	}
+	return control_points[n];
+}
+
+/** Find the range of x-coordinates that is currently visible in the editor.
+ *  @return false if the line has few enough points to create control points for all of them
+ */
+bool
+AutomationLine::visible_range (double& x0, double& x1) const
+{
+	const uint32_t max_points = UIConfiguration::instance().get_max_automation_control_points ();
+
+	if (max_points == 0 || _view_points.size() <= max_points) {
+		return false;
+	}
+
+	PublicEditor& e (trackview.editor());
+	double y = 0;
+
+	x0 = e.sample_to_pixel_unrounded (e.leftmost_sample ());
+	group->canvas_to_item (x0, y);
+	x1 = x0 + e.sample_to_pixel_unrounded (e.current_page_samples ());
+
+	return true;
+}
+
+/** Create control points for all view points in and near the visible range,
+ *  and delete control points outside of it, unless they are selected.
+ *  @param reset_existing also update the position of existing control points
+ */
+void
+AutomationLine::update_control_points (bool reset_existing)
+{
+	double x0 = -DBL_MAX;
+	double x1 = DBL_MAX;
+
+	if (visible_range (x0, x1)) {
+		/* add a page on either side, so that scrolling does not
+		 * create and delete control points all the time */
+		const double w = x1 - x0;
+		x0 -= w;
+		x1 += w;
+	}
+
+	_materialized_x0 = x0;
+	_materialized_x1 = x1;
+
+	const uint32_t np = alist->size ();
+
+	for (uint32_t n = 0; n < _view_points.size(); ++n) {
+		ViewPoint const& v (_view_points[n]);
+		ControlPoint*    cp = control_points[n];
+
+		if (v.x >= x0 && v.x <= x1) {
+			if (!cp || reset_existing) {
+				add_visible_control_point (n, v.pi, v.x, v.y, v.model, np);
+			}
+		} else if (cp) {
+			if (cp->selected ()) {
+				if (reset_existing) {
+					add_visible_control_point (n, v.pi, v.x, v.y, v.model, np);
+				}
+			} else {
+				delete cp;
+				control_points[n] = 0;
+			}
+		}
+	}
+}
+
+void
+AutomationLine::horizontal_position_changed ()
+{
+	if (!_drag_points.empty () || trackview.editor().drags()->active ()) {
+		return;
+	}
+
+	double x0, x1;
+
+	if (!visible_range (x0, x1) || (x0 >= _materialized_x0 && x1 <= _materialized_x1)) {
+		return;
+	}
+
+	update_control_points (false);
+	update_visibility ();
+}
+
 void
 AutomationLine::connect_to_list ()
 {
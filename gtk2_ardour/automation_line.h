@@ -82,6 +82,7 @@ public:
 	void set_fill (bool f) { _fill = f; } // owner needs to call set_height
 
 	void set_selected_points (PointSelection const &);
+	void unselect_points ();
 	void get_selectables (ARDOUR::samplepos_t, ARDOUR::samplepos_t, double, double, std::list<Selectable*>&);
 	void get_inverted_selectables (Selection&, std::list<Selectable*>& results);
 
@@ -95,9 +96,11 @@ public:
 	virtual std::pair<float, float> drag_motion (double, float, bool, bool with_push, uint32_t& final_index);
 	virtual void end_drag (bool with_push, uint32_t final_index);
 
+	/** @return the n-th point, a control point item is created if needed */
 	ControlPoint* nth (uint32_t);
+	/** @return the n-th point, or 0 if it currently has no control point item */
 	ControlPoint const * nth (uint32_t) const;
-	uint32_t npoints() const { return control_points.size(); }
+	uint32_t npoints() const { return _view_points.size(); }
 
 	std::string  name()    const { return _name; }
 	bool    visible() const { return _visible != VisibleAspects(0); }
@@ -193,7 +196,19 @@ protected:
 	ArdourCanvas::Container*    group;
 	ArdourCanvas::PolyLine*     line; /* line */
 	ArdourCanvas::Points        line_points; /* coordinates for canvas line */
-	std::vector<ControlPoint*>  control_points; /* visible control points */
+	std::vector<ControlPoint*>  control_points; /* control points, 0 for points outside the visible range */
+
+	/** view coordinates of all points, control points only exist for some of them */
+	struct ViewPoint {
+		ViewPoint (double xx, double yy, ARDOUR::AutomationList::iterator m, uint32_t i)
+			: x (xx), y (yy), model (m), pi (i) {}
+		double x;
+		double y;
+		ARDOUR::AutomationList::iterator model;
+		uint32_t pi; ///< index in the model
+	};
+
+	std::vector<ViewPoint> _view_points;
 
 	class ContiguousControlPoints : public std::list<ControlPoint*> {
 public:
@@ -237,6 +252,11 @@ private:
 	void update_visibility ();
 	void reset_line_coords (ControlPoint&);
 	void add_visible_control_point (uint32_t, uint32_t, double, double, ARDOUR::AutomationList::iterator, uint32_t);
+	ControlPoint* materialize (uint32_t);
+	void update_line ();
+	void update_control_points (bool reset_existing);
+	void horizontal_position_changed ();
+	bool visible_range (double& x0, double& x1) const;
 	double control_point_box_size ();
 	void connect_to_list ();
 	void interpolation_changed (ARDOUR::AutomationList::InterpolationStyle);
@@ -248,6 +268,10 @@ private:
 
 	bool _fill;
 
+	/** x-range (in item coordinates) in which control points were created */
+	double _materialized_x0;
+	double _materialized_x1;
+
 	const ARDOUR::ParameterDescriptor _desc;
 
 	friend class AudioRegionGainLine;
@@ -85,6 +85,7 @@
 #include "ardour/route.h"
 #include "ardour/route_group.h"
 #include "ardour/session_playlists.h"
+#include "ardour/source_factory.h"
 #include "ardour/tempo.h"
 #include "ardour/utils.h"
 #include "ardour/vca_manager.h"
@@ -4715,6 +4716,53 @@ Editor::visual_changer (const VisualChange& vc)
 	}
 
 	_summary->set_overlays_dirty ();
+
+	prioritize_visible_peaks ();
+}
+
+/** Move peak-files of regions that are currently on screen to the front of
+ * the peak-builder queue, so that they are displayed first.
+ */
+void
+Editor::prioritize_visible_peaks ()
+{
+	if (!_session || SourceFactory::peak_work_queue_length () == 0) {
+		return;
+	}
+
+	const double      top   = vertical_adjustment.get_value ();
+	const double      bot   = top + _visible_canvas_height;
+	const samplepos_t start = _leftmost_sample;
+	const samplepos_t end   = _leftmost_sample + current_page_samples ();
+
+	for (TrackViewList::const_iterator t = track_views.begin(); t != track_views.end(); ++t) {
+		RouteTimeAxisView* rtv = dynamic_cast<RouteTimeAxisView*>(*t);
+		if (!rtv || rtv->hidden ()) {
+			continue;
+		}
+		if (rtv->y_position () + rtv->effective_height () < top || rtv->y_position () > bot) {
+			continue;
+		}
+
+		boost::shared_ptr<Track> tr;
+		boost::shared_ptr<Playlist> pl;
+
+		if (!(tr = rtv->track()) || !(pl = tr->playlist())) {
+			continue;
+		}
+
+		boost::shared_ptr<RegionList> regions = pl->regions_touched (start, end);
+
+		for (RegionList::const_iterator i = regions->begin(); i != regions->end(); ++i) {
+			boost::shared_ptr<AudioRegion> ar = boost::dynamic_pointer_cast<AudioRegion> (*i);
+			if (!ar) {
+				continue;
+			}
+			for (uint32_t n = 0; n < ar->n_channels (); ++n) {
+				SourceFactory::prioritize_peakfile (ar->audio_source (n));
+			}
+		}
+	}
 }
 
 struct EditorOrderTimeAxisSorter {
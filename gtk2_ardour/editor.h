@@ -1157,6 +1157,7 @@ private:
 	static int _idle_visual_changer (void* arg);
 	int idle_visual_changer ();
 	void visual_changer (const VisualChange&);
+	void prioritize_visible_peaks ();
 	void ensure_visual_change_idle_handler ();
 
 	/* track views */
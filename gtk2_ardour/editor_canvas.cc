@@ -1003,6 +1003,8 @@ Editor::set_horizontal_position (double p)
 	horizontal_adjustment.set_value (p);
 
 	_leftmost_sample = (samplepos_t) floor (p * samples_per_pixel);
+
+	HorizontalPositionChanged (); /* EMIT SIGNAL */
 }
 
 void
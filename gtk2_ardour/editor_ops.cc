@@ -5360,43 +5360,36 @@ Editor::normalize_region ()
 	CursorContext::Handle cursor_ctx = CursorContext::create(*this, _cursors->wait);
 	gdk_flush ();
 
-	/* XXX: should really only count audio regions here */
-	int const regions = rs.size ();
-
-	/* Make a list of the selected audio regions' maximum amplitudes, and also
-	   obtain the maximum amplitude of them all.
+	/* Obtain the maximum amplitudes and rms of the selected audio regions,
+	   analyzing them concurrently, and the maximum of them all.
 	*/
-	list<double> max_amps;
-	list<double> rms_vals;
-	double max_amp = 0;
-	double max_rms = 0;
-	bool use_rms = dialog.constrain_rms ();
-
+	vector<boost::shared_ptr<AudioRegion> > aregions;
 	for (RegionSelection::const_iterator i = rs.begin(); i != rs.end(); ++i) {
 		AudioRegionView const * arv = dynamic_cast<AudioRegionView const *> (*i);
-		if (!arv) {
-			continue;
-		}
-		dialog.descend (1.0 / regions);
-		double const a = arv->audio_region()->maximum_amplitude (&dialog);
-		if (use_rms) {
-			double r = arv->audio_region()->rms (&dialog);
-			max_rms = max (max_rms, r);
-			rms_vals.push_back (r);
+		if (arv) {
+			aregions.push_back (arv->audio_region());
 		}
+	}
 
-		if (a == -1) {
-			/* the user cancelled the operation */
-			return;
-		}
+	vector<double> max_amps;
+	vector<double> rms_vals;
+
+	if (!AudioRegion::analyze_levels (aregions, max_amps, rms_vals, &dialog)) {
+		/* the user cancelled the operation */
+		return;
+	}
+
+	double max_amp = 0;
+	double max_rms = 0;
+	bool use_rms = dialog.constrain_rms ();
 
-		max_amps.push_back (a);
-		max_amp = max (max_amp, a);
-		dialog.ascend ();
+	for (size_t n = 0; n < max_amps.size (); ++n) {
+		max_amp = max (max_amp, max_amps[n]);
+		max_rms = max (max_rms, rms_vals[n]);
 	}
 
-	list<double>::const_iterator a = max_amps.begin ();
-	list<double>::const_iterator l = rms_vals.begin ();
+	vector<double>::const_iterator a = max_amps.begin ();
+	vector<double>::const_iterator l = rms_vals.begin ();
 	bool in_command = false;
 
 	for (RegionSelection::iterator r = rs.begin(); r != rs.end(); ++r) {
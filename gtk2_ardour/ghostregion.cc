@@ -43,6 +43,7 @@
 #include "midi_region_view.h"
 #include "rgb_macros.h"
 #include "note.h"
+#include "note_layer.h"
 #include "hit.h"
 #include "ui_config.h"
 
@@ -190,6 +191,7 @@ MidiGhostRegion::MidiGhostRegion(MidiRegionView& rv,
                                  double initial_unit_pos)
 	: GhostRegion(rv, tv.ghost_group(), tv, source_tv, initial_unit_pos)
 	, _note_group (new ArdourCanvas::Container (group))
+	, _note_layer (0)
 	,  parent_mrv (rv)
 	, _optimization_iterator(events.end())
 {
@@ -213,6 +215,7 @@ MidiGhostRegion::MidiGhostRegion(MidiRegionView& rv,
 	               source_tv,
 	               initial_unit_pos)
 	, _note_group (new ArdourCanvas::Container (group))
+	, _note_layer (0)
 	, parent_mrv (rv)
 	, _optimization_iterator(events.end())
 {
@@ -259,6 +262,9 @@ MidiGhostRegion::GhostEvent::~GhostEvent ()
 void
 MidiGhostRegion::set_samples_per_pixel (double /*spu*/)
 {
+	if (_note_layer) {
+		_note_layer->update ();
+	}
 }
 
 /** @return MidiStreamView that we are providing a ghost for */
@@ -290,6 +296,10 @@ MidiGhostRegion::set_colors()
 		it->second->item->set_fill_color (UIConfiguration::instance().color_mod((*it).second->event->base_color(), "ghost track midi fill"));
 		it->second->item->set_outline_color (_outline);
 	}
+
+	if (_note_layer) {
+		_note_layer->redraw ();
+	}
 }
 
 static double
@@ -320,6 +330,10 @@ MidiGhostRegion::update_contents_height ()
 		return;
 	}
 
+	if (_note_layer) {
+		_note_layer->update ();
+	}
+
 	double const h = note_height(trackview, mv);
 
 	for (EventList::iterator it = events.begin(); it != events.end(); ++it) {
@@ -340,9 +354,28 @@ MidiGhostRegion::update_contents_height ()
 	}
 }
 
+double
+MidiGhostRegion::pitch_y (uint8_t note_num)
+{
+	MidiStreamView* mv = midi_view();
+	return mv ? note_y (trackview, mv, note_num) : 0;
+}
+
+double
+MidiGhostRegion::pitch_height ()
+{
+	MidiStreamView* mv = midi_view();
+	return mv ? note_height (trackview, mv) : 0;
+}
+
 void
 MidiGhostRegion::add_note (NoteBase* n)
 {
+	if (parent_mrv._note_layer) {
+		/* all notes are drawn by the note layer, see redisplay_model() */
+		return;
+	}
+
 	GhostEvent* event = new GhostEvent (n, _note_group);
 	events.insert (make_pair (n->note(), event));
 
@@ -377,6 +410,17 @@ void
 MidiGhostRegion::clear_events()
 {
 	_note_group->clear (true);
+	_note_layer = 0;
+	events.clear ();
+	_optimization_iterator = events.end();
+}
+
+void
+MidiGhostRegion::delete_events ()
+{
+	for (EventList::iterator i = events.begin(); i != events.end(); ++i) {
+		delete i->second;
+	}
 	events.clear ();
 	_optimization_iterator = events.end();
 }
@@ -445,6 +489,29 @@ MidiGhostRegion::remove_note (NoteBase* note)
 void
 MidiGhostRegion::redisplay_model ()
 {
+	if (parent_mrv._note_layer) {
+		/* the parent draws its notes using a note layer, and only has
+		 * items for some of them. Draw all notes from the layer's data.
+		 */
+		delete_events ();
+		if (!_note_layer) {
+			_note_layer = new GhostNoteLayer (parent_mrv, *this, _note_group);
+		}
+		_note_layer->update ();
+		return;
+	}
+
+	if (_note_layer) {
+		delete _note_layer;
+		_note_layer = 0;
+		/* notes that had an item while the layer was used */
+		for (MidiRegionView::Events::const_iterator i = parent_mrv._events.begin(); i != parent_mrv._events.end(); ++i) {
+			if (events.find (i->first) == events.end ()) {
+				add_note (i->second);
+			}
+		}
+	}
+
 	/* we rely on the parent MRV having removed notes not in the model */
 	for (EventList::iterator i = events.begin(); i != events.end(); ) {
 
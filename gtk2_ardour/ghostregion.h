@@ -36,6 +36,7 @@ namespace ArdourWaveView {
 class NoteBase;
 class Note;
 class Hit;
+class GhostNoteLayer;
 class MidiStreamView;
 class TimeAxisView;
 class RegionView;
@@ -125,8 +126,12 @@ public:
 	void redisplay_model();
 	void clear_events();
 
+	double pitch_y (uint8_t note_num);
+	double pitch_height ();
+
 private:
 	ArdourCanvas::Container* _note_group;
+	GhostNoteLayer* _note_layer;
 	Gtkmm2ext::Color _outline;
 	ArdourCanvas::Rectangle* _tmp_rect;
 	ArdourCanvas::Polygon* _tmp_poly;
@@ -134,6 +139,7 @@ private:
 	MidiRegionView& parent_mrv;
 	typedef Evoral::Note<Temporal::Beats> NoteType;
 	MidiGhostRegion::GhostEvent* find_event (boost::shared_ptr<NoteType>);
+	void delete_events ();
 
 	typedef boost::unordered_map<boost::shared_ptr<NoteType>, MidiGhostRegion::GhostEvent* > EventList;
 	EventList events;
@@ -53,6 +53,7 @@
 #include "ardour/audioengine.h"
 #include "ardour/session_utils.h"
 #include "ardour/filesystem_paths.h"
+#include "ardour/thread_placement.h"
 
 #include <gtkmm/main.h>
 #include <gtkmm/stock.h>
@@ -373,6 +374,9 @@ int main (int argc, char *argv[])
 	}
 #endif
 
+	/* threads created later by the GUI inherit this */
+	ARDOUR::ThreadPlacement::place (ARDOUR::ThreadPlacement::GUI);
+
 	DEBUG_TRACE (DEBUG::Locale, string_compose ("main() locale '%1'\n", setlocale (LC_NUMERIC, NULL)));
 
 	if (UIConfiguration::instance().pre_gui_init ()) {
@@ -27,6 +27,7 @@
 
 #include <cmath>
 #include <algorithm>
+#include <map>
 #include <ostream>
 
 #include <gtkmm.h>
@@ -76,6 +77,7 @@
 #include "midi_util.h"
 #include "midi_velocity_dialog.h"
 #include "mouse_cursors.h"
+#include "note_layer.h"
 #include "note_player.h"
 #include "paste_context.h"
 #include "public_editor.h"
@@ -114,6 +116,8 @@ MidiRegionView::MidiRegionView (ArdourCanvas::Container*      parent,
 	, _region_relative_time_converter_double(r->session().tempo_map(), r->position())
 	, _active_notes(0)
 	, _note_group (new ArdourCanvas::Container (group))
+	, _note_layer (0)
+	, _hover_item (0)
 	, _note_diff_command (0)
 	, _ghost_note(0)
 	, _step_edit_cursor (0)
@@ -161,6 +165,8 @@ MidiRegionView::MidiRegionView (ArdourCanvas::Container*      parent,
 	, _region_relative_time_converter_double(r->session().tempo_map(), r->position())
 	, _active_notes(0)
 	, _note_group (new ArdourCanvas::Container (group))
+	, _note_layer (0)
+	, _hover_item (0)
 	, _note_diff_command (0)
 	, _ghost_note(0)
 	, _step_edit_cursor (0)
@@ -215,6 +221,8 @@ MidiRegionView::MidiRegionView (const MidiRegionView& other)
 	, _region_relative_time_converter_double(other.region_relative_time_converter_double())
 	, _active_notes(0)
 	, _note_group (new ArdourCanvas::Container (get_canvas_group()))
+	, _note_layer (0)
+	, _hover_item (0)
 	, _note_diff_command (0)
 	, _ghost_note(0)
 	, _step_edit_cursor (0)
@@ -245,6 +253,8 @@ MidiRegionView::MidiRegionView (const MidiRegionView& other, boost::shared_ptr<M
 	, _region_relative_time_converter_double(other.region_relative_time_converter_double())
 	, _active_notes(0)
 	, _note_group (new ArdourCanvas::Container (get_canvas_group()))
+	, _note_layer (0)
+	, _hover_item (0)
 	, _note_diff_command (0)
 	, _ghost_note(0)
 	, _step_edit_cursor (0)
@@ -398,6 +408,24 @@ MidiRegionView::canvas_group_event(GdkEvent* ev)
 	case GDK_MOTION_NOTIFY:
 		_last_event_x = ev->motion.x;
 		_last_event_y = ev->motion.y;
+		if (_note_layer) {
+			/* give the note under the pointer an item of its own, to receive note events */
+			ArdourCanvas::Duple p (ev->motion.x, ev->motion.y);
+			_note_layer->canvas_to_item (p.x, p.y);
+			boost::shared_ptr<NoteType> note = _note_layer->note_at (p);
+			if (note) {
+				/* only keep one such item around, not one for
+				 * every note the pointer passes over */
+				drop_hover_item ();
+				_hover_item = note_item (note);
+			} else if (_hover_item && _hover_item != _entered_note) {
+				ArdourCanvas::Duple h (ev->motion.x, ev->motion.y);
+				_hover_item->item()->canvas_to_item (h.x, h.y);
+				if (!_hover_item->item()->bounding_box().contains (h)) {
+					drop_hover_item ();
+				}
+			}
+		}
 		return motion (&ev->motion);
 
 	default:
@@ -910,6 +938,8 @@ MidiRegionView::clear_events ()
 
 
 	_note_group->clear (true);
+	_note_layer = 0;
+	_hover_item = 0;
 	_events.clear();
 	_patch_changes.clear();
 	_sys_exes.clear();
@@ -1064,6 +1094,96 @@ MidiRegionView::find_canvas_note (Evoral::event_id_t id)
 	return 0;
 }
 
+/** Find the canvas note for a model note. With a note layer, notes only
+ * get an item of their own when they are edited, create it if needed.
+ */
+NoteBase*
+MidiRegionView::note_item (boost::shared_ptr<NoteType> note)
+{
+	NoteBase* cne = find_canvas_note (note);
+
+	if (cne || !_note_layer || !_note_layer->contains (note)) {
+		return cne;
+	}
+
+	bool visible;
+	note_in_region_range (note, visible);
+	cne = add_note (note, visible);
+
+	/* _events may have been re-hashed */
+	_optimization_iterator = _events.end();
+	return cne;
+}
+
+/** Remove the item that was created for the note under the pointer,
+ * unless it is in use by now.
+ */
+void
+MidiRegionView::drop_hover_item ()
+{
+	NoteBase* cne = _hover_item;
+	_hover_item = 0;
+
+	if (!cne || !_note_layer) {
+		return;
+	}
+
+	if (cne->selected () || cne == _entered_note || note_needs_item (cne->note ()) || trackview.editor().drags()->active()) {
+		/* it is removed by redisplay_model() once no longer used */
+		return;
+	}
+
+	Events::iterator i = _events.find (cne->note ());
+	if (i == _events.end () || i->second != cne) {
+		return;
+	}
+
+	for (vector<GhostRegion*>::iterator j = ghosts.begin(); j != ghosts.end(); ++j) {
+		MidiGhostRegion* gr = dynamic_cast<MidiGhostRegion*> (*j);
+		if (gr) {
+			gr->remove_note (cne);
+		}
+	}
+
+	_events.erase (i);
+	_optimization_iterator = _events.end ();
+	_note_layer->set_materialized (cne->note (), false);
+	delete cne;
+}
+
+/** @return true if a note needs a canvas item of its own when a note layer is used */
+bool
+MidiRegionView::note_needs_item (boost::shared_ptr<NoteType> note) const
+{
+	return _marked_for_selection.find (note) != _marked_for_selection.end ()
+		|| _marked_for_velocity.find (note) != _marked_for_velocity.end ()
+		|| _pending_note_selection.find (note->id ()) != _pending_note_selection.end ();
+}
+
+/** Compute the region-relative position of a note in samples, see update_sustained() */
+void
+MidiRegionView::note_samples (boost::shared_ptr<NoteType> note, samplepos_t& start, samplepos_t& end) const
+{
+	TempoMap& map (trackview.session()->tempo_map());
+	const boost::shared_ptr<ARDOUR::MidiRegion> mr = midi_region();
+
+	const double session_source_start = _region->quarter_note() - mr->start_beats();
+
+	start = map.sample_at_quarter_note (note->time().to_double() + session_source_start) - _region->position();
+
+	if (note->length() == Temporal::Beats()) {
+		end = start;
+	} else if (note->end_time() != std::numeric_limits<Temporal::Beats>::max()) {
+		double note_end_time = note->end_time().to_double();
+		if (note->end_time() > mr->start_beats() + mr->length_beats()) {
+			note_end_time = mr->start_beats() + mr->length_beats();
+		}
+		end = map.sample_at_quarter_note (session_source_start + note_end_time) - _region->position();
+	} else {
+		end = _region->length();
+	}
+}
+
 boost::shared_ptr<PatchChange>
 MidiRegionView::find_canvas_patch_change (MidiModel::PatchChangePtr p)
 {
@@ -1139,6 +1259,24 @@ MidiRegionView::redisplay_model()
 	MidiModel::ReadLock lock(_model->read_lock());
 	MidiModel::Notes& notes (_model->notes());
 
+	/* Do not create a canvas item for each note of large regions, draw
+	 * them using a single NoteLayer. Only notes that are edited get an
+	 * item of their own.
+	 */
+	const uint32_t max_items = UIConfiguration::instance().get_max_midi_note_items ();
+
+	if (max_items > 0 && notes.size () > max_items) {
+		if (!_note_layer) {
+			_note_layer = new NoteLayer (*this, _note_group);
+			_note_layer->lower_to_bottom ();
+		}
+		_note_layer->clear ();
+		_note_layer->set_percussive (midi_view()->note_mode() == Percussive);
+	} else if (_note_layer) {
+		delete _note_layer;
+		_note_layer = 0;
+	}
+
 	NoteBase* cne;
 	for (MidiModel::Notes::iterator n = notes.begin(); n != notes.end(); ++n) {
 
@@ -1146,19 +1284,32 @@ MidiRegionView::redisplay_model()
 		bool visible;
 
 		if (note_in_region_range (note, visible)) {
+			if (_note_layer) {
+				samplepos_t start, end;
+				note_samples (note, start, end);
+				_note_layer->add (note, start, end);
+			}
 			if (!empty_when_starting && (cne = find_canvas_note (note)) != 0) {
+				if (_note_layer && !cne->selected () && cne != _entered_note && !note_needs_item (note)) {
+					/* not validated, the item is removed below */
+					continue;
+				}
 				cne->validate ();
 				if (visible) {
 					cne->show ();
 				} else {
 					cne->hide ();
 				}
-			} else {
+			} else if (!_note_layer || note_needs_item (note)) {
 				missing_notes.insert (note);
 			}
 		}
 	}
 
+	if (_note_layer) {
+		_note_layer->done ();
+	}
+
 	if (!empty_when_starting) {
 		MidiModel::Notes::iterator f;
 		for (Events::iterator i = _events.begin(); i != _events.end(); ) {
@@ -1221,6 +1372,12 @@ MidiRegionView::redisplay_model()
 		}
 	}
 
+	if (_note_layer) {
+		for (Events::iterator i = _events.begin(); i != _events.end(); ++i) {
+			_note_layer->set_materialized (i->first, true);
+		}
+	}
+
 	for (vector<GhostRegion*>::iterator j = ghosts.begin(); j != ghosts.end(); ++j) {
 		MidiGhostRegion* gr = dynamic_cast<MidiGhostRegion*> (*j);
 		if (gr && !gr->trackview.hidden()) {
@@ -1504,6 +1661,11 @@ MidiRegionView::add_ghost (TimeAxisView& tv)
 		ghost->add_note(i->second);
 	}
 
+	if (_note_layer) {
+		/* draw the notes of the layer */
+		ghost->redisplay_model ();
+	}
+
 	ghosts.push_back (ghost);
 	enable_display (true);
 	return ghost;
@@ -1815,6 +1977,10 @@ MidiRegionView::add_note(const boost::shared_ptr<NoteType> note, bool visible)
 		event->on_channel_selection_change (get_selected_channels());
 		_events.insert (make_pair (event->note(), event));
 
+		if (_note_layer) {
+			_note_layer->set_materialized (note, true);
+		}
+
 		if (visible) {
 			event->show();
 		} else {
@@ -2086,6 +2252,10 @@ MidiRegionView::note_deleted (NoteBase* cne)
 		_entered_note = 0;
 	}
 
+	if (cne == _hover_item) {
+		_hover_item = 0;
+	}
+
 	if (_selection.empty()) {
 		return;
 	}
@@ -2164,6 +2334,14 @@ MidiRegionView::select_all_notes ()
 	for (Events::iterator i = _events.begin(); i != _events.end(); ++i) {
 		add_to_selection (i->second);
 	}
+
+	if (_note_layer) {
+		vector<boost::shared_ptr<NoteType> > notes;
+		_note_layer->get_notes (notes);
+		for (vector<boost::shared_ptr<NoteType> >::const_iterator n = notes.begin(); n != notes.end(); ++n) {
+			add_to_selection (note_item (*n));
+		}
+	}
 }
 
 void
@@ -2176,12 +2354,29 @@ MidiRegionView::select_range (samplepos_t start, samplepos_t end)
 			add_to_selection (i->second);
 		}
 	}
+
+	if (_note_layer) {
+		vector<boost::shared_ptr<NoteType> > notes;
+		_note_layer->get_notes (notes);
+		for (vector<boost::shared_ptr<NoteType> >::const_iterator n = notes.begin(); n != notes.end(); ++n) {
+			samplepos_t t = source_beats_to_absolute_samples((*n)->time());
+			if (t >= start && t <= end) {
+				add_to_selection (note_item (*n));
+			}
+		}
+	}
 }
 
 void
 MidiRegionView::invert_selection ()
 {
 	PBD::Unwinder<bool> uw (_no_sound_notes, true);
+	vector<boost::shared_ptr<NoteType> > notes;
+	if (_note_layer) {
+		/* notes without item, these are not selected */
+		_note_layer->get_notes (notes);
+	}
+
 	for (Events::iterator i = _events.begin(); i != _events.end(); ++i) {
 		if (i->second->selected()) {
 			remove_from_selection(i->second);
@@ -2189,6 +2384,10 @@ MidiRegionView::invert_selection ()
 			add_to_selection (i->second);
 		}
 	}
+
+	for (vector<boost::shared_ptr<NoteType> >::const_iterator n = notes.begin(); n != notes.end(); ++n) {
+		add_to_selection (note_item (*n));
+	}
 }
 
 /** Used for selection undo/redo.
@@ -2202,9 +2401,23 @@ MidiRegionView::select_notes (list<Evoral::event_id_t> notes, bool allow_auditio
 
 	PBD::Unwinder<bool> uw (_no_sound_notes, allow_audition ? _no_sound_notes : true);
 
+	/* notes drawn by the note layer, by ID */
+	std::map<Evoral::event_id_t, boost::shared_ptr<NoteType> > unmaterialized;
+	std::map<Evoral::event_id_t, boost::shared_ptr<NoteType> >::const_iterator u;
+
+	if (_note_layer) {
+		vector<boost::shared_ptr<NoteType> > layer_notes;
+		_note_layer->get_notes (layer_notes);
+		for (vector<boost::shared_ptr<NoteType> >::const_iterator i = layer_notes.begin(); i != layer_notes.end(); ++i) {
+			unmaterialized[(*i)->id()] = *i;
+		}
+	}
+
 	for (n = notes.begin(); n != notes.end(); ++n) {
 		if ((cne = find_canvas_note(*n)) != 0) {
 			add_to_selection (cne);
+		} else if ((u = unmaterialized.find (*n)) != unmaterialized.end()) {
+			add_to_selection (note_item (u->second));
 		} else {
 			_pending_note_selection.insert(*n);
 		}
@@ -2269,7 +2482,7 @@ MidiRegionView::select_matching_notes (uint8_t notenum, uint16_t channel_mask, b
 		}
 
 		if (select) {
-			if ((cne = find_canvas_note (note)) != 0) {
+			if ((cne = note_item (note)) != 0) {
 				// extend is false because we've taken care of it,
 				// since it extends by time range, not pitch.
 				note_selected (cne, add, false);
@@ -2293,7 +2506,7 @@ MidiRegionView::toggle_matching_notes (uint8_t notenum, uint16_t channel_mask)
 		NoteBase* cne;
 
 		if (note->note() == notenum && (((0x0001 << note->channel()) & channel_mask) != 0)) {
-			if ((cne = find_canvas_note (note)) != 0) {
+			if ((cne = note_item (note)) != 0) {
 				if (cne->selected()) {
 					note_deselected (cne);
 				} else {
@@ -2350,6 +2563,17 @@ MidiRegionView::note_selected (NoteBase* ev, bool add, bool extend)
 				add_to_selection (i->second);
 			}
 		}
+
+		if (_note_layer) {
+			vector<boost::shared_ptr<NoteType> > notes;
+			_note_layer->get_notes (notes);
+			for (vector<boost::shared_ptr<NoteType> >::const_iterator n = notes.begin(); n != notes.end(); ++n) {
+				if (((*n)->time() >= earliest && (*n)->end_time() <= latest) ||
+				    ((*n)->time() <= earliest && (*n)->end_time() >= latest)) {
+					add_to_selection (note_item (*n));
+				}
+			}
+		}
 	}
 }
 
@@ -2388,6 +2612,15 @@ MidiRegionView::update_drag_selection(samplepos_t start, samplepos_t end, double
 		}
 	}
 
+	if (_note_layer) {
+		/* notes without item, use the layer's index */
+		vector<boost::shared_ptr<NoteType> > notes;
+		_note_layer->get_notes (ArdourCanvas::Rect (x0, y0, x1, y1), notes);
+		for (vector<boost::shared_ptr<NoteType> >::const_iterator n = notes.begin(); n != notes.end(); ++n) {
+			add_to_selection (note_item (*n));
+		}
+	}
+
 	typedef RouteTimeAxisView::AutomationTracks ATracks;
 	typedef std::list<Selectable*>              Selectables;
 
@@ -2428,6 +2661,14 @@ MidiRegionView::update_vertical_drag_selection (double y1, double y2, bool exten
 			remove_from_selection (i->second);
 		}
 	}
+
+	if (_note_layer) {
+		vector<boost::shared_ptr<NoteType> > notes;
+		_note_layer->get_notes (ArdourCanvas::Rect (0, y1, ArdourCanvas::COORD_MAX, y2), notes);
+		for (vector<boost::shared_ptr<NoteType> >::const_iterator n = notes.begin(); n != notes.end(); ++n) {
+			add_to_selection (note_item (*n));
+		}
+	}
 }
 
 void
@@ -3584,6 +3825,10 @@ MidiRegionView::midi_channel_mode_changed ()
 		i->second->on_channel_selection_change (mask);
 	}
 
+	if (_note_layer) {
+		_note_layer->redraw ();
+	}
+
 	_patch_changes.clear ();
 	display_patch_changes ();
 }
@@ -3772,17 +4017,18 @@ MidiRegionView::goto_next_note (bool add_to_selection)
 
 	for (MidiModel::Notes::iterator n = notes.begin(); n != notes.end(); ++n) {
 		NoteBase* cne = 0;
-		if ((cne = find_canvas_note (*n))) {
+		if ((cne = find_canvas_note (*n)) || (_note_layer && _note_layer->contains (*n))) {
 
 			if (!first_note && (channel_mask & (1 << (*n)->channel()))) {
-				first_note = cne;
+				first_note = cne ? cne : note_item (*n);
 			}
 
-			if (cne->selected()) {
+			if (cne && cne->selected()) {
 				use_next = true;
 				continue;
 			} else if (use_next) {
 				if (channel_mask & (1 << (*n)->channel())) {
+					cne = note_item (*n);
 					if (!add_to_selection) {
 						unique_select (cne);
 					} else {
@@ -3825,18 +4071,19 @@ MidiRegionView::goto_previous_note (bool add_to_selection)
 
 	for (MidiModel::Notes::reverse_iterator n = notes.rbegin(); n != notes.rend(); ++n) {
 		NoteBase* cne = 0;
-		if ((cne = find_canvas_note (*n))) {
+		if ((cne = find_canvas_note (*n)) || (_note_layer && _note_layer->contains (*n))) {
 
 			if (!last_note && (channel_mask & (1 << (*n)->channel()))) {
-				last_note = cne;
+				last_note = cne ? cne : note_item (*n);
 			}
 
-			if (cne->selected()) {
+			if (cne && cne->selected()) {
 				use_next = true;
 				continue;
 
 			} else if (use_next) {
 				if (channel_mask & (1 << (*n)->channel())) {
+					cne = note_item (*n);
 					if (!add_to_selection) {
 						unique_select (cne);
 					} else {
@@ -3876,6 +4123,11 @@ MidiRegionView::selection_as_notelist (Notes& selected, bool allow_all_if_none_s
 		for (Events::iterator i = _events.begin(); i != _events.end(); ++i) {
 			selected.insert (i->first);
 		}
+		if (_note_layer) {
+			vector<boost::shared_ptr<NoteType> > notes;
+			_note_layer->get_notes (notes);
+			selected.insert (notes.begin(), notes.end());
+		}
 	}
 }
 
@@ -4030,6 +4282,10 @@ MidiRegionView::color_handler ()
 		i->second->set_selected (i->second->selected()); // will change color
 	}
 
+	if (_note_layer) {
+		_note_layer->redraw ();
+	}
+
 	/* XXX probably more to do here */
 }
 
@@ -57,6 +57,7 @@ class SysEx;
 class NoteBase;
 class Note;
 class Hit;
+class NoteLayer;
 class MidiTimeAxisView;
 class GhostRegion;
 class AutomationTimeAxisView;
@@ -427,6 +428,8 @@ public:
 	friend class NoteCreateDrag;
 	friend class HitCreateDrag;
 	friend class MidiGhostRegion;
+	friend class NoteLayer;
+	friend class GhostNoteLayer;
 
 	friend class EditNoteDialog;
 
@@ -491,6 +494,8 @@ public:
 	SysExes                              _sys_exes;
 	Note**                               _active_notes;
 	ArdourCanvas::Container*             _note_group;
+	NoteLayer*                           _note_layer;
+	NoteBase*                            _hover_item; ///< item given to a note of the layer on motion
 	ARDOUR::MidiModel::NoteDiffCommand*  _note_diff_command;
 	NoteBase*                            _ghost_note;
 	double                               _last_ghost_x;
@@ -528,6 +533,11 @@ public:
 	NoteBase* find_canvas_note (Evoral::event_id_t id);
 	Events::iterator _optimization_iterator;
 
+	NoteBase* note_item (boost::shared_ptr<NoteType>);
+	void drop_hover_item ();
+	bool note_needs_item (boost::shared_ptr<NoteType>) const;
+	void note_samples (boost::shared_ptr<NoteType>, ARDOUR::samplepos_t& start, ARDOUR::samplepos_t& end) const;
+
 	boost::shared_ptr<PatchChange> find_canvas_patch_change (ARDOUR::MidiModel::PatchChangePtr p);
 	boost::shared_ptr<SysEx> find_canvas_sys_ex (ARDOUR::MidiModel::SysExPtr s);
 
@@ -84,6 +84,7 @@ class NoteBase : public sigc::trackable
 	virtual void move_event(double dx, double dy) = 0;
 
 	uint32_t base_color();
+	static uint32_t base_color (MidiRegionView&, uint8_t velocity, uint8_t channel);
 
 	void show_velocity();
 	void hide_velocity();
@@ -0,0 +1,508 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+
+#include <cairomm/context.h>
+
+#include "gtkmm2ext/colors.h"
+
+#include "ardour/region.h"
+
+#include "canvas/debug.h"
+
+#include "ghostregion.h"
+#include "midi_region_view.h"
+#include "note_base.h"
+#include "note_layer.h"
+#include "public_editor.h"
+#include "time_axis_view.h"
+#include "ui_config.h"
+
+using namespace std;
+using namespace ARDOUR;
+using namespace ArdourCanvas;
+
+NoteLayer::NoteLayer (MidiRegionView& region, Item* parent)
+	: Item (parent)
+	, _region (region)
+	, _percussive (false)
+	, _size (0)
+	, _dirty (false)
+{
+	CANVAS_DEBUG_NAME (this, "note layer");
+	/* hit-testing is done explicitly using note_at() */
+	set_ignore_events (true);
+	for (int p = 0; p < 128; ++p) {
+		_max_length[p] = 0;
+	}
+}
+
+void
+NoteLayer::clear ()
+{
+	begin_change ();
+
+	for (int p = 0; p < 128; ++p) {
+		_rows[p].clear ();
+		_max_length[p] = 0;
+	}
+	_index.clear ();
+	_size  = 0;
+	_dirty = false;
+
+	_bounding_box_dirty = true;
+	end_change ();
+}
+
+void
+NoteLayer::done ()
+{
+	/* the bounding box was computed while the layer was empty, and
+	 * geometry depends on zoom and height, which may have changed */
+	begin_change ();
+	_bounding_box_dirty = true;
+	end_change ();
+}
+
+void
+NoteLayer::add (boost::shared_ptr<NoteType> note, samplepos_t start, samplepos_t end)
+{
+	uint8_t const p = note->note () & 0x7f;
+	_rows[p].push_back (Entry (note, start, end));
+	_max_length[p] = max (_max_length[p], end - start);
+	++_size;
+	_dirty = true;
+}
+
+void
+NoteLayer::set_percussive (bool yn)
+{
+	if (_percussive == yn) {
+		return;
+	}
+	_percussive = yn;
+	redraw ();
+}
+
+void
+NoteLayer::ensure_index () const
+{
+	if (!_dirty) {
+		return;
+	}
+
+	_index.clear ();
+
+	for (size_t p = 0; p < 128; ++p) {
+		Row& row (_rows[p]);
+		stable_sort (row.begin (), row.end ());
+		for (size_t i = 0; i < row.size (); ++i) {
+			_index[row[i].note.get ()] = (i << 7) | p;
+		}
+	}
+
+	_dirty = false;
+}
+
+NoteLayer::Entry*
+NoteLayer::find_entry (boost::shared_ptr<NoteType> note) const
+{
+	ensure_index ();
+
+	Index::const_iterator i = _index.find (note.get ());
+	if (i == _index.end ()) {
+		return 0;
+	}
+	return &_rows[i->second & 0x7f][i->second >> 7];
+}
+
+void
+NoteLayer::set_materialized (boost::shared_ptr<NoteType> note, bool yn)
+{
+	Entry* e = find_entry (note);
+	if (e && e->materialized != yn) {
+		e->materialized = yn;
+		redraw ();
+	}
+}
+
+bool
+NoteLayer::contains (boost::shared_ptr<NoteType> note) const
+{
+	return find_entry (note) != 0;
+}
+
+bool
+NoteLayer::pitch_extent (uint8_t pitch, Coord& y0, Coord& y1) const
+{
+	if (pitch < _region._current_range_min || pitch > _region._current_range_max) {
+		return false;
+	}
+
+	/* same as MidiRegionView::update_sustained, update_hit */
+	if (_percussive) {
+		const double size = max (1., floor (_region.note_height ()) - 2.);
+		const double y    = 1.5 + floor (_region.note_to_y (pitch)) + size * .5;
+		if (y <= 0 || y >= _region.height ()) {
+			return false;
+		}
+		y0 = y - size * .5;
+		y1 = y + size * .5;
+	} else {
+		y0 = 1 + floor (_region.note_to_y (pitch));
+		y1 = y0 + max (1., floor (_region.note_height ()) - 1);
+	}
+	return true;
+}
+
+Rect
+NoteLayer::note_rect (Entry const& e, Coord y0, Coord y1) const
+{
+	PublicEditor& editor (_region.get_time_axis_view ().editor ());
+
+	if (_percussive) {
+		const double x    = editor.sample_to_pixel (e.start);
+		const double half = (y1 - y0) * .5;
+		return Rect (x - half, y0, x + half, y1);
+	}
+
+	const double x0 = max (0., editor.sample_to_pixel (e.start));
+	double       x1;
+
+	if (e.end <= e.start) {
+		x1 = x0 + 1.;
+	} else {
+		x1 = max (1., editor.sample_to_pixel (e.end)) - 1;
+	}
+
+	return Rect (x0, y0, max (x0 + 1., x1), y1);
+}
+
+NoteLayer::Row::const_iterator
+NoteLayer::first_in_range (uint8_t pitch, Coord x, Coord h) const
+{
+	Row const& row (_rows[pitch]);
+
+	/* a note starting this far to the left may still reach x */
+	const double      pad   = 2 + (_percussive ? h : 0);
+	const samplecnt_t spp   = _region.get_time_axis_view ().editor ().get_current_zoom ();
+	samplepos_t       start = (samplepos_t) floor (max (0., x - pad) * spp) - _max_length[pitch];
+
+	return lower_bound (row.begin (), row.end (), Entry (boost::shared_ptr<NoteType> (), start, start));
+}
+
+boost::shared_ptr<NoteLayer::NoteType>
+NoteLayer::note_at (Duple const& p) const
+{
+	if (_size == 0) {
+		return boost::shared_ptr<NoteType> ();
+	}
+
+	ensure_index ();
+
+	if (p.y < 0 || p.y >= _region.height ()) {
+		return boost::shared_ptr<NoteType> ();
+	}
+
+	uint8_t const pitch = _region.y_to_note (p.y);
+	Coord         y0, y1;
+
+	if (!pitch_extent (pitch, y0, y1) || p.y < y0 || p.y >= y1) {
+		return boost::shared_ptr<NoteType> ();
+	}
+
+	boost::shared_ptr<NoteType> rv;
+
+	for (Row::const_iterator i = first_in_range (pitch, p.x, y1 - y0); i != _rows[pitch].end (); ++i) {
+		Rect const r = note_rect (*i, y0, y1);
+		if (r.x0 > p.x) {
+			break;
+		}
+		if (!i->materialized && p.x < r.x1) {
+			/* later notes are drawn on top */
+			rv = i->note;
+		}
+	}
+
+	return rv;
+}
+
+void
+NoteLayer::get_notes (Rect const& area, vector<boost::shared_ptr<NoteType> >& notes) const
+{
+	ensure_index ();
+
+	for (size_t p = 0; p < 128; ++p) {
+		Coord y0, y1;
+		if (_rows[p].empty () || !pitch_extent (p, y0, y1) || y0 >= area.y1 || y1 <= area.y0) {
+			continue;
+		}
+		for (Row::const_iterator i = first_in_range (p, area.x0, y1 - y0); i != _rows[p].end (); ++i) {
+			Rect const r = note_rect (*i, y0, y1);
+			if (r.x0 >= area.x1) {
+				break;
+			}
+			if (!i->materialized && r.x1 > area.x0) {
+				notes.push_back (i->note);
+			}
+		}
+	}
+}
+
+void
+NoteLayer::get_notes (vector<boost::shared_ptr<NoteType> >& notes) const
+{
+	for (size_t p = 0; p < 128; ++p) {
+		for (Row::const_iterator i = _rows[p].begin (); i != _rows[p].end (); ++i) {
+			if (!i->materialized) {
+				notes.push_back (i->note);
+			}
+		}
+	}
+}
+
+void
+NoteLayer::compute_bounding_box () const
+{
+	if (_size == 0) {
+		_bounding_box = Rect ();
+	} else {
+		PublicEditor& editor (_region.get_time_axis_view ().editor ());
+		_bounding_box = Rect (0, 0, editor.sample_to_pixel (_region.region ()->length ()), _region.height ());
+	}
+	_bounding_box_dirty = false;
+}
+
+bool
+NoteLayer::covers (Duple const&) const
+{
+	/* events are handled by the region, see MidiRegionView::canvas_group_event */
+	return false;
+}
+
+void
+NoteLayer::render (Rect const& area, Cairo::RefPtr<Cairo::Context> context) const
+{
+	if (_size == 0) {
+		return;
+	}
+
+	Rect const self  = item_to_window (bounding_box ());
+	Rect const isect = self.intersection (area);
+
+	if (!isect) {
+		return;
+	}
+
+	ensure_index ();
+
+	Rect const  draw   = window_to_item (isect);
+	Duple const offset = item_to_window (Duple (0, 0));
+
+	Shapes fills;
+	Shapes outlines;
+
+	for (int p = _region._current_range_min; p <= _region._current_range_max; ++p) {
+		Coord y0, y1;
+		if (_rows[p].empty () || !pitch_extent (p, y0, y1) || y0 > draw.y1 || y1 < draw.y0) {
+			continue;
+		}
+		add_runs (p, y0, y1, draw, offset, false, fills, outlines);
+	}
+
+	draw_shapes (context, fills, outlines, _percussive);
+}
+
+void
+NoteLayer::add_runs (uint8_t p, Coord y0, Coord y1, Rect const& draw, Duple const& offset, bool ghost, Shapes& fills, Shapes& outlines) const
+{
+	UIConfiguration&       uic      = UIConfiguration::instance ();
+	uint16_t const         mask     = ghost ? 0xffff : _region.get_selected_channels ();
+	Gtkmm2ext::Color const inactive = uic.color ("midi note inactive channel");
+
+	Rect            run;
+	NoteType const* loudest = 0;
+	size_t          n_run   = 0;
+
+	for (Row::const_iterator i = first_in_range (p, draw.x0, y1 - y0);; ++i) {
+
+		Rect r;
+		bool done = i == _rows[p].end ();
+
+		if (!done) {
+			/* a ghost region does not show materialized notes separately */
+			if (i->materialized && !ghost) {
+				continue;
+			}
+			r = note_rect (*i, y0, y1);
+			if (r.x0 > draw.x1) {
+				done = true;
+			} else if (r.x1 < draw.x0) {
+				continue;
+			}
+		}
+
+		/* merge notes less than 2px wide, that touch the previous one */
+		if (!done && n_run > 0 && r.x0 <= run.x1 + 1. && (_percussive || r.width () < 2. || run.width () < 2.)) {
+			run.x1 = max (run.x1, r.x1);
+			if (i->note->velocity () > loudest->velocity ()) {
+				loudest = i->note.get ();
+			}
+			++n_run;
+			continue;
+		}
+
+		if (n_run > 0) {
+			Gtkmm2ext::Color c;
+			Gtkmm2ext::Color o;
+			if ((mask & (1 << loudest->channel ())) == 0) {
+				c = inactive;
+				o = NoteBase::calculate_outline (c);
+			} else if (ghost) {
+				c = uic.color_mod (NoteBase::base_color (_region, loudest->velocity (), loudest->channel ()), "ghost track midi fill");
+				o = uic.color ("ghost track midi outline");
+			} else {
+				c = NoteBase::base_color (_region, loudest->velocity (), loudest->channel ());
+				o = NoteBase::calculate_outline (c);
+			}
+			fills[c].push_back (run.translate (offset));
+			if (_percussive || (n_run == 1 && run.width () > 2.)) {
+				outlines[o].push_back (run.translate (offset));
+			}
+		}
+
+		if (done) {
+			break;
+		}
+
+		run     = r;
+		loudest = i->note.get ();
+		n_run   = 1;
+	}
+}
+
+void
+NoteLayer::shape (Cairo::RefPtr<Cairo::Context> context, Rect const& r, bool percussive, bool outline)
+{
+	if (percussive) {
+		const double xc = (r.x0 + r.x1) * .5;
+		const double yc = (r.y0 + r.y1) * .5;
+		context->move_to (r.x0, yc);
+		context->line_to (xc, r.y0);
+		context->line_to (r.x1, yc);
+		context->line_to (xc, r.y1);
+		context->close_path ();
+	} else if (outline) {
+		context->rectangle (r.x0 + .5, r.y0 + .5, r.width () - 1., r.height () - 1.);
+	} else {
+		context->rectangle (r.x0, r.y0, r.width (), r.height ());
+	}
+}
+
+void
+NoteLayer::draw_shapes (Cairo::RefPtr<Cairo::Context> context, Shapes const& fills, Shapes const& outlines, bool percussive)
+{
+	/* fill and stroke each color only once */
+	for (Shapes::const_iterator s = fills.begin (); s != fills.end (); ++s) {
+		for (vector<Rect>::const_iterator r = s->second.begin (); r != s->second.end (); ++r) {
+			shape (context, *r, percussive, false);
+		}
+		Gtkmm2ext::set_source_rgba (context, s->first);
+		context->fill ();
+	}
+
+	context->set_line_width (1.0);
+
+	for (Shapes::const_iterator s = outlines.begin (); s != outlines.end (); ++s) {
+		for (vector<Rect>::const_iterator r = s->second.begin (); r != s->second.end (); ++r) {
+			shape (context, *r, percussive, true);
+		}
+		Gtkmm2ext::set_source_rgba (context, s->first);
+		context->stroke ();
+	}
+}
+
+GhostNoteLayer::GhostNoteLayer (MidiRegionView& region, MidiGhostRegion& ghost, Item* parent)
+	: Item (parent)
+	, _region (region)
+	, _ghost (ghost)
+{
+	CANVAS_DEBUG_NAME (this, "ghost note layer");
+	set_ignore_events (true);
+}
+
+void
+GhostNoteLayer::update ()
+{
+	begin_change ();
+	_bounding_box_dirty = true;
+	end_change ();
+}
+
+void
+GhostNoteLayer::compute_bounding_box () const
+{
+	if (!_region._note_layer || _region._note_layer->size () == 0) {
+		_bounding_box = Rect ();
+	} else {
+		PublicEditor& editor (_region.get_time_axis_view ().editor ());
+		_bounding_box = Rect (0, 0, editor.sample_to_pixel (_region.region ()->length ()), _ghost.trackview.current_height ());
+	}
+	_bounding_box_dirty = false;
+}
+
+void
+GhostNoteLayer::render (Rect const& area, Cairo::RefPtr<Cairo::Context> context) const
+{
+	NoteLayer const* layer = _region._note_layer;
+
+	if (!layer || layer->size () == 0) {
+		return;
+	}
+
+	Rect const self  = item_to_window (bounding_box ());
+	Rect const isect = self.intersection (area);
+
+	if (!isect) {
+		return;
+	}
+
+	layer->ensure_index ();
+
+	Rect const   draw   = window_to_item (isect);
+	Duple const  offset = item_to_window (Duple (0, 0));
+	double const h      = _ghost.pitch_height ();
+
+	NoteLayer::Shapes fills;
+	NoteLayer::Shapes outlines;
+
+	for (int p = _region._current_range_min; p <= _region._current_range_max; ++p) {
+		double const y0 = _ghost.pitch_y (p);
+		double const y1 = y0 + h;
+
+		if (layer->_rows[p].empty () || y0 > draw.y1 || y1 < draw.y0) {
+			continue;
+		}
+		layer->add_runs (p, y0, y1, draw, offset, true, fills, outlines);
+	}
+
+	NoteLayer::draw_shapes (context, fills, outlines, layer->_percussive);
+}
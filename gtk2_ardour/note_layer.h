@@ -0,0 +1,163 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __gtk_ardour_note_layer_h__
+#define __gtk_ardour_note_layer_h__
+
+#include <map>
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/unordered_map.hpp>
+
+#include "evoral/Note.h"
+#include "temporal/beats.h"
+
+#include "ardour/types.h"
+
+#include "gtkmm2ext/colors.h"
+
+#include "canvas/item.h"
+
+class MidiRegionView;
+class MidiGhostRegion;
+
+/** Draws all notes of a MidiRegionView in a single canvas item.
+ *
+ * Regions with many notes do not get a canvas item (Note, Hit) per note.
+ * The note layer draws them directly from a per-pitch array sorted by time,
+ * which also serves as spatial index for hit-testing. Notes that are
+ * narrower than a pixel are merged with their neighbours.
+ *
+ * Notes that are edited (selected, hovered, dragged) get a NoteBase
+ * item of their own, those are marked "materialized" and are not drawn
+ * by the layer.
+ */
+class NoteLayer : public ArdourCanvas::Item
+{
+public:
+	typedef Evoral::Note<Temporal::Beats> NoteType;
+
+	NoteLayer (MidiRegionView&, ArdourCanvas::Item* parent);
+
+	/** remove all notes, call done() once the layer is refilled using add() */
+	void clear ();
+
+	/** Add a note.
+	 * @param start region relative start of the note in samples
+	 * @param end region relative end of the note in samples
+	 */
+	void add (boost::shared_ptr<NoteType>, ARDOUR::samplepos_t start, ARDOUR::samplepos_t end);
+	void done ();
+
+	void set_percussive (bool);
+	void set_materialized (boost::shared_ptr<NoteType>, bool);
+
+	bool contains (boost::shared_ptr<NoteType>) const;
+
+	/** @return the note at the given point in item coordinates */
+	boost::shared_ptr<NoteType> note_at (ArdourCanvas::Duple const&) const;
+
+	/** Find notes that are not materialized.
+	 * @param r area in item coordinates
+	 */
+	void get_notes (ArdourCanvas::Rect const& r, std::vector<boost::shared_ptr<NoteType> >&) const;
+	void get_notes (std::vector<boost::shared_ptr<NoteType> >&) const;
+
+	size_t size () const { return _size; }
+
+	void compute_bounding_box () const;
+	void render (ArdourCanvas::Rect const&, Cairo::RefPtr<Cairo::Context>) const;
+	bool covers (ArdourCanvas::Duple const&) const;
+
+private:
+	friend class GhostNoteLayer;
+
+	struct Entry {
+		Entry (boost::shared_ptr<NoteType> n, ARDOUR::samplepos_t s, ARDOUR::samplepos_t e)
+			: note (n), start (s), end (e), materialized (false) {}
+
+		boost::shared_ptr<NoteType> note;
+		ARDOUR::samplepos_t         start;
+		ARDOUR::samplepos_t         end;
+		bool                        materialized;
+
+		bool operator< (Entry const& other) const { return start < other.start; }
+	};
+
+	typedef std::vector<Entry> Row;
+
+	void   ensure_index () const;
+	Entry* find_entry (boost::shared_ptr<NoteType>) const;
+
+	ArdourCanvas::Rect note_rect (Entry const&, ArdourCanvas::Coord y0, ArdourCanvas::Coord y1) const;
+	bool               pitch_extent (uint8_t pitch, ArdourCanvas::Coord& y0, ArdourCanvas::Coord& y1) const;
+	Row::const_iterator first_in_range (uint8_t pitch, ArdourCanvas::Coord x, ArdourCanvas::Coord height) const;
+
+	/* shapes to draw, by color */
+	typedef std::map<Gtkmm2ext::Color, std::vector<ArdourCanvas::Rect> > Shapes;
+
+	/** Merge the notes of a pitch that are in the given area into runs,
+	 * shared by the layer and GhostNoteLayer.
+	 * @param y0 top of the notes in item coordinates
+	 * @param y1 bottom of the notes in item coordinates
+	 * @param offset item to window translation
+	 * @param ghost use ghost region colors, include materialized notes
+	 */
+	void add_runs (uint8_t pitch, ArdourCanvas::Coord y0, ArdourCanvas::Coord y1, ArdourCanvas::Rect const& area, ArdourCanvas::Duple const& offset,
+	               bool ghost, Shapes& fills, Shapes& outlines) const;
+
+	static void shape (Cairo::RefPtr<Cairo::Context>, ArdourCanvas::Rect const&, bool percussive, bool outline);
+	static void draw_shapes (Cairo::RefPtr<Cairo::Context>, Shapes const& fills, Shapes const& outlines, bool percussive);
+
+	MidiRegionView& _region;
+	bool            _percussive;
+	size_t          _size;
+
+	/* per pitch, sorted by start-time when _dirty is false */
+	mutable Row                 _rows[128];
+	mutable ARDOUR::samplecnt_t _max_length[128];
+	mutable bool                _dirty;
+
+	/* note -> (index << 7) | pitch */
+	typedef boost::unordered_map<NoteType const*, size_t> Index;
+	mutable Index _index;
+};
+
+/** Draws all notes of a MidiRegionView's NoteLayer in a ghost region.
+ *
+ * Unlike the NoteLayer, this also draws the notes that have an item
+ * of their own, the ghost region does not show those separately.
+ */
+class GhostNoteLayer : public ArdourCanvas::Item
+{
+public:
+	GhostNoteLayer (MidiRegionView&, MidiGhostRegion&, ArdourCanvas::Item* parent);
+
+	/** call when the notes, zoom or height changed */
+	void update ();
+
+	void compute_bounding_box () const;
+	void render (ArdourCanvas::Rect const&, Cairo::RefPtr<Cairo::Context>) const;
+
+private:
+	MidiRegionView&  _region;
+	MidiGhostRegion& _ghost;
+};
+
+#endif /* __gtk_ardour_note_layer_h__ */
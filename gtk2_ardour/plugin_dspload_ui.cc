@@ -30,10 +30,15 @@ using namespace Gtk;
 
 PluginLoadStatsGui::PluginLoadStatsGui (boost::shared_ptr<ARDOUR::PluginInsert> insert)
 	: _insert (insert)
+	, _worker (0)
 	, _lbl_min ("", ALIGN_RIGHT, ALIGN_CENTER)
 	, _lbl_max ("", ALIGN_RIGHT, ALIGN_CENTER)
 	, _lbl_avg ("", ALIGN_RIGHT, ALIGN_CENTER)
 	, _lbl_dev ("", ALIGN_RIGHT, ALIGN_CENTER)
+	, _lbl_lua_run ("", ALIGN_LEFT, ALIGN_CENTER)
+	, _lbl_lua_gc ("", ALIGN_LEFT, ALIGN_CENTER)
+	, _lbl_lua_mem ("", ALIGN_LEFT, ALIGN_CENTER)
+	, _lbl_worker ("", ALIGN_LEFT, ALIGN_CENTER)
 	, _reset_button (_("Reset"))
 	, _valid (false)
 {
@@ -63,6 +68,27 @@ PluginLoadStatsGui::PluginLoadStatsGui (boost::shared_ptr<ARDOUR::PluginInsert>
 	attach (_darea, 3, 4, 0, 4, Gtk::FILL|Gtk::EXPAND, Gtk::FILL, 4, 4);
 
 	attach (_reset_button, 4, 5, 2, 4, Gtk::FILL, Gtk::SHRINK);
+
+	_luaproc = boost::dynamic_pointer_cast<ARDOUR::LuaProc> (_insert->plugin ());
+	if (_luaproc) {
+		attach (*manage (new Gtk::Label (_("Lua DSP"), ALIGN_RIGHT, ALIGN_CENTER)),
+				0, 1, 4, 5, Gtk::FILL, Gtk::SHRINK, 2, 0);
+		attach (*manage (new Gtk::Label (_("Lua GC"), ALIGN_RIGHT, ALIGN_CENTER)),
+				0, 1, 5, 6, Gtk::FILL, Gtk::SHRINK, 2, 0);
+		attach (*manage (new Gtk::Label (_("Lua Memory"), ALIGN_RIGHT, ALIGN_CENTER)),
+				0, 1, 6, 7, Gtk::FILL, Gtk::SHRINK, 2, 0);
+		attach (_lbl_lua_run, 1, 5, 4, 5, Gtk::FILL, Gtk::SHRINK, 2, 0);
+		attach (_lbl_lua_gc,  1, 5, 5, 6, Gtk::FILL, Gtk::SHRINK, 2, 0);
+		attach (_lbl_lua_mem, 1, 5, 6, 7, Gtk::FILL, Gtk::SHRINK, 2, 0);
+	}
+
+	/* the plugin owns the worker, keep a reference to it */
+	_lv2 = boost::dynamic_pointer_cast<ARDOUR::LV2Plugin> (_insert->plugin ());
+	if (_lv2 && (_worker = _lv2->worker ()) != 0) {
+		attach (*manage (new Gtk::Label (_("LV2 Worker"), ALIGN_RIGHT, ALIGN_CENTER)),
+				0, 1, 7, 8, Gtk::FILL, Gtk::SHRINK, 2, 0);
+		attach (_lbl_worker, 1, 5, 7, 8, Gtk::FILL, Gtk::SHRINK, 2, 0);
+	}
 }
 
 void
@@ -95,9 +121,48 @@ PluginLoadStatsGui::update_cpu_label()
 		_lbl_avg.set_text ("-");
 		_lbl_dev.set_text ("-");
 	}
+	update_lua_labels ();
+	update_worker_label ();
 	_darea.queue_draw ();
 }
 
+void
+PluginLoadStatsGui::update_worker_label ()
+{
+	if (!_worker) {
+		return;
+	}
+
+	ARDOUR::Worker::Stats const s (_worker->stats ());
+	if (s.batches > 0) {
+		_lbl_worker.set_text (string_compose (_("requests: %1  latency max: %2  avg: %3 [ms]"),
+					s.requests, rint (s.max_latency / 10.) / 100., rint (s.total_latency / (10. * s.batches)) / 100.));
+	} else {
+		_lbl_worker.set_text ("-");
+	}
+}
+
+void
+PluginLoadStatsGui::update_lua_labels ()
+{
+	if (!_luaproc) {
+		return;
+	}
+
+	ARDOUR::LuaProc::DSPStats s;
+	if (_luaproc->get_dsp_stats (s)) {
+		_lbl_lua_run.set_text (string_compose (_("p50: %1  p90: %2  p99: %3 [ms]"),
+					rint (s.p50 / 10.) / 100., rint (s.p90 / 10.) / 100., rint (s.p99 / 10.) / 100.));
+		_lbl_lua_gc.set_text (string_compose (_("max: %1  avg: %2 [ms]"),
+					rint (s.gc_max / 10.) / 100., rint (s.gc_avg / 10.) / 100.));
+	} else {
+		_lbl_lua_run.set_text ("-");
+		_lbl_lua_gc.set_text ("-");
+	}
+	_lbl_lua_mem.set_text (string_compose (_("%1 kB, peak: %2 kB of %3 kB"),
+				s.mem_used / 1024, s.mem_peak / 1024, s.mem_size / 1024));
+}
+
 bool
 PluginLoadStatsGui::draw_bar (GdkEventExpose* ev)
 {
@@ -27,6 +27,8 @@
 
 #include "widgets/ardour_button.h"
 
+#include "ardour/luaproc.h"
+#include "ardour/lv2_plugin.h"
 #include "ardour/plugin_insert.h"
 
 class PluginLoadStatsGui : public Gtk::Table
@@ -43,17 +45,32 @@ public:
 private:
 	void update_cpu_label ();
 	bool draw_bar (GdkEventExpose*);
+	void update_lua_labels ();
+	void update_worker_label ();
 	void clear_stats () {
 		_insert->clear_stats ();
+		if (_luaproc) {
+			_luaproc->clear_dsp_stats ();
+		}
+		if (_worker) {
+			_worker->clear_stats ();
+		}
 	}
 
 	boost::shared_ptr<ARDOUR::PluginInsert> _insert;
+	boost::shared_ptr<ARDOUR::LuaProc>      _luaproc;
+	boost::shared_ptr<ARDOUR::LV2Plugin>    _lv2;
+	ARDOUR::Worker*                         _worker;
 	sigc::connection update_cpu_label_connection;
 
 	Gtk::Label _lbl_min;
 	Gtk::Label _lbl_max;
 	Gtk::Label _lbl_avg;
 	Gtk::Label _lbl_dev;
+	Gtk::Label _lbl_lua_run;
+	Gtk::Label _lbl_lua_gc;
+	Gtk::Label _lbl_lua_mem;
+	Gtk::Label _lbl_worker;
 
 	ArdourWidgets::ArdourButton _reset_button;
 	Gtk::DrawingArea _darea;
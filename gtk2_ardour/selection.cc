@@ -967,9 +967,7 @@ Selection::set (ControlPoint* cp)
 		return;
 	}
 
-	for (uint32_t i = 0; i < cp->line().npoints(); ++i) {
-		cp->line().nth (i)->set_selected (false);
-	}
+	cp->line().unselect_points ();
 
 	clear_objects ();
 	add (cp);
@@ -160,10 +160,7 @@ bool
 StripSilenceDialog::idle_update_progress()
 {
 	if (analysis_progress_max > 0) {
-		// AudioRegion::find_silence() has
-		// itt.progress = (end - pos) / length
-		// not sure if that's intentional, but let's use (1. - val)
-		float rp = std::min(1.f, std::max (0.f, (1.f - _interthread_info.progress)));
+		float rp = std::min(1.f, std::max (0.f, (float) _interthread_info.progress));
 		float p = analysis_progress_cur / (float) analysis_progress_max
 		        + rp / (float) analysis_progress_max;
 		update_progress_gui (p);
@@ -265,23 +262,33 @@ StripSilenceDialog::detection_thread_work ()
 	_lock.lock ();
 
 	while (1) {
-		analysis_progress_cur = 0;
-		analysis_progress_max = views.size();
+		vector<boost::shared_ptr<AudioRegion> > regions;
 		for (list<ViewInterval>::iterator i = views.begin(); i != views.end(); ++i) {
 			boost::shared_ptr<AudioRegion> ar = boost::dynamic_pointer_cast<AudioRegion> ((*i).view->region());
-
+			i->intervals.clear ();
 			if (ar) {
-				i->intervals = ar->find_silence (dB_to_coefficient (threshold ()), minimum_length (), fade_length(), _interthread_info);
+				regions.push_back (ar);
 			}
+		}
+
+		/* all regions are analyzed concurrently, and report a single progress */
+		analysis_progress_cur = 0;
+		analysis_progress_max = 1;
+		_interthread_info.progress = 0;
+
+		vector<AudioIntervalResult> intervals = AudioRegion::find_silence (regions, dB_to_coefficient (threshold ()), minimum_length (), fade_length(), _interthread_info);
 
-			if (_interthread_info.cancel) {
-				break;
+		if (!_interthread_info.cancel) {
+			vector<AudioIntervalResult>::const_iterator r = intervals.begin ();
+			for (list<ViewInterval>::iterator i = views.begin(); i != views.end(); ++i) {
+				if (boost::dynamic_pointer_cast<AudioRegion> ((*i).view->region())) {
+					i->intervals = *r++;
+				}
 			}
-			++analysis_progress_cur;
-			_interthread_info.progress = 1.0;
-			ARDOUR::GUIIdle ();
 		}
 
+		ARDOUR::GUIIdle ();
+
 		analysis_progress_max = 0;
 
 		if (!_interthread_info.cancel) {
@@ -113,6 +113,8 @@ UI_CONFIG_VARIABLE (bool, use_wm_visibility, "use-wm-visibility", true)
 UI_CONFIG_VARIABLE (std::string, stripable_color_palette, "stripable-color-palette", "#AA3939:#FFAAAA:#D46A6A:#801515:#550000:#AA8E39:#FFEAAA:#D4BA6A:#806515:#554000:#343477:#8080B3:#565695:#1A1A59:#09093B:#2D882D:#88CC88:#55AA55:#116611:#004400")  /* Gtk::ColorSelection::palette_to_string */
 UI_CONFIG_VARIABLE (bool, use_note_bars_for_velocity, "use-note-bars-for-velocity", true)
 UI_CONFIG_VARIABLE (bool, use_note_color_for_velocity, "use-note-color-for-velocity", true)
+UI_CONFIG_VARIABLE (uint32_t, max_midi_note_items, "max-midi-note-items", 1000) /* per region, more notes are drawn by a NoteLayer, 0: unlimited */
+UI_CONFIG_VARIABLE (uint32_t, max_automation_control_points, "max-automation-control-points", 1000) /* per line, more points only get a control point near the visible range, 0: unlimited */
 UI_CONFIG_VARIABLE (bool, show_snapped_cursor, "show-snapped-cursor", true)
 UI_CONFIG_VARIABLE (uint32_t, snap_threshold, "snap-threshold", 25)
 UI_CONFIG_VARIABLE (bool, snap_to_marks, "snap-to-marks", true)
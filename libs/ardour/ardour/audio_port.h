@@ -51,6 +51,7 @@ public:
 
 protected:
 	friend class PortManager;
+	friend class AudioPortResampler;
 	AudioPort (std::string const &, PortFlags);
 
 	/* special access for PortManager only (hah, C++) */
@@ -61,6 +62,7 @@ private:
 	ArdourZita::VMResampler _src;
 	Sample*                 _data;
 	bool                    _buf_valid;
+	bool                    _src_batched; /* _data is resampled by PortManager's AudioPortResampler */
 };
 
 } // namespace ARDOUR
@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _ardour_audio_port_resampler_h_
+#define _ardour_audio_port_resampler_h_
+
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+
+#include "zita-resampler/vmcresampler.h"
+
+#include "ardour/libardour_visibility.h"
+#include "ardour/rt_tasklist.h"
+#include "ardour/types.h"
+
+namespace ARDOUR {
+
+class AudioPort;
+
+/** Vari-speed resampling of externally connected AudioPorts.
+ *
+ * All ports share the same ratio (Port::speed_ratio). Rather than running
+ * one VMResampler per port, ports are grouped by direction into blocks
+ * of up to \ref max_block_size channels, and each block is processed in a
+ * single pass by a multi-channel ArdourZita::VMCResampler.
+ *
+ * Instances are immutable. PortManager creates a new one whenever the set
+ * of external audio ports changes, and the process-thread switches over,
+ * inheriting the resampler state of ports that are present in both.
+ */
+class LIBARDOUR_API AudioPortResampler
+{
+public:
+	typedef std::vector<boost::shared_ptr<AudioPort> > PortList;
+
+	AudioPortResampler (PortList const& inputs, PortList const& outputs, uint32_t quality);
+	~AudioPortResampler ();
+
+	static const uint32_t max_block_size = 64;
+
+	/** prepare to take over from \p other, must be called before \ref inherit */
+	void prepare_inherit (AudioPortResampler const* other);
+	/** copy resampler state of all ports also known by \p other. Realtime safe. */
+	void inherit (AudioPortResampler const* other);
+
+	/** mark all ports as being resampled by this instance. Realtime safe. */
+	void set_active (bool);
+
+	/** resample from the backend into the ports' buffers.
+	 * If a task list is given, blocks are queued there, otherwise they are
+	 * processed directly.
+	 */
+	void process_inputs (pframes_t nframes, RTTaskList::TaskList* tl = 0);
+	/** resample from the ports' buffers to the backend */
+	void process_outputs (pframes_t nframes, RTTaskList::TaskList* tl = 0);
+
+	size_t n_ports () const { return _n_ports; }
+
+private:
+	struct Block {
+		Block (PortList::const_iterator, PortList::const_iterator, uint32_t quality);
+
+		PortList                   ports;
+		ArdourZita::VMCResampler   src;
+		std::vector<float const*>  inp;
+		std::vector<float*>        out;
+
+		/* resampler state to inherit, see prepare_inherit() */
+		Block const*                                 state_from;
+		std::vector<std::pair<Block const*, uint32_t> > history_from;
+	};
+
+	typedef std::vector<Block*> Blocks;
+
+	static void setup_blocks (Blocks&, PortList const&, uint32_t quality);
+	static void map_blocks (Blocks&, Blocks const&);
+	static void inherit_blocks (Blocks&);
+
+	void process_input_block (Block*, pframes_t);
+	void process_output_block (Block*, pframes_t);
+	static void pad (Block*, uint32_t total, uint32_t remain);
+
+	Blocks _inputs;
+	Blocks _outputs;
+	size_t _n_ports;
+
+	AudioPortResampler const* _inherit_from;
+};
+
+} // namespace ARDOUR
+
+#endif
@@ -92,6 +92,15 @@ class LIBARDOUR_API AudioRegion : public Region
 	 */
 	double rms (Progress* p = 0) const;
 
+	/** Compute maximum_amplitude () and rms () of many regions at once.
+	 *  Each channel of each region is analyzed concurrently.
+	 *  @param peaks set to the maximum amplitude of each region
+	 *  @param rms set to the rms of each region
+	 *  @return false if the Progress object reports that the process was cancelled.
+	 */
+	static bool analyze_levels (std::vector<boost::shared_ptr<AudioRegion> > const&,
+	                            std::vector<double>& peaks, std::vector<double>& rms, Progress* p = 0);
+
 	bool envelope_active () const { return _envelope_active; }
 	bool fade_in_active ()  const { return _fade_in_active; }
 	bool fade_out_active () const { return _fade_out_active; }
@@ -183,6 +192,12 @@ class LIBARDOUR_API AudioRegion : public Region
 
 	AudioIntervalResult find_silence (Sample, samplecnt_t, samplecnt_t, InterThreadInfo&) const;
 
+	/** Call find_silence () for many regions, concurrently.
+	 *  @return the silent intervals of each region
+	 */
+	static std::vector<AudioIntervalResult> find_silence (std::vector<boost::shared_ptr<AudioRegion> > const&,
+	                                                      Sample, samplecnt_t, samplecnt_t, InterThreadInfo&);
+
   private:
 	friend class RegionFactory;
 
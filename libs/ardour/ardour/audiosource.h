@@ -105,6 +105,35 @@ class LIBARDOUR_API AudioSource : virtual public Source,
 
 	static void allocate_working_buffers (samplecnt_t framerate);
 
+	/** Peak and sum of squares of a range of samples */
+	struct RangeStats {
+		RangeStats () : peak (0), sumsq (0) {}
+		float  peak;
+		double sumsq;
+	};
+
+	/** Accumulate the peak and the sum of squares of [start, start + cnt) into \p s.
+	 *
+	 * The statistics of whole analysis blocks (aligned to multiples of
+	 * stats_block_size) are cached, so that repeated analysis of the same or
+	 * overlapping material only reads partial blocks at either end.
+	 * This can be called concurrently from different threads.
+	 *
+	 * @return false if the data could not be read
+	 */
+	bool range_stats (samplepos_t start, samplecnt_t cnt, RangeStats& s) const;
+
+	/** Look up the statistics of the given analysis block.
+	 * @return false if they are not known (yet)
+	 */
+	bool cached_block_stats (samplepos_t block, RangeStats&) const;
+	void cache_block_stats (samplepos_t block, RangeStats const&) const;
+
+	/** Accumulate the peak and the sum of squares of \p n samples into \p s */
+	static void compute_stats (Sample const*, samplecnt_t n, RangeStats& s);
+
+	static const samplecnt_t stats_block_size = 65536;
+
   protected:
 	static bool _build_missing_peakfiles;
 	static bool _build_peakfiles;
@@ -133,6 +162,9 @@ class LIBARDOUR_API AudioSource : virtual public Source,
 
 	mutable off_t _peak_byte_max; // modified in compute_and_write_peak()
 
+	mutable Glib::Threads::Mutex    _stats_lock;
+	mutable std::vector<RangeStats> _block_stats; // peak < 0: not known
+
 	virtual samplecnt_t read_unlocked (Sample *dst, samplepos_t start, samplecnt_t cnt) const = 0;
 	virtual samplecnt_t write_unlocked (Sample *dst, samplecnt_t cnt) = 0;
 	virtual std::string construct_peak_filepath (const std::string& audio_path, const bool in_session = false, const bool old_peak_name = false) const = 0;
@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __libardour_buffer_arena_h__
+#define __libardour_buffer_arena_h__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "ardour/libardour_visibility.h"
+
+namespace ARDOUR {
+
+/** A single, contiguous block of memory from which buffers are carved.
+ *
+ * The memory is page-aligned, zeroed by the thread that creates the arena,
+ * and locked (if permitted). On Linux it is backed by explicit huge pages
+ * if requested and available, or else marked as eligible for transparent
+ * huge pages. Memory is only released when the arena is destroyed.
+ */
+class LIBARDOUR_API BufferArena
+{
+public:
+	/** @param size minimum size in bytes
+	 *  @param huge_pages try to use huge pages
+	 */
+	BufferArena (size_t size, bool huge_pages);
+	~BufferArena ();
+
+	/** @return a cache-line aligned block of \p size bytes, 0 if the arena is exhausted */
+	void* alloc (size_t size);
+
+	template<typename T> T* alloc (size_t n) {
+		return static_cast<T*> (alloc (n * sizeof (T)));
+	}
+
+	size_t size () const { return _size; }
+	size_t used () const { return _used; }
+	bool huge_pages () const { return _huge_pages; }
+	bool locked () const { return _locked; }
+
+	/** round \p n up to a multiple of the cache-line size */
+	static size_t align (size_t n) { return (n + 63) & ~((size_t) 63); }
+
+private:
+	BufferArena (BufferArena const&);
+
+	uint8_t* _data;
+	size_t   _size;
+	size_t   _used;
+	bool     _huge_pages;
+	bool     _locked;
+};
+
+} // namespace ARDOUR
+
+#endif /* __libardour_buffer_arena_h__ */
@@ -35,6 +35,7 @@ class LIBARDOUR_API BufferManager
 {
 public:
 	static void init (uint32_t);
+	static uint32_t thread_buffer_count () { return _count; }
 
 	static ThreadBuffers* get_thread_buffers ();
 	static void           put_thread_buffers (ThreadBuffers*);
@@ -49,6 +50,7 @@ private:
 
 	static ThreadBufferFIFO* thread_buffers;
 	static ThreadBufferList* thread_buffers_list;
+	static uint32_t          _count;
 };
 
 }
@@ -82,6 +82,11 @@ public:
 	void ensure_buffers(DataType type, size_t num_buffers, size_t buffer_capacity);
 	void ensure_buffers(const ChanCount& chns, size_t buffer_capacity);
 
+	/** Replace the audio buffers with buffers using externally allocated memory.
+	 *  @param data memory for num_buffers * buffer_capacity samples, owned by the caller
+	 */
+	void use_audio_memory (size_t num_buffers, size_t buffer_capacity, Sample* data);
+
 	const ChanCount& available() const { return _available; }
 	ChanCount&       available()       { return _available; }
 
@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __libardour_cycle_trace_h__
+#define __libardour_cycle_trace_h__
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include <glib.h>
+
+#include <boost/function.hpp>
+
+#include "pbd/id.h"
+
+#include "ardour/libardour_visibility.h"
+
+namespace ARDOUR {
+
+class SessionObject;
+
+/** Flight recorder of the time spent in the process cycle.
+ *
+ * Each thread that records events writes to a ring-buffer of its own,
+ * without locks, keeping only the most recent events. When an xrun
+ * occurs, recording is paused until the butler has written the events
+ * to a file in Chrome's trace-event JSON format (chrome://tracing).
+ *
+ * Recording is disabled by default. A disabled Scope only costs an
+ * atomic load and a branch.
+ */
+class LIBARDOUR_API CycleTrace
+{
+public:
+	enum Kind {
+		Cycle,
+		PortCycleStart,
+		PortCycleEnd,
+		Route,
+		Processor,
+		Butler
+	};
+
+	struct Event {
+		Event () : kind (Cycle), thread (0), start (0), end (-1), id ((uint64_t) 0) { name[0] = '\0'; }
+
+		Kind     kind;
+		uint32_t thread;   ///< index of the recording thread
+		int64_t  start;    ///< [nsec]
+		int64_t  end;      ///< [nsec]
+		PBD::ID  id;       ///< the SessionObject, 0 if none
+		char     name[32]; ///< names of objects are filled in by snapshot ()
+	};
+
+	/** Record the lifetime of the scope as event */
+	class Scope {
+	public:
+		Scope (Kind kind, char const* name)
+		{
+			_event = g_atomic_int_get (&_state) == Recording ? begin (kind, name) : 0;
+		}
+
+		/* only the ID is recorded, the name is looked up by snapshot () */
+		Scope (Kind kind, SessionObject const& obj)
+		{
+			_event = g_atomic_int_get (&_state) == Recording ? begin (kind, obj) : 0;
+		}
+
+		~Scope ()
+		{
+			if (_event) {
+				end (_event);
+			}
+		}
+
+	private:
+		Scope (Scope const&);
+		Event* _event;
+	};
+
+	static void set_enabled (bool);
+	static bool enabled () { return g_atomic_int_get (&_state) != Disabled; }
+
+	/** Pause recording, and request the events to be written to a file
+	 * by write_pending (). Realtime safe.
+	 * @return true if a file is to be written
+	 */
+	static bool xrun ();
+
+	/** If xrun () was called, write all events to a file in the
+	 * user's cache directory, and resume recording.
+	 */
+	static void write_pending ();
+
+	/** Copy all recorded events, ordered by start time */
+	static void snapshot (std::vector<Event>&);
+
+	/** Set the function used to look up the names of objects
+	 * by their ID, when events are copied.
+	 */
+	static void set_name_lookup (boost::function<std::string (PBD::ID const&)>);
+
+	static bool write_chrome_trace (std::string const& path, std::vector<Event> const&);
+	static bool write_chrome_trace (std::string const& path);
+
+	/** @return count, total and max. time of recorded events, per event name */
+	static std::string summary ();
+
+	static char const* kind_name (Kind);
+
+	/** max. number of threads that record events at the same time */
+	static const uint32_t max_threads = 64;
+	/** events per thread, power of two */
+	static const uint32_t ring_size = 8192;
+
+private:
+	friend class Scope;
+
+	enum State {
+		Disabled = 0,
+		Recording,
+		Paused
+	};
+
+	static Event* begin (Kind, char const*);
+	static Event* begin (Kind, SessionObject const&);
+	static void   end (Event*);
+
+	static gint _state;
+};
+
+} // namespace ARDOUR
+
+#endif /* __libardour_cycle_trace_h__ */
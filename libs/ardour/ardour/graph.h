@@ -32,6 +32,7 @@
 
 #include "pbd/mpmc_queue.h"
 #include "pbd/semutils.h"
+#include "pbd/timing.h"
 
 #include "ardour/audio_backend.h"
 #include "ardour/libardour_visibility.h"
@@ -76,6 +77,16 @@ public:
 
 	bool in_process_thread () const;
 
+	/** Statistics since the DSP threads were last (re)created and placed
+	 * (see ThreadPlacement): duration of graph execution per cycle, and
+	 * the delay until the DSP threads wake up [usec]. */
+	bool cycle_stats (uint64_t& min, uint64_t& max, double& avg, double& dev) const {
+		return _cycle_stats.get_stats (min, max, avg, dev);
+	}
+	bool wakeup_stats (uint64_t& min, uint64_t& max, double& avg, double& dev) const {
+		return _wakeup_stats.get_stats (min, max, avg, dev);
+	}
+
 protected:
 	virtual void session_going_away ();
 
@@ -135,6 +146,11 @@ private:
 	int  _process_retval;
 	bool _process_need_butler;
 
+	PBD::TimingStats _cycle_stats;
+	PBD::TimingStats _wakeup_stats;
+
+	void report_stats ();
+
 	/* engine / thread connection */
 	PBD::ScopedConnectionList engine_connections;
 	void                      engine_stopped ();
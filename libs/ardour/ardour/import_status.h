@@ -34,12 +34,16 @@ namespace ARDOUR {
 
 class LIBARDOUR_API ImportStatus : public InterThreadInfo {
 public:
+	ImportStatus () : skip_failed_paths (false) {}
+
 	virtual ~ImportStatus() {
 		clear ();
 	}
 
 	virtual void clear () {
 		sources.clear ();
+		sources_by_path.clear ();
+		failed_paths.clear ();
 		paths.clear ();
 	}
 
@@ -54,6 +58,12 @@ public:
 	bool                       replace_existing_source;
 	bool                       split_midi_channels;
 	MidiTrackNameSource        midi_track_name_source;
+	/** if false, a file that fails to import fails all files of the batch,
+	 *  otherwise only the files that failed are skipped.
+	 *  Either way, the files are listed in failed_paths and cancel is
+	 *  left to the user.
+	 */
+	bool                       skip_failed_paths;
 
 	/** set to true when all files have been imported, as distinct from the done in ARDOUR::InterThreadInfo,
 	 *  which indicates that one run of the import thread has been completed.
@@ -61,7 +71,9 @@ public:
 	bool all_done;
 
 	/* result */
-	SourceList sources;
+	SourceList               sources;
+	std::vector<SourceList>  sources_by_path; ///< sources of each of paths, same order
+	std::vector<std::string> failed_paths;    ///< paths that could not be imported
 };
 
 } // namespace ARDOUR
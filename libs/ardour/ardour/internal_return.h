@@ -23,6 +23,11 @@
 #define __ardour_internal_return_h__
 
 
+#include <list>
+#include <vector>
+
+#include "pbd/rcu.h"
+
 #include "ardour/ardour.h"
 #include "ardour/return.h"
 #include "ardour/buffer_set.h"
@@ -35,24 +40,49 @@ class LIBARDOUR_API InternalReturn : public Return
 {
 public:
 	InternalReturn (Session&);
+	~InternalReturn ();
 
 	void run (BufferSet& bufs, samplepos_t start_sample, samplepos_t end_sample, double speed, pframes_t nframes, bool);
 	bool configure_io (ChanCount, ChanCount);
 	bool can_support_io_configuration (const ChanCount& in, ChanCount& out);
+	int  set_block_size (pframes_t);
 
 	void add_send (InternalSend *);
 	void remove_send (InternalSend *);
 
+	/** Sum the output of a send into the partial mix of the calling
+	 * process thread. This is called concurrently by sends of upstream
+	 * routes as they are processed, so that run() only needs to combine
+	 * one partial mix per thread.
+	 * @return false if the buffers were not used; run() then collects
+	 * them directly.
+	 */
+	bool accumulate (BufferSet const&, pframes_t nframes);
+
 	void set_playback_offset (samplecnt_t cnt);
 
 protected:
 	XMLNode& state ();
 
 private:
+	typedef std::list<InternalSend*> SendList;
+
 	/** sends that we are receiving data from */
-	std::list<InternalSend*> _sends;
-	/** mutex to protect _sends */
-	Glib::Threads::Mutex _sends_mutex;
+	SerializedRCUManager<SendList> _sends;
+	/** set while run() uses the current send list */
+	gint _in_run;
+
+	struct PartialMix {
+		PartialMix () : pass (0) {}
+		BufferSet bufs;
+		uint32_t  pass; ///< Session::process_pass() when last written
+	};
+
+	/** indexed by ThreadBuffers::id. The vector is never resized,
+	 * entries are allocated when the first send is added. */
+	std::vector<PartialMix*> _partials;
+
+	void allocate_partials ();
 };
 
 } // namespace ARDOUR
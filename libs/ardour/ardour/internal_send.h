@@ -56,6 +56,10 @@ public:
 	}
 
 	bool allow_feedback () const { return _allow_feedback;}
+
+	/** @return true if the output of the given process pass has been
+	 * added to the target's InternalReturn::accumulate() */
+	bool summed (uint32_t pass) const { return _summed_pass == pass; }
 	void set_allow_feedback (bool yn);
 
 	void set_can_pan (bool yn);
@@ -71,6 +75,7 @@ private:
 	boost::shared_ptr<Route> _send_from;
 	boost::shared_ptr<Route> _send_to;
 	bool _allow_feedback;
+	uint32_t _summed_pass;
 	PBD::ID _send_to_id;
 	PBD::ScopedConnection connect_c;
 	PBD::ScopedConnection source_connection;
@@ -29,6 +29,8 @@
 #include <list>
 #include <iostream>
 #include <map>
+#include <set>
+#include <vector>
 
 #include <sys/types.h>
 
@@ -230,6 +232,11 @@ public:
 	PBD::Signal1<void,Location*> removed;
 	PBD::Signal0<void> changed; /* emitted when any action that could have added/removed more than 1 location actually removed 1 or more */
 
+	/** emitted when the position, flags or name of a Location in this list changed.
+	 * (not emitted during set_state(), connect to changed for that)
+	 */
+	PBD::Signal1<void,Location*> modified;
+
 	template<class T> void apply (T& obj, void (T::*method)(const LocationList&)) const {
 		/* We don't want to hold the lock while the given method runs, so take a copy
 		 * of the list and pass that instead.
@@ -243,10 +250,37 @@ public:
 	}
 
 private:
+	typedef std::pair<samplepos_t, Location*> LocationPair;
+
 	LocationList locations;
 	Location*    current_location;
 	mutable Glib::Threads::Mutex lock;
 
+	/* Sorted index, rebuilt lazily (with lock held) after the list
+	 * or any of its locations changed. _index_dirty counts changes
+	 * since the last rebuild.
+	 */
+	mutable volatile gint             _index_dirty;
+	mutable std::vector<LocationPair> _index_positions; ///< start (and end of ranges) of all visible locations
+	mutable std::vector<LocationPair> _index_marks;     ///< start of all marks
+	mutable std::vector<Location*>    _index_by_start;  ///< all locations ordered by start
+	mutable std::map<PBD::ID, Location*> _index_ids;
+	mutable std::multiset<std::string>   _index_names;
+	mutable uint32_t                  _index_n_ranges;
+
+	/* special locations, valid while the index is not dirty */
+	mutable Location* _auto_loop_location;
+	mutable Location* _auto_punch_location;
+	mutable Location* _session_range_location;
+	mutable Location* _clock_origin_location;
+
+	bool _ignore_changes;
+	PBD::ScopedConnectionList _location_connections;
+
+	void invalidate_index () { g_atomic_int_inc (&_index_dirty); }
+	bool index_valid () const { return g_atomic_int_get (&_index_dirty) == 0; }
+	void ensure_index () const;
+
 	int set_current_unlocked (Location *);
 	void location_changed (Location*);
 	void listen_to (Location*);
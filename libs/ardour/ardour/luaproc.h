@@ -16,9 +16,6 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
-/* print runtime and garbage-collection timing statistics */
-//#define WITH_LUAPROC_STATS
-
 /* memory allocation system, default: ReallocPool */
 //#define USE_TLSF // use TLSF instead of ReallocPool
 //#define USE_MALLOC // or plain OS provided realloc (no mlock) -- if USE_TLSF isn't defined
@@ -26,10 +23,14 @@
 #ifndef __ardour_luaproc_h__
 #define __ardour_luaproc_h__
 
+#include <map>
 #include <set>
 #include <vector>
 #include <string>
 
+#include <glib.h>
+#include <glibmm/threads.h>
+
 #define USE_TLSF
 #ifdef USE_TLSF
 #  include "pbd/tlsf.h"
@@ -129,6 +130,27 @@ public:
 	DSP::DspShm* instance_shm () { return &lshm; }
 	LuaTableRef* instance_ref () { return &lref; }
 
+	struct DSPStats {
+		DSPStats () : n_cycles (0), p50 (0), p90 (0), p99 (0), gc_max (0), gc_avg (0), mem_used (0), mem_peak (0), mem_size (0) {}
+		uint64_t n_cycles;
+		double   p50;      ///< median time spent in dsp_run() [usec]
+		double   p90;
+		double   p99;
+		int64_t  gc_max;   ///< longest garbage collection step [usec]
+		double   gc_avg;
+		size_t   mem_used; ///< bytes allocated by the Lua interpreter
+		size_t   mem_peak;
+		size_t   mem_size; ///< size of the memory pool
+	};
+
+	/** Collect statistics of the realtime execution. Garbage collection
+	 * is usually performed by a background thread, and not included
+	 * in the dsp_run() timing.
+	 * @return false if the plugin has not been run since the last reset
+	 */
+	bool get_dsp_stats (DSPStats&) const;
+	void clear_dsp_stats ();
+
 private:
 	samplecnt_t plugin_latency() const { return _signal_latency; }
 	void find_presets ();
@@ -143,11 +165,18 @@ protected:
 	const std::string& origin() const { return _origin; }
 
 private:
+	static const size_t mempool_size = 3145728;
+
 #ifdef USE_TLSF
 	PBD::TLSF _mempool;
 #else
 	PBD::ReallocPool _mempool;
 #endif
+	/* memory accounting, must be initialized before the LuaState */
+	size_t _mem_used;
+	size_t _mem_peak;
+	static void* lalloc (void* ud, void* ptr, size_t osize, size_t nsize);
+
 	LuaState lua;
 	luabridge::LuaRef * _lua_dsp;
 	luabridge::LuaRef * _lua_latency;
@@ -198,12 +227,30 @@ private:
 	bool _has_midi_input;
 	bool _has_midi_output;
 
-
-#ifdef WITH_LUAPROC_STATS
-	int64_t _stats_avg[2];
-	int64_t _stats_max[2];
-	int64_t _stats_cnt;
-#endif
+	/* The interpreter is not thread-safe, this serializes the process
+	 * thread and garbage collection as well as (re)configuration.
+	 * The process thread waits for a garbage collection step, but
+	 * bypasses the cycle if a non-realtime call holds the lock. */
+	mutable Glib::Threads::Mutex _lua_lock;
+	gint _gc_pending;
+	gint _gc_running; ///< the background thread is about to or does collect garbage
+
+	void bypass (BufferSet&, ChanMapping const&, ChanMapping const&, pframes_t, samplecnt_t);
+
+	static void  gc_register (LuaProc*);
+	static void  gc_unregister (LuaProc*);
+	static void* gc_thread (void*);
+	static void  gc_run ();
+
+	/* dsp_run() execution time histogram, 4 bins per octave of usec */
+	static const int stats_bins = 64;
+	uint64_t _stats_hist[stats_bins];
+	int64_t  _stats_gc_max;
+	int64_t  _stats_gc_sum;
+	uint64_t _stats_gc_cnt;
+	gint     _stats_reset;
+
+	void record_gc_step (int64_t elapsed);
 };
 
 class LIBARDOUR_API LuaPluginInfo : public PluginInfo
@@ -30,10 +30,7 @@
 #include "ardour/processor.h"
 #include "ardour/types.h"
 
-#include "ardour/iec1ppmdsp.h"
-#include "ardour/iec2ppmdsp.h"
-#include "ardour/kmeterdsp.h"
-#include "ardour/vumeterdsp.h"
+#include "ardour/multimeterdsp.h"
 
 namespace ARDOUR {
 
@@ -108,10 +105,8 @@ private:
 	std::vector<float> _max_peak_signal; // dB calculation is done on demand
 	float              _combined_peak;   // Mackie surfaces expect the highest peak of all track channels
 
-	std::vector<Kmeterdsp*>  _kmeter;
-	std::vector<Iec1ppmdsp*> _iec1meter;
-	std::vector<Iec2ppmdsp*> _iec2meter;
-	std::vector<Vumeterdsp*> _vumeter;
+	Multimeterdsp             _multimeter; // K, IEC1, IEC2, VU of all audio channels
+	std::vector<float const*> _audio_data;
 
 	MeterType _meter_type;
 };
@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2008-2012 Fons Adriaensen <fons@linuxaudio.org>
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __MULTIMETERDSP_H
+#define __MULTIMETERDSP_H
+
+#include <stdint.h>
+#include <vector>
+
+#include "ardour/libardour_visibility.h"
+
+/** K-meter, IEC1 and IEC2 PPM and VU ballistics for many channels.
+ *
+ * This computes the same as Kmeterdsp, Iec1ppmdsp, Iec2ppmdsp and
+ * Vumeterdsp, but processes \ref lanes channels at a time in a single
+ * pass over the data. The filter state is kept per meter type in
+ * struct-of-arrays form, so that the compiler can vectorize the
+ * per-sample filters across channels.
+ */
+class LIBARDOUR_API Multimeterdsp
+{
+public:
+	enum Type {
+		KMeter = 0x01,
+		IEC1   = 0x02,
+		IEC2   = 0x04,
+		VU     = 0x08,
+		All    = 0x0f
+	};
+
+	Multimeterdsp ();
+
+	/** allocate state, not realtime-safe */
+	void set_channels (uint32_t n_chan);
+	uint32_t n_channels () const { return _n_chan; }
+
+	/** Process audio of all channels.
+	 * @param data one buffer per channel, at least \ref n_channels
+	 * @param peak if not NULL, updated with the absolute peak of each channel (like compute_peak())
+	 * @param n_chan number of channels to process
+	 * @param n number of samples per channel
+	 * @param types bitmask of \ref Type, meters that are not set are skipped
+	 */
+	void process (float const* const* data, float* peak, uint32_t n_chan, int n, int types);
+
+	/** @return highest value since the last call */
+	float read (Type, uint32_t chn);
+
+	void reset (int types);
+
+	static void init (float fsamp);
+
+	static const uint32_t lanes = 4;
+
+private:
+	struct State {
+		void resize (uint32_t);
+		void reset ();
+
+		std::vector<float> z1;   // filter state
+		std::vector<float> z2;   // filter state
+		std::vector<float> m;    // max value since last read()
+		std::vector<int>   res;  // flag set by read(), resets m
+	};
+
+	template <bool K, bool I1, bool I2, bool V>
+	void process_lanes (float const* const* p, uint32_t c, int nblocks, float* peak);
+
+	State* state (Type);
+
+	uint32_t _n_chan;
+
+	State _kmeter;
+	State _iec1;
+	State _iec2;
+	State _vu;
+
+	static float _k_omega; // K-meter ballistics filter constant
+	static float _i1_w1;   // IEC1 attack filter coefficient
+	static float _i1_w2;   // IEC1 attack filter coefficient
+	static float _i1_w3;   // IEC1 release filter coefficient
+	static float _i1_g;    // IEC1 gain factor
+	static float _i2_w1;   // IEC2 attack filter coefficient
+	static float _i2_w2;   // IEC2 attack filter coefficient
+	static float _i2_w3;   // IEC2 release filter coefficient
+	static float _i2_g;    // IEC2 gain factor
+	static float _vu_w;    // VU filter coefficient
+	static float _vu_g;    // VU gain factor
+};
+
+#endif
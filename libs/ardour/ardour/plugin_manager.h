@@ -37,6 +37,7 @@
 #include "ardour/libardour_visibility.h"
 #include "ardour/types.h"
 #include "ardour/plugin.h"
+#include "ardour/plugin_scan_index.h"
 
 namespace ARDOUR {
 
@@ -232,6 +233,8 @@ private:
 	bool _cancel_scan;
 	bool _cancel_timeout;
 
+	PluginScanIndex _scan_index;
+
 	void detect_name_ambiguities (ARDOUR::PluginInfoList*);
 	void detect_type_ambiguities (ARDOUR::PluginInfoList&);
 
@@ -272,7 +275,8 @@ private:
 	int vst3_discover (std::string const& path, bool cache_only = false);
 #ifdef VST3_SUPPORT
 	void vst3_plugin (std::string const& module_path, VST3Info const&);
-	bool run_vst3_scanner_app (std::string bundle_path) const;
+	bool run_vst3_scanner_app (std::string bundle_path);
+	std::set<std::string> run_vst3_scanner_apps (std::vector<std::string> const& bundle_paths);
 #endif
 
 	int lxvst_discover_from_path (std::string path, bool cache_only = false);
@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _ardour_plugin_scan_index_h_
+#define _ardour_plugin_scan_index_h_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+
+#include "pbd/xml++.h"
+
+#include "ardour/libardour_visibility.h"
+#include "ardour/types.h"
+
+namespace ARDOUR {
+
+/** Persistent, versioned index of plugin scan results.
+ *
+ * Every scanned plugin module is stored with the modification time and
+ * size of the module file at the time it was scanned. As long as both
+ * are unchanged, the cached plugin descriptions are used as-is, and
+ * neither the per-module cache files nor the module itself are touched.
+ *
+ * For each plugin type the index also remembers the search-path that
+ * was used and the list of modules found along it. A warm start using
+ * the same search-path can skip the file-system enumeration entirely.
+ */
+class LIBARDOUR_API PluginScanIndex
+{
+public:
+	PluginScanIndex ();
+
+	static int const current_version = 1;
+
+	/** read the index from the user's cache folder, discard outdated versions */
+	bool load ();
+	/** write the index, if it was modified since it was loaded */
+	bool save ();
+
+	/** look up cached plugin information.
+	 * @param module_path path of the plugin binary
+	 * @return node whose children describe the plugin(s) in the module,
+	 *  or NULL if the module is not indexed or was modified since.
+	 */
+	XMLNode const* lookup (PluginType, std::string const& module_path) const;
+
+	/** add or replace an entry, copying the children of \p info */
+	void set (PluginType, std::string const& module_path, XMLNode const& info);
+	void remove (PluginType, std::string const& module_path);
+	void clear (PluginType);
+
+	/** retrieve the list of modules previously found along a search-path.
+	 * @return false if the search-path differs from the one stored in the index
+	 */
+	bool modules (PluginType, std::string const& searchpath, std::vector<std::string>&) const;
+	void set_modules (PluginType, std::string const& searchpath, std::vector<std::string> const&);
+
+	bool dirty () const { return _dirty; }
+
+	static std::string index_file ();
+
+private:
+	struct Entry {
+		Entry () : mtime (0), size (0) {}
+		Entry (int64_t m, int64_t s, boost::shared_ptr<XMLNode> n)
+			: mtime (m), size (s), info (n) {}
+
+		int64_t mtime;
+		int64_t size;
+		boost::shared_ptr<XMLNode> info;
+	};
+
+	struct SearchPath {
+		std::string path;
+		std::vector<std::string> modules;
+	};
+
+	typedef std::pair<PluginType, std::string> Key;
+	typedef std::map<Key, Entry> Entries;
+	typedef std::map<PluginType, SearchPath> SearchPaths;
+
+	static bool stat_module (std::string const&, int64_t& mtime, int64_t& size);
+
+	Entries     _entries;
+	SearchPaths _searchpaths;
+	bool        _dirty;
+};
+
+} // namespace ARDOUR
+
+#endif
@@ -154,6 +154,8 @@ public:
 
 	static pframes_t cycle_nframes () { return _cycle_nframes; }
 	static double speed_ratio () { return _speed_ratio; }
+	static uint32_t resampler_quality () { return _resampler_quality; }
+	static bool setup_resampler (uint32_t q);
 
 protected:
 
@@ -170,7 +172,7 @@ protected:
 	LatencyRange _private_capture_latency;
 
 	static double _speed_ratio;
-	static const uint32_t _resampler_quality; /* also latency of the resampler */
+	static uint32_t _resampler_quality; /* also latency of the resampler */
 
 private:
 	std::string _name;  ///< port short name
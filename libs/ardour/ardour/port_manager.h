@@ -40,6 +40,7 @@ namespace ARDOUR {
 
 class PortEngine;
 class AudioBackend;
+class AudioPortResampler;
 class Session;
 
 class LIBARDOUR_API PortManager
@@ -49,7 +50,7 @@ public:
 	typedef std::list<boost::shared_ptr<Port> >             PortList;
 
 	PortManager ();
-	virtual ~PortManager () {}
+	virtual ~PortManager ();
 
 	PortEngine& port_engine ();
 
@@ -118,6 +119,11 @@ public:
 
 	bool check_for_ambiguous_latency (bool log = false) const;
 
+	/** Rebuild the port resampler if external connections changed.
+	 * Called by the butler, connect_callback() may run in realtime context.
+	 */
+	void rebuild_port_resampler ();
+
 	/* per-Port monitoring */
 
 	bool can_request_input_monitoring () const;
@@ -213,6 +219,21 @@ protected:
 	/** List of ports to be used between \ref cycle_start() and \ref cycle_end() */
 	boost::shared_ptr<Ports> _cycle_ports;
 
+	/* vari-speed resampling of all external audio ports.
+	 * _port_resampler is owned by the process thread, which switches to
+	 * _port_resampler_pending at the start of a cycle.
+	 */
+	Glib::Threads::Mutex _port_resampler_lock;
+	AudioPortResampler*  _port_resampler;
+	AudioPortResampler*  _port_resampler_pending;
+	AudioPortResampler*  _port_resampler_retired;
+	volatile gint        _port_resampler_update;
+	volatile gint        _port_resampler_rebuild; ///< 1: requested, 2: butler summoned
+
+	void update_port_resampler ();
+	void switch_port_resampler ();
+	void drop_port_resampler ();
+
 	void silence (pframes_t nframes, Session* s = 0);
 	void silence_outputs (pframes_t nframes);
 	void check_monitoring ();
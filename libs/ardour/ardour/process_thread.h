@@ -42,6 +42,10 @@ public:
 	void get_buffers ();
 	void drop_buffers ();
 
+	/** Re-allocate this thread's buffers from this thread, after it has
+	 * been bound to a CPU, so that memory is local to its NUMA node. */
+	void reallocate_buffers ();
+
 	/* these MUST be called by a process thread's thread, nothing else */
 
 	static BufferSet& get_silent_buffers (ChanCount count = ChanCount::ZERO);
@@ -55,6 +59,9 @@ public:
 	static gain_t* scratch_automation_buffer ();
 	static pan_t** pan_automation_buffer ();
 
+	/** @return id of the calling thread's ThreadBuffers, or -1 if this is not a process thread */
+	static int thread_buffers_id ();
+
 protected:
 	void session_going_away ();
 
@@ -96,8 +96,12 @@ CONFIG_VARIABLE (float, audio_playback_buffer_seconds, "playback-buffer-seconds"
 CONFIG_VARIABLE (float, midi_track_buffer_seconds, "midi-track-buffer-seconds", 1.0)
 CONFIG_VARIABLE (uint32_t, disk_choice_space_threshold,  "disk-choice-space-threshold", 57600000)
 CONFIG_VARIABLE (bool, auto_analyse_audio, "auto-analyse-audio", false)
+CONFIG_VARIABLE (uint32_t, import_concurrency, "import-concurrency", 0) /* max. files imported in parallel, 0: number of CPUs */
+CONFIG_VARIABLE (uint32_t, peak_builder_threads, "peak-builder-threads", 2) /* 0: number of CPUs, requires restart */
+CONFIG_VARIABLE (uint32_t, lv2_worker_threads, "lv2-worker-threads", 2) /* shared by all LV2 plugins, 0: number of CPUs, requires restart */
 CONFIG_VARIABLE (float, transient_sensitivity, "transient-sensitivity", 50)
 CONFIG_VARIABLE (float, max_transport_speed, "max-transport-speed", 8.0)
+CONFIG_VARIABLE (uint32_t, port_resampler_quality, "port-resampler-quality", 17) /* vari-speed filter length and latency: 8 (low) .. 96 (very high), used at engine start */
 
 /* OSC */
 
@@ -209,6 +213,14 @@ CONFIG_VARIABLE_SPECIAL (std::string, default_session_parent_dir, "default-sessi
 #endif
 CONFIG_VARIABLE (bool, allow_special_bus_removal, "allow-special-bus-removal", false)
 CONFIG_VARIABLE (int32_t, processor_usage, "processor-usage", -1)
+CONFIG_VARIABLE (std::string, dsp_thread_cpus, "dsp-thread-cpus", "") /* CPU list, e.g. "2-7", empty: no affinity */
+CONFIG_VARIABLE (std::string, butler_thread_cpus, "butler-thread-cpus", "")
+CONFIG_VARIABLE (std::string, backend_thread_cpus, "backend-thread-cpus", "")
+CONFIG_VARIABLE (std::string, gui_thread_cpus, "gui-thread-cpus", "")
+CONFIG_VARIABLE (bool, thread_buffer_arena, "thread-buffer-arena", true) /* allocate audio buffers of each process thread in one block, requires restart */
+CONFIG_VARIABLE (bool, thread_buffer_huge_pages, "thread-buffer-huge-pages", true)
+CONFIG_VARIABLE (bool, cycle_trace, "cycle-trace", false) /* record time spent in process threads, dumped on xrun */
+CONFIG_VARIABLE (bool, avoid_smt_siblings, "avoid-smt-siblings", true)
 CONFIG_VARIABLE (gain_t, max_gain, "max-gain", 2.0) /* +6.0dB */
 CONFIG_VARIABLE (uint32_t, max_recent_sessions, "max-recent-sessions", 10)
 CONFIG_VARIABLE (uint32_t, max_recent_templates, "max-recent-templates", 10)
@@ -229,10 +241,12 @@ CONFIG_VARIABLE (bool, verbose_plugin_scan, "verbose-plugin-scan", false)
 CONFIG_VARIABLE (bool, conceal_lv1_if_lv2_exists, "conceal-lv1-if-lv2-exists", true)
 CONFIG_VARIABLE (bool, conceal_vst2_if_vst3_exists, "conceal-vst2-if-vst3-exists", true)
 CONFIG_VARIABLE (int, vst_scan_timeout, "vst-scan-timeout", 1200) /* deciseconds, per plugin, <= 0 no timeout */
+CONFIG_VARIABLE (uint32_t, plugin_scan_concurrency, "plugin-scan-concurrency", 0) /* max. parallel scanner processes, 0: number of CPUs */
 CONFIG_VARIABLE (bool, discover_audio_units, "discover-audio-units", false)
 CONFIG_VARIABLE (bool, ask_replace_instrument, "ask-replace-instrument", true)
 CONFIG_VARIABLE (bool, ask_setup_instrument, "ask-setup-instrument", true)
 CONFIG_VARIABLE (uint32_t, limit_n_automatables, "limit-n-automatables", 512)
+CONFIG_VARIABLE (uint32_t, luaproc_gc_budget, "luaproc-gc-budget", 1000) /* max. usec of Lua DSP garbage collection per wakeup of the background thread */
 
 /* custom user plugin paths */
 CONFIG_VARIABLE (std::string, plugin_path_vst, "plugin-path-vst", "@default@")
@@ -21,6 +21,9 @@
 
 #include <map>
 #include <set>
+#include <vector>
+
+#include <stdint.h>
 
 namespace ARDOUR {
 
@@ -68,6 +71,54 @@ private:
 	EdgeMapWithSends _from_to_with_sends;
 };
 
+/** Transitive closure of the route graph, as bit-matrix.
+ *
+ *  This is a snapshot of every route's Route::fed_by() set, taken after
+ *  the graph was sorted. It answers "does A feed B, directly or indirectly"
+ *  in constant time, rather than searching B's fed_by() set, and allows
+ *  to keep per-route flags by index.
+ */
+class LIBARDOUR_API GraphReachability
+{
+public:
+	GraphReachability () : _words (0) {}
+	GraphReachability (RouteList const&);
+
+	/** @return the index of the given route, or -1 if the route is unknown.
+	 *  @param hint expected index, e.g. the position in the RouteList
+	 *  the index was built from.
+	 */
+	int32_t index (Route const*, uint32_t hint) const;
+
+	/** @return true if the route with index @param from feeds the route
+	 *  with index @param to, directly or indirectly.
+	 */
+	bool feeds (int32_t from, int32_t to) const {
+		if (from < 0 || to < 0) {
+			return false;
+		}
+		return (_fed_by[to * _words + (from >> 6)] >> (from & 63)) & 1;
+	}
+
+	size_t size () const { return _routes.size (); }
+
+	/* per route flags, to coalesce operations on routes */
+	void set_flag (int32_t i) const {
+		if (i >= 0) {
+			_flags[i >> 6] |= (uint64_t) 1 << (i & 63);
+		}
+	}
+
+	bool test_and_clear_flag (int32_t i) const;
+
+private:
+	std::vector<Route const*>       _routes;
+	std::map<Route const*, int32_t> _index;
+	size_t                          _words; /* per row */
+	std::vector<uint64_t>           _fed_by; /* row `to', bit `from' */
+	mutable std::vector<uint64_t>   _flags;
+};
+
 boost::shared_ptr<RouteList> topological_sort (
 	boost::shared_ptr<RouteList>,
 	GraphEdges
@@ -476,6 +476,8 @@ public:
 	void adjust_capture_buffering();
 
 	bool global_locate_pending() const { return _global_locate_pending; }
+	/** incremented each time routes are processed, identifies a (sub-)cycle */
+	uint32_t process_pass () const { return _process_pass; }
 	bool locate_pending() const;
 	bool locate_initiated() const;
 	bool declick_in_progress () const;
@@ -1145,6 +1147,9 @@ public:
 
 	boost::shared_ptr<Processor> processor_by_id (PBD::ID) const;
 
+	/** @return name of the route or processor with the given ID, used by CycleTrace */
+	std::string object_name_by_id (PBD::ID const&) const;
+
 	boost::shared_ptr<PBD::Controllable> controllable_by_id (const PBD::ID&);
 	boost::shared_ptr<AutomationControl> automation_control_by_id (const PBD::ID&);
 
@@ -2162,6 +2167,17 @@ private:
 	*/
 	GraphEdges _current_route_graph;
 
+	/** Transitive closure of _current_route_graph, used to propagate solo */
+	SerializedRCUManager<GraphReachability> _route_reachability;
+
+	/** Solo changes applied as a batch (e.g. of a route-group) share one
+	 * GraphReachability snapshot, which also collects the routes that need
+	 * to act on a mute change once the batch is complete.
+	 */
+	boost::shared_ptr<GraphReachability> _solo_batch;
+	void begin_solo_batch ();
+	void end_solo_batch ();
+
 	void ensure_route_presentation_info_gap (PresentationInfo::order_t, uint32_t gap_size);
 
 	friend class    ProcessorChangeBlocker;
@@ -2208,6 +2224,7 @@ private:
 	CoreSelection* _selection;
 
 	bool _global_locate_pending;
+	uint32_t _process_pass;
 	boost::optional<samplepos_t> _nominal_jack_transport_sample;
 
 	bool _had_destructive_tracks;
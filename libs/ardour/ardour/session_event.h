@@ -23,6 +23,7 @@
 #define __ardour_session_event_h__
 
 #include <list>
+#include <vector>
 #include <boost/function.hpp>
 #include <boost/shared_ptr.hpp>
 #include <boost/weak_ptr.hpp>
@@ -78,6 +79,7 @@ public:
 
 	Type       type;
 	Action     action;
+	uint64_t   seq; ///< assigned when the event is scheduled, see SessionEventManager::process_events_at
 	samplepos_t action_sample;
 	samplepos_t target_sample;
 	double     speed;
@@ -152,10 +154,15 @@ private:
 	friend class Butler;
 };
 
-class SessionEventManager {
+class LIBARDOUR_API SessionEventManager {
 public:
-	SessionEventManager () : pending_events (2048),
-	                         auto_loop_event(0), punch_out_event(0), punch_in_event(0) {}
+	SessionEventManager () : pending_events (2048), next_event (0), event_seq (0),
+	                         auto_loop_event(0), punch_out_event(0), punch_in_event(0)
+	{
+		events.reserve (event_capacity);
+		immediate_events.reserve (event_capacity);
+		due_events.reserve (event_capacity);
+	}
 	virtual ~SessionEventManager() {}
 
 	virtual void queue_event (SessionEvent *ev) = 0;
@@ -164,10 +171,38 @@ public:
 
 protected:
 	PBD::RingBuffer<SessionEvent*> pending_events;
-	typedef std::list<SessionEvent *> Events;
-	Events           events;
-	Events           immediate_events;
-	Events::iterator next_event;
+
+	/* Scheduled events are kept sorted by action_sample, new events are
+	 * inserted at a position found by binary search. Immediate events are
+	 * kept in the order in which they were queued. Space for both is
+	 * preallocated, so that adding and removing events in realtime context
+	 * does not allocate memory, unless more than event_capacity events are
+	 * pending.
+	 */
+	typedef std::vector<SessionEvent *> Events;
+	Events            events;
+	Events            immediate_events;
+	Events::size_type next_event; ///< index into events, events.size(): none
+	uint64_t          event_seq;  ///< sequence number of the last scheduled event
+
+	static const Events::size_type event_capacity = 512;
+
+	bool have_next_event () const {
+		return next_event < events.size ();
+	}
+
+	/** @return the event at index \p n, or 0 if there is none */
+	SessionEvent* event_at (Events::size_type n) const {
+		return n < events.size () ? events[n] : 0;
+	}
+
+	/** @return index of the first event at or after \p sample */
+	Events::size_type first_event_at_or_after (samplepos_t sample) const;
+
+	/** Process all events scheduled at \p sample, each one once.
+	 * Events that are added at the same sample meanwhile are not processed.
+	 */
+	void process_events_at (samplepos_t sample);
 
 	Glib::Threads::Mutex rb_write_lock;
 
@@ -177,12 +212,15 @@ protected:
 	SessionEvent *punch_out_event;
 	SessionEvent *punch_in_event;
 
+	std::vector<uint64_t> due_events; ///< used by process_events_at
+
 	void dump_events () const;
 	void merge_event (SessionEvent*);
 	void replace_event (SessionEvent::Type, samplepos_t action_sample, samplepos_t target = 0);
 	bool _replace_event (SessionEvent*);
 	bool _remove_event (SessionEvent *);
 	void _clear_event_type (SessionEvent::Type);
+	void insert_event (SessionEvent*);
 
 	void add_event (samplepos_t action_sample, SessionEvent::Type type, samplepos_t target_sample = 0);
 	void remove_event (samplepos_t sample, SessionEvent::Type type);
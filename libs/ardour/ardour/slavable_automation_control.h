@@ -20,6 +20,10 @@
 #ifndef __ardour_slavable_automation_control_h__
 #define __ardour_slavable_automation_control_h__
 
+#include <vector>
+
+#include "pbd/rcu.h"
+
 #include "ardour/automation_control.h"
 #include "ardour/libardour_visibility.h"
 
@@ -71,6 +75,20 @@ public:
 
 	PBD::Signal0<void> MasterStatusChange;
 
+	/** emitted when a direct or indirect master is added or removed */
+	PBD::Signal0<void> MasterChainChanged;
+
+	/** Evaluate the effective curve of this control (its own value or
+	 * automation, scaled by all its masters) once for the given cycle, so
+	 * that slaves can share it rather than each re-evaluating the master chain.
+	 * This is called from the process thread, before any route is processed.
+	 */
+	void cache_masters_curve (samplepos_t start, samplepos_t end, samplecnt_t nframes);
+
+	/** preallocate the buffer used by cache_masters_curve(), must not be called
+	 * concurrently with processing */
+	void allocate_curve_cache (samplecnt_t);
+
 	void use_saved_master_ratios ();
 
 	int set_state (XMLNode const&, int);
@@ -115,6 +133,7 @@ protected:
 
 		PBD::ScopedConnection changed_connection;
 		PBD::ScopedConnection dropped_connection;
+		PBD::ScopedConnection chain_connection;
 
   private:
 		boost::weak_ptr<AutomationControl> _master;
@@ -130,6 +149,37 @@ protected:
 	typedef std::map<PBD::ID,MasterRecord> Masters;
 	Masters _masters;
 
+	/** All masters of this control, direct and indirect, in depth-first
+	 * order: every entry is followed by the entries of its own masters.
+	 * This allows to evaluate nested VCAs without recursion and without
+	 * taking each master's lock.
+	 */
+	struct MasterChain {
+		struct Entry {
+			Entry (boost::shared_ptr<SlavableAutomationControl> m, double r, size_t n)
+				: master (m)
+				, ratio (r)
+				, n_nested (n)
+			{}
+
+			boost::weak_ptr<SlavableAutomationControl> master;
+			double ratio;    /* MasterRecord::val_master_inv () */
+			size_t n_nested; /* number of entries following this one, that belong to its masters */
+		};
+
+		MasterChain () : flat (true) {}
+
+		std::vector<Entry> entries;
+		/* false if the chain cannot be evaluated by simple multiplication
+		 * (toggled controls), or a master is not slavable */
+		bool flat;
+	};
+
+	SerializedRCUManager<MasterChain> _master_chain;
+
+	void update_master_chain ();
+	void master_chain_changed ();
+
 	void   master_going_away (boost::weak_ptr<AutomationControl>);
 	double get_value_locked() const;
 	void   actually_set_value (double value, PBD::Controllable::GroupControlDisposition);
@@ -151,6 +201,18 @@ protected:
 	virtual void   post_add_master (boost::shared_ptr<AutomationControl>) {}
 
 	XMLNode* _masters_node; /* used to store master ratios in ::set_state() for later use */
+
+private:
+	bool cached_curve_multiply (samplepos_t, samplepos_t, float*, samplecnt_t, double, bool&) const;
+
+	/* written by cache_masters_curve() at the start of each cycle, before
+	 * the process graph runs, and only read by process threads */
+	std::vector<gain_t> _curve_cache;
+	samplecnt_t         _curve_cache_cycle;
+	samplepos_t         _curve_cache_start;
+	samplepos_t         _curve_cache_end;
+	samplecnt_t         _curve_cache_len;
+	bool                _curve_cache_automated;
 };
 
 } // namespace ARDOUR
@@ -20,6 +20,8 @@
 #ifndef __ardour_source_factory_h__
 #define __ardour_source_factory_h__
 
+#include <list>
+#include <map>
 #include <string>
 #include <stdint.h>
 #include <boost/shared_ptr.hpp>
@@ -70,6 +72,26 @@ class LIBARDOUR_API SourceFactory {
 
 	static int peak_work_queue_length ();
 	static int setup_peakfile (boost::shared_ptr<Source>, bool async);
+
+	/** Move the given source to the front of the peak-building queue,
+	 * e.g. because it is visible in the editor. Does nothing if the source
+	 * is not queued.
+	 */
+	static void prioritize_peakfile (boost::shared_ptr<Source>);
+
+	struct PeakBuildStats {
+		PeakBuildStats () : n_sources (0), n_samples (0), usec (0) {}
+		uint64_t n_sources; ///< sources processed by the peak-builder threads
+		uint64_t n_samples; ///< sum of their length
+		int64_t  usec;      ///< total time spent, summed over all threads
+	};
+
+	static PeakBuildStats peak_build_stats ();
+
+	/* used by the peak-builder threads, peak_building_lock must be held */
+	typedef std::list<boost::weak_ptr<AudioSource> > PeakQueue;
+	static std::map<AudioSource const*, PeakQueue::iterator> queued_peaks;
+	static PeakBuildStats peak_build_stats_unlocked;
 };
 
 }
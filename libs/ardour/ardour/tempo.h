@@ -32,8 +32,11 @@
 #include <cmath>
 #include <glibmm/threads.h>
 
+#include <boost/shared_ptr.hpp>
+
 #include "pbd/undo.h"
 #include "pbd/enum_convert.h"
+#include "pbd/rcu.h"
 
 #include "pbd/stateful.h"
 #include "pbd/statefuldestructible.h"
@@ -598,10 +601,89 @@ private:
 	static Tempo    _default_tempo;
 	static Meter    _default_meter;
 
+	/** Immutable, sorted copy of the active tempo and all meter sections.
+	 *
+	 * This allows to look up sections by binary search rather than walking
+	 * the Metrics list. It is re-created whenever the map is recomputed and
+	 * published via RCU, so that realtime callers can use it without taking
+	 * the map's lock. Any other change to the map invalidates it, and lookups
+	 * fall back to the *_locked() methods until the next recompute_map().
+	 */
+	class SectionIndex {
+	public:
+		SectionIndex ()
+			: generation (0)
+			, _t_minute_sorted (false), _t_pulse_sorted (false)
+			, _m_minute_sorted (false), _m_beat_sorted (false)
+			, _m_pulse_sorted (false), _m_bars_sorted (false)
+		{}
+		SectionIndex (Metrics const&, gint generation);
+
+		bool valid () const { return !tempi.empty () && !meters.empty (); }
+
+		double pulse_at_minute (double minute) const;
+		double minute_at_pulse (double pulse) const;
+		double beat_at_minute (double minute) const;
+		double minute_at_beat (double beat) const;
+		double pulse_at_beat (double beat) const;
+		double beat_at_pulse (double pulse) const;
+		Tempo  tempo_at_minute (double minute) const;
+
+		Timecode::BBT_Time bbt_at_minute (double minute) const;
+		Timecode::BBT_Time bbt_at_beat (double beat) const;
+		Timecode::BBT_Time bbt_at_pulse (double pulse) const;
+		double pulse_at_bbt (Timecode::BBT_Time const&) const;
+
+		/* indices into tempi and meters, equivalent to the linear
+		 * search of the Metrics list that they replace */
+		size_t tempo_at_minute_index (double minute) const;
+		size_t tempo_at_pulse_index (double pulse) const;
+		size_t tempo_at_beat_index (MeterSection const&, double beat) const;
+		size_t meter_at_minute_index (double minute) const;
+		size_t meter_at_beat_index (double beat) const;
+		size_t meter_at_pulse_index (double pulse) const;
+		size_t meter_at_bars_index (int32_t bars) const;
+
+		gint generation;
+
+		/* copies, safe to use without holding the map's lock */
+		std::vector<boost::shared_ptr<TempoSection const> > tempi;
+		std::vector<boost::shared_ptr<MeterSection const> > meters;
+
+		/* the sections of the map, only valid while holding its lock */
+		std::vector<TempoSection*> live_tempi;
+		std::vector<MeterSection*> live_meters;
+
+	private:
+		template<typename T> static size_t find (std::vector<T> const&, bool sorted, T const&);
+		static Timecode::BBT_Time bbt_in_meter (MeterSection const&, double beat);
+
+		std::vector<double>  _t_minute;
+		std::vector<double>  _t_pulse;
+		std::vector<double>  _m_minute;
+		std::vector<double>  _m_beat;
+		std::vector<double>  _m_pulse;
+		std::vector<int32_t> _m_bars;
+
+		/* keys are monotonic, binary search can be used */
+		bool _t_minute_sorted;
+		bool _t_pulse_sorted;
+		bool _m_minute_sorted;
+		bool _m_beat_sorted;
+		bool _m_pulse_sorted;
+		bool _m_bars_sorted;
+	};
+
+	boost::shared_ptr<SectionIndex> fresh_index () const;
+	void update_index ();
+
 	Metrics                       _metrics;
 	samplecnt_t                   _sample_rate;
 	mutable Glib::Threads::RWLock lock;
+	volatile gint                 _generation; /* incremented with every change to _metrics */
+	SerializedRCUManager<SectionIndex> _index;
 
+	/* these update the index when called for _metrics */
 	void recompute_tempi (Metrics& metrics);
 	void recompute_meters (Metrics& metrics);
 	void recompute_map (Metrics& metrics, samplepos_t end = -1);
@@ -29,15 +29,24 @@
 
 namespace ARDOUR {
 
+class BufferArena;
 class BufferSet;
 
 class LIBARDOUR_API ThreadBuffers {
 public:
-	ThreadBuffers ();
+	ThreadBuffers (uint32_t id);
 	~ThreadBuffers ();
 
+	/** unique index, 0 .. BufferManager::thread_buffer_count () - 1 */
+	uint32_t const id;
+
 	void ensure_buffers (ChanCount howmany = ChanCount::ZERO, size_t custom = 0);
 
+	/** free and allocate all buffers with their current size. Memory is
+	 * first touched by the calling thread, which places it on that thread's
+	 * NUMA node (with the default Linux memory policy). */
+	void reallocate ();
+
 	BufferSet* silent_buffers;
 	BufferSet* scratch_buffers;
 	BufferSet* noinplace_buffers;
@@ -52,6 +61,19 @@ public:
 
 private:
 	void allocate_pan_automation_buffers (samplecnt_t nframes, uint32_t howmany, bool force);
+	void ensure_buffers_locked (ChanCount howmany, size_t custom);
+	void ensure_arena (size_t n_audio, size_t size, uint32_t n_pan);
+
+	/* ensure_buffers () is called with the process lock held,
+	 * reallocate () by the process thread using these buffers */
+	Glib::Threads::Mutex _lock;
+	size_t               _custom;
+
+	/* audio and automation buffers, if Config->get_thread_buffer_arena () */
+	bool         _use_arena;
+	BufferArena* _arena;
+	size_t       _arena_n_audio;
+	size_t       _arena_size;
 };
 
 } // namespace
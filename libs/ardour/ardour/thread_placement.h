@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __ardour_thread_placement_h__
+#define __ardour_thread_placement_h__
+
+#include <string>
+#include <vector>
+
+#include <glibmm/threads.h>
+
+#include "ardour/libardour_visibility.h"
+
+namespace ARDOUR {
+
+/** CPU affinity of process, butler, backend and GUI threads.
+ *
+ * The CPUs for each role are configured as CPU lists (e.g. "2-7,10").
+ * By default no affinity is set. Threads inherit the affinity of the thread
+ * that created them, so once any role is configured, threads of
+ * unconfigured roles are explicitly allowed to run on all CPUs.
+ */
+class LIBARDOUR_API ThreadPlacement
+{
+public:
+	enum Role {
+		DSP = 0,
+		Butler,
+		Backend,
+		GUI,
+		NumRoles
+	};
+
+	/** Restrict the calling thread to the CPUs configured for the given role.
+	 * Every DSP thread is bound to a single CPU. If avoid-smt-siblings is set,
+	 * DSP threads are distributed over physical cores first.
+	 * @return true if the thread was bound to the configured CPUs
+	 */
+	static bool place (Role);
+
+	/** Forget previous DSP thread assignments, to be called before
+	 * the DSP threads are (re)created.
+	 */
+	static void reset ();
+
+	/** @return short description of the policy for the given role */
+	static std::string describe (Role);
+
+private:
+	static std::vector<int> configured_cpus (Role);
+
+	static Glib::Threads::Mutex _lock;
+	static uint32_t             _n_dsp;
+};
+
+} // namespace ARDOUR
+
+#endif /* __ardour_thread_placement_h__ */
@@ -23,16 +23,17 @@
 
 #include <stdint.h>
 
+#include <glib.h>
 #include <glibmm/threads.h>
 
 #include "pbd/ringbuffer.h"
-#include "pbd/semutils.h"
 
 #include "ardour/libardour_visibility.h"
 
 namespace ARDOUR {
 
 class Worker;
+class WorkerPool;
 
 /**
    An object that needs to schedule non-RT work in the audio thread.
@@ -55,9 +56,11 @@ public:
 /**
    A worker for non-realtime tasks scheduled from another thread.
 
-   A worker may be a separate thread that runs to execute scheduled work
-   asynchronously, or unthreaded, in which case work is executed immediately
-   upon scheduling by the calling thread.
+   A threaded worker executes scheduled work asynchronously, using a pool of
+   threads that is shared by all workers. Work of a given worker is never
+   executed concurrently, and requests as well as responses are processed in
+   the order they were scheduled. An unthreaded worker executes work
+   immediately upon scheduling by the calling thread.
 */
 class LIBARDOUR_API Worker
 {
@@ -92,8 +95,30 @@ public:
 	*/
 	void set_synchronous(bool synchronous) { _synchronous = synchronous; }
 
+	struct Stats {
+		Stats () : requests (0), batches (0), max_queue (0), max_latency (0), total_latency (0) {}
+		uint64_t requests;      ///< work requests processed
+		uint64_t batches;       ///< number of times a pool thread picked up pending work
+		uint32_t max_queue;     ///< max. bytes queued when work was picked up
+		uint64_t max_latency;   ///< max. time from scheduling until work started [usec]
+		uint64_t total_latency; ///< sum of all latencies, divide by batches for the average [usec]
+	};
+
+	/** Queue depth and wakeup latency, threaded workers only */
+	Stats stats () const;
+	void  clear_stats ();
+
 private:
-	void run();
+	friend class WorkerPool;
+
+	enum State {
+		Idle = 0,
+		Pending,        ///< work was scheduled, the pool was woken up
+		Running,        ///< a pool thread is processing requests
+		RunningPending  ///< work was scheduled while running
+	};
+
+	void run(void*& buf, size_t& buf_size);
 	/**
 	   Peek in RB, get size and check if a block of 'size' is available.
 
@@ -109,10 +134,11 @@ private:
 	PBD::RingBuffer<uint8_t>* _requests;
 	PBD::RingBuffer<uint8_t>* _responses;
 	uint8_t*                  _response;
-	PBD::Semaphore            _sem;
-	Glib::Threads::Thread*    _thread;
-	bool                      _exit;
 	bool                      _synchronous;
+	mutable gint              _state;
+	gint64                    _pending_since;
+	Stats                     _stats;
+	mutable Glib::Threads::Mutex _stats_lock;
 };
 
 } // namespace ARDOUR
@@ -41,6 +41,7 @@ AudioPort::AudioPort (const std::string& name, PortFlags flags)
 	: Port (name, DataType::AUDIO, flags)
 	, _buffer (new AudioBuffer (0))
 	, _data (0)
+	, _src_batched (false)
 {
 	assert (name.find_first_of (':') == string::npos);
 	_src.setup (_resampler_quality);
@@ -58,6 +59,11 @@ AudioPort::set_buffer_size (pframes_t nframes)
 {
 	if (_data) cache_aligned_free (_data);
 	cache_aligned_malloc ((void**) &_data, sizeof (Sample) * lrint (floor (nframes * Config->get_max_transport_speed())));
+
+	if (_src.inpsize () != 2 * (int) _resampler_quality) {
+		_src.setup (_resampler_quality);
+		_src.set_rrfilt (10);
+	}
 }
 
 void
@@ -68,6 +74,8 @@ AudioPort::cycle_start (pframes_t nframes)
 
 	if (sends_output()) {
 		_buffer->prepare ();
+	} else if (_src_batched) {
+		/* resampled by AudioPortResampler::process_inputs */
 	} else if (!externally_connected ()) {
 		/* ardour internal port, just silence input, don't resample */
 		// TODO reset resampler only once
@@ -102,6 +110,11 @@ AudioPort::cycle_end (pframes_t nframes)
 
 	if (sends_output() && _port_handle) {
 
+		if (_src_batched) {
+			/* resampled by AudioPortResampler::process_outputs */
+			return;
+		}
+
 		if (!externally_connected ()) {
 			/* ardour internal port, data goes nowhere, skip resampling */
 			// TODO reset resampler only once
@@ -0,0 +1,243 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <cassert>
+#include <map>
+
+#include <boost/bind.hpp>
+
+#include "ardour/audio_port.h"
+#include "ardour/audio_port_resampler.h"
+#include "ardour/audioengine.h"
+#include "ardour/port_engine.h"
+
+using namespace ARDOUR;
+
+#define port_engine AudioEngine::instance()->port_engine()
+
+AudioPortResampler::Block::Block (PortList::const_iterator b, PortList::const_iterator e, uint32_t quality)
+	: ports (b, e)
+	, inp (ports.size (), 0)
+	, out (ports.size (), 0)
+	, state_from (0)
+	, history_from (ports.size (), std::make_pair ((Block const*) 0, 0))
+{
+	src.setup (quality, ports.size ());
+	src.set_rrfilt (10);
+}
+
+AudioPortResampler::AudioPortResampler (PortList const& inputs, PortList const& outputs, uint32_t quality)
+	: _n_ports (inputs.size () + outputs.size ())
+	, _inherit_from (0)
+{
+	setup_blocks (_inputs, inputs, quality);
+	setup_blocks (_outputs, outputs, quality);
+}
+
+AudioPortResampler::~AudioPortResampler ()
+{
+	for (Blocks::const_iterator i = _inputs.begin (); i != _inputs.end (); ++i) {
+		delete *i;
+	}
+	for (Blocks::const_iterator i = _outputs.begin (); i != _outputs.end (); ++i) {
+		delete *i;
+	}
+}
+
+void
+AudioPortResampler::setup_blocks (Blocks& blocks, PortList const& ports, uint32_t quality)
+{
+	if (ports.empty ()) {
+		return;
+	}
+	/* split evenly, rather than leaving a small remainder */
+	size_t const n_blocks = (ports.size () + max_block_size - 1) / max_block_size;
+	size_t const n_chn    = (ports.size () + n_blocks - 1) / n_blocks;
+
+	for (size_t i = 0; i < ports.size (); i += n_chn) {
+		size_t const e = std::min (ports.size (), i + n_chn);
+		blocks.push_back (new Block (ports.begin () + i, ports.begin () + e, quality));
+	}
+}
+
+void
+AudioPortResampler::prepare_inherit (AudioPortResampler const* other)
+{
+	_inherit_from = other;
+	if (!other) {
+		return;
+	}
+	map_blocks (_inputs, other->_inputs);
+	map_blocks (_outputs, other->_outputs);
+}
+
+void
+AudioPortResampler::map_blocks (Blocks& blocks, Blocks const& other)
+{
+	if (other.empty ()) {
+		return;
+	}
+
+	/* all blocks of a given direction are processed in sync,
+	 * so they all share the same phase and read-position */
+	std::map<AudioPort const*, std::pair<Block const*, uint32_t> > known;
+	for (Blocks::const_iterator b = other.begin (); b != other.end (); ++b) {
+		for (uint32_t c = 0; c < (*b)->ports.size (); ++c) {
+			known[(*b)->ports[c].get ()] = std::make_pair (*b, c);
+		}
+	}
+
+	for (Blocks::iterator b = blocks.begin (); b != blocks.end (); ++b) {
+		(*b)->state_from = other.front ();
+		for (uint32_t c = 0; c < (*b)->ports.size (); ++c) {
+			std::map<AudioPort const*, std::pair<Block const*, uint32_t> >::const_iterator k = known.find ((*b)->ports[c].get ());
+			if (k != known.end ()) {
+				(*b)->history_from[c] = k->second;
+			}
+		}
+	}
+}
+
+void
+AudioPortResampler::inherit (AudioPortResampler const* other)
+{
+	if (!other || other != _inherit_from) {
+		return;
+	}
+	inherit_blocks (_inputs);
+	inherit_blocks (_outputs);
+}
+
+void
+AudioPortResampler::inherit_blocks (Blocks& blocks)
+{
+	for (Blocks::iterator b = blocks.begin (); b != blocks.end (); ++b) {
+		if (!(*b)->state_from || !(*b)->src.copy_state ((*b)->state_from->src)) {
+			continue;
+		}
+		for (uint32_t c = 0; c < (*b)->ports.size (); ++c) {
+			Block const* o = (*b)->history_from[c].first;
+			if (o) {
+				(*b)->src.copy_channel (c, o->src, (*b)->history_from[c].second);
+			}
+		}
+	}
+}
+
+void
+AudioPortResampler::set_active (bool yn)
+{
+	for (Blocks::const_iterator b = _inputs.begin (); b != _inputs.end (); ++b) {
+		for (PortList::const_iterator p = (*b)->ports.begin (); p != (*b)->ports.end (); ++p) {
+			(*p)->_src_batched = yn;
+		}
+	}
+	for (Blocks::const_iterator b = _outputs.begin (); b != _outputs.end (); ++b) {
+		for (PortList::const_iterator p = (*b)->ports.begin (); p != (*b)->ports.end (); ++p) {
+			(*p)->_src_batched = yn;
+		}
+	}
+}
+
+void
+AudioPortResampler::process_inputs (pframes_t nframes, RTTaskList::TaskList* tl)
+{
+	for (Blocks::const_iterator b = _inputs.begin (); b != _inputs.end (); ++b) {
+		if (tl) {
+			tl->push_back (boost::bind (&AudioPortResampler::process_input_block, this, *b, nframes));
+		} else {
+			process_input_block (*b, nframes);
+		}
+	}
+}
+
+void
+AudioPortResampler::process_outputs (pframes_t nframes, RTTaskList::TaskList* tl)
+{
+	for (Blocks::const_iterator b = _outputs.begin (); b != _outputs.end (); ++b) {
+		if (tl) {
+			tl->push_back (boost::bind (&AudioPortResampler::process_output_block, this, *b, nframes));
+		} else {
+			process_output_block (*b, nframes);
+		}
+	}
+}
+
+void
+AudioPortResampler::process_input_block (Block* b, pframes_t nframes)
+{
+	uint32_t const n_chn = b->ports.size ();
+	for (uint32_t c = 0; c < n_chn; ++c) {
+		AudioPort* ap = b->ports[c].get ();
+		assert (ap->port_handle ());
+		/* disconnected ports are silent */
+		b->inp[c] = (float const*) port_engine.get_buffer (ap->port_handle (), nframes);
+		b->out[c] = ap->_data;
+	}
+
+	pframes_t const cnt = Port::cycle_nframes ();
+
+	b->src.inp_list  = &b->inp[0];
+	b->src.out_list  = &b->out[0];
+	b->src.inp_count = nframes;
+	b->src.out_count = cnt;
+	b->src.set_rratio (cnt / (double)nframes);
+	b->src.process ();
+
+	pad (b, cnt, b->src.out_count);
+}
+
+void
+AudioPortResampler::process_output_block (Block* b, pframes_t nframes)
+{
+	uint32_t const n_chn = b->ports.size ();
+	for (uint32_t c = 0; c < n_chn; ++c) {
+		AudioPort* ap = b->ports[c].get ();
+		assert (ap->port_handle ());
+		b->inp[c] = ap->_data;
+		b->out[c] = (float*) port_engine.get_buffer (ap->port_handle (), nframes);
+	}
+
+	pframes_t const cnt = Port::cycle_nframes ();
+
+	b->src.inp_list  = &b->inp[0];
+	b->src.out_list  = &b->out[0];
+	b->src.inp_count = cnt;
+	b->src.out_count = nframes;
+	b->src.set_rratio (nframes / (double)cnt);
+	b->src.process ();
+
+	pad (b, nframes, b->src.out_count);
+}
+
+void
+AudioPortResampler::pad (Block* b, uint32_t total, uint32_t remain)
+{
+	if (remain == 0) {
+		return;
+	}
+	/* repeat the last sample, like AudioPort::cycle_start does */
+	uint32_t const done = total - remain;
+	for (std::vector<float*>::const_iterator i = b->out.begin (); i != b->out.end (); ++i) {
+		float* d = *i;
+		float const v = done > 0 ? d[done - 1] : 0.f;
+		for (uint32_t n = done; n < total; ++n) {
+			d[n] = v;
+		}
+	}
+}
@@ -53,6 +53,7 @@
 #include "ardour/search_paths.h"
 #include "ardour/buffer.h"
 #include "ardour/cycle_timer.h"
+#include "ardour/cycle_trace.h"
 #include "ardour/internal_send.h"
 #include "ardour/meter.h"
 #include "ardour/midi_port.h"
@@ -63,6 +64,7 @@
 #include "ardour/process_thread.h"
 #include "ardour/rc_configuration.h"
 #include "ardour/session.h"
+#include "ardour/thread_placement.h"
 #include "ardour/transport_master_manager.h"
 
 #include "pbd/i18n.h"
@@ -469,6 +471,8 @@ AudioEngine::process_callback (pframes_t nframes)
 #endif
 	}
 
+	CycleTrace::Scope cts (CycleTrace::Cycle, "process");
+
 	/* tell all relevant objects that we're starting a new cycle */
 
 	InternalSend::CycleStart (nframes);
@@ -997,6 +1001,10 @@ AudioEngine::start (bool for_latency)
 	_processed_samples = 0;
 	last_monitor_check = 0;
 
+	/* AudioPorts re-initialize their resampler when the backend
+	 * calls ::buffer_size_change() */
+	Port::setup_resampler (Config->get_port_resampler_quality ());
+
 	int error_code = _backend->start (for_latency);
 
 	if (error_code != 0) {
@@ -1390,6 +1398,7 @@ AudioEngine::thread_init_callback (void* arg)
 	AsyncMIDIPort::set_process_thread (pthread_self());
 
 	if (arg) {
+		ThreadPlacement::place (ThreadPlacement::Backend);
 		delete AudioEngine::instance()->_main_thread;
 		/* the special thread created/managed by the backend */
 		AudioEngine::instance()->_main_thread = new ProcessThread;
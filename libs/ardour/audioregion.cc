@@ -39,6 +39,8 @@
 #include "pbd/stacktrace.h"
 #include "pbd/enumwriter.h"
 #include "pbd/convert.h"
+#include "pbd/cpus.h"
+#include "pbd/pthread_utils.h"
 
 #include "evoral/Curve.h"
 
@@ -1401,82 +1403,324 @@ AudioRegion::set_scale_amplitude (gain_t g)
 	send_change (PropertyChange (Properties::scale_amplitude));
 }
 
-double
-AudioRegion::maximum_amplitude (Progress* p) const
+/** Accumulate the peak and sum of squares of one channel of a region.
+ *  The region is read in blocks that are aligned to the source's analysis
+ *  blocks, so that cached statistics can be used for all but the first and
+ *  last block.
+ *  @return 0 on success, -1 if cancelled, 1 on read error
+ */
+static int
+channel_stats (AudioRegion const& r, uint32_t chan, AudioSource::RangeStats& s, Progress* p)
 {
-	samplepos_t fpos = _start;
-	samplepos_t const fend = _start + _length;
-	double maxamp = 0;
-
-	samplecnt_t const blocksize = 64 * 1024;
-	Sample buf[blocksize];
-
-	while (fpos < fend) {
-
-		uint32_t n;
-
-		samplecnt_t const to_read = min (fend - fpos, blocksize);
+	boost::shared_ptr<AudioSource> src = r.audio_source (chan);
+	samplecnt_t const bs = AudioSource::stats_block_size;
+	samplepos_t pos = r.start ();
+	samplepos_t const end = r.start () + r.length ();
 
-		for (n = 0; n < n_channels(); ++n) {
+	while (pos < end) {
+		samplecnt_t const to_read = min (end, (pos / bs + 1) * bs) - pos;
 
-			/* read it in */
-
-			if (read_raw_internal (buf, fpos, to_read, n) != to_read) {
-				return 0;
-			}
-
-			maxamp = compute_peak (buf, to_read, maxamp);
+		if (!src->range_stats (pos, to_read, s)) {
+			return 1;
 		}
 
-		fpos += to_read;
+		pos += to_read;
 		if (p) {
-			p->set_progress (float (fpos - _start) / _length);
+			p->set_progress (float (pos - r.start ()) / r.length ());
 			if (p->cancelled ()) {
 				return -1;
 			}
 		}
 	}
+	return 0;
+}
 
-	return maxamp;
+static int
+region_stats (AudioRegion const& r, AudioSource::RangeStats& s, Progress* p)
+{
+	uint32_t const n_chan = r.n_channels ();
+	for (uint32_t c = 0; c < n_chan; ++c) {
+		if (p) {
+			p->descend (1.0 / n_chan);
+		}
+		int const rv = channel_stats (r, c, s, p);
+		if (p) {
+			p->ascend ();
+		}
+		if (rv) {
+			return rv;
+		}
+	}
+	return 0;
+}
+
+static double
+stats_to_rms (AudioSource::RangeStats const& s, samplecnt_t n_samples)
+{
+	if (n_samples == 0) {
+		return 0;
+	}
+	return sqrt (2. * s.sumsq / (double) n_samples);
 }
 
 double
-AudioRegion::rms (Progress* p) const
+AudioRegion::maximum_amplitude (Progress* p) const
 {
-	samplepos_t fpos = _start;
-	samplepos_t const fend = _start + _length;
-	uint32_t const n_chan = n_channels ();
-	double rms = 0;
+	AudioSource::RangeStats s;
 
-	samplecnt_t const blocksize = 64 * 1024;
-	Sample buf[blocksize];
+	switch (region_stats (*this, s, p)) {
+	case 0:
+		return s.peak;
+	case -1:
+		return -1;
+	default:
+		return 0;
+	}
+}
 
-	samplecnt_t total = 0;
+double
+AudioRegion::rms (Progress* p) const
+{
+	AudioSource::RangeStats s;
 
-	if (n_chan == 0 || fend == fpos) {
+	switch (region_stats (*this, s, p)) {
+	case 0:
+		return stats_to_rms (s, _length * n_channels ());
+	case -1:
+		return -1;
+	default:
 		return 0;
 	}
+}
+
+namespace {
+
+/** A unit of work for AudioRegion::analyze_levels() and the multi-region
+ * AudioRegion::find_silence()
+ */
+struct AnalysisJob {
+	virtual ~AnalysisJob () {}
+	virtual void  run () = 0;
+	virtual void  cancel () = 0;
+	virtual float progress () const = 0;
+};
+
+/** Progress of a single job, polled by the thread that waits for the jobs */
+class JobProgress : public Progress
+{
+public:
+	JobProgress () : _overall (0) {}
+	float overall () const { return _overall; }
+	void  cancel_job () { cancel (); }
+private:
+	void set_overall_progress (float p) { _overall = p; }
+	volatile float _overall;
+};
+
+/** peak and rms of one channel of a region */
+struct LevelJob : public AnalysisJob {
+	LevelJob (boost::shared_ptr<AudioRegion> r, uint32_t c) : region (r), chan (c), rv (0) {}
+
+	void  run () { rv = channel_stats (*region, chan, stats, &job_progress); }
+	void  cancel () { job_progress.cancel_job (); }
+	float progress () const { return job_progress.overall (); }
+
+	boost::shared_ptr<AudioRegion> region;
+	uint32_t                       chan;
+	AudioSource::RangeStats        stats;
+	JobProgress                    job_progress;
+	int                            rv;
+};
+
+/** silent intervals of a region, all channels need to be considered at once */
+struct SilenceJob : public AnalysisJob {
+	SilenceJob (boost::shared_ptr<AudioRegion> r, Sample t, samplecnt_t ml, samplecnt_t fl)
+		: region (r), threshold (t), min_length (ml), fade_length (fl) {}
+
+	void  run () { result = region->find_silence (threshold, min_length, fade_length, itt); }
+	void  cancel () { itt.cancel = true; }
+	float progress () const { return itt.progress; }
+
+	boost::shared_ptr<AudioRegion> region;
+	Sample                         threshold;
+	samplecnt_t                    min_length;
+	samplecnt_t                    fade_length;
+	InterThreadInfo                itt;
+	AudioIntervalResult            result;
+};
+
+struct AnalysisPool {
+	AnalysisPool (std::vector<AnalysisJob*> const& j) : jobs (j), next (0), running (0) {}
+
+	std::vector<AnalysisJob*> const& jobs;
+	size_t                           next;
+	uint32_t                         running;
+
+	Glib::Threads::Mutex lock;
+	Glib::Threads::Cond  cond;
+};
 
-	while (fpos < fend) {
-		samplecnt_t const to_read = min (fend - fpos, blocksize);
-		for (uint32_t c = 0; c < n_chan; ++c) {
-			if (read_raw_internal (buf, fpos, to_read, c) != to_read) {
-				return 0;
+}
+
+static void
+analysis_worker (AnalysisPool* pool)
+{
+	while (true) {
+		AnalysisJob* job;
+		{
+			Glib::Threads::Mutex::Lock lm (pool->lock);
+			if (pool->next == pool->jobs.size ()) {
+				break;
 			}
-			for (samplepos_t i = 0; i < to_read; ++i) {
-				rms += buf[i] * buf[i];
+			job = pool->jobs[pool->next++];
+		}
+		job->run ();
+	}
+
+	Glib::Threads::Mutex::Lock lm (pool->lock);
+	--pool->running;
+	pool->cond.signal ();
+}
+
+static void
+analysis_thread (AnalysisPool* pool)
+{
+	pthread_set_name ("RegionAnalysis");
+	analysis_worker (pool);
+}
+
+/** Run the given jobs using one thread per CPU, and wait for them to complete.
+ *  Overall progress is reported by the calling thread, using either \p p
+ *  or \p itt, which are also checked for cancellation.
+ *  @return false if cancelled
+ */
+static bool
+run_analysis_jobs (std::vector<AnalysisJob*> const& jobs, Progress* p, InterThreadInfo* itt)
+{
+	AnalysisPool pool (jobs);
+	std::vector<Glib::Threads::Thread*> threads;
+	uint32_t const n_threads = std::min<size_t> (hardware_concurrency (), jobs.size ());
+	bool cancelled = false;
+	bool cancel_sent = false;
+
+	{
+		Glib::Threads::Mutex::Lock lm (pool.lock);
+		for (uint32_t n = 0; n < n_threads; ++n) {
+			try {
+				threads.push_back (Glib::Threads::Thread::create (sigc::bind (sigc::ptr_fun (analysis_thread), &pool)));
+				++pool.running;
+			} catch (...) {
+				break;
 			}
 		}
-		total += to_read;
-		fpos += to_read;
-		if (p) {
-			p->set_progress (float (fpos - _start) / _length);
-			if (p->cancelled ()) {
-				return -1;
+	}
+
+	if (pool.running == 0 && !jobs.empty ()) {
+		/* no threads, do it ourselves */
+		pool.running = 1;
+		analysis_worker (&pool);
+	}
+
+	{
+		Glib::Threads::Mutex::Lock lm (pool.lock);
+		while (pool.running > 0) {
+			pool.cond.wait_until (pool.lock, g_get_monotonic_time () + 100 * G_TIME_SPAN_MILLISECOND);
+
+			float total = 0;
+			for (std::vector<AnalysisJob*>::const_iterator j = jobs.begin (); j != jobs.end (); ++j) {
+				total += (*j)->progress ();
+			}
+			total /= jobs.size ();
+
+			if (p) {
+				p->set_progress (total);
+				cancelled |= p->cancelled ();
+			}
+			if (itt) {
+				itt->progress = total;
+				cancelled |= itt->cancel;
+			}
+
+			if (cancelled && !cancel_sent) {
+				cancel_sent = true;
+				pool.next = jobs.size ();
+				for (std::vector<AnalysisJob*>::const_iterator j = jobs.begin (); j != jobs.end (); ++j) {
+					(*j)->cancel ();
+				}
 			}
 		}
 	}
-	return sqrt (2. * rms / (double)(total * n_chan));
+
+	for (std::vector<Glib::Threads::Thread*>::const_iterator t = threads.begin (); t != threads.end (); ++t) {
+		(*t)->join ();
+	}
+
+	return !cancelled;
+}
+
+bool
+AudioRegion::analyze_levels (std::vector<boost::shared_ptr<AudioRegion> > const& regions,
+                             std::vector<double>& peaks, std::vector<double>& rms, Progress* p)
+{
+	std::vector<LevelJob*> level_jobs;
+	std::vector<AnalysisJob*> jobs;
+
+	for (std::vector<boost::shared_ptr<AudioRegion> >::const_iterator r = regions.begin (); r != regions.end (); ++r) {
+		for (uint32_t c = 0; c < (*r)->n_channels (); ++c) {
+			level_jobs.push_back (new LevelJob (*r, c));
+			jobs.push_back (level_jobs.back ());
+		}
+	}
+
+	bool const rv = run_analysis_jobs (jobs, p, 0);
+
+	peaks.clear ();
+	rms.clear ();
+
+	std::vector<LevelJob*>::const_iterator j = level_jobs.begin ();
+	for (std::vector<boost::shared_ptr<AudioRegion> >::const_iterator r = regions.begin (); r != regions.end (); ++r) {
+		AudioSource::RangeStats s;
+		bool ok = true;
+		for (uint32_t c = 0; c < (*r)->n_channels (); ++c, ++j) {
+			ok &= (*j)->rv == 0;
+			s.peak   = max (s.peak, (*j)->stats.peak);
+			s.sumsq += (*j)->stats.sumsq;
+		}
+		/* like maximum_amplitude () and rms (), report 0 on read errors */
+		peaks.push_back (ok ? s.peak : 0);
+		rms.push_back (ok ? stats_to_rms (s, (*r)->length () * (*r)->n_channels ()) : 0);
+	}
+
+	for (std::vector<AnalysisJob*>::const_iterator j = jobs.begin (); j != jobs.end (); ++j) {
+		delete *j;
+	}
+
+	return rv;
+}
+
+std::vector<AudioIntervalResult>
+AudioRegion::find_silence (std::vector<boost::shared_ptr<AudioRegion> > const& regions,
+                           Sample threshold, samplecnt_t min_length, samplecnt_t fade_length, InterThreadInfo& itt)
+{
+	std::vector<SilenceJob*> silence_jobs;
+	std::vector<AnalysisJob*> jobs;
+
+	for (std::vector<boost::shared_ptr<AudioRegion> >::const_iterator r = regions.begin (); r != regions.end (); ++r) {
+		silence_jobs.push_back (new SilenceJob (*r, threshold, min_length, fade_length));
+		jobs.push_back (silence_jobs.back ());
+	}
+
+	run_analysis_jobs (jobs, 0, &itt);
+
+	std::vector<AudioIntervalResult> rv;
+	for (std::vector<SilenceJob*>::const_iterator j = silence_jobs.begin (); j != silence_jobs.end (); ++j) {
+		rv.push_back ((*j)->result);
+		delete *j;
+	}
+
+	itt.done = true;
+
+	return rv;
 }
 
 /** Normalize using a given maximum amplitude and target, so that region
@@ -1850,7 +2094,9 @@ AudioRegion::get_transients (AnalysisFeatureList& results)
 AudioIntervalResult
 AudioRegion::find_silence (Sample threshold, samplecnt_t min_length, samplecnt_t fade_length, InterThreadInfo& itt) const
 {
-	samplecnt_t const block_size = 64 * 1024;
+	/* use blocks that are aligned to the sources' analysis blocks, so that
+	 * blocks known to be silent in all channels can be skipped */
+	samplecnt_t const block_size = AudioSource::stats_block_size;
 	boost::scoped_array<Sample> loudest (new Sample[block_size]);
 	boost::scoped_array<Sample> buf (new Sample[block_size]);
 
@@ -1859,6 +2105,7 @@ AudioRegion::find_silence (Sample threshold, samplecnt_t min_length, samplecnt_t
 
 	samplepos_t pos = _start;
 	samplepos_t const end = _start + _length;
+	uint32_t const n_chan = n_channels ();
 
 	AudioIntervalResult silent_periods;
 
@@ -1867,17 +2114,44 @@ AudioRegion::find_silence (Sample threshold, samplecnt_t min_length, samplecnt_t
 
 	while (pos < end && !itt.cancel) {
 
+		samplepos_t const block = pos / block_size;
+		samplecnt_t const to_read = min (end, (block + 1) * block_size) - pos;
+		bool const whole = to_read == block_size;
+
+		if (whole) {
+			bool silent = true;
+			for (uint32_t n = 0; n < n_chan && silent; ++n) {
+				AudioSource::RangeStats s;
+				silent = audio_source (n)->cached_block_stats (block, s) && s.peak < threshold;
+			}
+			if (silent) {
+				if (!in_silence) {
+					/* non-silence to silence */
+					in_silence = true;
+					silence_start = pos + fade_length;
+				}
+				pos += to_read;
+				itt.progress = (pos - _start) / (double)_length;
+				continue;
+			}
+		}
+
 		samplecnt_t cur_samples = 0;
-		samplecnt_t const to_read = min (end - pos, block_size);
 		/* fill `loudest' with the loudest absolute sample at each instant, across all channels */
 		memset (loudest.get(), 0, sizeof (Sample) * block_size);
 
-		for (uint32_t n = 0; n < n_channels(); ++n) {
+		for (uint32_t n = 0; n < n_chan; ++n) {
 
 			cur_samples = read_raw_internal (buf.get(), pos, to_read, n);
 			for (samplecnt_t i = 0; i < cur_samples; ++i) {
 				loudest[i] = max (loudest[i], abs (buf[i]));
 			}
+
+			if (whole && cur_samples == to_read) {
+				AudioSource::RangeStats s;
+				AudioSource::compute_stats (buf.get(), cur_samples, s);
+				audio_source (n)->cache_block_stats (block, s);
+			}
 		}
 
 		/* now look for silence */
@@ -1899,7 +2173,7 @@ AudioRegion::find_silence (Sample threshold, samplecnt_t min_length, samplecnt_t
 		}
 
 		pos += cur_samples;
-		itt.progress = (end - pos) / (double)_length;
+		itt.progress = (pos - _start) / (double)_length;
 
 		if (cur_samples == 0) {
 			assert (pos >= end);
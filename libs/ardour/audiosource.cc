@@ -331,9 +331,99 @@ AudioSource::write (Sample *dst, samplecnt_t cnt)
 	Glib::Threads::Mutex::Lock lm (_lock);
 	/* any write makes the file not removable */
 	_flags = Flag (_flags & ~Removable);
+	{
+		Glib::Threads::Mutex::Lock sl (_stats_lock);
+		_block_stats.clear ();
+	}
 	return write_unlocked (dst, cnt);
 }
 
+bool
+AudioSource::range_stats (samplepos_t start, samplecnt_t cnt, RangeStats& s) const
+{
+	boost::scoped_array<Sample> buf;
+	samplepos_t const end = start + cnt;
+
+	while (start < end) {
+		samplepos_t const block = start / stats_block_size;
+		samplecnt_t const to_read = min (end, (block + 1) * stats_block_size) - start;
+		bool const whole = to_read == stats_block_size;
+
+		RangeStats bs;
+		if (!whole || !cached_block_stats (block, bs)) {
+			if (!buf) {
+				buf.reset (new Sample[stats_block_size]);
+			}
+			if (read (buf.get(), start, to_read) != to_read) {
+				return false;
+			}
+			compute_stats (buf.get(), to_read, bs);
+			if (whole) {
+				cache_block_stats (block, bs);
+			}
+		}
+
+		s.peak   = max (s.peak, bs.peak);
+		s.sumsq += bs.sumsq;
+		start   += to_read;
+	}
+	return true;
+}
+
+bool
+AudioSource::cached_block_stats (samplepos_t block, RangeStats& s) const
+{
+	Glib::Threads::Mutex::Lock lm (_stats_lock);
+	if (block < 0 || block >= (samplepos_t) _block_stats.size () || _block_stats[block].peak < 0) {
+		return false;
+	}
+	s = _block_stats[block];
+	return true;
+}
+
+void
+AudioSource::cache_block_stats (samplepos_t block, RangeStats const& s) const
+{
+	Glib::Threads::Mutex::Lock lm (_stats_lock);
+	if (block >= (samplepos_t) _block_stats.size ()) {
+		RangeStats unknown;
+		unknown.peak = -1;
+		_block_stats.resize (block + 1, unknown);
+	}
+	_block_stats[block] = s;
+}
+
+void
+AudioSource::compute_stats (Sample const* buf, samplecnt_t n, RangeStats& s)
+{
+	s.peak = compute_peak (buf, n, s.peak);
+
+	/* sum short runs in single precision and accumulate those in double
+	 * precision. Four independent partial sums break the dependency chain
+	 * of a single accumulator; a plain reduction loop is neither unrolled
+	 * nor vectorized without -ffast-math (float addition is not associative).
+	 */
+	samplecnt_t i = 0;
+	while (i < n) {
+		samplecnt_t const e  = min (n, i + 256);
+		samplecnt_t const e4 = i + ((e - i) & ~3);
+		float s0 = 0;
+		float s1 = 0;
+		float s2 = 0;
+		float s3 = 0;
+		for (; i < e4; i += 4) {
+			s0 += buf[i]     * buf[i];
+			s1 += buf[i + 1] * buf[i + 1];
+			s2 += buf[i + 2] * buf[i + 2];
+			s3 += buf[i + 3] * buf[i + 3];
+		}
+		for (; i < e; ++i) {
+			s0 += buf[i] * buf[i];
+		}
+		s.sumsq += (s0 + s1) + (s2 + s3);
+	}
+}
+
 int
 AudioSource::read_peaks (PeakData *peaks, samplecnt_t npeaks, samplepos_t start, samplecnt_t cnt, double samples_per_visual_peak) const
 {
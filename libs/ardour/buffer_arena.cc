@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <string.h>
+
+#ifndef PLATFORM_WINDOWS
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "pbd/failed_constructor.h"
+#include "pbd/malign.h"
+
+#include "ardour/buffer_arena.h"
+
+using namespace ARDOUR;
+
+#ifdef MAP_HUGETLB
+/* default huge page size on x86_64 and aarch64 */
+static const size_t huge_page_size = 2 * 1024 * 1024;
+#endif
+
+BufferArena::BufferArena (size_t size, bool huge_pages)
+	: _data (0)
+	, _size (0)
+	, _used (0)
+	, _huge_pages (false)
+	, _locked (false)
+{
+#ifndef PLATFORM_WINDOWS
+	void* mem = MAP_FAILED;
+
+#ifdef MAP_HUGETLB
+	/* only use explicit huge pages if that does not waste most of a page */
+	if (huge_pages && size > huge_page_size / 2) {
+		_size = (size + huge_page_size - 1) & ~(huge_page_size - 1);
+		mem   = mmap (0, _size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+		_huge_pages = mem != MAP_FAILED;
+	}
+#endif
+
+	if (mem == MAP_FAILED) {
+		const size_t page_size = sysconf (_SC_PAGESIZE);
+		_size = (size + page_size - 1) & ~(page_size - 1);
+		mem   = mmap (0, _size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+#ifdef MADV_HUGEPAGE
+		if (huge_pages && mem != MAP_FAILED) {
+			madvise (mem, _size, MADV_HUGEPAGE);
+		}
+#endif
+	}
+
+	if (mem == MAP_FAILED) {
+		throw failed_constructor ();
+	}
+
+	_data = (uint8_t*) mem;
+
+	memset (_data, 0, _size); // make resident
+	_locked = mlock (_data, _size) == 0;
+#else
+	_size = align (size);
+	if (cache_aligned_malloc ((void**) &_data, _size)) {
+		throw failed_constructor ();
+	}
+	memset (_data, 0, _size);
+#endif
+}
+
+BufferArena::~BufferArena ()
+{
+#ifndef PLATFORM_WINDOWS
+	if (_locked) {
+		munlock (_data, _size);
+	}
+	munmap (_data, _size);
+#else
+	cache_aligned_free (_data);
+#endif
+}
+
+void*
+BufferArena::alloc (size_t size)
+{
+	size = align (size);
+	if (_used + size > _size) {
+		return 0;
+	}
+	void* rv = _data + _used;
+	_used += size;
+	return rv;
+}
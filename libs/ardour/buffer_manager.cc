@@ -30,6 +30,7 @@ using namespace PBD;
 
 RingBufferNPT<ThreadBuffers*>* BufferManager::thread_buffers = 0;
 std::list<ThreadBuffers*>* BufferManager::thread_buffers_list = 0;
+uint32_t BufferManager::_count = 0;
 Glib::Threads::Mutex BufferManager::rb_mutex;
 
 using std::cerr;
@@ -45,10 +46,11 @@ BufferManager::init (uint32_t size)
          */
 
         for (uint32_t n = 0; n < size; ++n) {
-                ThreadBuffers* ts = new ThreadBuffers;
+                ThreadBuffers* ts = new ThreadBuffers (n);
                 thread_buffers->write (&ts, 1);
 		thread_buffers_list->push_back (ts);
         }
+	_count = size;
 	// cerr << "Initialized thread buffers, readable count now " << thread_buffers->read_space() << endl;
 
 }
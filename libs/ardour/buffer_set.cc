@@ -31,6 +31,7 @@
 #include "pbd/compose.h"
 #include "pbd/failed_constructor.h"
 
+#include "ardour/audio_buffer.h"
 #include "ardour/buffer.h"
 #include "ardour/buffer_set.h"
 #include "ardour/debug.h"
@@ -221,6 +222,29 @@ BufferSet::ensure_buffers(DataType type, size_t num_buffers, size_t buffer_capac
 /** Ensure that the number of buffers of each type @a type matches @a chns
  * and each buffer is of size at least @a buffer_capacity
  */
+void
+BufferSet::use_audio_memory (size_t num_buffers, size_t buffer_capacity, Sample* data)
+{
+	assert (!_is_mirror);
+
+	BufferVec& bufs = _buffers[DataType::AUDIO];
+
+	for (BufferVec::iterator i = bufs.begin(); i != bufs.end(); ++i) {
+		delete (*i);
+	}
+	bufs.clear();
+
+	for (size_t i = 0; i < num_buffers; ++i) {
+		/* capacity 0: the buffer does not own its data */
+		AudioBuffer* ab = new AudioBuffer (0);
+		ab->set_data (data + i * buffer_capacity, buffer_capacity);
+		bufs.push_back (ab);
+	}
+
+	_available.set (DataType::AUDIO, num_buffers);
+	_count.set (DataType::AUDIO, num_buffers);
+}
+
 void
 BufferSet::ensure_buffers(const ChanCount& chns, size_t buffer_capacity)
 {
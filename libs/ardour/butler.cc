@@ -31,12 +31,15 @@
 #include "pbd/error.h"
 #include "pbd/pthread_utils.h"
 
+#include "ardour/audioengine.h"
 #include "ardour/butler.h"
+#include "ardour/cycle_trace.h"
 #include "ardour/debug.h"
 #include "ardour/disk_io.h"
 #include "ardour/disk_reader.h"
 #include "ardour/io.h"
 #include "ardour/session.h"
+#include "ardour/thread_placement.h"
 #include "ardour/track.h"
 #include "ardour/auditioner.h"
 
@@ -150,6 +153,7 @@ Butler::_thread_work (void* arg)
 {
 	SessionEvent::create_per_thread_pool ("butler events", 4096);
 	pthread_set_name (X_("butler"));
+	ThreadPlacement::place (ThreadPlacement::Butler);
 	return ((Butler *) arg)->thread_work ();
 }
 
@@ -200,6 +204,9 @@ Butler::thread_work ()
 		DEBUG_TRACE (DEBUG::Butler, "at restart for disk work\n");
 		disk_work_outstanding = false;
 
+		CycleTrace::write_pending ();
+		AudioEngine::instance ()->rebuild_port_resampler ();
+
 		if (transport_work_requested()) {
 			DEBUG_TRACE (DEBUG::Butler, string_compose ("do transport work @ %1\n", g_get_monotonic_time()));
 			_session.butler_transport_work ();
@@ -250,6 +257,7 @@ Butler::thread_work ()
 				continue;
 			}
 			// DEBUG_TRACE (DEBUG::Butler, string_compose ("butler refills %1, playback load = %2\n", tr->name(), tr->playback_buffer_load()));
+			CycleTrace::Scope cts (CycleTrace::Butler, *tr);
 			switch (tr->do_refill ()) {
 			case 0:
 				//DEBUG_TRACE (DEBUG::Butler, string_compose ("\ttrack refill done %1\n", tr->name()));
@@ -0,0 +1,410 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <map>
+#include <sstream>
+
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <glibmm/datetime.h>
+#include <glibmm/miscutils.h>
+#include <glibmm/threads.h>
+
+#include "pbd/compose.h"
+#include "pbd/error.h"
+#include "pbd/pthread_utils.h"
+
+#include "ardour/cycle_trace.h"
+#include "ardour/filesystem_paths.h"
+#include "ardour/session_object.h"
+
+#include "pbd/i18n.h"
+
+using namespace std;
+using namespace ARDOUR;
+using namespace PBD;
+
+gint CycleTrace::_state = CycleTrace::Disabled;
+
+namespace {
+
+struct Ring {
+	Ring () : written (0), in_use (0) { name[0] = '\0'; }
+	CycleTrace::Event events[CycleTrace::ring_size];
+	gint              written; ///< number of events started, wraps around
+	gint              in_use;  ///< owned by a thread
+	char              name[32];
+};
+
+/* allocated when enabled for the first time, and never freed:
+ * a thread may still be inside a Scope when recording is disabled.
+ * A ring is owned by a thread until the thread exits.
+ */
+Ring*        rings       = 0;
+gint         n_rings     = 0; ///< number of rings that were used so far
+volatile int dump_needed = 0;
+
+Glib::Threads::Mutex alloc_lock;
+
+Glib::Threads::Mutex                               name_lookup_lock;
+boost::function<std::string (PBD::ID const&)> name_lookup;
+
+void
+release_ring (void* r)
+{
+	g_atomic_int_set (&static_cast<Ring*> (r)->in_use, 0);
+}
+
+Glib::Threads::Private<Ring> thread_ring (release_ring);
+
+Ring*
+acquire_ring ()
+{
+	for (uint32_t n = 0; n < CycleTrace::max_threads; ++n) {
+		Ring* r = &rings[n];
+		if (!g_atomic_int_compare_and_exchange (&r->in_use, 0, 1)) {
+			continue;
+		}
+		/* drop the events of the previous owner */
+		g_atomic_int_set (&r->written, 0);
+		strncpy (r->name, pthread_name (), sizeof (r->name) - 1);
+		r->name[sizeof (r->name) - 1] = '\0';
+
+		gint nr = g_atomic_int_get (&n_rings);
+		while (nr <= (gint) n && !g_atomic_int_compare_and_exchange (&n_rings, nr, n + 1)) {
+			nr = g_atomic_int_get (&n_rings);
+		}
+		return r;
+	}
+	return 0;
+}
+
+inline int64_t
+now ()
+{
+#if defined PLATFORM_WINDOWS || defined __APPLE__
+	return g_get_monotonic_time () * 1000;
+#else
+	struct timespec ts;
+	clock_gettime (CLOCK_MONOTONIC, &ts);
+	return (int64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+#endif
+}
+
+struct Stat {
+	Stat () : count (0), total (0), max (0) {}
+	uint64_t count;
+	int64_t  total;
+	int64_t  max;
+};
+
+bool
+event_cmp (CycleTrace::Event const& a, CycleTrace::Event const& b)
+{
+	return a.start < b.start;
+}
+
+void
+json_escape (ostream& o, char const* s)
+{
+	for (; *s; ++s) {
+		switch (*s) {
+			case '"':
+				o << "\\\"";
+				break;
+			case '\\':
+				o << "\\\\";
+				break;
+			default:
+				if ((unsigned char)*s < 0x20) {
+					o << ' ';
+				} else {
+					o << *s;
+				}
+				break;
+		}
+	}
+}
+
+} // anon namespace
+
+void
+CycleTrace::set_enabled (bool yn)
+{
+	if (yn == enabled ()) {
+		return;
+	}
+
+	if (yn) {
+		Glib::Threads::Mutex::Lock lm (alloc_lock);
+		if (!rings) {
+			rings = new Ring[max_threads];
+		}
+		g_atomic_int_set (&_state, Recording);
+	} else {
+		g_atomic_int_set (&_state, Disabled);
+		dump_needed = 0;
+	}
+}
+
+CycleTrace::Event*
+CycleTrace::begin (Kind kind, char const* name)
+{
+	Ring* r = thread_ring.get ();
+
+	if (!r) {
+		/* first event of this thread */
+		if (!(r = acquire_ring ())) {
+			return 0;
+		}
+		thread_ring.set (r);
+	}
+
+	/* this thread is the only writer, publish the slot before filling
+	 * it, so that nested scopes use the next one.
+	 */
+	guint const n = g_atomic_int_get (&r->written);
+	g_atomic_int_set (&r->written, n + 1);
+
+	Event* e = &r->events[n & (ring_size - 1)];
+	e->kind   = kind;
+	e->thread = r - rings;
+	e->end    = -1;
+	e->id     = (uint64_t) 0;
+	strncpy (e->name, name, sizeof (e->name) - 1);
+	e->name[sizeof (e->name) - 1] = '\0';
+	e->start  = now ();
+	return e;
+}
+
+CycleTrace::Event*
+CycleTrace::begin (Kind kind, SessionObject const& obj)
+{
+	/* SessionObject::name () copies a string, and may change concurrently */
+	Event* e = begin (kind, "");
+	if (e) {
+		e->id = obj.id ();
+	}
+	return e;
+}
+
+void
+CycleTrace::end (Event* e)
+{
+	e->end = now ();
+}
+
+bool
+CycleTrace::xrun ()
+{
+	if (!g_atomic_int_compare_and_exchange (&_state, Recording, Paused)) {
+		return false;
+	}
+	dump_needed = 1;
+	return true;
+}
+
+void
+CycleTrace::snapshot (vector<Event>& events)
+{
+	events.clear ();
+
+	if (!rings) {
+		return;
+	}
+
+	gint const nr = min (g_atomic_int_get (&n_rings), (gint) max_threads);
+
+	for (gint t = 0; t < nr; ++t) {
+		Ring& r (rings[t]);
+		guint const w0 = g_atomic_int_get (&r.written);
+		guint const n  = min (w0, (guint) ring_size);
+		size_t const first = events.size ();
+
+		for (guint i = w0 - n; i != w0; ++i) {
+			events.push_back (r.events[i & (ring_size - 1)]);
+		}
+
+		/* events that were overwritten while copying are unreliable,
+		 * as are events that have not yet completed.
+		 */
+		guint const w1   = g_atomic_int_get (&r.written);
+		guint const lost = min (w1 - w0, n);
+
+		vector<Event>::iterator i = events.begin () + first;
+		events.erase (i, i + lost);
+		for (i = events.begin () + first; i != events.end ();) {
+			if (i->end < i->start) {
+				i = events.erase (i);
+			} else {
+				++i;
+			}
+		}
+	}
+
+	stable_sort (events.begin (), events.end (), event_cmp);
+
+	/* fill in the names of objects */
+	Glib::Threads::Mutex::Lock lm (name_lookup_lock);
+	map<PBD::ID, string> names;
+
+	for (vector<Event>::iterator i = events.begin (); i != events.end (); ++i) {
+		if (i->id == (uint64_t) 0) {
+			continue;
+		}
+		map<PBD::ID, string>::iterator n = names.find (i->id);
+		if (n == names.end ()) {
+			string name;
+			if (name_lookup) {
+				name = name_lookup (i->id);
+			}
+			if (name.empty ()) {
+				name = i->id.to_s ();
+			}
+			n = names.insert (make_pair (i->id, name)).first;
+		}
+		strncpy (i->name, n->second.c_str (), sizeof (i->name) - 1);
+		i->name[sizeof (i->name) - 1] = '\0';
+	}
+}
+
+void
+CycleTrace::set_name_lookup (boost::function<string (PBD::ID const&)> f)
+{
+	Glib::Threads::Mutex::Lock lm (name_lookup_lock);
+	name_lookup = f;
+}
+
+char const*
+CycleTrace::kind_name (Kind k)
+{
+	switch (k) {
+		case Cycle:
+			return "cycle";
+		case PortCycleStart:
+			return "port-cycle-start";
+		case PortCycleEnd:
+			return "port-cycle-end";
+		case Route:
+			return "route";
+		case Processor:
+			return "processor";
+		case Butler:
+			return "butler";
+	}
+	return "";
+}
+
+bool
+CycleTrace::write_chrome_trace (string const& path, vector<Event> const& events)
+{
+	ofstream f (path.c_str ());
+	if (!f) {
+		return false;
+	}
+
+	int64_t const t0 = events.empty () ? 0 : events.front ().start;
+
+	f << "{\"traceEvents\":[\n";
+
+	gint const nr = rings ? min (g_atomic_int_get (&n_rings), (gint) max_threads) : 0;
+	for (gint t = 0; t < nr; ++t) {
+		f << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << t << ",\"args\":{\"name\":\"";
+		json_escape (f, rings[t].name);
+		f << "\"}},\n";
+	}
+
+	char buf[64];
+	for (vector<Event>::const_iterator i = events.begin (); i != events.end (); ++i) {
+		if (i != events.begin ()) {
+			f << ",\n";
+		}
+		f << "{\"name\":\"";
+		json_escape (f, i->name);
+		/* timestamps are in usec */
+		snprintf (buf, sizeof (buf), "%.3f", (i->start - t0) / 1000.0);
+		f << "\",\"cat\":\"" << kind_name (i->kind) << "\",\"ph\":\"X\",\"ts\":" << buf;
+		snprintf (buf, sizeof (buf), "%.3f", (i->end - i->start) / 1000.0);
+		f << ",\"dur\":" << buf << ",\"pid\":0,\"tid\":" << i->thread << "}";
+	}
+
+	f << "\n]}\n";
+	return f.good ();
+}
+
+bool
+CycleTrace::write_chrome_trace (string const& path)
+{
+	vector<Event> events;
+	snapshot (events);
+	return write_chrome_trace (path, events);
+}
+
+void
+CycleTrace::write_pending ()
+{
+	if (!dump_needed) {
+		return;
+	}
+	dump_needed = 0;
+
+	vector<Event> events;
+	snapshot (events);
+
+	string const path = Glib::build_filename (user_cache_directory (), string_compose ("xrun-%1.json", Glib::DateTime::create_now_local ().format ("%Y%m%d-%H%M%S")));
+
+	if (write_chrome_trace (path, events)) {
+		info << string_compose (_("Cycle trace of xrun written to %1"), path) << endmsg;
+	} else {
+		error << string_compose (_("Could not write cycle trace to %1"), path) << endmsg;
+	}
+
+	g_atomic_int_compare_and_exchange (&_state, Paused, Recording);
+}
+
+string
+CycleTrace::summary ()
+{
+	vector<Event> events;
+	snapshot (events);
+
+	typedef map<pair<Kind, string>, Stat> Stats;
+	Stats stats;
+
+	for (vector<Event>::const_iterator i = events.begin (); i != events.end (); ++i) {
+		Stat& s (stats[make_pair (i->kind, string (i->name))]);
+		int64_t const d = i->end - i->start;
+		++s.count;
+		s.total += d;
+		s.max    = max (s.max, d);
+	}
+
+	stringstream ss;
+	ss << "kind\tname\tcount\tavg [us]\tmax [us]\n";
+	for (Stats::const_iterator i = stats.begin (); i != stats.end (); ++i) {
+		Stat const& s (i->second);
+		ss << kind_name (i->first.first) << "\t" << i->first.second << "\t" << s.count
+		   << "\t" << (s.total / (double)s.count) / 1000.0 << "\t" << s.max / 1000.0 << "\n";
+	}
+	return ss.str ();
+}
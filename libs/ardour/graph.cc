@@ -28,11 +28,13 @@
 #include "pbd/pthread_utils.h"
 
 #include "ardour/audioengine.h"
+#include "ardour/cycle_trace.h"
 #include "ardour/debug.h"
 #include "ardour/graph.h"
 #include "ardour/process_thread.h"
 #include "ardour/route.h"
 #include "ardour/session.h"
+#include "ardour/thread_placement.h"
 #include "ardour/types.h"
 
 #include "pbd/i18n.h"
@@ -125,6 +127,10 @@ Graph::reset_thread_list ()
 		drop_threads ();
 	}
 
+	ThreadPlacement::reset ();
+	_cycle_stats.reset ();
+	_wakeup_stats.reset ();
+
 	/* Allow threads to run */
 	g_atomic_int_set (&_terminate, 0);
 
@@ -143,6 +149,26 @@ Graph::reset_thread_list ()
 	}
 }
 
+void
+Graph::report_stats ()
+{
+	uint64_t min, max;
+	double   avg, dev;
+
+	if (!_cycle_stats.get_stats (min, max, avg, dev)) {
+		return;
+	}
+	info << string_compose (_("DSP graph, %1 threads, %2: cycle min %3 max %4 avg %5 dev %6 [usec]"),
+	                        g_atomic_uint_get (&_n_workers) + 1, ThreadPlacement::describe (ThreadPlacement::DSP),
+	                        min, max, rint (avg), rint (dev)) << endmsg;
+
+	if (_wakeup_stats.get_stats (min, max, avg, dev)) {
+		info << string_compose (_("DSP graph, %1: wakeup min %2 max %3 avg %4 dev %5 [usec]"),
+		                        ThreadPlacement::describe (ThreadPlacement::DSP),
+		                        min, max, rint (avg), rint (dev)) << endmsg;
+	}
+}
+
 void
 Graph::session_going_away ()
 {
@@ -162,6 +188,8 @@ Graph::drop_threads ()
 {
 	Glib::Threads::Mutex::Lock ls (_swap_mutex);
 
+	report_stats ();
+
 	/* Flag threads to terminate */
 	g_atomic_int_set (&_terminate, 1);
 
@@ -304,6 +332,8 @@ Graph::reached_terminal_node ()
 			return;
 		}
 
+		_wakeup_stats.update ();
+
 		DEBUG_TRACE (DEBUG::ProcessThreads, string_compose ("%1 prepare new cycle.\n", pthread_name ()));
 
 		/* Prepare next cycle:
@@ -466,6 +496,11 @@ Graph::helper_thread ()
 
 	pt->get_buffers ();
 
+	if (ThreadPlacement::place (ThreadPlacement::DSP)) {
+		/* allocate buffers on this CPU's NUMA node */
+		pt->reallocate_buffers ();
+	}
+
 	while (!g_atomic_int_get (&_terminate)) {
 		run_one ();
 	}
@@ -496,6 +531,10 @@ Graph::main_thread ()
 
 	pt->get_buffers ();
 
+	if (ThreadPlacement::place (ThreadPlacement::DSP)) {
+		pt->reallocate_buffers ();
+	}
+
 	/* Wait for initial process callback */
 again:
 	_callback_start_sem.wait ();
@@ -508,6 +547,8 @@ again:
 		return;
 	}
 
+	_wakeup_stats.update ();
+
 	/* Bootstrap the trigger-list
 	 * (later this is done by Graph_reached_terminal_node) */
 	prep ();
@@ -622,8 +663,11 @@ Graph::process_routes (pframes_t nframes, samplepos_t start_sample, samplepos_t
 	_process_need_butler = false;
 
 	DEBUG_TRACE (DEBUG::ProcessThreads, "wake graph for non-silent process\n");
+	_cycle_stats.start ();
+	_wakeup_stats.start ();
 	_callback_start_sem.signal ();
 	_callback_done_sem.wait ();
+	_cycle_stats.update ();
 	DEBUG_TRACE (DEBUG::ProcessThreads, "graph execution complete\n");
 
 	need_butler = _process_need_butler;
@@ -650,8 +694,11 @@ Graph::routes_no_roll (pframes_t nframes, samplepos_t start_sample, samplepos_t
 	_process_need_butler = false;
 
 	DEBUG_TRACE (DEBUG::ProcessThreads, "wake graph for no-roll process\n");
+	_cycle_stats.start ();
+	_wakeup_stats.start ();
 	_callback_start_sem.signal ();
 	_callback_done_sem.wait ();
+	_cycle_stats.update ();
 	DEBUG_TRACE (DEBUG::ProcessThreads, "graph execution complete\n");
 
 	return _process_retval;
@@ -664,6 +711,8 @@ Graph::process_one_route (Route* route)
 
 	assert (route);
 
+	CycleTrace::Scope cts (CycleTrace::Route, *route);
+
 	DEBUG_TRACE (DEBUG::ProcessThreads, string_compose ("%1 runs route %2\n", pthread_name (), route->name ()));
 
 	if (_process_noroll) {
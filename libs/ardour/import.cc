@@ -46,6 +46,8 @@
 
 #include "pbd/basename.h"
 #include "pbd/convert.h"
+#include "pbd/cpus.h"
+#include "pbd/pthread_utils.h"
 
 #include "evoral/SMF.h"
 
@@ -55,11 +57,13 @@
 #include "ardour/audioregion.h"
 #include "ardour/import_status.h"
 #include "ardour/mp3fileimportable.h"
+#include "ardour/rc_configuration.h"
 #include "ardour/region_factory.h"
 #include "ardour/resampled_source.h"
 #include "ardour/runtime_functions.h"
 #include "ardour/session.h"
 #include "ardour/session_directory.h"
+#include "ardour/session_event.h"
 #include "ardour/smf_source.h"
 #include "ardour/sndfile_helpers.h"
 #include "ardour/sndfileimportable.h"
@@ -242,7 +246,7 @@ compose_status_message (const string& path,
 }
 
 static void
-write_audio_data_to_new_files (ImportableSource* source, ImportStatus& status,
+write_audio_data_to_new_files (ImportableSource* source, ImportStatus& status, float& progress,
                                vector<boost::shared_ptr<Source> >& newfiles)
 {
 	const samplecnt_t nframes = ResampledImportableSource::blocksize;
@@ -264,7 +268,7 @@ write_audio_data_to_new_files (ImportableSource* source, ImportStatus& status,
 	boost::shared_ptr<AudioSource> s = boost::dynamic_pointer_cast<AudioSource> (newfiles[0]);
 	assert (s);
 
-	status.progress = 0.0f;
+	progress = 0.0f;
 	float progress_multiplier = 1;
 	float progress_base = 0;
 	const float progress_length = source->ratio() * source->length();
@@ -288,7 +292,7 @@ write_audio_data_to_new_files (ImportableSource* source, ImportStatus& status,
 			peak = compute_peak (data.get(), nread, peak);
 
 			read_count += nread / channels;
-			status.progress = 0.5 * read_count / progress_length;
+			progress = 0.5 * read_count / progress_length;
 		}
 
 		if (peak >= 1) {
@@ -347,19 +351,19 @@ write_audio_data_to_new_files (ImportableSource* source, ImportStatus& status,
 		}
 
 		read_count += nfread;
-		status.progress = progress_base + progress_multiplier * read_count / progress_length;
+		progress = progress_base + progress_multiplier * read_count / progress_length;
 	}
 }
 
 static void
-write_midi_data_to_new_files (Evoral::SMF* source, ImportStatus& status,
+write_midi_data_to_new_files (Evoral::SMF* source, ImportStatus& status, float& progress,
                               vector<boost::shared_ptr<Source> >& newfiles,
                               bool split_type0)
 {
 	uint32_t buf_size = 4;
 	uint8_t* buf      = (uint8_t*) malloc (buf_size);
 
-	status.progress = 0.0f;
+	progress = 0.0f;
 	uint16_t num_tracks;
 	bool type0 = source->is_type0 () && split_type0;
 	const std::set<uint8_t>& chn = source->channels ();
@@ -438,8 +442,8 @@ write_midi_data_to_new_files (Evoral::SMF* source, ImportStatus& status,
 						size,
 						buf));
 
-				if (status.progress < 0.99) {
-					status.progress += 0.01;
+				if (progress < 0.99) {
+					progress += 0.01;
 				}
 			}
 
@@ -487,6 +491,203 @@ remove_file_source (boost::shared_ptr<Source> source)
 	}
 }
 
+namespace {
+
+/** A file to import, see Session::import_files() */
+struct ImportJob {
+	ImportJob () : progress (0), failed (false) {}
+
+	std::string path;
+	vector<boost::shared_ptr<Source> > newfiles;
+	float progress; /* 0..1 */
+	bool  failed;
+};
+
+/** Files are imported in parallel by a bounded number of threads. Opening the
+ * file and creating the new sources is serialized, since that picks unique
+ * names and adds sources to the session. Decoding, sample-rate conversion,
+ * writing the new files and their peaks happens concurrently.
+ */
+struct ImportPool {
+	ImportPool (Session& s, ImportStatus& st)
+		: session (s)
+		, status (st)
+		, next (0)
+		, running (0)
+	{}
+
+	Session&           session;
+	ImportStatus&      status;
+	vector<ImportJob>  jobs;
+	size_t             next;
+	uint32_t           running;
+
+	Glib::Threads::Mutex lock;
+	Glib::Threads::Cond  cond;
+};
+
+}
+
+/* called with ImportPool::lock held */
+static void
+job_failed (ImportStatus& status, ImportJob& job)
+{
+	status.failed_paths.push_back (job.path);
+	job.failed = true;
+	job.progress = 1.0;
+}
+
+/* called with ImportPool::lock held */
+static bool
+prepare_import_job (ImportPool& pool, ImportJob& job,
+                    boost::shared_ptr<ImportableSource>& source,
+                    boost::scoped_ptr<Evoral::SMF>& smf_reader)
+{
+	Session& session (pool.session);
+	ImportStatus& status (pool.status);
+	uint32_t channels = 0;
+	vector<string> smf_names;
+
+	const DataType type = SMFSource::safe_midi_file_extension (job.path) ? DataType::MIDI : DataType::AUDIO;
+
+	if (type == DataType::AUDIO) {
+		try {
+			source = open_importable_source (job.path, session.sample_rate(), status.quality);
+			channels = source->channels();
+		} catch (const failed_constructor& err) {
+			error << string_compose(_("Import: cannot open input sound file \"%1\""), job.path) << endmsg;
+			job_failed (status, job);
+			return false;
+		}
+
+	} else {
+		try {
+			smf_reader.reset (new Evoral::SMF());
+
+			if (smf_reader->open(job.path)) {
+				throw Evoral::SMF::FileError (job.path);
+			}
+
+			if (smf_reader->is_type0 () && status.split_midi_channels) {
+				channels = smf_reader->channels().size();
+			} else {
+				channels = smf_reader->num_tracks();
+				switch (status.midi_track_name_source) {
+				case SMFTrackNumber:
+					break;
+				case SMFTrackName:
+					smf_reader->track_names (smf_names);
+					break;
+				case SMFInstrumentName:
+					smf_reader->instrument_names (smf_names);
+					break;
+				}
+			}
+		} catch (...) {
+			error << _("Import: error opening MIDI file") << endmsg;
+			job_failed (status, job);
+			return false;
+		}
+	}
+
+	if (channels == 0) {
+		error << _("Import: file contains no channels.") << endmsg;
+		job.progress = 1.0;
+		return false;
+	}
+
+	vector<string> new_paths = session.get_paths_for_new_sources (status.replace_existing_source, job.path, channels, smf_names);
+	samplepos_t natural_position = source ? source->natural_position() : 0;
+
+	bool ok;
+	if (status.replace_existing_source) {
+		fatal << "THIS IS NOT IMPLEMENTED YET, IT SHOULD NEVER GET CALLED!!! DYING!" << endmsg;
+		ok = map_existing_mono_sources (new_paths, session, session.sample_rate(), job.newfiles, &session);
+	} else {
+		ok = create_mono_sources_for_writing (new_paths, session, session.sample_rate(), job.newfiles, natural_position);
+	}
+
+	/* any files that were created are removed by import_files() */
+	if (!ok) {
+		job_failed (status, job);
+		return false;
+	}
+
+	boost::shared_ptr<AudioFileSource> afs;
+	for (vector<boost::shared_ptr<Source> >::iterator i = job.newfiles.begin(); i != job.newfiles.end(); ++i) {
+		if ((afs = boost::dynamic_pointer_cast<AudioFileSource>(*i)) != 0) {
+			afs->prepare_for_peakfile_writes ();
+		}
+	}
+
+	if (source) {
+		status.doing_what = compose_status_message (job.path, source->samplerate(),
+		                                            session.sample_rate(), status.current, status.total);
+	} else {
+		status.doing_what = string_compose(_("Loading MIDI file %1"), job.path);
+	}
+
+	return true;
+}
+
+static void
+import_worker (ImportPool* pool)
+{
+	ImportStatus& status (pool->status);
+
+	while (true) {
+		boost::shared_ptr<ImportableSource> source;
+		boost::scoped_ptr<Evoral::SMF> smf_reader;
+		ImportJob* job;
+
+		{
+			Glib::Threads::Mutex::Lock lm (pool->lock);
+			if (status.cancel || pool->next == pool->jobs.size ()) {
+				break;
+			}
+			if (!status.skip_failed_paths && !status.failed_paths.empty ()) {
+				/* the batch failed, don't bother with the remaining files */
+				break;
+			}
+			job = &pool->jobs[pool->next++];
+			if (!prepare_import_job (*pool, *job, source, smf_reader)) {
+				continue;
+			}
+		}
+
+		if (source) { // audio
+			write_audio_data_to_new_files (source.get(), status, job->progress, job->newfiles);
+		} else if (smf_reader) { // midi
+			write_midi_data_to_new_files (smf_reader.get(), status, job->progress, job->newfiles, status.split_midi_channels);
+		}
+
+		if (!status.cancel) {
+			/* peaks were computed while writing, flush them now rather
+			 * than keeping the peakfiles of all imported files open */
+			boost::shared_ptr<AudioFileSource> afs;
+			for (vector<boost::shared_ptr<Source> >::iterator i = job->newfiles.begin(); i != job->newfiles.end(); ++i) {
+				if ((afs = boost::dynamic_pointer_cast<AudioFileSource>(*i)) != 0) {
+					afs->done_with_peakfile_writes ();
+				}
+			}
+		}
+
+		job->progress = 1.0;
+	}
+
+	Glib::Threads::Mutex::Lock lm (pool->lock);
+	--pool->running;
+	pool->cond.signal ();
+}
+
+static void
+import_thread (ImportPool* pool)
+{
+	pthread_set_name ("Import");
+	SessionEvent::create_per_thread_pool ("Import", 64);
+	import_worker (pool);
+}
+
 // This function is still unable to cleanly update an existing source, even though
 // it is possible to set the ImportStatus flag accordingly. The functinality
 // is disabled at the GUI until the Source implementations are able to provide
@@ -498,102 +699,83 @@ Session::import_files (ImportStatus& status)
 	Sources all_new_sources;
 	boost::shared_ptr<AudioFileSource> afs;
 	boost::shared_ptr<SMFSource> smfs;
-	uint32_t channels = 0;
-	vector<string> smf_names;
 
 	status.sources.clear ();
+	status.sources_by_path.clear ();
+	status.failed_paths.clear ();
 
-	for (vector<string>::const_iterator p = status.paths.begin(); p != status.paths.end() && !status.cancel; ++p) {
+	ImportPool pool (*this, status);
 
-		boost::shared_ptr<ImportableSource> source;
+	pool.jobs.resize (status.paths.size ());
+	for (size_t n = 0; n < status.paths.size (); ++n) {
+		pool.jobs[n].path = status.paths[n];
+	}
 
-		const DataType type = SMFSource::safe_midi_file_extension (*p) ? DataType::MIDI : DataType::AUDIO;
-		boost::scoped_ptr<Evoral::SMF> smf_reader;
+	uint32_t n_threads = Config->get_import_concurrency ();
+	if (n_threads == 0) {
+		n_threads = hardware_concurrency ();
+	}
+	n_threads = std::max<uint32_t> (1, std::min<uint32_t> (n_threads, pool.jobs.size ()));
 
-		if (type == DataType::AUDIO) {
-			try {
-				source = open_importable_source (*p, sample_rate(), status.quality);
-				channels = source->channels();
-			} catch (const failed_constructor& err) {
-				error << string_compose(_("Import: cannot open input sound file \"%1\""), (*p)) << endmsg;
-				status.done = status.cancel = true;
-				return;
-			}
+	const uint32_t first_file = status.current;
+	vector<Glib::Threads::Thread*> threads;
 
-		} else {
+	{
+		Glib::Threads::Mutex::Lock lm (pool.lock);
+		for (uint32_t n = 0; n < n_threads; ++n) {
 			try {
-				smf_reader.reset (new Evoral::SMF());
-
-				if (smf_reader->open(*p)) {
-					throw Evoral::SMF::FileError (*p);
-				}
-
-				if (smf_reader->is_type0 () && status.split_midi_channels) {
-					channels = smf_reader->channels().size();
-				} else {
-					channels = smf_reader->num_tracks();
-					switch (status.midi_track_name_source) {
-					case SMFTrackNumber:
-						break;
-					case SMFTrackName:
-						smf_reader->track_names (smf_names);
-						break;
-					case SMFInstrumentName:
-						smf_reader->instrument_names (smf_names);
-						break;
-					}
-				}
+				threads.push_back (Glib::Threads::Thread::create (sigc::bind (sigc::ptr_fun (import_thread), &pool)));
+				++pool.running;
 			} catch (...) {
-				error << _("Import: error opening MIDI file") << endmsg;
-				status.done = status.cancel = true;
-				return;
+				break;
 			}
 		}
+	}
 
-		if (channels == 0) {
-			error << _("Import: file contains no channels.") << endmsg;
-			continue;
-		}
-
-		vector<string> new_paths = get_paths_for_new_sources (status.replace_existing_source, *p, channels, smf_names);
-		Sources newfiles;
-		samplepos_t natural_position = source ? source->natural_position() : 0;
-
-
-		if (status.replace_existing_source) {
-			fatal << "THIS IS NOT IMPLEMENTED YET, IT SHOULD NEVER GET CALLED!!! DYING!" << endmsg;
-			status.cancel = !map_existing_mono_sources (new_paths, *this, sample_rate(), newfiles, this);
-		} else {
-			status.cancel = !create_mono_sources_for_writing (new_paths, *this, sample_rate(), newfiles, natural_position);
-		}
-
-		// copy on cancel/failure so that any files that were created will be removed below
-		std::copy (newfiles.begin(), newfiles.end(), std::back_inserter(all_new_sources));
+	if (pool.running == 0 && !pool.jobs.empty ()) {
+		/* no threads, do it ourselves */
+		pool.running = 1;
+		import_worker (&pool);
+	}
 
-		if (status.cancel) {
-			break;
-		}
+	/* wait for all workers, and report the aggregate progress */
+	{
+		Glib::Threads::Mutex::Lock lm (pool.lock);
+		while (pool.running > 0) {
+			pool.cond.wait_until (pool.lock, g_get_monotonic_time () + 100 * G_TIME_SPAN_MILLISECOND);
 
-		for (Sources::iterator i = newfiles.begin(); i != newfiles.end(); ++i) {
-			if ((afs = boost::dynamic_pointer_cast<AudioFileSource>(*i)) != 0) {
-				afs->prepare_for_peakfile_writes ();
+			float total = 0;
+			for (vector<ImportJob>::const_iterator j = pool.jobs.begin (); j != pool.jobs.end (); ++j) {
+				total += j->progress;
 			}
+			const uint32_t complete = std::min<uint32_t> (floorf (total), pool.jobs.size ());
+			status.current  = first_file + complete;
+			status.progress = total - complete;
 		}
+	}
 
-		if (source) { // audio
-			status.doing_what = compose_status_message (*p, source->samplerate(),
-			                                            sample_rate(), status.current, status.total);
-			write_audio_data_to_new_files (source.get(), status, newfiles);
-		} else if (smf_reader) { // midi
-			status.doing_what = string_compose(_("Loading MIDI file %1"), *p);
-			write_midi_data_to_new_files (smf_reader.get(), status, newfiles, status.split_midi_channels);
-		}
+	for (vector<Glib::Threads::Thread*>::const_iterator t = threads.begin (); t != threads.end (); ++t) {
+		(*t)->join ();
+	}
 
-		++status.current;
-		status.progress = 0;
+	/* sources of files that failed to import are removed. If the user
+	 * cancelled, or a file failed and the caller did not ask to skip
+	 * failed files, the sources of all files are removed.
+	 */
+	const bool all_failed = status.cancel || (!status.failed_paths.empty () && !status.skip_failed_paths);
+	Sources failed_sources;
+
+	/* keep the order of the given paths */
+	for (vector<ImportJob>::iterator j = pool.jobs.begin (); j != pool.jobs.end (); ++j) {
+		if (all_failed || j->failed) {
+			std::copy (j->newfiles.begin(), j->newfiles.end(), std::back_inserter(failed_sources));
+			j->newfiles.clear ();
+		} else {
+			std::copy (j->newfiles.begin(), j->newfiles.end(), std::back_inserter(all_new_sources));
+		}
 	}
 
-	if (!status.cancel) {
+	if (!all_failed) {
 		struct tm* now;
 		time_t xnow;
 		time (&xnow);
@@ -606,7 +788,6 @@ Session::import_files (ImportStatus& status)
 
 			if ((afs = boost::dynamic_pointer_cast<AudioFileSource>(*x)) != 0) {
 				afs->update_header((*x)->natural_position(), *now, xnow);
-				afs->done_with_peakfile_writes ();
 
 				/* now that there is data there, requeue the file for analysis */
 
@@ -642,13 +823,22 @@ Session::import_files (ImportStatus& status)
 		}
 
 		std::copy (all_new_sources.begin(), all_new_sources.end(), std::back_inserter(status.sources));
-	} else {
-		try {
-			std::for_each (all_new_sources.begin(), all_new_sources.end(), remove_file_source);
-		} catch (...) {
-			error << _("Failed to remove some files after failed/cancelled import operation") << endmsg;
+
+		status.sources_by_path.resize (pool.jobs.size ());
+		for (size_t n = 0; n < pool.jobs.size (); ++n) {
+			Sources const& nf (pool.jobs[n].newfiles);
+			for (Sources::const_iterator x = nf.begin(); x != nf.end(); ++x) {
+				if ((smfs = boost::dynamic_pointer_cast<SMFSource>(*x)) == 0 || !smfs->is_empty()) {
+					status.sources_by_path[n].push_back (*x);
+				}
+			}
 		}
+	}
 
+	try {
+		std::for_each (failed_sources.begin(), failed_sources.end(), remove_file_source);
+	} catch (...) {
+		error << _("Failed to remove some files after failed/cancelled import operation") << endmsg;
 	}
 
 	status.done = true;
@@ -22,6 +22,7 @@
 #include <errno.h>
 #include <unistd.h>
 #include <algorithm>
+#include <map>
 #include <glibmm.h>
 
 #include "pbd/pthread_utils.h"
@@ -67,16 +68,6 @@ struct midipair {
 	string trname;
 };
 
-typedef struct ptflookup {
-	uint16_t index1;
-	uint16_t index2;
-	PBD::ID  id;
-
-	bool operator ==(const struct ptflookup& other) {
-		return (this->index1 == other.index1);
-	}
-} ptflookup_t;
-
 
 bool
 Session::import_sndfile_as_region (string path, SrcQuality quality, samplepos_t& pos, SourceList& sources, ImportStatus& status)
@@ -90,22 +81,15 @@ Session::import_sndfile_as_region (string path, SrcQuality quality, samplepos_t&
 	status.quality = quality;
 	status.replace_existing_source = false;
 	status.split_midi_channels = false;
+	status.skip_failed_paths = false;
 	status.done = false;
 	status.cancel = false;
 
 	import_files(status);
 	sources.clear();
 
-	/* FIXME: There is no way to tell if cancel button was pressed
-	 * or if the file failed to import, just that one of these occurred.
-	 * We want status.cancel to reflect the user's choice only
-	 */
-	if (status.cancel && status.current > 1) {
-		/* Succeeded to import file, assume user hit cancel */
-		return false;
-	} else if (status.cancel && status.current == 1) {
-		/* Failed to import file, assume user did not hit cancel */
-		status.cancel = false;
+	/* status.cancel reflects the user's choice only */
+	if (status.cancel || !status.failed_paths.empty () || status.sources.empty ()) {
 		return false;
 	}
 
@@ -187,79 +171,125 @@ Session::import_sndfile_as_region (string path, SrcQuality quality, samplepos_t&
 void
 Session::import_pt (PTFFormat& ptf, ImportStatus& status)
 {
-	vector<boost::shared_ptr<Region> > regions;
 	boost::shared_ptr<ARDOUR::Track> track;
 	ARDOUR::PluginInfoPtr instrument;
-	vector<string> to_import;
 	string fullpath;
-	bool ok = false;
 	bool onefailed = false;
-	samplepos_t pos = -1;
 	uint32_t srate = sample_rate ();
 
-	vector<ptflookup_t> ptfwavpair;
-	vector<ptflookup_t> ptfregpair;
 	vector<PTFFormat::wav_t>::const_iterator w;
 
 	SourceList just_one_src;
 	SourceList imported;
 
-	boost::shared_ptr<AudioTrack> existing_track;
-	uint16_t nth = 0;
-	vector<ptflookup_t> usedtracks;
-	ptflookup_t utr;
+	vector<string>   paths;
+	vector<uint16_t> path_wav; /* PT wav index of each of paths */
+
+	/* lookup tables: PT wav index -> source, PT region index -> regions,
+	 * PT track index -> ardour track */
+	map<uint16_t, boost::shared_ptr<Source> >          wav_sources;
+	map<uint16_t, vector<boost::shared_ptr<Region> > > pt_regions;
+	map<uint16_t, boost::shared_ptr<AudioTrack> >      used_tracks;
 
-	for (w = ptf.audiofiles ().begin (); w != ptf.audiofiles ().end () && !status.cancel; ++w) {
-		ptflookup_t p;
-		ok = false;
+	size_t  n_regions = 0;
+	int64_t t_start   = g_get_monotonic_time ();
+	int64_t t_audio   = 0;
+	int64_t t_regions = 0;
+	int64_t t_tracks  = 0;
+
+	for (w = ptf.audiofiles ().begin (); w != ptf.audiofiles ().end (); ++w) {
 		/* Try audio file */
 		fullpath = Glib::build_filename (Glib::path_get_dirname (ptf.path ()), "Audio Files");
 		fullpath = Glib::build_filename (fullpath, w->filename);
-		if (Glib::file_test (fullpath, Glib::FILE_TEST_EXISTS)) {
-			just_one_src.clear();
-			ok = import_sndfile_as_region (fullpath, SrcBest, pos, just_one_src, status);
-		} else {
+		if (!Glib::file_test (fullpath, Glib::FILE_TEST_EXISTS)) {
 			/* Try fade file */
 			fullpath = Glib::build_filename (Glib::path_get_dirname (ptf.path ()), "Fade Files");
 			fullpath = Glib::build_filename (fullpath, w->filename);
-			if (Glib::file_test (fullpath, Glib::FILE_TEST_EXISTS)) {
-				just_one_src.clear();
-				ok = import_sndfile_as_region (fullpath, SrcBest, pos, just_one_src, status);
-			} else {
-				onefailed = true;
-
-				/* ptformat knows length of sources *in PT sample rate*
-				 * BUT if ardour user later resolves missing file,
-				 * it won't be resampled, so we can only do this
-				 * when sample rates are matching
-				 */
-				if (sample_rate () == ptf.sessionrate ()) {
-					/* Insert reference to missing source */
-					samplecnt_t sourcelen = w->length;
-					XMLNode srcxml (X_("Source"));
-					srcxml.set_property ("name", w->filename);
-					srcxml.set_property ("type", "audio");
-					srcxml.set_property ("id", PBD::ID ().to_s ());
-					boost::shared_ptr<Source> source = SourceFactory::createSilent (*this, srcxml, sourcelen, sample_rate ());
-					p.index1 = w->index;
-					p.id = source->id ();
-					ptfwavpair.push_back (p);
-					imported.push_back (source);
-					warning << string_compose (_("PT Import : MISSING `%1`, inserting ref to missing source"), fullpath) << endmsg;
-				} else {
-					warning << string_compose (_("PT Import : MISSING `%1`, please check Audio Files"), fullpath) << endmsg;
-				}
-			}
 		}
-		if (ok) {
-			p.index1 = w->index;
-			p.id = just_one_src.back ()->id ();
+		if (Glib::file_test (fullpath, Glib::FILE_TEST_EXISTS)) {
+			paths.push_back (fullpath);
+			path_wav.push_back (w->index);
+			continue;
+		}
+
+		onefailed = true;
+
+		/* ptformat knows length of sources *in PT sample rate*
+		 * BUT if ardour user later resolves missing file,
+		 * it won't be resampled, so we can only do this
+		 * when sample rates are matching
+		 */
+		if (sample_rate () == ptf.sessionrate ()) {
+			/* Insert reference to missing source */
+			samplecnt_t sourcelen = w->length;
+			XMLNode srcxml (X_("Source"));
+			srcxml.set_property ("name", w->filename);
+			srcxml.set_property ("type", "audio");
+			srcxml.set_property ("id", PBD::ID ().to_s ());
+			boost::shared_ptr<Source> source = SourceFactory::createSilent (*this, srcxml, sourcelen, sample_rate ());
+			wav_sources[w->index] = source;
+			imported.push_back (source);
+			warning << string_compose (_("PT Import : MISSING `%1`, inserting ref to missing source"), fullpath) << endmsg;
+		} else {
+			warning << string_compose (_("PT Import : MISSING `%1`, please check Audio Files"), fullpath) << endmsg;
+		}
+	}
+
+	/* Import all files at once, import_files() processes them in parallel.
+	 * Files that fail to import are skipped and reported.
+	 */
+	status.paths = paths;
+	status.current = 1;
+	status.total = paths.size ();
+	status.freeze = false;
+	status.quality = SrcBest;
+	status.replace_existing_source = false;
+	status.split_midi_channels = false;
+	status.skip_failed_paths = true;
+	status.done = false;
+	status.cancel = false;
 
-			ptfwavpair.push_back (p);
-			imported.push_back (just_one_src.back ());
+	if (!paths.empty ()) {
+		import_files (status);
+	}
+
+	for (vector<string>::const_iterator f = status.failed_paths.begin (); f != status.failed_paths.end (); ++f) {
+		warning << string_compose (_("PT Import : failed to import `%1`"), *f) << endmsg;
+		onefailed = true;
+	}
+
+	if (!status.cancel) {
+		for (size_t n = 0; n < status.sources_by_path.size (); ++n) {
+			if (status.sources_by_path[n].empty ()) {
+				continue;
+			}
+			boost::shared_ptr<Source> src = status.sources_by_path[n].front ();
+			wav_sources[path_wav[n]] = src;
+			imported.push_back (src);
+
+			/* add a whole-file region for the source, peaks were
+			 * already written during import */
+			string region_name = region_name_from_path (paths[n], false, false);
+			while (RegionFactory::region_by_name (region_name)) {
+				region_name = bump_name_once (region_name, '.');
+			}
+
+			PropertyList plist;
+			plist.add (ARDOUR::Properties::start, 0);
+			plist.add (ARDOUR::Properties::length, src->length (0));
+			plist.add (ARDOUR::Properties::name, region_name);
+			plist.add (ARDOUR::Properties::layer, 0);
+			plist.add (ARDOUR::Properties::whole_file, true);
+			plist.add (ARDOUR::Properties::external, true);
+
+			just_one_src.clear ();
+			just_one_src.push_back (src);
+			RegionFactory::create (just_one_src, plist);
 		}
 	}
 
+	t_audio = g_get_monotonic_time () - t_start;
+
 	if (imported.empty ()) {
 		error << _("Failed to find any audio for PT import") << endmsg;
 		goto trymidi;
@@ -271,102 +301,81 @@ Session::import_pt (PTFFormat& ptf, ImportStatus& status)
 
 	for (vector<PTFFormat::region_t>::const_iterator a = ptf.regions ().begin ();
 			a != ptf.regions ().end (); ++a) {
-		for (vector<ptflookup_t>::iterator p = ptfwavpair.begin ();
-				p != ptfwavpair.end (); ++p) {
-			if ((p->index1 == a->wave.index) && (strcmp (a->wave.filename.c_str (), "") != 0)) {
-				for (SourceList::iterator x = imported.begin (); x != imported.end (); ++x) {
-					if ((*x)->id () == p->id) {
-						/* Matched an uncreated ptf region to ardour region */
-						ptflookup_t rp;
-						PropertyList plist;
-
-						plist.add (ARDOUR::Properties::start, a->sampleoffset);
-						plist.add (ARDOUR::Properties::position, 0);
-						plist.add (ARDOUR::Properties::length, a->length);
-						plist.add (ARDOUR::Properties::name, a->name);
-						plist.add (ARDOUR::Properties::layer, 0);
-						plist.add (ARDOUR::Properties::whole_file, false);
-						plist.add (ARDOUR::Properties::external, true);
-
-						just_one_src.clear ();
-						just_one_src.push_back (*x);
-
-						boost::shared_ptr<Region> r = RegionFactory::create (just_one_src, plist);
-						regions.push_back (r);
-
-						rp.id = regions.back ()->id ();
-						rp.index1 = a->index;
-						ptfregpair.push_back (rp);
-					}
-				}
-			}
+		if (a->wave.filename.empty ()) {
+			continue;
+		}
+		map<uint16_t, boost::shared_ptr<Source> >::const_iterator x = wav_sources.find (a->wave.index);
+		if (x == wav_sources.end ()) {
+			continue;
 		}
+
+		/* Matched an uncreated ptf region to ardour region */
+		PropertyList plist;
+
+		plist.add (ARDOUR::Properties::start, a->sampleoffset);
+		plist.add (ARDOUR::Properties::position, 0);
+		plist.add (ARDOUR::Properties::length, a->length);
+		plist.add (ARDOUR::Properties::name, a->name);
+		plist.add (ARDOUR::Properties::layer, 0);
+		plist.add (ARDOUR::Properties::whole_file, false);
+		plist.add (ARDOUR::Properties::external, true);
+
+		just_one_src.clear ();
+		just_one_src.push_back (x->second);
+
+		pt_regions[a->index].push_back (RegionFactory::create (just_one_src, plist));
+		++n_regions;
 	}
 
+	t_regions = g_get_monotonic_time () - t_start - t_audio;
+
 	for (vector<PTFFormat::track_t>::const_iterator a = ptf.tracks ().begin (); a != ptf.tracks ().end (); ++a) {
-		for (vector<ptflookup_t>::iterator p = ptfregpair.begin ();
-				p != ptfregpair.end (); ++p) {
-
-			if (p->index1 == a->reg.index)  {
-
-				/* Matched a ptf active region to an ardour region */
-				utr.index1 = a->index;
-				utr.index2 = nth;
-				utr.id = p->id;
-				boost::shared_ptr<Region> r = RegionFactory::region_by_id (p->id);
-				vector<ptflookup_t>::iterator lookuptr = usedtracks.begin ();
-				vector<ptflookup_t>::iterator found;
-				if ((found = std::find (lookuptr, usedtracks.end (), utr)) != usedtracks.end ()) {
-					DEBUG_TRACE (DEBUG::FileUtils, string_compose ("\twav(%1) reg(%2) ptf_tr(%3) ard_tr(%4)\n", a->reg.wave.filename.c_str (), a->reg.index, found->index1, found->index2));
-
-					/* Use existing track if possible */
-					existing_track = get_nth_audio_track (found->index2 + 1);
-					if (!existing_track) {
-						list<boost::shared_ptr<AudioTrack> > at (new_audio_track (1, 2, 0, 1, "", PresentationInfo::max_order, Normal));
-						if (at.empty ()) {
-							return;
-						}
-						existing_track = at.back ();
-					}
-					/* Put on existing track */
-					boost::shared_ptr<Playlist> playlist = existing_track->playlist ();
-					boost::shared_ptr<Region> copy (RegionFactory::create (r, true));
-					playlist->clear_changes ();
-					playlist->add_region (copy, a->reg.startpos);
-					//add_command (new StatefulDiffCommand (playlist));
-				} else {
-					/* Put on a new track */
-					DEBUG_TRACE (DEBUG::FileUtils, string_compose ("\twav(%1) reg(%2) new_tr(%3)\n", a->reg.wave.filename.c_str (), a->reg.index, nth));
-					list<boost::shared_ptr<AudioTrack> > at (new_audio_track (1, 2, 0, 1, "", PresentationInfo::max_order, Normal));
-					if (at.empty ()) {
-						return;
-					}
-					existing_track = at.back ();
-					std::string trackname;
-					try {
-						trackname = Glib::convert_with_fallback (a->name, "UTF-8", "UTF-8", "_");
-					} catch (Glib::ConvertError& err) {
-						trackname = string_compose ("Invalid %1", a->index);
-					}
-					/* generate a unique name by adding a number if needed */
-					uint32_t id = 0;
-					if (!find_route_name (trackname.c_str (), id, trackname, false)) {
-						fatal << _("PTImport: failed to generate unique Track ID!") << endmsg;
-						abort(); /*NOTREACHED*/
-					}
-					existing_track->set_name (trackname);
-					boost::shared_ptr<Playlist> playlist = existing_track->playlist();
-					boost::shared_ptr<Region> copy (RegionFactory::create (r, true));
-					playlist->clear_changes ();
-					playlist->add_region (copy, a->reg.startpos);
-					//add_command (new StatefulDiffCommand (playlist));
-					nth++;
+		map<uint16_t, vector<boost::shared_ptr<Region> > >::const_iterator p = pt_regions.find (a->reg.index);
+		if (p == pt_regions.end ()) {
+			continue;
+		}
+
+		for (vector<boost::shared_ptr<Region> >::const_iterator r = p->second.begin (); r != p->second.end (); ++r) {
+
+			/* Matched a ptf active region to an ardour region */
+			boost::shared_ptr<AudioTrack>& existing_track (used_tracks[a->index]);
+
+			if (existing_track) {
+				/* Use existing track */
+				DEBUG_TRACE (DEBUG::FileUtils, string_compose ("\twav(%1) reg(%2) ptf_tr(%3) ard_tr(%4)\n", a->reg.wave.filename.c_str (), a->reg.index, a->index, existing_track->name ()));
+			} else {
+				/* Put on a new track */
+				DEBUG_TRACE (DEBUG::FileUtils, string_compose ("\twav(%1) reg(%2) new_tr(%3)\n", a->reg.wave.filename.c_str (), a->reg.index, used_tracks.size () - 1));
+				list<boost::shared_ptr<AudioTrack> > at (new_audio_track (1, 2, 0, 1, "", PresentationInfo::max_order, Normal));
+				if (at.empty ()) {
+					return;
+				}
+				existing_track = at.back ();
+				std::string trackname;
+				try {
+					trackname = Glib::convert_with_fallback (a->name, "UTF-8", "UTF-8", "_");
+				} catch (Glib::ConvertError& err) {
+					trackname = string_compose ("Invalid %1", a->index);
+				}
+				/* generate a unique name by adding a number if needed */
+				uint32_t id = 0;
+				if (!find_route_name (trackname.c_str (), id, trackname, false)) {
+					fatal << _("PTImport: failed to generate unique Track ID!") << endmsg;
+					abort(); /*NOTREACHED*/
 				}
-				usedtracks.push_back (utr);
+				existing_track->set_name (trackname);
 			}
+
+			boost::shared_ptr<Playlist> playlist = existing_track->playlist ();
+			boost::shared_ptr<Region> copy (RegionFactory::create (*r, true));
+			playlist->clear_changes ();
+			playlist->add_region (copy, a->reg.startpos);
+			//add_command (new StatefulDiffCommand (playlist));
 		}
 	}
 
+	t_tracks = g_get_monotonic_time () - t_start - t_audio - t_regions;
+
 trymidi:
 	status.paths.clear();
 	status.paths.push_back(ptf.path ());
@@ -398,7 +407,6 @@ trymidi:
 	std::map <int, boost::shared_ptr<MidiTrack> > midi_tracks;
 	/* MIDI - Create unique midi tracks and a lookup table for used tracks */
 	for (vector<midipair>::iterator a = uniquetr.begin (); a != uniquetr.end (); ++a) {
-		ptflookup_t miditr;
 		list<boost::shared_ptr<MidiTrack> > mt (new_midi_track (
 				ChanCount (DataType::MIDI, 1),
 				ChanCount (DataType::MIDI, 1),
@@ -451,6 +459,12 @@ trymidi:
 		playlist->add_region (copy, f);
 	}
 
+	info << string_compose (_("PT Import: %1 audio files: %2 ms, %3 regions: %4 ms, %5 tracks: %6 ms, %7 MIDI tracks: %8 ms"),
+	                        imported.size (), t_audio / 1000, n_regions, t_regions / 1000,
+	                        used_tracks.size (), t_tracks / 1000,
+	                        midi_tracks.size (), (g_get_monotonic_time () - t_start - t_audio - t_regions - t_tracks) / 1000)
+	     << endmsg;
+
 	status.progress = 1.0;
 	status.done = true;
 	status.sources.clear ();
@@ -19,21 +19,35 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <glibmm/miscutils.h>
 #include <glibmm/threads.h>
 
+#include "ardour/buffer_manager.h"
 #include "ardour/internal_return.h"
 #include "ardour/internal_send.h"
+#include "ardour/process_thread.h"
 #include "ardour/route.h"
+#include "ardour/session.h"
 
 using namespace std;
 using namespace ARDOUR;
 
 InternalReturn::InternalReturn (Session& s)
 	: Return (s, true)
+	, _sends (new SendList)
+	, _in_run (0)
+	, _partials (BufferManager::thread_buffer_count (), (PartialMix*) 0)
 {
 	_display_to_user = false;
 }
 
+InternalReturn::~InternalReturn ()
+{
+	for (vector<PartialMix*>::const_iterator i = _partials.begin (); i != _partials.end (); ++i) {
+		delete *i;
+	}
+}
+
 void
 InternalReturn::run (BufferSet& bufs, samplepos_t /*start_sample*/, samplepos_t /*end_sample*/, double /*speed*/, pframes_t nframes, bool)
 {
@@ -42,31 +56,96 @@ InternalReturn::run (BufferSet& bufs, samplepos_t /*start_sample*/, samplepos_t
 	}
 	_active = _pending_active;
 
-	Glib::Threads::Mutex::Lock lm (_sends_mutex, Glib::Threads::TRY_LOCK);
+	g_atomic_int_set (&_in_run, 1);
 
-	if (!lm.locked ()) {
-		return;
-	}
+	uint32_t const pass = _session.process_pass ();
 
-	for (list<InternalSend*>::iterator i = _sends.begin(); i != _sends.end(); ++i) {
+	/* sends of upstream routes have already added their output
+	 * to the partial mixes. Collect the remaining ones (feedback,
+	 * or sends that could not accumulate) directly.
+	 */
+	boost::shared_ptr<SendList> sends = _sends.reader ();
+	for (SendList::const_iterator i = sends->begin(); i != sends->end(); ++i) {
+		if ((*i)->summed (pass)) {
+			continue;
+		}
 		if ((*i)->active () && (!(*i)->source_route() || (*i)->source_route()->active())) {
 			bufs.merge_from ((*i)->get_buffers(), nframes);
 		}
 	}
+
+	for (size_t n = 0; n < _partials.size (); ++n) {
+		PartialMix* pm = (PartialMix*) g_atomic_pointer_get (&_partials[n]);
+		if (pm && pm->pass == pass) {
+			bufs.merge_from (pm->bufs, nframes);
+		}
+	}
+
+	g_atomic_int_set (&_in_run, 0);
+}
+
+bool
+InternalReturn::accumulate (BufferSet const& bufs, pframes_t nframes)
+{
+	int const id = ProcessThread::thread_buffers_id ();
+	if (id < 0 || id >= (int) _partials.size ()) {
+		return false;
+	}
+
+	PartialMix* pm = (PartialMix*) g_atomic_pointer_get (&_partials[id]);
+	if (!pm || !(pm->bufs.available () >= bufs.count ())) {
+		return false;
+	}
+
+	/* only the thread with the given id writes to this partial,
+	 * and the first send of each cycle replaces previous data */
+	uint32_t const pass = _session.process_pass ();
+	if (pm->pass != pass) {
+		pm->bufs.read_from (bufs, nframes);
+		pm->pass = pass;
+	} else {
+		pm->bufs.merge_from (bufs, nframes);
+	}
+	return true;
+}
+
+void
+InternalReturn::allocate_partials ()
+{
+	for (size_t n = 0; n < _partials.size (); ++n) {
+		if (_partials[n]) {
+			continue;
+		}
+		PartialMix* pm = new PartialMix;
+		pm->bufs.ensure_buffers (input_streams (), _session.get_block_size ());
+		g_atomic_pointer_set (&_partials[n], pm);
+	}
 }
 
 void
 InternalReturn::add_send (InternalSend* send)
 {
-	Glib::Threads::Mutex::Lock lm (_sends_mutex);
-	_sends.push_back (send);
+	allocate_partials ();
+
+	RCUWriter<SendList> writer (_sends);
+	boost::shared_ptr<SendList> s = writer.get_copy ();
+	s->push_back (send);
 }
 
 void
 InternalReturn::remove_send (InternalSend* send)
 {
-	Glib::Threads::Mutex::Lock lm (_sends_mutex);
-	_sends.remove (send);
+	{
+		RCUWriter<SendList> writer (_sends);
+		boost::shared_ptr<SendList> s = writer.get_copy ();
+		s->remove (send);
+	}
+
+	/* the send is about to be destroyed, and the process thread
+	 * may still be iterating over the previous list */
+	while (g_atomic_int_get (&_in_run)) {
+		Glib::usleep (100);
+	}
 }
 
 void
@@ -74,8 +153,8 @@ InternalReturn::set_playback_offset (samplecnt_t cnt)
 {
 	Processor::set_playback_offset (cnt);
 
-	Glib::Threads::Mutex::Lock lm (_sends_mutex); // TODO reader lock
-	for (list<InternalSend*>::iterator i = _sends.begin(); i != _sends.end(); ++i) {
+	boost::shared_ptr<SendList> sends = _sends.reader ();
+	for (SendList::const_iterator i = sends->begin(); i != sends->end(); ++i) {
 		(*i)->set_delay_out (cnt);
 	}
 }
@@ -100,5 +179,23 @@ bool
 InternalReturn::configure_io (ChanCount in, ChanCount out)
 {
 	IOProcessor::configure_io (in, out);
+
+	/* called with the process lock held */
+	for (vector<PartialMix*>::const_iterator i = _partials.begin (); i != _partials.end (); ++i) {
+		if (*i) {
+			(*i)->bufs.ensure_buffers (in, _session.get_block_size ());
+		}
+	}
 	return true;
 }
+
+int
+InternalReturn::set_block_size (pframes_t nframes)
+{
+	for (vector<PartialMix*>::const_iterator i = _partials.begin (); i != _partials.end (); ++i) {
+		if (*i) {
+			(*i)->bufs.ensure_buffers (input_streams (), nframes);
+		}
+	}
+	return 0;
+}
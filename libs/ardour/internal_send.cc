@@ -59,6 +59,7 @@ InternalSend::InternalSend (Session&                      s,
 	: Send (s, p, mm, role, ignore_bitslot)
 	, _send_from (sendfrom)
 	, _allow_feedback (false)
+	, _summed_pass (0)
 {
 	if (sendto) {
 		if (use_target (sendto)) {
@@ -314,6 +315,10 @@ InternalSend::run (BufferSet& bufs, samplepos_t start_sample, samplepos_t end_sa
 		/* we were quiet last time, and we're still supposed to be quiet. */
 		_meter->reset ();
 		Amp::apply_simple_gain (mixbufs, nframes, GAIN_COEFF_ZERO);
+		if (_role == Listen || !_allow_feedback) {
+			/* nothing to add */
+			_summed_pass = _session.process_pass ();
+		}
 		goto out;
 	} else if (tgain != GAIN_COEFF_UNITY) {
 		/* target gain has not changed, but is not zero or unity */
@@ -327,6 +332,16 @@ InternalSend::run (BufferSet& bufs, samplepos_t start_sample, samplepos_t end_sa
 
 	_send_delay->run (mixbufs, start_sample, end_sample, speed, nframes, true);
 
+	/* The target is processed after this route (unless feedback is allowed),
+	 * add our output to its mix now, while the data is in this thread's cache.
+	 */
+	if (_pending_active && (_role == Listen || !_allow_feedback)) {
+		boost::shared_ptr<InternalReturn> ir = _send_to->internal_return ();
+		if (ir && ir->accumulate (mixbufs, nframes)) {
+			_summed_pass = _session.process_pass ();
+		}
+	}
+
 	/* consider metering */
 	if (_metering) {
 		if (_amp->gain_control ()->get_value () == GAIN_COEFF_ZERO) {
@@ -34,6 +34,7 @@
 
 #include "pbd/types_convert.h"
 #include "pbd/stl_delete.h"
+#include "pbd/unwind.h"
 #include "pbd/xml++.h"
 #include "pbd/enumwriter.h"
 
@@ -785,12 +786,21 @@ Location::set_scene_change (boost::shared_ptr<SceneChange>  sc)
 
 Locations::Locations (Session& s)
 	: SessionHandleRef (s)
+	, _index_dirty (1)
+	, _index_n_ranges (0)
+	, _auto_loop_location (0)
+	, _auto_punch_location (0)
+	, _session_range_location (0)
+	, _clock_origin_location (0)
+	, _ignore_changes (false)
 {
 	current_location = 0;
 }
 
 Locations::~Locations ()
 {
+	_location_connections.drop_connections ();
+
 	for (LocationList::iterator i = locations.begin(); i != locations.end(); ) {
 		LocationList::iterator tmp = i;
 		++tmp;
@@ -834,7 +844,6 @@ Locations::set_clock_origin (Location* loc, void *src)
 int
 Locations::next_available_name(string& result,string base)
 {
-	LocationList::iterator i;
 	string::size_type l;
 	int suffix;
 	char buf[32];
@@ -847,22 +856,29 @@ Locations::next_available_name(string& result,string base)
 	if (!base.empty()) {
 
 		/* find all existing names that match "base", and store
-		   the numeric part of them (if any) in the map "taken"
+		   the numeric part of them (if any) in the map "taken".
+		   Names are sorted, so all matches directly follow
+		   the lower bound of "base".
 		*/
 
-		for (i = locations.begin(); i != locations.end(); ++i) {
+		Glib::Threads::Mutex::Lock lm (lock);
+		ensure_index ();
 
-			const string& temp ((*i)->name());
+		for (std::multiset<string>::const_iterator i = _index_names.lower_bound (base); i != _index_names.end (); ++i) {
 
-			if (!temp.find (base,0)) {
-				/* grab what comes after the "base" as if it was
-				   a number, and assuming that works OK,
-				   store it in "taken" so that we know it
-				   has been used.
-				*/
-                                if ((suffix = atoi (temp.substr(l))) != 0) {
-					taken.insert (make_pair (suffix,true));
-				}
+			const string& temp (*i);
+
+			if (temp.compare (0, l, base) != 0) {
+				break;
+			}
+
+			/* grab what comes after the "base" as if it was
+			   a number, and assuming that works OK,
+			   store it in "taken" so that we know it
+			   has been used.
+			*/
+			if ((suffix = atoi (temp.substr(l).c_str ())) != 0) {
+				taken.insert (make_pair (suffix,true));
 			}
 		}
 	}
@@ -909,6 +925,9 @@ Locations::clear ()
 	{
 		Glib::Threads::Mutex::Lock lm (lock);
 
+		/* before deleting: realtime readers use the index without lock */
+		invalidate_index ();
+
 		for (LocationList::iterator i = locations.begin(); i != locations.end(); ) {
 
 			LocationList::iterator tmp = i;
@@ -936,6 +955,9 @@ Locations::clear_markers ()
 		Glib::Threads::Mutex::Lock lm (lock);
 		LocationList::iterator tmp;
 
+		/* before deleting: realtime readers use the index without lock */
+		invalidate_index ();
+
 		for (LocationList::iterator i = locations.begin(); i != locations.end(); ) {
 			tmp = i;
 			++tmp;
@@ -959,6 +981,9 @@ Locations::clear_ranges ()
 		Glib::Threads::Mutex::Lock lm (lock);
 		LocationList::iterator tmp;
 
+		/* before deleting: realtime readers use the index without lock */
+		invalidate_index ();
+
 		for (LocationList::iterator i = locations.begin(); i != locations.end(); ) {
 
 			tmp = i;
@@ -999,12 +1024,15 @@ Locations::add (Location *loc, bool make_current)
 	{
 		Glib::Threads::Mutex::Lock lm (lock);
 		locations.push_back (loc);
+		invalidate_index ();
 
 		if (make_current) {
 			current_location = loc;
 		}
 	}
 
+	listen_to (loc);
+
 	added (loc); /* EMIT SIGNAL */
 
 	if (make_current) {
@@ -1043,6 +1071,7 @@ Locations::remove (Location *loc)
 					 * disconnect signals, clear events */
 					_session.set_auto_punch_location (0);
 				}
+				invalidate_index ();
 				delete *i;
 				locations.erase (i);
 				was_removed = true;
@@ -1098,6 +1127,9 @@ Locations::set_state (const XMLNode& node, int version)
 	/* build up a new locations list in here */
 	LocationList new_locations;
 
+	/* Location::set_state() emits change signals while the lock is held */
+	PBD::Unwinder<bool> uw (_ignore_changes, true);
+
 	current_location = 0;
 
 	Location* session_range_location = 0;
@@ -1173,6 +1205,9 @@ Locations::set_state (const XMLNode& node, int version)
 			}
 		}
 
+		/* before deleting: realtime readers use the index without lock */
+		invalidate_index ();
+
 		/* We may have some unused locations in the old list. */
 		for (LocationList::iterator i = locations.begin(); i != locations.end(); ) {
 			LocationList::iterator tmp = i;
@@ -1206,56 +1241,154 @@ Locations::set_state (const XMLNode& node, int version)
 		}
 	}
 
+	_location_connections.drop_connections ();
+	for (LocationList::const_iterator i = locations.begin(); i != locations.end(); ++i) {
+		listen_to (*i);
+	}
+
 	changed (); /* EMIT SIGNAL */
 
 	return 0;
 }
 
 
-typedef std::pair<samplepos_t,Location*> LocationPair;
+void
+Locations::listen_to (Location* loc)
+{
+	loc->Changed.connect_same_thread (_location_connections, boost::bind (&Locations::location_changed, this, loc));
+	loc->StartChanged.connect_same_thread (_location_connections, boost::bind (&Locations::location_changed, this, loc));
+	loc->EndChanged.connect_same_thread (_location_connections, boost::bind (&Locations::location_changed, this, loc));
+	loc->FlagsChanged.connect_same_thread (_location_connections, boost::bind (&Locations::location_changed, this, loc));
+	loc->NameChanged.connect_same_thread (_location_connections, boost::bind (&Locations::location_changed, this, loc));
+}
+
+void
+Locations::location_changed (Location* loc)
+{
+	/* this may be called with the lock held (Location::set_state),
+	 * defer re-indexing until the next query.
+	 */
+	invalidate_index ();
+
+	if (!_ignore_changes) {
+		modified (loc); /* EMIT SIGNAL */
+	}
+}
 
-struct LocationStartEarlierComparison
+struct LocationPairSorter
 {
-	bool operator() (LocationPair a, LocationPair b) {
+	bool operator() (std::pair<samplepos_t, Location*> const& a, std::pair<samplepos_t, Location*> const& b) const {
 		return a.first < b.first;
 	}
 };
 
-struct LocationStartLaterComparison
+struct LocationStartSorter
 {
-	bool operator() (LocationPair a, LocationPair b) {
-		return a.first > b.first;
+	bool operator() (Location const* a, Location const* b) const {
+		return a->start() < b->start();
+	}
+	bool operator() (Location const* a, samplepos_t b) const {
+		return a->start() < b;
+	}
+	bool operator() (samplepos_t a, Location const* b) const {
+		return a < b->start();
 	}
 };
 
-samplepos_t
-Locations::first_mark_before (samplepos_t sample, bool include_special_ranges)
+/** (re)build the sorted lookup tables, must be called with the lock held */
+void
+Locations::ensure_index () const
 {
-	Glib::Threads::Mutex::Lock lm (lock);
-	vector<LocationPair> locs;
+	if (index_valid ()) {
+		return;
+	}
 
-	for (LocationList::iterator i = locations.begin(); i != locations.end(); ++i) {
-		locs.push_back (make_pair ((*i)->start(), (*i)));
-		if (!(*i)->is_mark()) {
-			locs.push_back (make_pair ((*i)->end(), (*i)));
+	/* a concurrent change while rebuilding bumps the counter,
+	 * and leaves the index dirty for the next query.
+	 */
+	const gint dirty = g_atomic_int_get (&_index_dirty);
+
+	_index_positions.clear ();
+	_index_marks.clear ();
+	_index_by_start.clear ();
+	_index_ids.clear ();
+	_index_names.clear ();
+	_index_n_ranges = 0;
+
+	/* realtime readers use the special locations without taking the lock,
+	 * as long as the index is valid. Find them first, and publish them
+	 * before the index is marked valid.
+	 */
+	Location* auto_loop     = 0;
+	Location* auto_punch    = 0;
+	Location* session_range = 0;
+	Location* clock_origin  = 0;
+
+	_index_positions.reserve (2 * locations.size ());
+	_index_by_start.reserve (locations.size ());
+
+	for (LocationList::const_iterator i = locations.begin(); i != locations.end(); ++i) {
+		Location* l = *i;
+
+		_index_by_start.push_back (l);
+		_index_ids[l->id ()] = l;
+		_index_names.insert (l->name ());
+
+		if (l->is_mark ()) {
+			_index_marks.push_back (make_pair (l->start (), l));
+		}
+		if (!l->is_hidden ()) {
+			_index_positions.push_back (make_pair (l->start (), l));
+			if (!l->is_mark ()) {
+				_index_positions.push_back (make_pair (l->end (), l));
+			}
+		}
+
+		if (l->is_range_marker ()) {
+			++_index_n_ranges;
+		}
+		if (!auto_loop && l->is_auto_loop ()) {
+			auto_loop = l;
+		}
+		if (!auto_punch && l->is_auto_punch ()) {
+			auto_punch = l;
+		}
+		if (!session_range && l->is_session_range ()) {
+			session_range = l;
+		}
+		if (!clock_origin && l->is_clock_origin ()) {
+			clock_origin = l;
 		}
 	}
 
-	LocationStartLaterComparison cmp;
-	sort (locs.begin(), locs.end(), cmp);
+	/* stable: preserve list-order for locations at the same position */
+	std::stable_sort (_index_positions.begin (), _index_positions.end (), LocationPairSorter ());
+	std::stable_sort (_index_marks.begin (), _index_marks.end (), LocationPairSorter ());
+	std::stable_sort (_index_by_start.begin (), _index_by_start.end (), LocationStartSorter ());
 
-	/* locs is sorted in ascending order */
+	_auto_loop_location     = auto_loop;
+	_auto_punch_location    = auto_punch;
+	_session_range_location = session_range;
+	_clock_origin_location  = clock_origin;
 
-	for (vector<LocationPair>::iterator i = locs.begin(); i != locs.end(); ++i) {
-		if ((*i).second->is_hidden()) {
-			continue;
-		}
+	g_atomic_int_compare_and_exchange (&_index_dirty, dirty, 0);
+}
+
+samplepos_t
+Locations::first_mark_before (samplepos_t sample, bool include_special_ranges)
+{
+	Glib::Threads::Mutex::Lock lm (lock);
+	ensure_index ();
+
+	/* first position >= sample, walk backwards from there */
+	std::vector<LocationPair>::const_iterator i = std::lower_bound (_index_positions.begin (), _index_positions.end (), make_pair (sample, (Location*) 0), LocationPairSorter ());
+
+	while (i != _index_positions.begin ()) {
+		--i;
 		if (!include_special_ranges && ((*i).second->is_auto_loop() || (*i).second->is_auto_punch())) {
 			continue;
 		}
-		if ((*i).first < sample) {
-			return (*i).first;
-		}
+		return (*i).first;
 	}
 
 	return -1;
@@ -1265,34 +1398,30 @@ Location*
 Locations::mark_at (samplepos_t pos, samplecnt_t slop) const
 {
 	Glib::Threads::Mutex::Lock lm (lock);
+	ensure_index ();
+
 	Location* closest = 0;
 	sampleoffset_t mindelta = max_samplepos;
 	sampleoffset_t delta;
 
-	/* locations are not necessarily stored in linear time order so we have
-	 * to iterate across all of them to find the one closest to a give point.
-	 */
+	std::vector<LocationPair>::const_iterator i = std::lower_bound (_index_marks.begin (), _index_marks.end (), make_pair (pos > slop ? pos - slop : 0, (Location*) 0), LocationPairSorter ());
 
-	for (LocationList::const_iterator i = locations.begin(); i != locations.end(); ++i) {
+	for (; i != _index_marks.end () && (*i).first <= pos + slop; ++i) {
 
-		if ((*i)->is_mark()) {
-			if (pos > (*i)->start()) {
-				delta = pos - (*i)->start();
-			} else {
-				delta = (*i)->start() - pos;
-			}
+		if (pos > (*i).first) {
+			delta = pos - (*i).first;
+		} else {
+			delta = (*i).first - pos;
+		}
 
-			if (slop == 0 && delta == 0) {
-				/* special case: no slop, and direct hit for position */
-				return *i;
-			}
+		if (slop == 0 && delta == 0) {
+			/* special case: no slop, and direct hit for position */
+			return (*i).second;
+		}
 
-			if (delta <= slop) {
-				if (delta < mindelta) {
-					closest = *i;
-					mindelta = delta;
-				}
-			}
+		if (delta < mindelta) {
+			closest = (*i).second;
+			mindelta = delta;
 		}
 	}
 
@@ -1303,30 +1432,16 @@ samplepos_t
 Locations::first_mark_after (samplepos_t sample, bool include_special_ranges)
 {
 	Glib::Threads::Mutex::Lock lm (lock);
-	vector<LocationPair> locs;
+	ensure_index ();
 
-	for (LocationList::iterator i = locations.begin(); i != locations.end(); ++i) {
-		locs.push_back (make_pair ((*i)->start(), (*i)));
-		if (!(*i)->is_mark()) {
-			locs.push_back (make_pair ((*i)->end(), (*i)));
-		}
-	}
-
-	LocationStartEarlierComparison cmp;
-	sort (locs.begin(), locs.end(), cmp);
+	/* first position > sample */
+	std::vector<LocationPair>::const_iterator i = std::upper_bound (_index_positions.begin (), _index_positions.end (), make_pair (sample, (Location*) 0), LocationPairSorter ());
 
-	/* locs is sorted in reverse order */
-
-	for (vector<LocationPair>::iterator i = locs.begin(); i != locs.end(); ++i) {
-		if ((*i).second->is_hidden()) {
-			continue;
-		}
+	for (; i != _index_positions.end (); ++i) {
 		if (!include_special_ranges && ((*i).second->is_auto_loop() || (*i).second->is_auto_punch())) {
 			continue;
 		}
-		if ((*i).first > sample) {
-			return (*i).first;
-		}
+		return (*i).first;
 	}
 
 	return -1;
@@ -1344,69 +1459,40 @@ Locations::marks_either_side (samplepos_t const sample, samplepos_t& before, sam
 {
 	before = after = max_samplepos;
 
-	LocationList locs;
-
-	{
-		Glib::Threads::Mutex::Lock lm (lock);
-		locs = locations;
-	}
+	Glib::Threads::Mutex::Lock lm (lock);
+	ensure_index ();
 
-	/* Get a list of positions; don't store any that are exactly on our requested position */
+	/* positions exactly on our requested position are ignored */
 
-	std::list<samplepos_t> positions;
+	std::vector<LocationPair>::const_iterator i = std::upper_bound (_index_positions.begin (), _index_positions.end (), make_pair (sample, (Location*) 0), LocationPairSorter ());
 
-	for (LocationList::const_iterator i = locs.begin(); i != locs.end(); ++i) {
-		if (((*i)->is_auto_loop() || (*i)->is_auto_punch())) {
+	for (std::vector<LocationPair>::const_iterator a = i; a != _index_positions.end (); ++a) {
+		if ((*a).second->is_auto_loop() || (*a).second->is_auto_punch()) {
 			continue;
 		}
-
-		if (!(*i)->is_hidden()) {
-			if ((*i)->is_mark ()) {
-				if ((*i)->start() != sample) {
-					positions.push_back ((*i)->start ());
-				}
-			} else {
-				if ((*i)->start() != sample) {
-					positions.push_back ((*i)->start ());
-				}
-				if ((*i)->end() != sample) {
-					positions.push_back ((*i)->end ());
-				}
-			}
-		}
-	}
-
-	if (positions.empty ()) {
-		return;
-	}
-
-	positions.sort ();
-
-	std::list<samplepos_t>::iterator i = positions.begin ();
-	while (i != positions.end () && *i < sample) {
-		++i;
+		after = (*a).first;
+		break;
 	}
 
-	if (i == positions.end ()) {
-		/* run out of marks */
-		before = positions.back ();
-		return;
-	}
+	std::vector<LocationPair>::const_iterator b = std::lower_bound (_index_positions.begin (), i, make_pair (sample, (Location*) 0), LocationPairSorter ());
 
-	after = *i;
-
-	if (i == positions.begin ()) {
-		/* none before */
-		return;
+	while (b != _index_positions.begin ()) {
+		--b;
+		if ((*b).second->is_auto_loop() || (*b).second->is_auto_punch()) {
+			continue;
+		}
+		before = (*b).first;
+		break;
 	}
-
-	--i;
-	before = *i;
 }
 
 Location*
 Locations::session_range_location () const
 {
+	/* this is called from realtime context, only use the index if it is up-to-date */
+	if (index_valid ()) {
+		return _session_range_location;
+	}
 	for (LocationList::const_iterator i = locations.begin(); i != locations.end(); ++i) {
 		if ((*i)->is_session_range()) {
 			return const_cast<Location*> (*i);
@@ -1418,6 +1504,10 @@ Locations::session_range_location () const
 Location*
 Locations::auto_loop_location () const
 {
+	/* this is called from realtime context, only use the index if it is up-to-date */
+	if (index_valid ()) {
+		return _auto_loop_location;
+	}
 	for (LocationList::const_iterator i = locations.begin(); i != locations.end(); ++i) {
 		if ((*i)->is_auto_loop()) {
 			return const_cast<Location*> (*i);
@@ -1429,6 +1519,10 @@ Locations::auto_loop_location () const
 Location*
 Locations::auto_punch_location () const
 {
+	/* this is called from realtime context, only use the index if it is up-to-date */
+	if (index_valid ()) {
+		return _auto_punch_location;
+	}
 	for (LocationList::const_iterator i = locations.begin(); i != locations.end(); ++i) {
 		if ((*i)->is_auto_punch()) {
 			return const_cast<Location*> (*i);
@@ -1440,6 +1534,9 @@ Locations::auto_punch_location () const
 Location*
 Locations::clock_origin_location () const
 {
+	if (index_valid ()) {
+		return _clock_origin_location ? _clock_origin_location : _session_range_location;
+	}
 	for (LocationList::const_iterator i = locations.begin(); i != locations.end(); ++i) {
 		if ((*i)->is_clock_origin()) {
 			return const_cast<Location*> (*i);
@@ -1451,24 +1548,21 @@ Locations::clock_origin_location () const
 uint32_t
 Locations::num_range_markers () const
 {
-	uint32_t cnt = 0;
 	Glib::Threads::Mutex::Lock lm (lock);
-	for (LocationList::const_iterator i = locations.begin(); i != locations.end(); ++i) {
-		if ((*i)->is_range_marker()) {
-			++cnt;
-		}
-	}
-	return cnt;
+	ensure_index ();
+	return _index_n_ranges;
 }
 
 Location *
 Locations::get_location_by_id(PBD::ID id)
 {
-	LocationList::iterator it;
-	for (it  = locations.begin(); it != locations.end(); ++it)
-		if (id == (*it)->id())
-			return *it;
+	Glib::Threads::Mutex::Lock lm (lock);
+	ensure_index ();
 
+	std::map<PBD::ID, Location*>::const_iterator i = _index_ids.find (id);
+	if (i != _index_ids.end ()) {
+		return i->second;
+	}
 	return 0;
 }
 
@@ -1476,11 +1570,14 @@ void
 Locations::find_all_between (samplepos_t start, samplepos_t end, LocationList& ll, Location::Flags flags)
 {
 	Glib::Threads::Mutex::Lock lm (lock);
+	ensure_index ();
 
-	for (LocationList::const_iterator i = locations.begin(); i != locations.end(); ++i) {
-		if ((flags == 0 || (*i)->matches (flags)) &&
-		    ((*i)->start() >= start && (*i)->end() < end)) {
+	std::vector<Location*>::const_iterator i = std::lower_bound (_index_by_start.begin (), _index_by_start.end (), start, LocationStartSorter ());
+
+	for (; i != _index_by_start.end () && (*i)->start() < end; ++i) {
+		if ((flags == 0 || (*i)->matches (flags)) && (*i)->end() < end) {
 			ll.push_back (*i);
 		}
 	}
 }
+
@@ -46,6 +46,7 @@
 #include "ardour/beats_samples_converter.h"
 #include "ardour/chan_mapping.h"
 #include "ardour/convolver.h"
+#include "ardour/cycle_trace.h"
 #include "ardour/dB.h"
 #include "ardour/delayline.h"
 #include "ardour/disk_reader.h"
@@ -2259,6 +2260,12 @@ LuaBindings::common (lua_State* L)
 		.beginNamespace ("ARDOUR")
 		.addFunction ("user_config_directory", &ARDOUR::user_config_directory)
 		.addFunction ("user_cache_directory", &ARDOUR::user_cache_directory)
+		.beginNamespace ("CycleTrace")
+		.addFunction ("set_enabled", &CycleTrace::set_enabled)
+		.addFunction ("enabled", &CycleTrace::enabled)
+		.addFunction ("summary", &CycleTrace::summary)
+		.addFunction ("write_chrome_trace", (bool (*)(std::string const&)) &CycleTrace::write_chrome_trace)
+		.endNamespace ()
 		.endNamespace (); // end ARDOUR
 
 	luabridge::getGlobalNamespace (L)
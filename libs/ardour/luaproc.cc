@@ -19,14 +19,20 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
 #include <glib.h>
 #include <glibmm/miscutils.h>
 #include <glibmm/fileutils.h>
 
 #include "pbd/gstdio_compat.h"
 #include "pbd/pthread_utils.h"
+#include "pbd/semutils.h"
 
 #include "ardour/audio_buffer.h"
+#include "ardour/audioengine.h"
 #include "ardour/buffer_set.h"
 #include "ardour/filesystem_paths.h"
 #include "ardour/luabindings.h"
@@ -34,26 +40,97 @@
 #include "ardour/luascripting.h"
 #include "ardour/midi_buffer.h"
 #include "ardour/plugin.h"
+#include "ardour/rc_configuration.h"
+#include "ardour/search_paths.h"
 #include "ardour/session.h"
 
 #include "LuaBridge/LuaBridge.h"
 
+#include "sha1.c"
+
 #include "pbd/i18n.h"
 
 using namespace ARDOUR;
 using namespace PBD;
 
+/* Scripts are compiled once, instances share the bytecode */
+static Glib::Threads::Mutex                _bytecode_lock;
+static std::map<std::string, std::string> _bytecode_cache; // sha1 -> bytecode
+
+static int
+run_script (LuaState& lua, std::string const& script)
+{
+	char hash[41];
+	Sha1Digest s;
+	sha1_init (&s);
+	sha1_write (&s, (const uint8_t *) script.c_str(), script.size ());
+	sha1_result_hash (&s, hash);
+
+	std::string bytecode;
+	{
+		Glib::Threads::Mutex::Lock lm (_bytecode_lock);
+		std::map<std::string, std::string>::const_iterator i = _bytecode_cache.find (hash);
+		if (i != _bytecode_cache.end ()) {
+			bytecode = i->second;
+		}
+	}
+
+	if (bytecode.empty ()) {
+		int rv = lua.compile (script, bytecode);
+		if (rv) {
+			return rv;
+		}
+		Glib::Threads::Mutex::Lock lm (_bytecode_lock);
+		_bytecode_cache[hash] = bytecode;
+	}
+
+	return lua.do_bytecode (bytecode);
+}
+
+/* Garbage collection is performed by a background thread, which is
+ * woken up by the process thread after each dsp_run() call.
+ * The process thread never waits for it: if a collection step is still
+ * in progress when the next cycle starts, the instance is bypassed for
+ * that cycle.
+ */
+static Glib::Threads::Mutex   _gc_lock;        // protects _gc_instances
+static Glib::Threads::Mutex   _gc_thread_lock; // serializes thread start/stop
+static std::vector<LuaProc*>  _gc_instances;
+static size_t                 _gc_next = 0;
+static PBD::Semaphore         _gc_sem ("luaproc_gc", 0);
+static pthread_t              _gc_tid;
+static gint                   _gc_active = 0;
+static gint                   _gc_quit = 0;
+
+/* collect garbage in the process thread if less than 1/4 of the pool is free */
+static const size_t gc_rt_threshold = 4;
+
+static int
+stats_bin (int64_t usec)
+{
+	if (usec < 1) {
+		return 0;
+	}
+	return std::min (63, 1 + (int) floor (4.0 * log2 ((double) usec)));
+}
+
+static double
+stats_bin_limit (int bin)
+{
+	return bin == 0 ? 1.0 : pow (2.0, bin / 4.0);
+}
+
 LuaProc::LuaProc (AudioEngine& engine,
                   Session& session,
                   const std::string &script)
 	: Plugin (engine, session)
-	, _mempool ("LuaProc", 3145728)
-#ifdef USE_TLSF
-	, lua (lua_newstate (&PBD::TLSF::lalloc, &_mempool))
-#elif defined USE_MALLOC
+	, _mempool ("LuaProc", mempool_size)
+	, _mem_used (0)
+	, _mem_peak (0)
+#if defined USE_MALLOC && !defined USE_TLSF
 	, lua ()
 #else
-	, lua (lua_newstate (&PBD::ReallocPool::lalloc, &_mempool))
+	, lua (lua_newstate (&LuaProc::lalloc, this))
 #endif
 	, _lua_dsp (0)
 	, _lua_latency (0)
@@ -68,6 +145,8 @@ LuaProc::LuaProc (AudioEngine& engine,
 	, _configured (false)
 	, _has_midi_input (false)
 	, _has_midi_output (false)
+	, _gc_pending (0)
+	, _gc_running (0)
 {
 	init ();
 
@@ -75,19 +154,20 @@ LuaProc::LuaProc (AudioEngine& engine,
 	 * the script is set during set_state();
 	 */
 	if (!_script.empty () && load_script ()) {
+		gc_unregister (this);
 		throw failed_constructor ();
 	}
 }
 
 LuaProc::LuaProc (const LuaProc &other)
 	: Plugin (other)
-	, _mempool ("LuaProc", 3145728)
-#ifdef USE_TLSF
-	, lua (lua_newstate (&PBD::TLSF::lalloc, &_mempool))
-#elif defined USE_MALLOC
+	, _mempool ("LuaProc", mempool_size)
+	, _mem_used (0)
+	, _mem_peak (0)
+#if defined USE_MALLOC && !defined USE_TLSF
 	, lua ()
 #else
-	, lua (lua_newstate (&PBD::ReallocPool::lalloc, &_mempool))
+	, lua (lua_newstate (&LuaProc::lalloc, this))
 #endif
 	, _lua_dsp (0)
 	, _lua_latency (0)
@@ -102,10 +182,13 @@ LuaProc::LuaProc (const LuaProc &other)
 	, _configured (false)
 	, _has_midi_input (false)
 	, _has_midi_output (false)
+	, _gc_pending (0)
+	, _gc_running (0)
 {
 	init ();
 
 	if (load_script ()) {
+		gc_unregister (this);
 		throw failed_constructor ();
 	}
 
@@ -116,20 +199,8 @@ LuaProc::LuaProc (const LuaProc &other)
 }
 
 LuaProc::~LuaProc () {
-#ifdef WITH_LUAPROC_STATS
-	if (_info && _stats_cnt > 0) {
-		printf ("LuaProc: '%s' run()  avg: %.3f  max: %.3f [ms] p: %.1f\n",
-				_info->name.c_str (),
-				0.0001f * _stats_avg[0] / (float) _stats_cnt,
-				0.0001f * _stats_max[0],
-				_stats_max[0] * (float)_stats_cnt / _stats_avg[0]);
-		printf ("LuaProc: '%s' gc()   avg: %.3f  max: %.3f [ms] p: %.1f\n",
-				_info->name.c_str (),
-				0.0001f * _stats_avg[1] / (float) _stats_cnt,
-				0.0001f * _stats_max[1],
-				_stats_max[1] * (float)_stats_cnt / _stats_avg[1]);
-	}
-#endif
+	gc_unregister (this);
+	Glib::Threads::Mutex::Lock lm (_lua_lock);
 	lua.collect_garbage ();
 	delete (_lua_dsp);
 	delete (_lua_latency);
@@ -140,10 +211,10 @@ LuaProc::~LuaProc () {
 void
 LuaProc::init ()
 {
-#ifdef WITH_LUAPROC_STATS
-	_stats_avg[0] = _stats_avg[1] = _stats_max[0] = _stats_max[1] = 0;
-	_stats_cnt = -25;
-#endif
+	memset (_stats_hist, 0, sizeof (_stats_hist));
+	_stats_gc_max = _stats_gc_sum = 0;
+	_stats_gc_cnt = 0;
+	_stats_reset  = 0;
 
 	lua.Print.connect (sigc::mem_fun (*this, &LuaProc::lua_print));
 	// register session object
@@ -180,15 +251,200 @@ LuaProc::init ()
 	lua.do_command ("for n in pairs(_G) do print(n) end print ('----')"); // print global env
 #endif
 	lua.do_command ("function ardour () end");
+
+	gc_register (this);
 }
 
 void
 LuaProc::drop_references ()
 {
-	lua.collect_garbage ();
+	{
+		Glib::Threads::Mutex::Lock lm (_lua_lock);
+		lua.collect_garbage ();
+	}
 	Plugin::drop_references ();
 }
 
+void*
+LuaProc::lalloc (void* ud, void* ptr, size_t osize, size_t nsize)
+{
+	LuaProc* self = static_cast<LuaProc*> (ud);
+#ifdef USE_TLSF
+	void* rv = PBD::TLSF::lalloc (&self->_mempool, ptr, osize, nsize);
+#else
+	void* rv = PBD::ReallocPool::lalloc (&self->_mempool, ptr, osize, nsize);
+#endif
+	if (rv || nsize == 0) {
+		/* if ptr is NULL, osize encodes the type of object being allocated */
+		self->_mem_used += nsize - (ptr ? osize : 0);
+		self->_mem_peak  = std::max (self->_mem_peak, self->_mem_used);
+	}
+	return rv;
+}
+
+void
+LuaProc::gc_register (LuaProc* p)
+{
+	Glib::Threads::Mutex::Lock tl (_gc_thread_lock);
+	{
+		Glib::Threads::Mutex::Lock lm (_gc_lock);
+		_gc_instances.push_back (p);
+	}
+
+	if (g_atomic_int_get (&_gc_active)) {
+		return;
+	}
+
+	int rv = 1;
+	if (AudioEngine::instance()->is_realtime ()) {
+		/* just below the process threads */
+		rv = pbd_realtime_pthread_create (PBD_SCHED_FIFO, AudioEngine::instance()->client_real_time_priority() - 1, PBD_RT_STACKSIZE_PROC, &_gc_tid, gc_thread, NULL);
+	}
+	if (rv) {
+		rv = pbd_pthread_create (PBD_RT_STACKSIZE_PROC, &_gc_tid, gc_thread, NULL);
+	}
+	if (rv) {
+		/* process threads fall back to collect garbage themselves */
+		PBD::warning << _("Cannot create thread for Lua DSP garbage collection") << endmsg;
+		return;
+	}
+	g_atomic_int_set (&_gc_active, 1);
+}
+
+void
+LuaProc::gc_unregister (LuaProc* p)
+{
+	Glib::Threads::Mutex::Lock tl (_gc_thread_lock);
+	{
+		Glib::Threads::Mutex::Lock lm (_gc_lock);
+		std::vector<LuaProc*>::iterator i = std::find (_gc_instances.begin (), _gc_instances.end (), p);
+		if (i != _gc_instances.end ()) {
+			_gc_instances.erase (i);
+		}
+		if (!_gc_instances.empty ()) {
+			return;
+		}
+	}
+
+	if (!g_atomic_int_get (&_gc_active)) {
+		return;
+	}
+
+	g_atomic_int_set (&_gc_active, 0);
+	g_atomic_int_set (&_gc_quit, 1);
+	_gc_sem.signal ();
+	pthread_join (_gc_tid, NULL);
+	g_atomic_int_set (&_gc_quit, 0);
+	_gc_sem.reset ();
+}
+
+void*
+LuaProc::gc_thread (void*)
+{
+	pthread_set_name ("LuaProcGC");
+	while (true) {
+		_gc_sem.wait ();
+		if (g_atomic_int_get (&_gc_quit)) {
+			break;
+		}
+		/* one pass handles all pending instances */
+		_gc_sem.reset ();
+		gc_run ();
+	}
+	return 0;
+}
+
+void
+LuaProc::gc_run ()
+{
+	const int64_t deadline = g_get_monotonic_time () + Config->get_luaproc_gc_budget ();
+
+	Glib::Threads::Mutex::Lock lm (_gc_lock);
+	const size_t n = _gc_instances.size ();
+
+	/* round-robin, instances that are not handled before the deadline
+	 * are first in line at the next wakeup */
+	for (size_t k = 0; k < n; ++k) {
+		const size_t i = (_gc_next + k) % n;
+		LuaProc* p = _gc_instances[i];
+		if (!g_atomic_int_get (&p->_gc_pending)) {
+			continue;
+		}
+
+		int64_t t0 = g_get_monotonic_time ();
+		if (t0 > deadline) {
+			_gc_next = i;
+			return;
+		}
+
+		/* set while holding the lock, and a bit longer: a process
+		 * thread that finds the interpreter locked waits for this step,
+		 * see connect_and_run() */
+		g_atomic_int_set (&p->_gc_running, 1);
+		{
+			Glib::Threads::Mutex::Lock pl (p->_lua_lock);
+			p->lua.collect_garbage_step ();
+			p->record_gc_step (g_get_monotonic_time () - t0);
+			g_atomic_int_set (&p->_gc_pending, 0);
+		}
+		g_atomic_int_set (&p->_gc_running, 0);
+	}
+	_gc_next = 0;
+}
+
+void
+LuaProc::record_gc_step (int64_t elapsed)
+{
+	_stats_gc_max  = std::max (_stats_gc_max, elapsed);
+	_stats_gc_sum += elapsed;
+	++_stats_gc_cnt;
+}
+
+bool
+LuaProc::get_dsp_stats (DSPStats& s) const
+{
+	/* no lock, values written by the process thread are only approximate */
+	s = DSPStats ();
+	s.mem_used = _mem_used;
+	s.mem_peak = _mem_peak;
+	s.mem_size = mempool_size;
+
+	if (g_atomic_int_get (const_cast<gint*> (&_stats_reset))) {
+		return false;
+	}
+
+	for (int b = 0; b < stats_bins; ++b) {
+		s.n_cycles += _stats_hist[b];
+	}
+	if (s.n_cycles == 0) {
+		return false;
+	}
+
+	double* const pp[3] = { &s.p50, &s.p90, &s.p99 };
+	const double  pv[3] = { .50, .90, .99 };
+	uint64_t      acc   = 0;
+	int           k     = 0;
+
+	for (int b = 0; b < stats_bins && k < 3; ++b) {
+		acc += _stats_hist[b];
+		while (k < 3 && acc >= ceil (pv[k] * s.n_cycles)) {
+			*pp[k++] = stats_bin_limit (b);
+		}
+	}
+
+	if (_stats_gc_cnt > 0) {
+		s.gc_max = _stats_gc_max;
+		s.gc_avg = _stats_gc_sum / (double) _stats_gc_cnt;
+	}
+	return true;
+}
+
+void
+LuaProc::clear_dsp_stats ()
+{
+	g_atomic_int_set (&_stats_reset, 1);
+}
+
 boost::weak_ptr<Route>
 LuaProc::route () const
 {
@@ -234,8 +490,11 @@ LuaProc::load_script ()
 		return true;
 	}
 
+	Glib::Threads::Mutex::Lock lm (_lua_lock);
 	lua_State* L = lua.getState ();
-	lua.do_command (_script);
+	if (run_script (lua, _script)) {
+		return true;
+	}
 
 	// check if script has a DSP callback
 	luabridge::LuaRef lua_dsp_run = luabridge::getGlobal (L, "dsp_run");
@@ -402,6 +661,8 @@ LuaProc::match_variable_io (ChanCount& in, ChanCount& aux_in, ChanCount& out)
 	/* caller must hold process lock (no concurrent calls to interpreter */
 	_output_configs.clear ();
 
+	Glib::Threads::Mutex::Lock lm (_lua_lock);
+
 	lua_State* L = lua.getState ();
 	luabridge::LuaRef ioconfig = luabridge::getGlobal (L, "dsp_ioconfig");
 
@@ -581,6 +842,8 @@ LuaProc::match_variable_io (ChanCount& in, ChanCount& aux_in, ChanCount& out)
 bool
 LuaProc::reconfigure_io (ChanCount in, ChanCount aux_in, ChanCount out)
 {
+	Glib::Threads::Mutex::Lock lm (_lua_lock);
+
 	in += aux_in;
 	assert (in == _selected_in && out ==_selected_out);
 
@@ -659,6 +922,21 @@ LuaProc::connect_and_run (BufferSet& bufs,
 
 	Plugin::connect_and_run (bufs, start, end, speed, in, out, nframes, offset);
 
+	Glib::Threads::Mutex::Lock lm (_lua_lock, Glib::Threads::TRY_LOCK);
+
+	if (!lm.locked ()) {
+		if (!g_atomic_int_get (&_gc_running)) {
+			/* a non-realtime call is in progress */
+			bypass (bufs, in, out, nframes, offset);
+			return 0;
+		}
+		/* never skip a cycle for garbage collection. The background
+		 * thread runs a single incremental step at a priority just
+		 * below the process threads, wait for it to complete.
+		 */
+		lm.acquire ();
+	}
+
 	// This is needed for ARDOUR::Session requests :(
 	assert (SessionEvent::has_per_thread_pool ());
 
@@ -669,9 +947,15 @@ LuaProc::connect_and_run (BufferSet& bufs,
 		}
 	}
 
-#ifdef WITH_LUAPROC_STATS
+	if (g_atomic_int_get (&_stats_reset)) {
+		memset (_stats_hist, 0, sizeof (_stats_hist));
+		_stats_gc_max = _stats_gc_sum = 0;
+		_stats_gc_cnt = 0;
+		_mem_peak     = _mem_used;
+		g_atomic_int_set (&_stats_reset, 0);
+	}
+
 	int64_t t0 = g_get_monotonic_time ();
-#endif
 
 	try {
 		if (_lua_does_channelmapping) {
@@ -789,25 +1073,40 @@ LuaProc::connect_and_run (BufferSet& bufs,
 	} catch (...) {
 		return -1;
 	}
-#ifdef WITH_LUAPROC_STATS
+
 	int64_t t1 = g_get_monotonic_time ();
-#endif
+	++_stats_hist[stats_bin (t1 - t0)];
 
-	lua.collect_garbage_step ();
-#ifdef WITH_LUAPROC_STATS
-	if (++_stats_cnt > 0) {
-		int64_t t2 = g_get_monotonic_time ();
-		int64_t ela0 = t1 - t0;
-		int64_t ela1 = t2 - t1;
-		if (ela0 > _stats_max[0]) _stats_max[0] = ela0;
-		if (ela1 > _stats_max[1]) _stats_max[1] = ela1;
-		_stats_avg[0] += ela0;
-		_stats_avg[1] += ela1;
+	if (g_atomic_int_get (&_gc_active) && _mem_used < mempool_size - mempool_size / gc_rt_threshold) {
+		/* defer garbage collection to the background thread */
+		if (g_atomic_int_compare_and_exchange (&_gc_pending, 0, 1)) {
+			_gc_sem.signal ();
+		}
+	} else {
+		lua.collect_garbage_step ();
+		record_gc_step (g_get_monotonic_time () - t1);
 	}
-#endif
 	return 0;
 }
 
+void
+LuaProc::bypass (BufferSet& bufs, ChanMapping const& in, ChanMapping const& out, pframes_t nframes, samplecnt_t offset)
+{
+	const uint32_t audio_out = _configured_out.n_audio ();
+	for (uint32_t ap = 0; ap < audio_out; ++ap) {
+		bool valid;
+		const uint32_t ob = out.get (DataType::AUDIO, ap, &valid);
+		if (!valid) {
+			continue;
+		}
+		const uint32_t ib = in.get (DataType::AUDIO, ap, &valid);
+		if (!valid) {
+			bufs.get_audio (ob).silence (nframes, offset);
+		} else if (ib != ob) {
+			bufs.get_audio (ob).read_from (bufs.get_audio (ib), nframes, offset, offset);
+		}
+	}
+}
 
 void
 LuaProc::add_state (XMLNode* root) const
@@ -1072,7 +1371,7 @@ LuaProc::setup_lua_inline_gui (LuaState *lua_gui)
 
 	lua_gui->Print.connect (sigc::mem_fun (*this, &LuaProc::lua_print));
 	lua_gui->do_command ("function ardour () end");
-	lua_gui->do_command (_script);
+	run_script (*lua_gui, _script);
 
 	// TODO think: use a weak-pointer here ?
 	// (the GUI itself uses a shared ptr to this plugin, so we should be good)
@@ -1092,9 +1391,6 @@ LuaProc::setup_lua_inline_gui (LuaState *lua_gui)
 }
 ////////////////////////////////////////////////////////////////////////////////
 
-#include "ardour/search_paths.h"
-#include "sha1.c"
-
 std::string
 LuaProc::preset_name_to_uri (const std::string& name) const
 {
@@ -999,6 +999,13 @@ LV2Plugin::~LV2Plugin ()
 	DEBUG_TRACE(DEBUG::LV2, string_compose("%1 destroy\n", name()));
 
 	deactivate();
+
+	/* pool threads may still be busy with this instance's work */
+	delete _worker;
+	delete _state_worker;
+	_worker       = NULL;
+	_state_worker = NULL;
+
 	cleanup();
 
 #ifdef LV2_EXTENDED
@@ -1028,8 +1035,6 @@ LV2Plugin::~LV2Plugin ()
 
 	delete _to_ui;
 	delete _from_ui;
-	delete _worker;
-	delete _state_worker;
 
 	if (_atom_ev_buffers) {
 		LV2_Evbuf**  b = _atom_ev_buffers;
@@ -44,10 +44,7 @@ using namespace ARDOUR;
 PeakMeter::PeakMeter (Session& s, const std::string& name)
     : Processor (s, string_compose ("meter-%1", name))
 {
-	Kmeterdsp::init  (s.nominal_sample_rate ());
-	Iec1ppmdsp::init (s.nominal_sample_rate ());
-	Iec2ppmdsp::init (s.nominal_sample_rate ());
-	Vumeterdsp::init (s.nominal_sample_rate ());
+	Multimeterdsp::init (s.nominal_sample_rate ());
 
 	_pending_active = true;
 	_meter_type     = MeterPeak;
@@ -59,16 +56,6 @@ PeakMeter::PeakMeter (Session& s, const std::string& name)
 
 PeakMeter::~PeakMeter ()
 {
-	while (_kmeter.size () > 0) {
-		delete _kmeter.back ();
-		delete _iec1meter.back ();
-		delete _iec2meter.back ();
-		delete _vumeter.back ();
-		_kmeter.pop_back ();
-		_iec1meter.pop_back ();
-		_iec2meter.pop_back ();
-		_vumeter.pop_back ();
-	}
 	while (_peak_power.size () > 0) {
 		_peak_buffer.pop_back ();
 		_peak_power.pop_back ();
@@ -76,6 +63,26 @@ PeakMeter::~PeakMeter ()
 	}
 }
 
+/** @return the Multimeterdsp::Type bitmask needed for the given meter type */
+static int
+multimeter_types (MeterType t)
+{
+	int rv = 0;
+	if (t & (MeterKrms | MeterK20 | MeterK14 | MeterK12)) {
+		rv |= Multimeterdsp::KMeter;
+	}
+	if (t & (MeterIEC1DIN | MeterIEC1NOR)) {
+		rv |= Multimeterdsp::IEC1;
+	}
+	if (t & (MeterIEC2BBC | MeterIEC2EBU)) {
+		rv |= Multimeterdsp::IEC2;
+	}
+	if (t & MeterVU) {
+		rv |= Multimeterdsp::VU;
+	}
+	return rv;
+}
+
 std::string
 PeakMeter::display_name () const
 {
@@ -150,11 +157,26 @@ PeakMeter::run (BufferSet& bufs, samplepos_t /*start_sample*/, samplepos_t /*end
 	}
 
 	/* Audio Meters */
+	const int mtypes = multimeter_types (_meter_type);
+
+	if (mtypes && n_audio > 0) {
+		/* ballistics and peaks of all channels in a single pass */
+		for (uint32_t i = 0; i < n_audio; ++i) {
+			/* const, non-const data () would mark the buffer as not silent */
+			AudioBuffer const& ab (bufs.get_audio (i));
+			_audio_data[i] = ab.data ();
+		}
+		_multimeter.process (&_audio_data[0], &_peak_buffer[n], n_audio, nframes, mtypes);
+	}
+
 	for (uint32_t i = 0; i < n_audio; ++i, ++n) {
-		if (bufs.get_audio (i).silent ()) {
+		AudioBuffer const& ab (bufs.get_audio (i));
+		if (ab.silent ()) {
 			_peak_buffer[n] = 0;
 		} else {
-			_peak_buffer[n]     = compute_peak (bufs.get_audio (i).data (), nframes, _peak_buffer[n]);
+			if (!mtypes) {
+				_peak_buffer[n] = compute_peak (ab.data (), nframes, _peak_buffer[n]);
+			}
 			_peak_buffer[n]     = std::min (_peak_buffer[n], 100.f); // cut off at +40dBFS for falloff.
 			_max_peak_signal[n] = std::max (_peak_buffer[n], _max_peak_signal[n]);
 			_combined_peak      = std::max (_peak_buffer[n], _combined_peak);
@@ -180,19 +202,6 @@ PeakMeter::run (BufferSet& bufs, samplepos_t /*start_sample*/, samplepos_t /*end
 				_peak_buffer[n] = 0;
 			}
 		}
-
-		if (_meter_type & (MeterKrms | MeterK20 | MeterK14 | MeterK12)) {
-			_kmeter[i]->process (bufs.get_audio (i).data (), nframes);
-		}
-		if (_meter_type & (MeterIEC1DIN | MeterIEC1NOR)) {
-			_iec1meter[i]->process (bufs.get_audio (i).data (), nframes);
-		}
-		if (_meter_type & (MeterIEC2BBC | MeterIEC2EBU)) {
-			_iec2meter[i]->process (bufs.get_audio (i).data (), nframes);
-		}
-		if (_meter_type & MeterVU) {
-			_vumeter[i]->process (bufs.get_audio (i).data (), nframes);
-		}
 	}
 
 	/* Zero any excess peaks */
@@ -229,12 +238,7 @@ PeakMeter::reset ()
 	}
 
 	/* these are handled async just fine. */
-	for (size_t n = 0; n < _kmeter.size (); ++n) {
-		_kmeter[n]->reset ();
-		_iec1meter[n]->reset ();
-		_iec2meter[n]->reset ();
-		_vumeter[n]->reset ();
-	}
+	_multimeter.reset (Multimeterdsp::All);
 }
 
 void
@@ -321,26 +325,8 @@ PeakMeter::set_max_channels (const ChanCount& chn)
 	assert (_max_peak_signal.size () == limit);
 
 	/* alloc/free other audio-only meter types. */
-	while (_kmeter.size () > n_audio) {
-		delete _kmeter.back ();
-		delete _iec1meter.back ();
-		delete _iec2meter.back ();
-		delete _vumeter.back ();
-		_kmeter.pop_back ();
-		_iec1meter.pop_back ();
-		_iec2meter.pop_back ();
-		_vumeter.pop_back ();
-	}
-	while (_kmeter.size () < n_audio) {
-		_kmeter.push_back (new Kmeterdsp ());
-		_iec1meter.push_back (new Iec1ppmdsp ());
-		_iec2meter.push_back (new Iec2ppmdsp ());
-		_vumeter.push_back (new Vumeterdsp ());
-	}
-	assert (_kmeter.size () == n_audio);
-	assert (_iec1meter.size () == n_audio);
-	assert (_iec2meter.size () == n_audio);
-	assert (_vumeter.size () == n_audio);
+	_multimeter.set_channels (n_audio);
+	_audio_data.resize (n_audio);
 
 	reset ();
 	reset_max ();
@@ -351,7 +337,7 @@ PeakMeter::set_max_channels (const ChanCount& chn)
  * of meter size during this call.
  */
 
-#define CHECKSIZE(MTR) (n < MTR.size () + n_midi && n >= n_midi)
+#define CHECKSIZE(MTR) (n < MTR.n_channels () + n_midi && n >= n_midi)
 
 float
 PeakMeter::meter_level (uint32_t n, MeterType type)
@@ -372,8 +358,8 @@ PeakMeter::meter_level (uint32_t n, MeterType type)
 		case MeterK12:
 			{
 				const uint32_t n_midi = current_meters.n_midi ();
-				if (CHECKSIZE (_kmeter)) {
-					return accurate_coefficient_to_dB (_kmeter[n - n_midi]->read ());
+				if (CHECKSIZE (_multimeter)) {
+					return accurate_coefficient_to_dB (_multimeter.read (Multimeterdsp::KMeter, n - n_midi));
 				}
 			}
 			break;
@@ -381,8 +367,8 @@ PeakMeter::meter_level (uint32_t n, MeterType type)
 		case MeterIEC1NOR:
 			{
 				const uint32_t n_midi = current_meters.n_midi ();
-				if (CHECKSIZE (_iec1meter)) {
-					return accurate_coefficient_to_dB (_iec1meter[n - n_midi]->read ());
+				if (CHECKSIZE (_multimeter)) {
+					return accurate_coefficient_to_dB (_multimeter.read (Multimeterdsp::IEC1, n - n_midi));
 				}
 			}
 			break;
@@ -390,16 +376,16 @@ PeakMeter::meter_level (uint32_t n, MeterType type)
 		case MeterIEC2EBU:
 			{
 				const uint32_t n_midi = current_meters.n_midi ();
-				if (CHECKSIZE (_iec2meter)) {
-					return accurate_coefficient_to_dB (_iec2meter[n - n_midi]->read ());
+				if (CHECKSIZE (_multimeter)) {
+					return accurate_coefficient_to_dB (_multimeter.read (Multimeterdsp::IEC2, n - n_midi));
 				}
 			}
 			break;
 		case MeterVU:
 			{
 				const uint32_t n_midi = current_meters.n_midi ();
-				if (CHECKSIZE (_vumeter)) {
-					return accurate_coefficient_to_dB (_vumeter[n - n_midi]->read ());
+				if (CHECKSIZE (_multimeter)) {
+					return accurate_coefficient_to_dB (_multimeter.read (Multimeterdsp::VU, n - n_midi));
 				}
 			}
 			break;
@@ -434,30 +420,8 @@ PeakMeter::set_meter_type (MeterType t)
 
 	_meter_type = t;
 
-	if (t & (MeterKrms | MeterK20 | MeterK14 | MeterK12)) {
-		const size_t n_audio = current_meters.n_audio ();
-		for (size_t n = 0; n < n_audio; ++n) {
-			_kmeter[n]->reset ();
-		}
-	}
-	if (t & (MeterIEC1DIN | MeterIEC1NOR)) {
-		const size_t n_audio = current_meters.n_audio ();
-		for (size_t n = 0; n < n_audio; ++n) {
-			_iec1meter[n]->reset ();
-		}
-	}
-	if (t & (MeterIEC2BBC | MeterIEC2EBU)) {
-		const size_t n_audio = current_meters.n_audio ();
-		for (size_t n = 0; n < n_audio; ++n) {
-			_iec2meter[n]->reset ();
-		}
-	}
-	if (t & MeterVU) {
-		const size_t n_audio = current_meters.n_audio ();
-		for (size_t n = 0; n < n_audio; ++n) {
-			_vumeter[n]->reset ();
-		}
-	}
+	/* meter types that are not used are not processed, start afresh */
+	_multimeter.reset (multimeter_types (t));
 
 	MeterTypeChanged (t); /* EMIT SIGNAL */
 }
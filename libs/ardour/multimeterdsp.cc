@@ -0,0 +1,344 @@
+/*
+ * Copyright (C) 2008-2012 Fons Adriaensen <fons@linuxaudio.org>
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <algorithm>
+#include <math.h>
+
+#include "ardour/multimeterdsp.h"
+
+using std::max;
+using std::min;
+
+float Multimeterdsp::_k_omega;
+float Multimeterdsp::_i1_w1;
+float Multimeterdsp::_i1_w2;
+float Multimeterdsp::_i1_w3;
+float Multimeterdsp::_i1_g;
+float Multimeterdsp::_i2_w1;
+float Multimeterdsp::_i2_w2;
+float Multimeterdsp::_i2_w3;
+float Multimeterdsp::_i2_g;
+float Multimeterdsp::_vu_w;
+float Multimeterdsp::_vu_g;
+
+void
+Multimeterdsp::init (float fsamp)
+{
+	/* same as Kmeterdsp::init, Iec1ppmdsp::init, Iec2ppmdsp::init, Vumeterdsp::init */
+	_k_omega = 9.72f / fsamp;
+
+	_i1_w1 =  450.0f / fsamp;
+	_i1_w2 = 1300.0f / fsamp;
+	_i1_w3 = 1.0f - 5.4f / fsamp;
+	_i1_g  = 0.5108f;
+
+	_i2_w1 = 200.0f / fsamp;
+	_i2_w2 = 860.0f / fsamp;
+	_i2_w3 = 1.0f - 4.0f / fsamp;
+	_i2_g  = 0.5141f;
+
+	_vu_w = 11.1f / fsamp;
+	_vu_g = 1.5f * 1.571f;
+}
+
+void
+Multimeterdsp::State::resize (uint32_t n)
+{
+	z1.resize (n, 0);
+	z2.resize (n, 0);
+	m.resize (n, 0);
+	res.resize (n, 1);
+}
+
+void
+Multimeterdsp::State::reset ()
+{
+	std::fill (z1.begin (), z1.end (), 0.f);
+	std::fill (z2.begin (), z2.end (), 0.f);
+	std::fill (m.begin (), m.end (), 0.f);
+	std::fill (res.begin (), res.end (), 1);
+}
+
+Multimeterdsp::Multimeterdsp ()
+	: _n_chan (0)
+{
+}
+
+void
+Multimeterdsp::set_channels (uint32_t n_chan)
+{
+	/* round up to complete lanes, padding is processed but never read */
+	uint32_t const n = lanes * ((n_chan + lanes - 1) / lanes);
+
+	_kmeter.resize (n);
+	_iec1.resize (n);
+	_iec2.resize (n);
+	_vu.resize (n);
+
+	_n_chan = n_chan;
+}
+
+Multimeterdsp::State*
+Multimeterdsp::state (Type t)
+{
+	switch (t) {
+		case KMeter:
+			return &_kmeter;
+		case IEC1:
+			return &_iec1;
+		case IEC2:
+			return &_iec2;
+		case VU:
+			return &_vu;
+		default:
+			break;
+	}
+	return 0;
+}
+
+void
+Multimeterdsp::reset (int types)
+{
+	if (types & KMeter) {
+		_kmeter.reset ();
+	}
+	if (types & IEC1) {
+		_iec1.reset ();
+	}
+	if (types & IEC2) {
+		_iec2.reset ();
+	}
+	if (types & VU) {
+		_vu.reset ();
+	}
+}
+
+float
+Multimeterdsp::read (Type t, uint32_t chn)
+{
+	State* s = state (t);
+	if (!s || chn >= _n_chan) {
+		return 0;
+	}
+
+	float rv = s->m[chn];
+	s->res[chn] = 1; // resets m in next process()
+
+	switch (t) {
+		case IEC1:
+			return _i1_g * rv;
+		case IEC2:
+			return _i2_g * rv;
+		case VU:
+			return _vu_g * rv;
+		default:
+			return rv;
+	}
+}
+
+/* Each filter below is evaluated exactly as in the single channel
+ * implementation, only the conditional updates of the PPM
+ *   if (t > z) z += w * (t - z);
+ * are written as
+ *   z += w * max (t - z, 0);
+ * which yields the same result without a branch.
+ */
+template <bool K, bool I1, bool I2, bool V>
+void
+Multimeterdsp::process_lanes (float const* const* p, uint32_t c, int nblocks, float* peak)
+{
+	float kz1[lanes], kz2[lanes];
+	float a1[lanes], a2[lanes], am[lanes];
+	float b1[lanes], b2[lanes], bm[lanes];
+	float vz1[lanes], vz2[lanes], vt[lanes], vm[lanes];
+	float pk[lanes];
+
+	/* get filter state */
+	for (uint32_t l = 0; l < lanes; ++l) {
+		if (K) {
+			kz1[l] = min (50.f, max (0.f, _kmeter.z1[c + l]));
+			kz2[l] = min (50.f, max (0.f, _kmeter.z2[c + l]));
+		}
+		if (I1) {
+			a1[l] = min (20.f, max (0.f, _iec1.z1[c + l]));
+			a2[l] = min (20.f, max (0.f, _iec1.z2[c + l]));
+			am[l] = 0;
+		}
+		if (I2) {
+			b1[l] = min (20.f, max (0.f, _iec2.z1[c + l]));
+			b2[l] = min (20.f, max (0.f, _iec2.z2[c + l]));
+			bm[l] = 0;
+		}
+		if (V) {
+			vz1[l] = min (20.f, max (-20.f, _vu.z1[c + l]));
+			vz2[l] = min (20.f, max (-20.f, _vu.z2[c + l]));
+			vm[l]  = 0;
+		}
+		pk[l] = 0;
+	}
+
+	for (int b = 0; b < nblocks; ++b) {
+		for (uint32_t l = 0; l < lanes; ++l) {
+			if (I1) {
+				a1[l] *= _i1_w3;
+				a2[l] *= _i1_w3;
+			}
+			if (I2) {
+				b1[l] *= _i2_w3;
+				b2[l] *= _i2_w3;
+			}
+			if (V) {
+				vt[l] = vz2[l] / 2;
+			}
+		}
+
+		for (int i = 4 * b; i < 4 * b + 4; ++i) {
+			for (uint32_t l = 0; l < lanes; ++l) {
+				const float s = p[l][i];
+				const float t = fabsf (s);
+				pk[l] = max (pk[l], t);
+				if (K) {
+					kz1[l] += _k_omega * (s * s - kz1[l]);
+				}
+				if (I1) {
+					a1[l] += _i1_w1 * max (t - a1[l], 0.f);
+					a2[l] += _i1_w2 * max (t - a2[l], 0.f);
+				}
+				if (I2) {
+					b1[l] += _i2_w1 * max (t - b1[l], 0.f);
+					b2[l] += _i2_w2 * max (t - b2[l], 0.f);
+				}
+				if (V) {
+					vz1[l] += _vu_w * ((t - vt[l]) - vz1[l]);
+				}
+			}
+		}
+
+		for (uint32_t l = 0; l < lanes; ++l) {
+			if (K) {
+				kz2[l] += 4 * _k_omega * (kz1[l] - kz2[l]);
+			}
+			if (I1) {
+				am[l] = max (am[l], a1[l] + a2[l]);
+			}
+			if (I2) {
+				bm[l] = max (bm[l], b1[l] + b2[l]);
+			}
+			if (V) {
+				vz2[l] += 4 * _vu_w * (vz1[l] - vz2[l]);
+				vm[l] = max (vm[l], vz2[l]);
+			}
+		}
+	}
+
+	/* save filter state, the added constants avoid denormals */
+	for (uint32_t l = 0; l < lanes; ++l) {
+		const uint32_t n = c + l;
+		if (K) {
+			if (isnan (kz1[l])) kz1[l] = 0;
+			if (isnan (kz2[l])) kz2[l] = 0;
+			_kmeter.z1[n] = kz1[l] + 1e-20f;
+			_kmeter.z2[n] = kz2[l] + 1e-20f;
+			const float rms = sqrtf (2.0f * kz2[l]);
+			_kmeter.m[n] = _kmeter.res[n] ? rms : max (_kmeter.m[n], rms);
+			_kmeter.res[n] = 0;
+		}
+		if (I1) {
+			_iec1.z1[n] = a1[l] + 1e-10f;
+			_iec1.z2[n] = a2[l] + 1e-10f;
+			_iec1.m[n] = _iec1.res[n] ? am[l] : max (_iec1.m[n], am[l]);
+			_iec1.res[n] = 0;
+		}
+		if (I2) {
+			_iec2.z1[n] = b1[l] + 1e-10f;
+			_iec2.z2[n] = b2[l] + 1e-10f;
+			_iec2.m[n] = _iec2.res[n] ? bm[l] : max (_iec2.m[n], bm[l]);
+			_iec2.res[n] = 0;
+		}
+		if (V) {
+			if (isnan (vz1[l])) vz1[l] = 0;
+			if (isnan (vz2[l])) vz2[l] = 0;
+			_vu.z1[n] = vz1[l];
+			_vu.z2[n] = vz2[l] + 1e-10f;
+			_vu.m[n] = _vu.res[n] ? vm[l] : max (_vu.m[n], vm[l]);
+			_vu.res[n] = 0;
+		}
+		if (peak && n < _n_chan) {
+			peak[n] = max (peak[n], pk[l]);
+		}
+	}
+}
+
+void
+Multimeterdsp::process (float const* const* data, float* peak, uint32_t n_chan, int n, int types)
+{
+	n_chan = min (n_chan, _n_chan);
+
+	if (n_chan == 0) {
+		return;
+	}
+
+	/* like the single channel meters, the ballistics are
+	 * evaluated for complete blocks of 4 samples.
+	 */
+	const int nblocks = n / 4;
+
+	for (uint32_t c = 0; c < n_chan; c += lanes) {
+		float const* p[lanes];
+		for (uint32_t l = 0; l < lanes; ++l) {
+			/* unused lanes repeat the last channel */
+			p[l] = data[min (c + l, n_chan - 1)];
+		}
+
+		switch (types & All) {
+#define PROCESS_LANES(T) \
+			case T: \
+				process_lanes<(T & KMeter) != 0, (T & IEC1) != 0, (T & IEC2) != 0, (T & VU) != 0> (p, c, nblocks, peak); \
+				break;
+			PROCESS_LANES (0x00)
+			PROCESS_LANES (0x01)
+			PROCESS_LANES (0x02)
+			PROCESS_LANES (0x03)
+			PROCESS_LANES (0x04)
+			PROCESS_LANES (0x05)
+			PROCESS_LANES (0x06)
+			PROCESS_LANES (0x07)
+			PROCESS_LANES (0x08)
+			PROCESS_LANES (0x09)
+			PROCESS_LANES (0x0a)
+			PROCESS_LANES (0x0b)
+			PROCESS_LANES (0x0c)
+			PROCESS_LANES (0x0d)
+			PROCESS_LANES (0x0e)
+			PROCESS_LANES (0x0f)
+#undef PROCESS_LANES
+		}
+	}
+
+	if (!peak) {
+		return;
+	}
+
+	/* peak of remaining samples */
+	for (uint32_t c = 0; c < n_chan; ++c) {
+		for (int i = 4 * nblocks; i < n; ++i) {
+			peak[c] = max (peak[c], fabsf (data[c][i]));
+		}
+	}
+}
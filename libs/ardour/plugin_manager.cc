@@ -81,6 +81,7 @@
 #include <glibmm/fileutils.h>
 
 #include "pbd/convert.h"
+#include "pbd/cpus.h"
 #include "pbd/file_utils.h"
 #include "pbd/tokenizer.h"
 #include "pbd/whitespace.h"
@@ -230,6 +231,7 @@ PluginManager::PluginManager ()
 	load_statuses ();
 	load_tags ();
 	load_stats ();
+	_scan_index.load ();
 
 	if ((s = getenv ("LADSPA_RDF_PATH"))){
 		lrdf_path = s;
@@ -561,6 +563,8 @@ PluginManager::refresh (bool cache_only)
 	detect_name_ambiguities (_lua_plugin_info);
 	detect_name_ambiguities (_vst3_plugin_info);
 
+	_scan_index.save ();
+
 	PluginInfoList all_plugs;
 	if (_windows_vst_plugin_info) {
 		all_plugs.insert(all_plugs.end(), _windows_vst_plugin_info->begin(), _windows_vst_plugin_info->end());
@@ -1540,6 +1544,8 @@ PluginManager::clear_vst3_cache ()
 	for (vector<string>::iterator i = v3i_files.begin(); i != v3i_files.end (); ++i) {
 		::g_unlink(i->c_str());
 	}
+	_scan_index.clear (VST3);
+	_scan_index.save ();
 #endif
 }
 
@@ -1652,11 +1658,37 @@ PluginManager::vst3_discover_from_path (string const& path, bool cache_only)
 
 	vector<string> plugin_objects;
 
-	find_paths_matching_filter (plugin_objects, paths, vst3_filter, 0, false, true, true);
+	/* when only using cached data, the list of bundles found along
+	 * the same search-path on the previous scan is sufficient.
+	 */
+	if (!cache_only || !_scan_index.modules (VST3, paths.to_string (), plugin_objects)) {
+		find_paths_matching_filter (plugin_objects, paths, vst3_filter, 0, false, true, true);
+		_scan_index.set_modules (VST3, paths.to_string (), plugin_objects);
+	}
+
+	set<string> failed;
+
+	if (!cache_only && !vst3_scanner_bin_path.empty ()) {
+		/* run external scanner for all new or modified bundles in parallel */
+		vector<string> to_scan;
+		for (vector<string>::iterator i = plugin_objects.begin(); i != plugin_objects.end (); ++i) {
+			string module_path = module_path_vst3 (*i);
+			if (module_path.empty () || vst3_is_blacklisted (module_path)) {
+				continue;
+			}
+			if (_scan_index.lookup (VST3, module_path) || !vst3_valid_cache_file (module_path).empty ()) {
+				continue;
+			}
+			to_scan.push_back (*i);
+		}
+		failed = run_vst3_scanner_apps (to_scan);
+	}
 
 	for (vector<string>::iterator i = plugin_objects.begin(); i != plugin_objects.end (); ++i) {
-		ARDOUR::PluginScanMessage(_("VST3"), *i, !(cache_only || cancelled()));
-		vst3_discover (*i, cache_only || cancelled ());
+		/* do not re-scan plugins that timed out above */
+		bool const skip_scan = cache_only || cancelled () || failed.find (*i) != failed.end ();
+		ARDOUR::PluginScanMessage(_("VST3"), *i, !skip_scan);
+		vst3_discover (*i, skip_scan);
 	}
 
 	return cancelled() ? -1 : 0;
@@ -1703,6 +1735,19 @@ PluginManager::vst3_discover (string const& path, bool cache_only)
 
 	DEBUG_TRACE (DEBUG::PluginManager, string_compose ("VST3: discover %1 (%2)\n", path, module_path));
 
+	if (XMLNode const* cached = _scan_index.lookup (VST3, module_path)) {
+		for (XMLNodeConstIterator i = cached->children().begin(); i != cached->children().end(); ++i) {
+			try {
+				VST3Info nfo (**i);
+				vst3_plugin (module_path, nfo);
+			} catch (...) {
+				_scan_index.remove (VST3, module_path);
+				break;
+			}
+		}
+		return 0;
+	}
+
 	if (!cache_only && vst3_scanner_bin_path.empty ()) {
 		/* direct scan in the host's process */
 		vst3_blacklist (module_path);
@@ -1713,6 +1758,12 @@ PluginManager::vst3_discover (string const& path, bool cache_only)
 		}
 
 		vst3_whitelist (module_path);
+
+		XMLTree tree;
+		string cache_file = vst3_valid_cache_file (module_path);
+		if (!cache_file.empty () && tree.read (cache_file)) {
+			_scan_index.set (VST3, module_path, *tree.root ());
+		}
 		return 0;
 	}
 
@@ -1769,6 +1820,7 @@ PluginManager::vst3_discover (string const& path, bool cache_only)
 
 	vst3_whitelist (module_path);
 
+	bool valid = true;
 	for (XMLNodeConstIterator i = tree.root()->children().begin(); i != tree.root()->children().end(); ++i) {
 		try {
 			VST3Info nfo (**i);
@@ -1776,9 +1828,14 @@ PluginManager::vst3_discover (string const& path, bool cache_only)
 		} catch (...) {
 			error << string_compose (_("Corrupt VST3 cache file '%1' for plugin '%2'"), cache_file, module_path) << endmsg;
 			DEBUG_TRACE (DEBUG::PluginManager, string_compose ("Cannot load VST3 at '%1'\n", path));
+			valid = false;
 			continue;
 		}
 	}
+
+	if (valid) {
+		_scan_index.set (VST3, module_path, *tree.root ());
+	}
 	return 0;
 }
 
@@ -1787,50 +1844,146 @@ static void vst3_scanner_log (std::string msg, std::string bundle_path)
 	PBD::info << string_compose ("VST3<%1>: %2", bundle_path, msg) << endmsg;
 }
 
+namespace {
+struct VST3ScanJob {
+	VST3ScanJob (std::string const& b, int t)
+		: bundle_path (b)
+		, timeout (t)
+		, scanner (0)
+	{}
+
+	~VST3ScanJob () {
+		delete scanner;
+	}
+
+	std::string           bundle_path;
+	int                   timeout; // deciseconds
+	ARDOUR::SystemExec*   scanner;
+	PBD::ScopedConnection connection;
+};
+}
+
 bool
-PluginManager::run_vst3_scanner_app (std::string bundle_path) const
+PluginManager::run_vst3_scanner_app (std::string bundle_path)
 {
-	char **argp= (char**) calloc (5, sizeof (char*));
-	argp[0] = strdup (vst3_scanner_bin_path.c_str ());
-	argp[1] = strdup ("-q");
-	argp[2] = strdup ("-f");
-	argp[3] = strdup (bundle_path.c_str ());
-	argp[4] = 0;
+	std::vector<std::string> bundles (1, bundle_path);
+	return run_vst3_scanner_apps (bundles).empty ();
+}
 
-	ARDOUR::SystemExec scanner (vst3_scanner_bin_path, argp);
-	PBD::ScopedConnection c;
-	scanner.ReadStdout.connect_same_thread (c, boost::bind (&vst3_scanner_log, _1, bundle_path));
+/** Run the external scanner for the given bundles using a bounded
+ * pool of concurrent processes. Every process has its own timeout.
+ *
+ * @return bundles whose scan was aborted (timeout, cancel) or could not be started
+ */
+std::set<std::string>
+PluginManager::run_vst3_scanner_apps (std::vector<std::string> const& bundle_paths)
+{
+	typedef std::list<boost::shared_ptr<VST3ScanJob> > ScanJobs;
 
-	if (scanner.start (ARDOUR::SystemExec::MergeWithStdin)) {
-		PBD::error << string_compose (_("Cannot launch VST scanner app '%1': %2"), scanner_bin_path, strerror (errno)) << endmsg;
-		return false;
+	std::set<std::string> failed;
+	ScanJobs running;
+
+	uint32_t n_parallel = Config->get_plugin_scan_concurrency ();
+	if (n_parallel == 0) {
+		n_parallel = hardware_concurrency ();
 	}
+	n_parallel = std::max<uint32_t> (1, n_parallel);
+
+	bool notime = Config->get_vst_scan_timeout () <= 0; // deciseconds
+
+	std::vector<std::string>::const_iterator next = bundle_paths.begin ();
+
+	while (next != bundle_paths.end () || !running.empty ()) {
+
+		while (next != bundle_paths.end () && running.size () < n_parallel && !cancelled ()) {
+			boost::shared_ptr<VST3ScanJob> job (new VST3ScanJob (*next, Config->get_vst_scan_timeout ()));
+			++next;
 
-	int timeout = Config->get_vst_scan_timeout(); // deciseconds
-	bool notime = (timeout <= 0);
+			char **argp= (char**) calloc (5, sizeof (char*));
+			argp[0] = strdup (vst3_scanner_bin_path.c_str ());
+			argp[1] = strdup ("-q");
+			argp[2] = strdup ("-f");
+			argp[3] = strdup (job->bundle_path.c_str ());
+			argp[4] = 0;
+
+			/* blacklist in case the scanner crashes */
+			vst3_blacklist (module_path_vst3 (job->bundle_path));
+
+			job->scanner = new ARDOUR::SystemExec (vst3_scanner_bin_path, argp);
+			job->scanner->ReadStdout.connect_same_thread (job->connection, boost::bind (&vst3_scanner_log, _1, job->bundle_path));
+
+			if (job->scanner->start (ARDOUR::SystemExec::MergeWithStdin)) {
+				PBD::error << string_compose (_("Cannot launch VST scanner app '%1': %2"), vst3_scanner_bin_path, strerror (errno)) << endmsg;
+				vst3_whitelist (module_path_vst3 (job->bundle_path));
+				failed.insert (job->bundle_path);
+				continue;
+			}
+
+			DEBUG_TRACE (DEBUG::PluginManager, string_compose ("VST3: started scanner for '%1' (%2 running)\n", job->bundle_path, running.size () + 1));
+			ARDOUR::PluginScanMessage (_("VST3"), job->bundle_path, true);
+			running.push_back (job);
+		}
+
+		if (cancelled ()) {
+			/* do not start any more scanners */
+			next = bundle_paths.end ();
+		}
+
+		if (running.empty ()) {
+			continue;
+		}
+
+		Glib::usleep (100000);
 
-	while (scanner.is_running () && (notime || timeout > 0)) {
 		if (!notime && no_timeout ()) {
 			notime = true;
-			timeout = -1;
 		}
 
-		ARDOUR::PluginScanTimeout (timeout);
-		--timeout;
-		Glib::usleep (100000);
+		int min_timeout = -1;
+
+		for (ScanJobs::iterator i = running.begin (); i != running.end ();) {
+			VST3ScanJob& job (**i);
+			if (!job.scanner->is_running ()) {
+				/* a scanner that crashed does not leave a cache-file,
+				 * the bundle remains blacklisted */
+				std::string module_path = module_path_vst3 (job.bundle_path);
+				if (!module_path.empty () && !vst3_valid_cache_file (module_path).empty ()) {
+					vst3_whitelist (module_path);
+				} else {
+					DEBUG_TRACE (DEBUG::PluginManager, string_compose ("VST3: scanner failed for '%1'\n", job.bundle_path));
+				}
+				i = running.erase (i);
+				continue;
+			}
+
+			--job.timeout;
 
-		if (cancelled () || (!notime && timeout == 0)) {
-			scanner.terminate ();
-			/* may be partially written */
-			std::string module_path = module_path_vst3 (bundle_path);
-			if (!module_path.empty ()) {
-				g_unlink (vst3_cache_file (module_path).c_str ());
+			if (cancelled () || (!notime && job.timeout <= 0)) {
+				job.scanner->terminate ();
+				/* may be partially written */
+				std::string module_path = module_path_vst3 (job.bundle_path);
+				if (!module_path.empty ()) {
+					g_unlink (vst3_cache_file (module_path).c_str ());
+				}
+				/* a bundle that timed out remains blacklisted */
+				if (cancelled ()) {
+					vst3_whitelist (module_path);
+				}
+				failed.insert (job.bundle_path);
+				i = running.erase (i);
+				continue;
+			}
+
+			if (!notime && (min_timeout < 0 || job.timeout < min_timeout)) {
+				min_timeout = job.timeout;
 			}
-			vst3_whitelist (module_path);
-			return false;
+			++i;
 		}
+
+		ARDOUR::PluginScanTimeout (min_timeout);
 	}
-	return true;
+
+	return failed;
 }
 
 #endif // VST3_SUPPORT
@@ -0,0 +1,237 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "pbd/gstdio_compat.h"
+#include <glibmm/fileutils.h>
+#include <glibmm/miscutils.h>
+
+#include "pbd/error.h"
+#include "pbd/compose.h"
+
+#include "ardour/debug.h"
+#include "ardour/filesystem_paths.h"
+#include "ardour/plugin_scan_index.h"
+
+#include "pbd/i18n.h"
+
+using namespace std;
+using namespace PBD;
+using namespace ARDOUR;
+
+PluginScanIndex::PluginScanIndex ()
+	: _dirty (false)
+{
+}
+
+string
+PluginScanIndex::index_file ()
+{
+	return Glib::build_filename (ARDOUR::user_cache_directory (), "plugin_index");
+}
+
+bool
+PluginScanIndex::stat_module (string const& module_path, int64_t& mtime, int64_t& size)
+{
+	GStatBuf sb;
+	if (g_stat (module_path.c_str (), &sb) != 0) {
+		return false;
+	}
+	mtime = sb.st_mtime;
+	size  = sb.st_size;
+	return true;
+}
+
+bool
+PluginScanIndex::load ()
+{
+	_entries.clear ();
+	_searchpaths.clear ();
+	_dirty = false;
+
+	string const path = index_file ();
+	if (!Glib::file_test (path, Glib::FILE_TEST_EXISTS)) {
+		return false;
+	}
+
+	XMLTree tree;
+	if (!tree.read (path)) {
+		warning << string_compose (_("Cannot parse plugin index %1, ignored."), path) << endmsg;
+		return false;
+	}
+
+	int version = 0;
+	if (!tree.root ()->get_property (X_("version"), version) || version != current_version) {
+		/* re-scan everything, the file will be replaced */
+		_dirty = true;
+		return false;
+	}
+
+	for (XMLNodeConstIterator i = tree.root ()->children ().begin (); i != tree.root ()->children ().end (); ++i) {
+		PluginType type;
+		string     p;
+		if (!(*i)->get_property (X_("type"), type) || !(*i)->get_property (X_("path"), p)) {
+			continue;
+		}
+
+		if ((*i)->name () == X_("Module")) {
+			int64_t mtime;
+			int64_t size;
+			if (!(*i)->get_property (X_("mtime"), mtime) || !(*i)->get_property (X_("size"), size)) {
+				continue;
+			}
+			_entries[Key (type, p)] = Entry (mtime, size, boost::shared_ptr<XMLNode> (new XMLNode (**i)));
+		} else if ((*i)->name () == X_("SearchPath")) {
+			SearchPath& sp (_searchpaths[type]);
+			sp.path = p;
+			sp.modules.clear ();
+			for (XMLNodeConstIterator j = (*i)->children ().begin (); j != (*i)->children ().end (); ++j) {
+				string m;
+				if ((*j)->get_property (X_("path"), m)) {
+					sp.modules.push_back (m);
+				}
+			}
+		}
+	}
+
+	DEBUG_TRACE (DEBUG::PluginManager, string_compose ("Plugin index: loaded %1 modules from %2\n", _entries.size (), path));
+	return true;
+}
+
+bool
+PluginScanIndex::save ()
+{
+	if (!_dirty) {
+		return true;
+	}
+
+	XMLNode* root = new XMLNode (X_("PluginIndex"));
+	root->set_property (X_("version"), current_version);
+
+	for (SearchPaths::const_iterator i = _searchpaths.begin (); i != _searchpaths.end (); ++i) {
+		XMLNode* node = root->add_child (X_("SearchPath"));
+		node->set_property (X_("type"), i->first);
+		node->set_property (X_("path"), i->second.path);
+		for (vector<string>::const_iterator j = i->second.modules.begin (); j != i->second.modules.end (); ++j) {
+			node->add_child (X_("Module"))->set_property (X_("path"), *j);
+		}
+	}
+
+	for (Entries::const_iterator i = _entries.begin (); i != _entries.end (); ++i) {
+		root->add_child_copy (*i->second.info);
+	}
+
+	XMLTree tree;
+	tree.set_root (root);
+	if (!tree.write (index_file ())) {
+		error << string_compose (_("Could not save plugin index to %1"), index_file ()) << endmsg;
+		return false;
+	}
+	_dirty = false;
+	return true;
+}
+
+XMLNode const*
+PluginScanIndex::lookup (PluginType type, string const& module_path) const
+{
+	Entries::const_iterator i = _entries.find (Key (type, module_path));
+	if (i == _entries.end ()) {
+		return 0;
+	}
+
+	int64_t mtime;
+	int64_t size;
+	if (!stat_module (module_path, mtime, size)) {
+		return 0;
+	}
+	if (mtime != i->second.mtime || size != i->second.size) {
+		DEBUG_TRACE (DEBUG::PluginManager, string_compose ("Plugin index: '%1' was modified\n", module_path));
+		return 0;
+	}
+	return i->second.info.get ();
+}
+
+void
+PluginScanIndex::set (PluginType type, string const& module_path, XMLNode const& info)
+{
+	int64_t mtime;
+	int64_t size;
+	if (!stat_module (module_path, mtime, size)) {
+		remove (type, module_path);
+		return;
+	}
+
+	boost::shared_ptr<XMLNode> node (new XMLNode (X_("Module")));
+	node->set_property (X_("type"), type);
+	node->set_property (X_("path"), module_path);
+	node->set_property (X_("mtime"), mtime);
+	node->set_property (X_("size"), size);
+
+	for (XMLNodeConstIterator i = info.children ().begin (); i != info.children ().end (); ++i) {
+		node->add_child_copy (**i);
+	}
+
+	_entries[Key (type, module_path)] = Entry (mtime, size, node);
+	_dirty = true;
+}
+
+void
+PluginScanIndex::remove (PluginType type, string const& module_path)
+{
+	if (_entries.erase (Key (type, module_path)) > 0) {
+		_dirty = true;
+	}
+}
+
+void
+PluginScanIndex::clear (PluginType type)
+{
+	for (Entries::iterator i = _entries.begin (); i != _entries.end ();) {
+		if (i->first.first == type) {
+			_entries.erase (i++);
+			_dirty = true;
+		} else {
+			++i;
+		}
+	}
+	if (_searchpaths.erase (type) > 0) {
+		_dirty = true;
+	}
+}
+
+bool
+PluginScanIndex::modules (PluginType type, string const& searchpath, vector<string>& modules) const
+{
+	SearchPaths::const_iterator i = _searchpaths.find (type);
+	if (i == _searchpaths.end () || i->second.path != searchpath) {
+		return false;
+	}
+	modules = i->second.modules;
+	return true;
+}
+
+void
+PluginScanIndex::set_modules (PluginType type, string const& searchpath, vector<string> const& modules)
+{
+	SearchPath& sp (_searchpaths[type]);
+	if (sp.path == searchpath && sp.modules == modules) {
+		return;
+	}
+	sp.path    = searchpath;
+	sp.modules = modules;
+	_dirty     = true;
+}
@@ -48,7 +48,7 @@ pframes_t    Port::_global_port_buffer_offset = 0;
 pframes_t    Port::_cycle_nframes = 0;
 double       Port::_speed_ratio = 1.0;
 std::string  Port::state_node_name = X_("Port");
-const uint32_t Port::_resampler_quality = 17;
+uint32_t     Port::_resampler_quality = 17;
 
 /* a handy define to shorten what would otherwise be a needlessly verbose
  * repeated phrase
@@ -671,6 +671,21 @@ Port::set_speed_ratio (double s) {
 	}
 }
 
+/*static*/ bool
+Port::setup_resampler (uint32_t q)
+{
+	/* see VMResampler::setup() for valid range */
+	q = std::min ((uint32_t) 96, std::max ((uint32_t) 8, q));
+	if (_resampler_quality == q) {
+		return false;
+	}
+	/* this changes port-latency, which is only re-computed when
+	 * the engine is (re)started. */
+	assert (!port_manager->running ());
+	_resampler_quality = q;
+	return true;
+}
+
 /*static*/ void
 Port::set_cycle_samplecnt (pframes_t n)
 {
@@ -37,6 +37,9 @@
 #include "ardour/async_midi_port.h"
 #include "ardour/audio_backend.h"
 #include "ardour/audio_port.h"
+#include "ardour/audio_port_resampler.h"
+#include "ardour/butler.h"
+#include "ardour/cycle_trace.h"
 #include "ardour/debug.h"
 #include "ardour/filesystem_paths.h"
 #include "ardour/midi_port.h"
@@ -58,11 +61,21 @@ PortManager::PortManager ()
 	: ports (new Ports)
 	, _port_remove_in_progress (false)
 	, _port_deletions_pending (8192) /* ick, arbitrary sizing */
+	, _port_resampler (0)
+	, _port_resampler_pending (0)
+	, _port_resampler_retired (0)
+	, _port_resampler_update (0)
+	, _port_resampler_rebuild (0)
 	, midi_info_dirty (true)
 {
 	load_midi_port_info ();
 }
 
+PortManager::~PortManager ()
+{
+	drop_port_resampler ();
+}
+
 void
 PortManager::clear_pending_port_deletions ()
 {
@@ -97,6 +110,8 @@ PortManager::remove_all_ports ()
 
 	ports.flush ();
 
+	drop_port_resampler ();
+
 	/* clear out pending port deletion list. we know this is safe because
 	 * the auto connect thread in Session is already dead when this is
 	 * done. It doesn't use shared_ptr<Port> anyway.
@@ -478,6 +493,17 @@ PortManager::unregister_port (boost::shared_ptr<Port> port)
 
 	ports.flush ();
 
+	boost::shared_ptr<AudioPort> ap = boost::dynamic_pointer_cast<AudioPort> (port);
+	if (ap && (ap->_src_batched || ap->externally_connected ())) {
+		update_port_resampler ();
+		/* the process thread is not running (process lock is held),
+		 * switch now, so that the port can be released */
+		Glib::Threads::Mutex::Lock lm (_port_resampler_lock);
+		switch_port_resampler ();
+		delete _port_resampler_retired;
+		_port_resampler_retired = 0;
+	}
+
 	return 0;
 }
 
@@ -691,6 +717,12 @@ PortManager::connect_callback (const string& a, const string& b, bool conn)
 		port_b, b,
 		conn
 		); /* EMIT SIGNAL */
+
+	if ((port_a && !port_b && port_a->type () == DataType::AUDIO) || (port_b && !port_a && port_b->type () == DataType::AUDIO)) {
+		/* this may be called by the backend's process thread,
+		 * the butler rebuilds the resampler, see cycle_start() */
+		g_atomic_int_set (&_port_resampler_rebuild, 1);
+	}
 }
 
 void
@@ -782,11 +814,24 @@ PortManager::graph_order_callback ()
 void
 PortManager::cycle_start (pframes_t nframes, Session* s)
 {
+	CycleTrace::Scope cts (CycleTrace::PortCycleStart, "cycle-start");
+
 	Port::set_global_port_buffer_offset (0);
 	Port::set_cycle_samplecnt (nframes);
 
 	_cycle_ports = ports.reader ();
 
+	if (s && s->butler () && g_atomic_int_compare_and_exchange (&_port_resampler_rebuild, 1, 2)) {
+		s->butler ()->summon ();
+	}
+
+	if (g_atomic_int_get (&_port_resampler_update)) {
+		Glib::Threads::Mutex::Lock lm (_port_resampler_lock, Glib::Threads::TRY_LOCK);
+		if (lm.locked ()) {
+			switch_port_resampler ();
+		}
+	}
+
 	/* TODO optimize
 	 *  - when speed == 1.0, the resampler copies data without processing
 	 *   it may (or may not) be more efficient to just run all in sequence.
@@ -805,9 +850,15 @@ PortManager::cycle_start (pframes_t nframes, Session* s)
 	 *    (rather than resample into each ardour-owned input port).
 	 *    A single external source-port may be connected to many ardour
 	 *    input-ports. Currently re-sampling is per input.
+	 *
+	 * Externally connected audio ports are resampled in blocks by
+	 * _port_resampler, their ::cycle_start() skips resampling.
 	 */
 	if (s && s->rt_tasklist () && fabs (Port::speed_ratio ()) != 1.0) {
 		RTTaskList::TaskList tl;
+		if (_port_resampler) {
+			_port_resampler->process_inputs (nframes, &tl);
+		}
 		for (Ports::iterator p = _cycle_ports->begin(); p != _cycle_ports->end(); ++p) {
 			if (!(p->second->flags() & TransportSyncPort)) {
 				tl.push_back (boost::bind (&Port::cycle_start, p->second, nframes));
@@ -815,6 +866,9 @@ PortManager::cycle_start (pframes_t nframes, Session* s)
 		}
 		s->rt_tasklist()->process (tl);
 	} else {
+		if (_port_resampler) {
+			_port_resampler->process_inputs (nframes);
+		}
 		for (Ports::iterator p = _cycle_ports->begin(); p != _cycle_ports->end(); ++p) {
 			if (!(p->second->flags() & TransportSyncPort)) {
 				p->second->cycle_start (nframes);
@@ -826,6 +880,8 @@ PortManager::cycle_start (pframes_t nframes, Session* s)
 void
 PortManager::cycle_end (pframes_t nframes, Session* s)
 {
+	CycleTrace::Scope cts (CycleTrace::PortCycleEnd, "cycle-end");
+
 	// see optimzation note in ::cycle_start()
 	if (0 && s && s->rt_tasklist () && fabs (Port::speed_ratio ()) != 1.0) {
 		RTTaskList::TaskList tl;
@@ -843,6 +899,16 @@ PortManager::cycle_end (pframes_t nframes, Session* s)
 		}
 	}
 
+	if (_port_resampler) {
+		if (s && s->rt_tasklist () && fabs (Port::speed_ratio ()) != 1.0) {
+			RTTaskList::TaskList tl;
+			_port_resampler->process_outputs (nframes, &tl);
+			s->rt_tasklist()->process (tl);
+		} else {
+			_port_resampler->process_outputs (nframes);
+		}
+	}
+
 	for (Ports::iterator p = _cycle_ports->begin(); p != _cycle_ports->end(); ++p) {
 		/* AudioEngine::split_cycle flushes buffers until Port::port_offset.
 		 * Now only flush remaining events (after Port::port_offset) */
@@ -952,6 +1018,16 @@ PortManager::cycle_end_fade_out (gain_t base_gain, gain_t gain_step, pframes_t n
 		}
 	}
 
+	if (_port_resampler) {
+		if (s && s->rt_tasklist () && fabs (Port::speed_ratio ()) != 1.0) {
+			RTTaskList::TaskList tl;
+			_port_resampler->process_outputs (nframes, &tl);
+			s->rt_tasklist()->process (tl);
+		} else {
+			_port_resampler->process_outputs (nframes);
+		}
+	}
+
 	for (Ports::iterator p = _cycle_ports->begin(); p != _cycle_ports->end(); ++p) {
 		p->second->flush_buffers (nframes);
 
@@ -1373,6 +1449,108 @@ PortManager::set_port_buffer_sizes (pframes_t n)
 	for (Ports::iterator p = all->begin(); p != all->end(); ++p) {
 		p->second->set_buffer_size (n);
 	}
+
+	/* Port::resampler_quality () may have changed */
+	update_port_resampler ();
+}
+
+void
+PortManager::update_port_resampler ()
+{
+	AudioPortResampler::PortList inputs;
+	AudioPortResampler::PortList outputs;
+
+	boost::shared_ptr<Ports> all = ports.reader();
+
+	for (Ports::iterator p = all->begin(); p != all->end(); ++p) {
+		if (p->second->type () != DataType::AUDIO || !p->second->externally_connected ()) {
+			continue;
+		}
+		if (p->second->flags () & TransportSyncPort) {
+			continue;
+		}
+		boost::shared_ptr<AudioPort> ap = boost::dynamic_pointer_cast<AudioPort> (p->second);
+		if (ap->sends_output ()) {
+			outputs.push_back (ap);
+		} else {
+			inputs.push_back (ap);
+		}
+	}
+
+	AudioPortResampler* ar = 0;
+	if (!inputs.empty () || !outputs.empty ()) {
+		ar = new AudioPortResampler (inputs, outputs, Port::resampler_quality ());
+	}
+
+	DEBUG_TRACE (DEBUG::Ports, string_compose ("port resampler: %1 inputs, %2 outputs\n", inputs.size (), outputs.size ()));
+
+	Glib::Threads::Mutex::Lock lm (_port_resampler_lock);
+
+	/* the process-thread only changes _port_resampler while holding the lock */
+	if (ar) {
+		ar->prepare_inherit (_port_resampler);
+	}
+
+	delete _port_resampler_pending;
+	delete _port_resampler_retired;
+	_port_resampler_retired = 0;
+	_port_resampler_pending = ar;
+	g_atomic_int_set (&_port_resampler_update, 1);
+}
+
+void
+PortManager::rebuild_port_resampler ()
+{
+	if (g_atomic_int_get (&_port_resampler_rebuild) == 0) {
+		return;
+	}
+	/* reset first, a connection change while rebuilding requests another pass */
+	g_atomic_int_set (&_port_resampler_rebuild, 0);
+	update_port_resampler ();
+}
+
+void
+PortManager::switch_port_resampler ()
+{
+	/* caller must hold _port_resampler_lock, and either be the
+	 * process-thread or hold the process lock */
+	if (!g_atomic_int_get (&_port_resampler_update) || _port_resampler_retired) {
+		return;
+	}
+
+	AudioPortResampler* ar = _port_resampler_pending;
+
+	if (ar) {
+		ar->inherit (_port_resampler);
+	}
+	if (_port_resampler) {
+		_port_resampler->set_active (false);
+	}
+	if (ar) {
+		ar->set_active (true);
+	}
+
+	_port_resampler_retired = _port_resampler;
+	_port_resampler         = ar;
+	_port_resampler_pending = 0;
+	g_atomic_int_set (&_port_resampler_update, 0);
+}
+
+void
+PortManager::drop_port_resampler ()
+{
+	/* process lock MUST be held by caller */
+	Glib::Threads::Mutex::Lock lm (_port_resampler_lock);
+	if (_port_resampler) {
+		_port_resampler->set_active (false);
+	}
+	delete _port_resampler;
+	delete _port_resampler_pending;
+	delete _port_resampler_retired;
+	_port_resampler         = 0;
+	_port_resampler_pending = 0;
+	_port_resampler_retired = 0;
+	g_atomic_int_set (&_port_resampler_update, 0);
 }
 
 bool
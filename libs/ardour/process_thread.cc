@@ -73,6 +73,21 @@ ProcessThread::drop_buffers ()
 	_private_thread_buffers.set (0);
 }
 
+void
+ProcessThread::reallocate_buffers ()
+{
+	ThreadBuffers* tb = _private_thread_buffers.get();
+	assert (tb);
+	tb->reallocate ();
+}
+
+int
+ProcessThread::thread_buffers_id ()
+{
+	ThreadBuffers* tb = _private_thread_buffers.get();
+	return tb ? (int) tb->id : -1;
+}
+
 BufferSet&
 ProcessThread::get_silent_buffers (ChanCount count)
 {
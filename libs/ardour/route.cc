@@ -57,6 +57,7 @@
 #include "ardour/buffer.h"
 #include "ardour/buffer_set.h"
 #include "ardour/capturing_processor.h"
+#include "ardour/cycle_trace.h"
 #include "ardour/debug.h"
 #include "ardour/delivery.h"
 #include "ardour/disk_reader.h"
@@ -524,6 +525,8 @@ Route::process_output_buffers (BufferSet& bufs,
 			latency += (*i)->effective_latency ();
 		}
 
+		CycleTrace::Scope cts (CycleTrace::Processor, **i);
+
 		if (speed < 0) {
 			(*i)->run (bufs, start_sample + latency, end_sample + latency, pspeed, nframes, *i != _processors.back());
 		} else {
@@ -287,3 +287,56 @@ ARDOUR::topological_sort (
 
 	return sorted_routes;
 }
+
+GraphReachability::GraphReachability (RouteList const& routes)
+	: _words ((routes.size () + 63) / 64)
+{
+	int32_t n = 0;
+	for (RouteList::const_iterator i = routes.begin(); i != routes.end(); ++i, ++n) {
+		_routes.push_back (i->get ());
+		_index[i->get ()] = n;
+	}
+
+	_fed_by.resize (_routes.size () * _words, 0);
+	_flags.resize (_words, 0);
+
+	n = 0;
+	for (RouteList::const_iterator i = routes.begin(); i != routes.end(); ++i, ++n) {
+		uint64_t* row = &_fed_by[n * _words];
+		Route::FedBy const& fed_by ((*i)->fed_by ());
+		for (Route::FedBy::const_iterator f = fed_by.begin(); f != fed_by.end(); ++f) {
+			boost::shared_ptr<Route> sr = f->r.lock ();
+			if (!sr) {
+				continue;
+			}
+			std::map<Route const*, int32_t>::const_iterator x = _index.find (sr.get ());
+			if (x != _index.end ()) {
+				row[x->second >> 6] |= (uint64_t) 1 << (x->second & 63);
+			}
+		}
+	}
+}
+
+int32_t
+GraphReachability::index (Route const* r, uint32_t hint) const
+{
+	if (hint < _routes.size () && _routes[hint] == r) {
+		return hint;
+	}
+	std::map<Route const*, int32_t>::const_iterator x = _index.find (r);
+	return x == _index.end () ? -1 : x->second;
+}
+
+bool
+GraphReachability::test_and_clear_flag (int32_t i) const
+{
+	if (i < 0) {
+		return false;
+	}
+	uint64_t const bit = (uint64_t) 1 << (i & 63);
+	if (_flags[i >> 6] & bit) {
+		_flags[i >> 6] &= ~bit;
+		return true;
+	}
+	return false;
+}
@@ -75,6 +75,7 @@
 #include "ardour/butler.h"
 #include "ardour/click.h"
 #include "ardour/control_protocol_manager.h"
+#include "ardour/cycle_trace.h"
 #include "ardour/data_type.h"
 #include "ardour/debug.h"
 #include "ardour/disk_reader.h"
@@ -316,6 +317,7 @@ Session::Session (AudioEngine &eng,
 	, _step_editors (0)
 	, _suspend_timecode_transmission (0)
 	,  _speakers (new Speakers)
+	, _route_reachability (new GraphReachability)
 	, _ignore_route_processor_changes (0)
 	, _ignored_a_processor_change (0)
 	, midi_clock (0)
@@ -325,6 +327,7 @@ Session::Session (AudioEngine &eng,
 	, _vca_manager (new VCAManager (*this))
 	, _selection (new CoreSelection (*this))
 	, _global_locate_pending (false)
+	, _process_pass (0)
 	, _had_destructive_tracks (false)
 {
 	created_with = string_compose ("%1 %2", PROGRAM_NAME, revision);
@@ -451,6 +454,9 @@ Session::Session (AudioEngine &eng,
 	Config->ParameterChanged.connect_same_thread (*this, boost::bind (&Session::config_changed, this, _1, false));
 	config.ParameterChanged.connect_same_thread (*this, boost::bind (&Session::config_changed, this, _1, true));
 
+	CycleTrace::set_name_lookup (boost::bind (&Session::object_name_by_id, this, _1));
+	CycleTrace::set_enabled (Config->get_cycle_trace ());
+
 	if (was_dirty) {
 		DirtyChanged (); /* EMIT SIGNAL */
 	}
@@ -582,6 +588,8 @@ Session::destroy ()
 
 	remove_pending_capture_state ();
 
+	CycleTrace::set_name_lookup (boost::function<std::string (PBD::ID const&)> ());
+
 	Analyser::flush ();
 
 	_state_of_the_state = StateOfTheState (CannotSave | Deletion);
@@ -769,7 +777,7 @@ Session::destroy ()
 		Glib::Threads::Mutex::Lock lm (AudioEngine::instance()->process_lock ());
 		SessionEvent *ev = immediate_events.front ();
 		DEBUG_TRACE (DEBUG::SessionEvents, string_compose ("Drop event: %1\n", enum_2_string (ev->type)));
-		immediate_events.pop_front ();
+		immediate_events.erase (immediate_events.begin ());
 		bool remove = true;
 		bool del = true;
 		switch (ev->type) {
@@ -2092,6 +2100,11 @@ Session::set_block_size (pframes_t nframes)
 
 	foreach_route (&Route::set_block_size, nframes);
 
+	VCAList v = _vca_manager->vcas ();
+	for (VCAList::const_iterator i = v.begin(); i != v.end(); ++i) {
+		(*i)->gain_control ()->allocate_curve_cache (nframes);
+	}
+
 	DEBUG_TRACE (DEBUG::LatencyCompensation, "Session::set_block_size -> update worst i/o latency\n");
 	/* when this is called from the auto-connect thread, the process-lock is held */
 	Glib::Threads::Mutex::Lock lx (_update_latency_lock);
@@ -2264,6 +2277,13 @@ Session::resort_routes_using (boost::shared_ptr<RouteList> r)
 
 		*r = *sorted_routes;
 
+		{
+			/* index the routes' fed_by(), in processing order */
+			RCUWriter<GraphReachability> writer (_route_reachability);
+			boost::shared_ptr<GraphReachability> gr = writer.get_copy ();
+			*gr = GraphReachability (*r);
+		}
+
 #ifndef NDEBUG
 		DEBUG_TRACE (DEBUG::Graph, "Routes resorted, order follows:\n");
 		for (RouteList::iterator i = r->begin(); i != r->end(); ++i) {
@@ -3692,7 +3712,12 @@ Session::route_solo_changed (bool self_solo_changed, Controllable::GroupControlD
 
 	DEBUG_TRACE (DEBUG::Solo, string_compose ("%1\n", route->name()));
 
-	for (RouteList::iterator i = r->begin(); i != r->end(); ++i) {
+	/* use the reachability index rather than searching each route's fed_by() */
+	boost::shared_ptr<GraphReachability> gr = _solo_batch ? _solo_batch : _route_reachability.reader ();
+	const int32_t ri = gr->index (route.get (), 0);
+	uint32_t n = 0;
+
+	for (RouteList::iterator i = r->begin(); i != r->end(); ++i, ++n) {
 		bool in_signal_flow;
 
 		if ((*i) == route) {
@@ -3718,9 +3743,11 @@ Session::route_solo_changed (bool self_solo_changed, Controllable::GroupControlD
 
 		in_signal_flow = false;
 
+		const int32_t ii = ri < 0 ? -1 : gr->index (i->get (), n);
+
 		DEBUG_TRACE (DEBUG::Solo, string_compose ("check feed from %1\n", (*i)->name()));
 
-		if ((*i)->feeds (route)) {
+		if (ii < 0 ? (*i)->feeds (route) : gr->feeds (ii, ri)) {
 			DEBUG_TRACE (DEBUG::Solo, string_compose ("\tthere is a feed from %1\n", (*i)->name()));
 			if (!route->soloed_by_others_upstream()) {
 				(*i)->solo_control()->mod_solo_by_others_downstream (delta);
@@ -3734,7 +3761,7 @@ Session::route_solo_changed (bool self_solo_changed, Controllable::GroupControlD
 
 		DEBUG_TRACE (DEBUG::Solo, string_compose ("check feed to %1\n", (*i)->name()));
 
-		if (route->feeds (*i)) {
+		if (ii < 0 ? route->feeds (*i) : gr->feeds (ri, ii)) {
 			DEBUG_TRACE (DEBUG::Solo, string_compose ("%1 feeds %2 sboD %3 sboU %4\n",
 			                                          route->name(),
 			                                          (*i)->name(),
@@ -3749,7 +3776,12 @@ Session::route_solo_changed (bool self_solo_changed, Controllable::GroupControlD
 		}
 
 		if (!in_signal_flow) {
-			uninvolved.push_back (*i);
+			if (_solo_batch && ii >= 0) {
+				/* act on mute only once, when the batch is complete */
+				gr->set_flag (ii);
+			} else {
+				uninvolved.push_back (*i);
+			}
 		}
 	}
 
@@ -3768,6 +3800,33 @@ Session::route_solo_changed (bool self_solo_changed, Controllable::GroupControlD
 	}
 }
 
+void
+Session::begin_solo_batch ()
+{
+	_solo_batch = _route_reachability.reader ();
+}
+
+void
+Session::end_solo_batch ()
+{
+	boost::shared_ptr<GraphReachability> gr;
+	gr.swap (_solo_batch);
+
+	if (!gr) {
+		return;
+	}
+
+	boost::shared_ptr<RouteList> r = routes.reader ();
+	uint32_t n = 0;
+
+	for (RouteList::iterator i = r->begin(); i != r->end(); ++i, ++n) {
+		if (gr->test_and_clear_flag (gr->index (i->get (), n))) {
+			DEBUG_TRACE (DEBUG::Solo, string_compose ("mute change for %1, after solo batch\n", (*i)->name()));
+			(*i)->act_on_mute ();
+		}
+	}
+}
+
 void
 Session::update_route_solo_state (boost::shared_ptr<RouteList> r)
 {
@@ -4104,6 +4163,20 @@ Session::processor_by_id (PBD::ID id) const
 	return boost::shared_ptr<Processor> ();
 }
 
+std::string
+Session::object_name_by_id (PBD::ID const& id) const
+{
+	boost::shared_ptr<Route> r = route_by_id (id);
+	if (r) {
+		return r->name ();
+	}
+	boost::shared_ptr<Processor> p = processor_by_id (id);
+	if (p) {
+		return p->name ();
+	}
+	return "";
+}
+
 boost::shared_ptr<Route>
 Session::get_remote_nth_route (PresentationInfo::order_t n) const
 {
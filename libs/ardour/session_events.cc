@@ -19,6 +19,7 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <algorithm>
 #include <cmath>
 #include <unistd.h>
 
@@ -63,6 +64,7 @@ SessionEvent::create_per_thread_pool (const std::string& name, uint32_t nitems)
 SessionEvent::SessionEvent (Type t, Action a, samplepos_t when, samplepos_t where, double spd, bool yn, bool yn2, bool yn3)
 	: type (t)
 	, action (a)
+	, seq (0)
 	, action_sample (when)
 	, target_sample (where)
 	, speed (spd)
@@ -166,12 +168,12 @@ SessionEventManager::dump_events () const
 	}
 	cerr << "Next event: ";
 
-	if ((Events::const_iterator) next_event == events.end()) {
+	if (!have_next_event ()) {
 		cerr << "none" << endl;
 	} else {
-		cerr << "at " << (*next_event)->action_sample << ' '
-		     << enum_2_string ((*next_event)->type) << " target = "
-		     << (*next_event)->target_sample << endl;
+		cerr << "at " << events[next_event]->action_sample << ' '
+		     << enum_2_string (events[next_event]->type) << " target = "
+		     << events[next_event]->target_sample << endl;
 	}
 	cerr << "Immediate events pending:\n";
 	for (Events::const_iterator i = immediate_events.begin(); i != immediate_events.end(); ++i) {
@@ -180,6 +182,53 @@ SessionEventManager::dump_events () const
 	cerr << "END EVENT_DUMP" << endl;
 }
 
+static bool
+event_before_sample (SessionEvent const* ev, samplepos_t sample)
+{
+	return ev->action_sample < sample;
+}
+
+SessionEventManager::Events::size_type
+SessionEventManager::first_event_at_or_after (samplepos_t sample) const
+{
+	return lower_bound (events.begin(), events.end(), sample, event_before_sample) - events.begin();
+}
+
+/** Add @a ev to the scheduled events, in front of any other events at the same sample */
+void
+SessionEventManager::insert_event (SessionEvent* ev)
+{
+	if (events.size () == events.capacity ()) {
+		DEBUG_TRACE (DEBUG::SessionEvents, string_compose ("Event queue is full (%1 events), allocating more space\n", events.size ()));
+	}
+	ev->seq = ++event_seq;
+	events.insert (events.begin() + first_event_at_or_after (ev->action_sample), ev);
+}
+
+void
+SessionEventManager::process_events_at (samplepos_t sample)
+{
+	/* Processing an event can remove other events (e.g. a RangeStop clears
+	 * pending RangeStop and RangeLocate events) or schedule new ones, and
+	 * both shift the array. So remember the events that are due, and look
+	 * up each of them again before processing it. An event that is
+	 * rescheduled gets a new sequence number.
+	 */
+	due_events.clear ();
+	for (Events::size_type n = first_event_at_or_after (sample); n < events.size() && events[n]->action_sample == sample; ++n) {
+		due_events.push_back (events[n]->seq);
+	}
+
+	for (vector<uint64_t>::const_iterator s = due_events.begin(); s != due_events.end(); ++s) {
+		for (Events::size_type n = first_event_at_or_after (sample); n < events.size() && events[n]->action_sample == sample; ++n) {
+			if (events[n]->seq == *s) {
+				process_event (events[n]);
+				break;
+			}
+		}
+	}
+}
+
 void
 SessionEventManager::merge_event (SessionEvent* ev)
 {
@@ -228,8 +277,8 @@ SessionEventManager::merge_event (SessionEvent* ev)
 		_clear_event_type (ev->type);
 		break;
 	default:
-		for (Events::iterator i = events.begin(); i != events.end(); ++i) {
-			if ((*i)->type == ev->type && (*i)->action_sample == ev->action_sample) {
+		for (Events::size_type n = first_event_at_or_after (ev->action_sample); n < events.size() && events[n]->action_sample == ev->action_sample; ++n) {
+			if (events[n]->type == ev->type) {
 			  error << string_compose(_("Session: cannot have two events of type %1 at the same sample (%2)."),
 						  enum_2_string (ev->type), ev->action_sample) << endmsg;
 				return;
@@ -237,9 +286,7 @@ SessionEventManager::merge_event (SessionEvent* ev)
 		}
 	}
 
-	events.insert (events.begin(), ev);
-	events.sort (SessionEvent::compare);
-	next_event = events.begin();
+	insert_event (ev);
 	set_next_event ();
 }
 
@@ -248,28 +295,33 @@ bool
 SessionEventManager::_replace_event (SessionEvent* ev)
 {
 	bool ret = false;
-	Events::iterator i;
+	bool found = false;
 
 	/* private, used only for events that can only exist once in the queue */
 
-	for (i = events.begin(); i != events.end(); ++i) {
+	for (Events::iterator i = events.begin(); i != events.end(); ++i) {
 		if ((*i)->type == ev->type) {
-			(*i)->action_sample = ev->action_sample;
-			(*i)->target_sample = ev->target_sample;
-			if ((*i) == ev) {
+			SessionEvent* existing = *i;
+			existing->action_sample = ev->action_sample;
+			existing->target_sample = ev->target_sample;
+			if (existing == ev) {
 				ret = true;
 			}
 			delete ev;
+			/* move it to its new position */
+			events.erase (i);
+			if (!ret) {
+				insert_event (existing);
+			}
+			found = true;
 			break;
 		}
 	}
 
-	if (i == events.end()) {
-		events.insert (events.begin(), ev);
+	if (!found) {
+		insert_event (ev);
 	}
 
-	events.sort (SessionEvent::compare);
-	next_event = events.end();
 	set_next_event ();
 
 	return ret;
@@ -280,62 +332,42 @@ bool
 SessionEventManager::_remove_event (SessionEvent* ev)
 {
 	bool ret = false;
-	Events::iterator i;
 
-	for (i = events.begin(); i != events.end(); ++i) {
-		if ((*i)->type == ev->type && (*i)->action_sample == ev->action_sample) {
-			if ((*i) == ev) {
+	for (Events::size_type n = first_event_at_or_after (ev->action_sample); n < events.size() && events[n]->action_sample == ev->action_sample; ++n) {
+		if (events[n]->type == ev->type) {
+			if (events[n] == ev) {
 				ret = true;
 			}
 
-			delete *i;
-			if (i == next_event) {
-				++next_event;
-			}
-			i = events.erase (i);
+			delete events[n];
+			events.erase (events.begin() + n);
+			set_next_event ();
 			break;
 		}
 	}
 
-	if (i != events.end()) {
-		set_next_event ();
-	}
-
 	return ret;
 }
 
 void
 SessionEventManager::_clear_event_type (SessionEvent::Type type)
 {
-	Events::iterator i, tmp;
-
-	for (i = events.begin(); i != events.end(); ) {
-
-		tmp = i;
-		++tmp;
-
+	for (Events::iterator i = events.begin(); i != events.end(); ) {
 		if ((*i)->type == type) {
 			delete *i;
-			if (i == next_event) {
-				++next_event;
-			}
-			events.erase (i);
+			i = events.erase (i);
+		} else {
+			++i;
 		}
-
-		i = tmp;
 	}
 
-	for (i = immediate_events.begin(); i != immediate_events.end(); ) {
-
-		tmp = i;
-		++tmp;
-
+	for (Events::iterator i = immediate_events.begin(); i != immediate_events.end(); ) {
 		if ((*i)->type == type) {
 			delete *i;
-			immediate_events.erase (i);
+			i = immediate_events.erase (i);
+		} else {
+			++i;
 		}
-
-		i = tmp;
 	}
 
 	set_next_event ();
@@ -39,8 +39,10 @@
 #include "ardour/auditioner.h"
 #include "ardour/butler.h"
 #include "ardour/cycle_timer.h"
+#include "ardour/cycle_trace.h"
 #include "ardour/debug.h"
 #include "ardour/disk_reader.h"
+#include "ardour/gain_control.h"
 #include "ardour/graph.h"
 #include "ardour/port.h"
 #include "ardour/process_thread.h"
@@ -178,8 +180,13 @@ Session::no_roll (pframes_t nframes)
 	for (VCAList::const_iterator i = v.begin(); i != v.end(); ++i) {
 		(*i)->automation_run (_transport_sample, nframes);
 	}
+	/* evaluate VCA master curves once, to be shared by all slaves */
+	for (VCAList::const_iterator i = v.begin(); i != v.end(); ++i) {
+		(*i)->gain_control ()->cache_masters_curve (_transport_sample, end_sample, nframes);
+	}
 
 	_global_locate_pending = locate_pending ();
+	++_process_pass;
 
 	if (_process_graph) {
 		DEBUG_TRACE(DEBUG::ProcessThreads,"calling graph/no-roll\n");
@@ -220,8 +227,13 @@ Session::process_routes (pframes_t nframes, bool& need_butler)
 	for (VCAList::const_iterator i = v.begin(); i != v.end(); ++i) {
 		(*i)->automation_run (start_sample, nframes);
 	}
+	/* evaluate VCA master curves once, to be shared by all slaves */
+	for (VCAList::const_iterator i = v.begin(); i != v.end(); ++i) {
+		(*i)->gain_control ()->cache_masters_curve (start_sample, end_sample, nframes);
+	}
 
 	_global_locate_pending = locate_pending();
+	++_process_pass;
 
 	if (_process_graph) {
 		DEBUG_TRACE(DEBUG::ProcessThreads,"calling graph/process-routes\n");
@@ -241,6 +253,8 @@ Session::process_routes (pframes_t nframes, bool& need_butler)
 
 			bool b = false;
 
+			CycleTrace::Scope cts (CycleTrace::Route, **i);
+
 			if ((ret = (*i)->roll (nframes, start_sample, end_sample, b)) < 0) {
 				TFSM_STOP (false, false);
 				return -1;
@@ -352,7 +366,7 @@ Session::process_with_events (pframes_t nframes)
 
 	while (!non_realtime_work_pending() && !immediate_events.empty()) {
 		SessionEvent *ev = immediate_events.front ();
-		immediate_events.pop_front ();
+		immediate_events.erase (immediate_events.begin ());
 		process_event (ev);
 	}
 	/* only count-in when going to roll at speed 1.0 */
@@ -404,20 +418,8 @@ Session::process_with_events (pframes_t nframes)
 		nframes -= ns;
 
 		/* process events.. */
-		if (!events.empty() && next_event != events.end()) {
-			SessionEvent* this_event = *next_event;
-			Events::iterator the_next_one = next_event;
-			++the_next_one;
-
-			while (this_event && this_event->action_sample == _transport_sample) {
-				process_event (this_event);
-				if (the_next_one == events.end()) {
-					this_event = 0;
-				} else {
-					this_event = *the_next_one;
-					++the_next_one;
-				}
-			}
+		if (have_next_event ()) {
+			process_events_at (_transport_sample);
 			set_next_event ();
 		}
 
@@ -471,13 +473,13 @@ Session::process_with_events (pframes_t nframes)
 		return;
 	}
 
-	if (events.empty() || next_event == events.end()) {
+	if (!have_next_event ()) {
 		try_run_lua (nframes); // also during export ?? ->move to process_without_events()
 		/* lua scripts may inject events */
 		while (_n_lua_scripts > 0 && pending_events.read (&ev, 1) == 1) {
 			merge_event (ev);
 		}
-		if (events.empty() || next_event == events.end()) {
+		if (!have_next_event ()) {
 			process_without_events (nframes);
 			return;
 		}
@@ -492,7 +494,6 @@ Session::process_with_events (pframes_t nframes)
 
 	{
 		SessionEvent* this_event;
-		Events::iterator the_next_one;
 
 		if (!process_can_proceed()) {
 			_silent = true;
@@ -523,9 +524,7 @@ Session::process_with_events (pframes_t nframes)
 			return;
 		}
 
-		this_event = *next_event;
-		the_next_one = next_event;
-		++the_next_one;
+		this_event = event_at (next_event);
 
 		/* yes folks, here it is, the actual loop where we really truly
 		   process some audio
@@ -581,15 +580,10 @@ Session::process_with_events (pframes_t nframes)
 
 			/* now handle this event and all others scheduled for the same time */
 
-			while (this_event && this_event->action_sample == _transport_sample) {
-				process_event (this_event);
-
-				if (the_next_one == events.end()) {
-					this_event = 0;
-				} else {
-					this_event = *the_next_one;
-					++the_next_one;
-				}
+			if (this_event && this_event->action_sample == _transport_sample) {
+				const samplepos_t when = _transport_sample;
+				process_events_at (when);
+				this_event = event_at (first_event_at_or_after (when + 1));
 			}
 
 			/* if an event left our state changing, do the right thing */
@@ -735,7 +729,7 @@ Session::process_audition (pframes_t nframes)
 
 	while (!non_realtime_work_pending() && !immediate_events.empty()) {
 		SessionEvent *ev = immediate_events.front ();
-		immediate_events.pop_front ();
+		immediate_events.erase (immediate_events.begin ());
 		process_event (ev);
 	}
 
@@ -808,24 +802,7 @@ Session::queue_event (SessionEvent* ev)
 void
 Session::set_next_event ()
 {
-	if (events.empty()) {
-		next_event = events.end();
-		return;
-	}
-
-	if (next_event == events.end()) {
-		next_event = events.begin();
-	}
-
-	if ((*next_event)->action_sample > _transport_sample) {
-		next_event = events.begin();
-	}
-
-	for (; next_event != events.end(); ++next_event) {
-		if ((*next_event)->action_sample >= _transport_sample) {
-			break;
-		}
-	}
+	next_event = first_event_at_or_after (_transport_sample);
 }
 
 void
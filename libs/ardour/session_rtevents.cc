@@ -73,10 +73,21 @@ Session::rt_set_controls (boost::shared_ptr<ControlList> cl, double val, Control
 		return;
 	}
 
+	const bool solo = cl->front()->parameter().type() == SoloAutomation;
+
+	if (solo) {
+		/* coalesce mute changes of routes not involved in the solo */
+		begin_solo_batch ();
+	}
+
 	for (ControlList::iterator c = cl->begin(); c != cl->end(); ++c) {
 		(*c)->set_value (val, gcd);
 	}
 
+	if (solo) {
+		end_solo_batch ();
+	}
+
 	/* some controls need global work to take place after they are set. Do
 	 * that here.
 	 */
@@ -99,6 +110,8 @@ Session::clear_all_solo_state (boost::shared_ptr<RouteList> rl)
 void
 Session::rt_clear_all_solo_state (boost::shared_ptr<RouteList> rl, bool /* yn */, Controllable::GroupControlDisposition /* group_override */)
 {
+	begin_solo_batch ();
+
 	for (RouteList::iterator i = rl->begin(); i != rl->end(); ++i) {
 		if ((*i)->is_auditioner()) {
 			continue;
@@ -108,6 +121,8 @@ Session::rt_clear_all_solo_state (boost::shared_ptr<RouteList> rl, bool /* yn */
 
 	_vca_manager->clear_all_solo_state ();
 
+	end_solo_batch ();
+
 	update_route_solo_state ();
 }
 
@@ -101,6 +101,7 @@
 #include "ardour/boost_debug.h"
 #include "ardour/butler.h"
 #include "ardour/control_protocol_manager.h"
+#include "ardour/cycle_trace.h"
 #include "ardour/directory_names.h"
 #include "ardour/disk_reader.h"
 #include "ardour/filename_extensions.h"
@@ -4238,6 +4239,8 @@ Session::config_changed (std::string p, bool ours)
 			_master_out->set_volume_applies_to_output (true);
 			master_volume ()->set_value (GAIN_COEFF_UNITY, Controllable::NoGroup);
 		}
+	} else if (p == "cycle-trace") {
+		CycleTrace::set_enabled (Config->get_cycle_trace ());
 	}
 
 	set_dirty ();
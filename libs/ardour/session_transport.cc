@@ -51,6 +51,7 @@
 #include "ardour/automation_watch.h"
 #include "ardour/butler.h"
 #include "ardour/click.h"
+#include "ardour/cycle_trace.h"
 #include "ardour/debug.h"
 #include "ardour/disk_reader.h"
 #include "ardour/location.h"
@@ -1845,6 +1846,11 @@ Session::xrun_recovery ()
 
 	Xrun (_transport_sample); /* EMIT SIGNAL */
 
+	if (CycleTrace::xrun ()) {
+		/* the butler writes the trace to disk */
+		_butler->summon ();
+	}
+
 	if (Config->get_stop_recording_on_xrun() && actively_recording()) {
 
 		/* it didn't actually halt, but we need
@@ -46,7 +46,13 @@ SlavableAutomationControl::SlavableAutomationControl(ARDOUR::Session& s,
                                                      const std::string&                        name,
                                                      Controllable::Flag                        flags)
 	: AutomationControl (s, parameter, desc, l, name, flags)
+	, _master_chain (new MasterChain)
 	, _masters_node (0)
+	, _curve_cache_cycle (0)
+	, _curve_cache_start (0)
+	, _curve_cache_end (0)
+	, _curve_cache_len (0)
+	, _curve_cache_automated (false)
 {
 }
 
@@ -68,16 +74,45 @@ SlavableAutomationControl::get_masters_value_locked () const
 			}
 		}
 		return _desc.lower;
-	} else {
+	}
+
+	double v = 1.0; /* the masters function as a scaling factor */
 
-		double v = 1.0; /* the masters function as a scaling factor */
+	boost::shared_ptr<MasterChain> mc = _master_chain.reader ();
 
+	if (!mc->flat) {
 		for (Masters::const_iterator mr = _masters.begin(); mr != _masters.end(); ++mr) {
 			v *= mr->second.master_ratio ();
 		}
-
 		return v;
 	}
+
+	/* Same as multiplying the master_ratio() of every direct master, but
+	 * without recursing into each master's ::get_value() and its lock.
+	 */
+	const samplepos_t now = _session.transport_sample ();
+
+	for (size_t i = 0; i < mc->entries.size (); ++i) {
+		MasterChain::Entry const& e (mc->entries[i]);
+		boost::shared_ptr<SlavableAutomationControl> m = e.master.lock ();
+		if (!m) {
+			/* master is going away */
+			i += e.n_nested;
+			continue;
+		}
+		/* see SlavableAutomationControl::get_value () */
+		if (m->automation_playback ()) {
+			v *= m->Control::get_double (true, now) * e.ratio;
+		} else {
+			v *= m->Control::user_double () * e.ratio;
+			if (e.n_nested > 0 && m->automation_write ()) {
+				/* writing automation takes the fader value as-is */
+				i += e.n_nested;
+			}
+		}
+	}
+
+	return v;
 }
 
 double
@@ -145,18 +180,112 @@ SlavableAutomationControl::masters_curve_multiply (samplepos_t start, samplepos_
 	} else {
 		apply_gain_to_buffer (vec, veclen, Control::get_double ());
 	}
-	if (_masters.empty()) {
-		return rv;
+
+	/* use the master chain, rather than _masters, this is called
+	 * recursively without holding the master's master_lock */
+	boost::shared_ptr<MasterChain> mc = _master_chain.reader ();
+
+	for (size_t i = 0; i < mc->entries.size (); i += mc->entries[i].n_nested + 1) {
+		MasterChain::Entry const& e (mc->entries[i]);
+		boost::shared_ptr<SlavableAutomationControl> sc = e.master.lock ();
+		if (!sc) {
+			continue;
+		}
+		if (!sc->cached_curve_multiply (start, end, vec, veclen, e.ratio, rv)) {
+			rv |= sc->masters_curve_multiply (start, end, vec, veclen);
+			apply_gain_to_buffer (vec, veclen, e.ratio);
+		}
+	}
+	return rv;
+}
+
+void
+SlavableAutomationControl::allocate_curve_cache (samplecnt_t nframes)
+{
+	_curve_cache.resize (nframes);
+	_curve_cache_len = 0;
+}
+
+void
+SlavableAutomationControl::cache_masters_curve (samplepos_t start, samplepos_t end, samplecnt_t nframes)
+{
+	_curve_cache_len = 0; /* invalidate */
+
+	if (_desc.toggled || nframes <= 0 || (samplecnt_t) _curve_cache.size () < nframes) {
+		return;
+	}
+
+	gain_t* c = &_curve_cache[0];
+	for (samplecnt_t i = 0; i < nframes; ++i) {
+		c[i] = 1.f;
+	}
+
+	_curve_cache_automated = masters_curve_multiply (start, end, c, nframes);
+	_curve_cache_start     = start;
+	_curve_cache_end       = end;
+	_curve_cache_cycle     = _session.engine ().processed_samples ();
+	_curve_cache_len       = nframes;
+}
+
+bool
+SlavableAutomationControl::cached_curve_multiply (samplepos_t start, samplepos_t end, float* vec, samplecnt_t veclen, double ratio, bool& rv) const
+{
+	if (_curve_cache_len == 0 || _curve_cache_cycle != _session.engine ().processed_samples ()) {
+		return false;
+	}
+
+	if (!_curve_cache_automated) {
+		/* constant during this cycle, regardless of the slave's latency offset */
+		apply_gain_to_buffer (vec, veclen, _curve_cache[0] * ratio);
+		return true;
 	}
 
+	if (_curve_cache_start != start || _curve_cache_end != end || _curve_cache_len != veclen) {
+		return false;
+	}
+
+	const gain_t g = ratio;
+	for (samplecnt_t i = 0; i < veclen; ++i) {
+		vec[i] *= _curve_cache[i] * g;
+	}
+	rv = true;
+	return true;
+}
+
+void
+SlavableAutomationControl::update_master_chain ()
+{
+	/* CALLER MUST HOLD master_lock */
+
+	RCUWriter<MasterChain> writer (_master_chain);
+	boost::shared_ptr<MasterChain> mc = writer.get_copy ();
+
+	mc->entries.clear ();
+	mc->flat = !_desc.toggled;
+
 	for (Masters::const_iterator mr = _masters.begin(); mr != _masters.end(); ++mr) {
 		boost::shared_ptr<SlavableAutomationControl> sc
 			= boost::dynamic_pointer_cast<SlavableAutomationControl>(mr->second.master());
-		assert (sc);
-		rv |= sc->masters_curve_multiply (start, end, vec, veclen);
-		apply_gain_to_buffer (vec, veclen, mr->second.val_master_inv ());
+		if (!sc) {
+			mc->flat = false;
+			continue;
+		}
+		boost::shared_ptr<MasterChain> nested = sc->_master_chain.reader ();
+		mc->entries.push_back (MasterChain::Entry (sc, mr->second.val_master_inv (), nested->entries.size ()));
+		mc->entries.insert (mc->entries.end (), nested->entries.begin (), nested->entries.end ());
+		mc->flat = mc->flat && nested->flat && !sc->toggled ();
 	}
-	return rv;
+}
+
+void
+SlavableAutomationControl::master_chain_changed ()
+{
+	/* a master's masters changed, our copy of its chain is outdated */
+	{
+		Glib::Threads::RWLock::ReaderLock lm (master_lock);
+		update_master_chain ();
+	}
+	MasterChainChanged (); /* EMIT SIGNAL */
 }
 
 double
@@ -223,12 +352,21 @@ SlavableAutomationControl::add_master (boost::shared_ptr<AutomationControl> m)
 			*/
 
 			m->Changed.connect_same_thread (res.first->second.changed_connection, boost::bind (&SlavableAutomationControl::master_changed, this, _1, _2, boost::weak_ptr<AutomationControl>(m)));
+
+			/* nested VCAs: follow changes of the master's own masters */
+			boost::shared_ptr<SlavableAutomationControl> sc = boost::dynamic_pointer_cast<SlavableAutomationControl>(m);
+			if (sc) {
+				sc->MasterChainChanged.connect_same_thread (res.first->second.chain_connection, boost::bind (&SlavableAutomationControl::master_chain_changed, this));
+			}
+
+			update_master_chain ();
 		}
 	}
 
 	if (res.second) {
 		/* this will notify everyone that we're now slaved to the master */
 		MasterStatusChange (); /* EMIT SIGNAL */
+		MasterChainChanged (); /* EMIT SIGNAL */
 	}
 
 	post_add_master (m);
@@ -361,6 +499,8 @@ SlavableAutomationControl::remove_master (boost::shared_ptr<AutomationControl> m
 		if (!_masters.erase (m->id())) {
 			return;
 		}
+
+		update_master_chain ();
 	}
 
 	if (update_value) {
@@ -391,6 +531,7 @@ SlavableAutomationControl::remove_master (boost::shared_ptr<AutomationControl> m
 	}
 
 	MasterStatusChange (); /* EMIT SIGNAL */
+	MasterChainChanged (); /* EMIT SIGNAL */
 
 	/* no need to update boolean masters records, since the MR will have
 	 * been removed already.
@@ -434,6 +575,7 @@ SlavableAutomationControl::clear_masters ()
 		master_ratio = get_masters_value_locked ();
 		update_value = true;
 		_masters.clear ();
+		update_master_chain ();
 	}
 
 	if (update_value) {
@@ -464,6 +606,7 @@ SlavableAutomationControl::clear_masters ()
 	}
 
 	MasterStatusChange (); /* EMIT SIGNAL */
+	MasterChainChanged (); /* EMIT SIGNAL */
 
 	/* no need to update boolean masters records, since all MRs will have
 	 * been removed already.
@@ -629,27 +772,32 @@ SlavableAutomationControl::use_saved_master_ratios ()
 		return;
 	}
 
-	Glib::Threads::RWLock::ReaderLock lm (master_lock);
+	{
+		Glib::Threads::RWLock::ReaderLock lm (master_lock);
 
-	XMLNodeList nlist = _masters_node->children();
-	XMLNodeIterator niter;
+		XMLNodeList nlist = _masters_node->children();
+		XMLNodeIterator niter;
 
-	for (niter = nlist.begin(); niter != nlist.end(); ++niter) {
-		ID id_val;
-		if (!(*niter)->get_property (X_("id"), id_val)) {
-			continue;
-		}
-		Masters::iterator mi = _masters.find (id_val);
-		if (mi == _masters.end()) {
-			continue;
+		for (niter = nlist.begin(); niter != nlist.end(); ++niter) {
+			ID id_val;
+			if (!(*niter)->get_property (X_("id"), id_val)) {
+				continue;
+			}
+			Masters::iterator mi = _masters.find (id_val);
+			if (mi == _masters.end()) {
+				continue;
+			}
+			mi->second.set_state (**niter, Stateful::loading_state_version);
 		}
-		mi->second.set_state (**niter, Stateful::loading_state_version);
-	}
 
-	delete _masters_node;
-	_masters_node = 0;
+		delete _masters_node;
+		_masters_node = 0;
+
+		/* the chain holds a copy of the ratios */
+		update_master_chain ();
+	}
 
-	return;
+	MasterChainChanged (); /* EMIT SIGNAL */
 }
 
 
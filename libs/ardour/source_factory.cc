@@ -24,6 +24,7 @@
 #include "libardour-config.h"
 #endif
 
+#include "pbd/cpus.h"
 #include "pbd/error.h"
 #include "pbd/convert.h"
 #include "pbd/pthread_utils.h"
@@ -32,9 +33,11 @@
 #include "ardour/audioplaylist.h"
 #include "ardour/audio_playlist_source.h"
 #include "ardour/boost_debug.h"
+#include "ardour/debug.h"
 #include "ardour/midi_playlist.h"
 #include "ardour/midi_playlist_source.h"
 #include "ardour/mp3filesource.h"
+#include "ardour/rc_configuration.h"
 #include "ardour/source.h"
 #include "ardour/source_factory.h"
 #include "ardour/sndfilesource.h"
@@ -56,6 +59,8 @@ PBD::Signal1<void,boost::shared_ptr<Source> > SourceFactory::SourceCreated;
 Glib::Threads::Cond SourceFactory::PeaksToBuild;
 Glib::Threads::Mutex SourceFactory::peak_building_lock;
 std::list<boost::weak_ptr<AudioSource> > SourceFactory::files_with_peaks;
+std::map<AudioSource const*, SourceFactory::PeakQueue::iterator> SourceFactory::queued_peaks;
+SourceFactory::PeakBuildStats SourceFactory::peak_build_stats_unlocked;
 
 static int active_threads = 0;
 
@@ -79,18 +84,43 @@ peak_thread_work ()
 		}
 
 		boost::shared_ptr<AudioSource> as (SourceFactory::files_with_peaks.front().lock());
+		std::map<AudioSource const*, SourceFactory::PeakQueue::iterator>::iterator q;
+		if (as) {
+			q = SourceFactory::queued_peaks.find (as.get ());
+		} else {
+			/* source is gone, the index has a dangling key */
+			for (q = SourceFactory::queued_peaks.begin (); q != SourceFactory::queued_peaks.end (); ++q) {
+				if (q->second == SourceFactory::files_with_peaks.begin ()) {
+					break;
+				}
+			}
+		}
+		/* the source may have been queued more than once */
+		if (q != SourceFactory::queued_peaks.end () && q->second == SourceFactory::files_with_peaks.begin ()) {
+			SourceFactory::queued_peaks.erase (q);
+		}
 		SourceFactory::files_with_peaks.pop_front ();
-		++active_threads;
-		SourceFactory::peak_building_lock.unlock ();
 
 		if (!as) {
+			SourceFactory::peak_building_lock.unlock ();
 			continue;
 		}
 
+		++active_threads;
+		SourceFactory::peak_building_lock.unlock ();
+
+		const int64_t start = g_get_monotonic_time ();
 		as->setup_peakfile ();
+		const int64_t elapsed = g_get_monotonic_time () - start;
+
 		SourceFactory::peak_building_lock.lock ();
 		--active_threads;
+		++SourceFactory::peak_build_stats_unlocked.n_sources;
+		SourceFactory::peak_build_stats_unlocked.n_samples += as->length (0);
+		SourceFactory::peak_build_stats_unlocked.usec += elapsed;
 		SourceFactory::peak_building_lock.unlock ();
+
+		DEBUG_TRACE (DEBUG::Peaks, string_compose ("Peak builder: %1 took %2 ms\n", as->name (), elapsed / 1000.0));
 	}
 }
 
@@ -105,11 +135,42 @@ SourceFactory::peak_work_queue_length ()
 void
 SourceFactory::init ()
 {
-	for (int n = 0; n < 2; ++n) {
+	uint32_t n_threads = Config->get_peak_builder_threads ();
+	if (n_threads == 0) {
+		n_threads = hardware_concurrency ();
+	}
+	n_threads = std::max<uint32_t> (1, n_threads);
+
+	for (uint32_t n = 0; n < n_threads; ++n) {
 		Glib::Threads::Thread::create (sigc::ptr_fun (::peak_thread_work));
 	}
 }
 
+void
+SourceFactory::prioritize_peakfile (boost::shared_ptr<Source> s)
+{
+	if (!s) {
+		return;
+	}
+
+	Glib::Threads::Mutex::Lock lm (peak_building_lock);
+
+	std::map<AudioSource const*, PeakQueue::iterator>::const_iterator q = queued_peaks.find (dynamic_cast<AudioSource const*> (s.get ()));
+
+	if (q == queued_peaks.end () || q->second == files_with_peaks.begin ()) {
+		return;
+	}
+
+	files_with_peaks.splice (files_with_peaks.begin (), files_with_peaks, q->second);
+}
+
+SourceFactory::PeakBuildStats
+SourceFactory::peak_build_stats ()
+{
+	Glib::Threads::Mutex::Lock lm (peak_building_lock);
+	return peak_build_stats_unlocked;
+}
+
 int
 SourceFactory::setup_peakfile (boost::shared_ptr<Source> s, bool async)
 {
@@ -122,6 +183,7 @@ SourceFactory::setup_peakfile (boost::shared_ptr<Source> s, bool async)
 
 			Glib::Threads::Mutex::Lock lm (peak_building_lock);
 			files_with_peaks.push_back (boost::weak_ptr<AudioSource> (as));
+			queued_peaks[as.get ()] = --files_with_peaks.end ();
 			PeaksToBuild.broadcast ();
 
 		} else {
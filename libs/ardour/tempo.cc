@@ -723,6 +723,8 @@ struct MetricSectionFrameSorter {
 };
 
 TempoMap::TempoMap (samplecnt_t fr)
+	: _generation (0)
+	, _index (new SectionIndex)
 {
 	_sample_rate = fr;
 	BBT_Time start (1, 1, 0);
@@ -740,6 +742,7 @@ TempoMap::TempoMap (samplecnt_t fr)
 	_metrics.push_back (t);
 	_metrics.push_back (m);
 
+	update_index ();
 }
 
 TempoMap&
@@ -769,6 +772,8 @@ TempoMap::operator= (TempoMap const & other)
 				_metrics.push_back (new_section);
 			}
 		}
+
+		update_index ();
 	}
 
 	PropertyChanged (PropertyChange());
@@ -822,6 +827,8 @@ TempoMap::remove_tempo_locked (const TempoSection& tempo)
 {
 	Metrics::iterator i;
 
+	g_atomic_int_inc (&_generation);
+
 	for (i = _metrics.begin(); i != _metrics.end(); ++i) {
 		if (dynamic_cast<TempoSection*> (*i) != 0) {
 			if (tempo.sample() == (*i)->sample()) {
@@ -859,6 +866,7 @@ TempoMap::remove_meter (const MeterSection& tempo, bool complete_operation)
 bool
 TempoMap::remove_meter_locked (const MeterSection& meter)
 {
+	g_atomic_int_inc (&_generation);
 
 	if (meter.position_lock_style() == AudioTime) {
 		/* remove meter-locked tempo */
@@ -893,6 +901,9 @@ void
 TempoMap::do_insert (MetricSection* section)
 {
 	bool need_add = true;
+
+	g_atomic_int_inc (&_generation);
+
 	/* we only allow new meters to be inserted on beat 1 of an existing
 	 * measure.
 	 */
@@ -1397,6 +1408,10 @@ TempoMap::recompute_tempi (Metrics& metrics)
 {
 	TempoSection* prev_t = 0;
 
+	if (&metrics == &_metrics) {
+		g_atomic_int_inc (&_generation);
+	}
+
 	for (Metrics::const_iterator i = metrics.begin(); i != metrics.end(); ++i) {
 		TempoSection* t;
 
@@ -1431,6 +1446,10 @@ TempoMap::recompute_tempi (Metrics& metrics)
 	}
 	assert (prev_t);
 	prev_t->set_c (0.0);
+
+	if (&metrics == &_metrics) {
+		update_index ();
+	}
 }
 
 /* tempos must be positioned correctly.
@@ -1444,6 +1463,10 @@ TempoMap::recompute_meters (Metrics& metrics)
 	MeterSection* meter = 0;
 	MeterSection* prev_m = 0;
 
+	if (&metrics == &_metrics) {
+		g_atomic_int_inc (&_generation);
+	}
+
 	for (Metrics::const_iterator mi = metrics.begin(); mi != metrics.end(); ++mi) {
 		if (!(*mi)->is_tempo()) {
 			meter = static_cast<MeterSection*> (*mi);
@@ -1513,6 +1536,331 @@ TempoMap::recompute_meters (Metrics& metrics)
 			prev_m = meter;
 		}
 	}
+
+	if (&metrics == &_metrics) {
+		update_index ();
+	}
+}
+
+template<typename T> static bool
+monotonic (T b, T e)
+{
+	if (b == e) {
+		return true;
+	}
+	for (T n = b + 1; n != e; b = n, ++n) {
+		if (*n < *b) {
+			return false;
+		}
+	}
+	return true;
+}
+
+TempoMap::SectionIndex::SectionIndex (Metrics const& metrics, gint gen)
+	: generation (gen)
+{
+	for (Metrics::const_iterator i = metrics.begin(); i != metrics.end(); ++i) {
+		if ((*i)->is_tempo()) {
+			TempoSection* t = static_cast<TempoSection*> (*i);
+			if (!t->active()) {
+				continue;
+			}
+			live_tempi.push_back (t);
+			tempi.push_back (boost::shared_ptr<TempoSection const> (new TempoSection (*t)));
+			_t_minute.push_back (t->minute());
+			_t_pulse.push_back (t->pulse());
+		} else {
+			MeterSection* m = static_cast<MeterSection*> (*i);
+			live_meters.push_back (m);
+			meters.push_back (boost::shared_ptr<MeterSection const> (new MeterSection (*m)));
+			_m_minute.push_back (m->minute());
+			_m_beat.push_back (m->beat());
+			_m_pulse.push_back (m->pulse());
+			_m_bars.push_back (m->bbt().bars);
+		}
+	}
+
+	/* sections are usually in order, but audio-locked sections may not be */
+	_t_minute_sorted = monotonic (_t_minute.begin (), _t_minute.end ());
+	_t_pulse_sorted  = monotonic (_t_pulse.begin (), _t_pulse.end ());
+	_m_minute_sorted = monotonic (_m_minute.begin (), _m_minute.end ());
+	_m_beat_sorted   = monotonic (_m_beat.begin (), _m_beat.end ());
+	_m_pulse_sorted  = monotonic (_m_pulse.begin (), _m_pulse.end ());
+	_m_bars_sorted   = monotonic (_m_bars.begin (), _m_bars.end ());
+}
+
+/** Returns the index of the last section whose key is <= x, but at least the first one.
+ * This is the same result as a linear search that stops at the first key > x.
+ */
+template<typename T> size_t
+TempoMap::SectionIndex::find (std::vector<T> const& keys, bool sorted, T const& x)
+{
+	assert (!keys.empty ());
+	if (sorted) {
+		typename std::vector<T>::const_iterator i = upper_bound (keys.begin () + 1, keys.end (), x);
+		return (i - keys.begin ()) - 1;
+	}
+	size_t n = 1;
+	while (n < keys.size () && !(keys[n] > x)) {
+		++n;
+	}
+	return n - 1;
+}
+
+size_t
+TempoMap::SectionIndex::tempo_at_minute_index (double minute) const
+{
+	return find (_t_minute, _t_minute_sorted, minute);
+}
+
+size_t
+TempoMap::SectionIndex::tempo_at_pulse_index (double pulse) const
+{
+	return find (_t_pulse, _t_pulse_sorted, pulse);
+}
+
+size_t
+TempoMap::SectionIndex::tempo_at_beat_index (MeterSection const& m, double beat) const
+{
+	/* the last tempo starting at or before the beat, relative to meter m.
+	 * Search by pulse, then correct for rounding using the beat. */
+	size_t const n = tempi.size ();
+	size_t i;
+
+	if (_t_pulse_sorted) {
+		i = find (_t_pulse, true, ((beat - m.beat()) / m.note_divisor()) + m.pulse());
+	} else {
+		i = 0;
+	}
+
+	while (i + 1 < n && !(((_t_pulse[i + 1] - m.pulse()) * m.note_divisor()) + m.beat() > beat)) {
+		++i;
+	}
+	while (_t_pulse_sorted && i > 0 && ((_t_pulse[i] - m.pulse()) * m.note_divisor()) + m.beat() > beat) {
+		--i;
+	}
+	return i;
+}
+
+size_t
+TempoMap::SectionIndex::meter_at_minute_index (double minute) const
+{
+	return find (_m_minute, _m_minute_sorted, minute);
+}
+
+size_t
+TempoMap::SectionIndex::meter_at_beat_index (double beat) const
+{
+	return find (_m_beat, _m_beat_sorted, beat);
+}
+
+size_t
+TempoMap::SectionIndex::meter_at_pulse_index (double pulse) const
+{
+	return find (_m_pulse, _m_pulse_sorted, pulse);
+}
+
+size_t
+TempoMap::SectionIndex::meter_at_bars_index (int32_t bars) const
+{
+	return find (_m_bars, _m_bars_sorted, bars);
+}
+
+double
+TempoMap::SectionIndex::pulse_at_minute (double minute) const
+{
+	size_t const i = tempo_at_minute_index (minute);
+	TempoSection const& prev_t (*tempi[i]);
+
+	if (i + 1 < tempi.size ()) {
+		const double ret = prev_t.pulse_at_minute (minute);
+		/* audio locked section in new meter*/
+		if (_t_pulse[i + 1] < ret) {
+			return _t_pulse[i + 1];
+		}
+		return ret;
+	}
+
+	/* treated as constant for this ts */
+	const double pulses_in_section = ((minute - prev_t.minute()) * prev_t.note_types_per_minute()) / prev_t.note_type();
+
+	return pulses_in_section + prev_t.pulse();
+}
+
+double
+TempoMap::SectionIndex::minute_at_pulse (double pulse) const
+{
+	size_t const i = tempo_at_pulse_index (pulse);
+	TempoSection const& prev_t (*tempi[i]);
+
+	if (i + 1 < tempi.size ()) {
+		return prev_t.minute_at_pulse (pulse);
+	}
+
+	/* must be treated as constant, irrespective of _type */
+	double const dtime = ((pulse - prev_t.pulse()) * prev_t.note_type()) / prev_t.note_types_per_minute();
+
+	return dtime + prev_t.minute();
+}
+
+double
+TempoMap::SectionIndex::beat_at_minute (double minute) const
+{
+	TempoSection const& ts (*tempi[tempo_at_minute_index (minute)]);
+	size_t const i = meter_at_minute_index (minute);
+	MeterSection const& prev_m (*meters[i]);
+
+	const double beat = prev_m.beat() + (ts.pulse_at_minute (minute) - prev_m.pulse()) * prev_m.note_divisor();
+
+	/* audio locked meters fake their beat */
+	if (i + 1 < meters.size () && _m_beat[i + 1] < beat) {
+		return _m_beat[i + 1];
+	}
+
+	return beat;
+}
+
+double
+TempoMap::SectionIndex::minute_at_beat (double beat) const
+{
+	MeterSection const& prev_m (*meters[meter_at_beat_index (beat)]);
+	TempoSection const& prev_t (*tempi[tempo_at_beat_index (prev_m, beat)]);
+
+	return prev_t.minute_at_pulse (((beat - prev_m.beat()) / prev_m.note_divisor()) + prev_m.pulse());
+}
+
+double
+TempoMap::SectionIndex::pulse_at_beat (double beat) const
+{
+	MeterSection const& prev_m (*meters[meter_at_beat_index (beat)]);
+
+	return prev_m.pulse() + ((beat - prev_m.beat()) / prev_m.note_divisor());
+}
+
+double
+TempoMap::SectionIndex::beat_at_pulse (double pulse) const
+{
+	MeterSection const& prev_m (*meters[meter_at_pulse_index (pulse)]);
+
+	return ((pulse - prev_m.pulse()) * prev_m.note_divisor()) + prev_m.beat();
+}
+
+Tempo
+TempoMap::SectionIndex::tempo_at_minute (double minute) const
+{
+	size_t const i = tempo_at_minute_index (minute);
+	TempoSection const& prev_t (*tempi[i]);
+
+	if (i + 1 < tempi.size ()) {
+		return prev_t.tempo_at_minute (minute);
+	}
+	return Tempo (prev_t.note_types_per_minute(), prev_t.note_type(), prev_t.end_note_types_per_minute());
+}
+
+BBT_Time
+TempoMap::SectionIndex::bbt_in_meter (MeterSection const& prev_m, double beat)
+{
+	const double beats_in_ms = beat - prev_m.beat();
+	const uint32_t bars_in_ms = (uint32_t) floor (beats_in_ms / prev_m.divisions_per_bar());
+	const uint32_t total_bars = bars_in_ms + (prev_m.bbt().bars - 1);
+	const double remaining_beats = beats_in_ms - (bars_in_ms * prev_m.divisions_per_bar());
+	const double remaining_ticks = (remaining_beats - floor (remaining_beats)) * BBT_Time::ticks_per_beat;
+
+	BBT_Time ret;
+
+	ret.ticks = (uint32_t) floor (remaining_ticks + 0.5);
+	ret.beats = (uint32_t) floor (remaining_beats);
+	ret.bars = total_bars;
+
+	/* 0 0 0 to 1 1 0 - based mapping*/
+	++ret.bars;
+	++ret.beats;
+
+	if (ret.ticks >= BBT_Time::ticks_per_beat) {
+		++ret.beats;
+		ret.ticks -= BBT_Time::ticks_per_beat;
+	}
+
+	if (ret.beats >= prev_m.divisions_per_bar() + 1) {
+		++ret.bars;
+		ret.beats = 1;
+	}
+
+	return ret;
+}
+
+BBT_Time
+TempoMap::SectionIndex::bbt_at_minute (double minute) const
+{
+	if (minute < 0) {
+		return BBT_Time (1, 1, 0);
+	}
+
+	TempoSection const& ts (*tempi[tempo_at_minute_index (minute)]);
+	size_t const i = meter_at_minute_index (minute);
+	MeterSection const& prev_m (*meters[i]);
+
+	double beat = prev_m.beat() + (ts.pulse_at_minute (minute) - prev_m.pulse()) * prev_m.note_divisor();
+
+	/* handle sample before first meter */
+	if (minute < prev_m.minute()) {
+		beat = 0.0;
+	}
+	/* audio locked meters fake their beat */
+	if (i + 1 < meters.size () && _m_beat[i + 1] < beat) {
+		beat = _m_beat[i + 1];
+	}
+
+	return bbt_in_meter (prev_m, max (0.0, beat));
+}
+
+BBT_Time
+TempoMap::SectionIndex::bbt_at_beat (double b) const
+{
+	const double beats = max (0.0, b);
+	return bbt_in_meter (*meters[meter_at_beat_index (beats)], beats);
+}
+
+BBT_Time
+TempoMap::SectionIndex::bbt_at_pulse (double pulse) const
+{
+	MeterSection const& prev_m (*meters[meter_at_pulse_index (pulse)]);
+	return bbt_in_meter (prev_m, (pulse - prev_m.pulse()) * prev_m.note_divisor() + prev_m.beat());
+}
+
+double
+TempoMap::SectionIndex::pulse_at_bbt (BBT_Time const& bbt) const
+{
+	MeterSection const& prev_m (*meters[meter_at_bars_index (bbt.bars)]);
+
+	const double remaining_bars = bbt.bars - prev_m.bbt().bars;
+	const double remaining_pulses = remaining_bars * prev_m.divisions_per_bar() / prev_m.note_divisor();
+
+	return remaining_pulses + prev_m.pulse() + (((bbt.beats - 1) + (bbt.ticks / BBT_Time::ticks_per_beat)) / prev_m.note_divisor());
+}
+
+boost::shared_ptr<TempoMap::SectionIndex>
+TempoMap::fresh_index () const
+{
+	/* does not need the lock, but SectionIndex::live_tempi and
+	 * SectionIndex::live_meters may only be used while holding it.
+	 */
+	boost::shared_ptr<SectionIndex> si = _index.reader ();
+	if (si->generation != g_atomic_int_get (&_generation) || !si->valid ()) {
+		return boost::shared_ptr<SectionIndex> ();
+	}
+	return si;
+}
+
+void
+TempoMap::update_index ()
+{
+	/* CALLER MUST HOLD WRITE LOCK */
+	g_atomic_int_inc (&_generation);
+
+	RCUWriter<SectionIndex> writer (_index);
+	boost::shared_ptr<SectionIndex> si = writer.get_copy ();
+	*si = SectionIndex (_metrics, g_atomic_int_get (&_generation));
 }
 
 void
@@ -1610,6 +1958,10 @@ TempoMap::beat_at_sample (const samplecnt_t sample) const
 {
 	Glib::Threads::RWLock::ReaderLock lm (lock);
 
+	if (boost::shared_ptr<SectionIndex> si = fresh_index ()) {
+		return si->beat_at_minute (minute_at_sample (sample));
+	}
+
 	return beat_at_minute_locked (_metrics, minute_at_sample (sample));
 }
 
@@ -1654,6 +2006,10 @@ TempoMap::sample_at_beat (const double& beat) const
 {
 	Glib::Threads::RWLock::ReaderLock lm (lock);
 
+	if (boost::shared_ptr<SectionIndex> si = fresh_index ()) {
+		return sample_at_minute (si->minute_at_beat (beat));
+	}
+
 	return sample_at_minute (minute_at_beat_locked (_metrics, beat));
 }
 
@@ -1709,6 +2065,10 @@ TempoMap::tempo_at_sample (const samplepos_t sample) const
 {
 	Glib::Threads::RWLock::ReaderLock lm (lock);
 
+	if (boost::shared_ptr<SectionIndex> si = fresh_index ()) {
+		return si->tempo_at_minute (minute_at_sample (sample));
+	}
+
 	return tempo_at_minute_locked (_metrics, minute_at_sample (sample));
 }
 
@@ -2048,6 +2408,11 @@ Timecode::BBT_Time
 TempoMap::bbt_at_beat (const double& beat)
 {
 	Glib::Threads::RWLock::ReaderLock lm (lock);
+
+	if (boost::shared_ptr<SectionIndex> si = fresh_index ()) {
+		return si->bbt_at_beat (beat);
+	}
+
 	return bbt_at_beat_locked (_metrics, beat);
 }
 
@@ -2117,12 +2482,21 @@ TempoMap::quarter_note_at_bbt (const Timecode::BBT_Time& bbt)
 {
 	Glib::Threads::RWLock::ReaderLock lm (lock);
 
+	if (boost::shared_ptr<SectionIndex> si = fresh_index ()) {
+		return si->pulse_at_bbt (bbt) * 4.0;
+	}
+
 	return pulse_at_bbt_locked (_metrics, bbt) * 4.0;
 }
 
 double
 TempoMap::quarter_note_at_bbt_rt (const Timecode::BBT_Time& bbt)
 {
+	/* lock-free, if the index is up to date */
+	if (boost::shared_ptr<SectionIndex> si = fresh_index ()) {
+		return si->pulse_at_bbt (bbt) * 4.0;
+	}
+
 	Glib::Threads::RWLock::ReaderLock lm (lock, Glib::Threads::TRY_LOCK);
 
 	if (!lm.locked()) {
@@ -2177,6 +2551,10 @@ TempoMap::bbt_at_quarter_note (const double& qn)
 {
 	Glib::Threads::RWLock::ReaderLock lm (lock);
 
+	if (boost::shared_ptr<SectionIndex> si = fresh_index ()) {
+		return si->bbt_at_pulse (qn / 4.0);
+	}
+
 	return bbt_at_pulse_locked (_metrics, qn / 4.0);
 }
 
@@ -2267,6 +2645,10 @@ TempoMap::bbt_at_sample (samplepos_t sample) const
 
 	Glib::Threads::RWLock::ReaderLock lm (lock);
 
+	if (boost::shared_ptr<SectionIndex> si = fresh_index ()) {
+		return si->bbt_at_minute (minute);
+	}
+
 	return bbt_at_minute_locked (_metrics, minute);
 }
 
@@ -2275,6 +2657,11 @@ TempoMap::bbt_at_sample_rt (samplepos_t sample) const
 {
 	const double minute =  minute_at_sample (sample);
 
+	/* lock-free, if the index is up to date */
+	if (boost::shared_ptr<SectionIndex> si = fresh_index ()) {
+		return si->bbt_at_minute (minute);
+	}
+
 	Glib::Threads::RWLock::ReaderLock lm (lock, Glib::Threads::TRY_LOCK);
 
 	if (!lm.locked()) {
@@ -2408,6 +2795,10 @@ TempoMap::quarter_note_at_sample (const samplepos_t sample) const
 
 	Glib::Threads::RWLock::ReaderLock lm (lock);
 
+	if (boost::shared_ptr<SectionIndex> si = fresh_index ()) {
+		return si->pulse_at_minute (minute) * 4.0;
+	}
+
 	return pulse_at_minute_locked (_metrics, minute) * 4.0;
 }
 
@@ -2416,6 +2807,11 @@ TempoMap::quarter_note_at_sample_rt (const samplepos_t sample) const
 {
 	const double minute =  minute_at_sample (sample);
 
+	/* lock-free, if the index is up to date */
+	if (boost::shared_ptr<SectionIndex> si = fresh_index ()) {
+		return si->pulse_at_minute (minute) * 4.0;
+	}
+
 	Glib::Threads::RWLock::ReaderLock lm (lock, Glib::Threads::TRY_LOCK);
 
 	if (!lm.locked()) {
@@ -2440,7 +2836,11 @@ TempoMap::sample_at_quarter_note (const double quarter_note) const
 	{
 		Glib::Threads::RWLock::ReaderLock lm (lock);
 
-		minute = minute_at_pulse_locked (_metrics, quarter_note / 4.0);
+		if (boost::shared_ptr<SectionIndex> si = fresh_index ()) {
+			minute = si->minute_at_pulse (quarter_note / 4.0);
+		} else {
+			minute = minute_at_pulse_locked (_metrics, quarter_note / 4.0);
+		}
 	}
 
 	return sample_at_minute (minute);
@@ -2458,6 +2858,10 @@ TempoMap::quarter_note_at_beat (const double beat) const
 {
 	Glib::Threads::RWLock::ReaderLock lm (lock);
 
+	if (boost::shared_ptr<SectionIndex> si = fresh_index ()) {
+		return si->pulse_at_beat (beat) * 4.0;
+	}
+
 	return pulse_at_beat_locked (_metrics, beat) * 4.0;
 }
 
@@ -2473,6 +2877,10 @@ TempoMap::beat_at_quarter_note (const double quarter_note) const
 {
 	Glib::Threads::RWLock::ReaderLock lm (lock);
 
+	if (boost::shared_ptr<SectionIndex> si = fresh_index ()) {
+		return si->beat_at_pulse (quarter_note / 4.0);
+	}
+
 	return beat_at_pulse_locked (_metrics, quarter_note / 4.0);
 }
 
@@ -4213,6 +4621,10 @@ TempoMap::tempo_section_at_sample (samplepos_t sample) const
 {
 	Glib::Threads::RWLock::ReaderLock lm (lock);
 
+	if (boost::shared_ptr<SectionIndex> si = fresh_index ()) {
+		return *si->live_tempi[si->tempo_at_minute_index (minute_at_sample (sample))];
+	}
+
 	return tempo_section_at_minute_locked (_metrics, minute_at_sample (sample));
 }
 
@@ -4221,6 +4633,10 @@ TempoMap::tempo_section_at_sample (samplepos_t sample)
 {
 	Glib::Threads::RWLock::ReaderLock lm (lock);
 
+	if (boost::shared_ptr<SectionIndex> si = fresh_index ()) {
+		return *si->live_tempi[si->tempo_at_minute_index (minute_at_sample (sample))];
+	}
+
 	return tempo_section_at_minute_locked (_metrics, minute_at_sample (sample));
 }
 
@@ -4440,6 +4856,11 @@ const MeterSection&
 TempoMap::meter_section_at_sample (samplepos_t sample) const
 {
 	Glib::Threads::RWLock::ReaderLock lm (lock);
+
+	if (boost::shared_ptr<SectionIndex> si = fresh_index ()) {
+		return *si->live_meters[si->meter_at_minute_index (minute_at_sample (sample))];
+	}
+
 	return meter_section_at_minute_locked (_metrics, minute_at_sample (sample));
 }
 
@@ -4501,6 +4922,11 @@ const MeterSection&
 TempoMap::meter_section_at_beat (double beat) const
 {
 	Glib::Threads::RWLock::ReaderLock lm (lock);
+
+	if (boost::shared_ptr<SectionIndex> si = fresh_index ()) {
+		return *si->live_meters[si->meter_at_beat_index (beat)];
+	}
+
 	return meter_section_at_beat_locked (_metrics, beat);
 }
 
@@ -4637,6 +5063,8 @@ TempoMap::set_state (const XMLNode& node, int /*version*/)
 	{
 		Glib::Threads::RWLock::WriterLock lm (lock);
 
+		g_atomic_int_inc (&_generation);
+
 		XMLNodeList nlist;
 		XMLNodeConstIterator niter;
 		Metrics old_metrics (_metrics);
@@ -4841,6 +5269,9 @@ TempoMap::remove_time (samplepos_t where, samplecnt_t amount)
 	bool meter_after = false; // is there a meter marker likewise?
 	{
 		Glib::Threads::RWLock::WriterLock lm (lock);
+
+		g_atomic_int_inc (&_generation);
+
 		for (Metrics::iterator i = _metrics.begin(); i != _metrics.end(); ++i) {
 			if ((*i)->sample() >= where && (*i)->sample() < where+amount) {
 				metric_kill_list.push_back(*i);
@@ -0,0 +1,171 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "pbd/xml++.h"
+
+#include "ardour/location.h"
+#include "ardour/session.h"
+
+#include "locations_test.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (LocationsTest);
+
+using namespace std;
+using namespace ARDOUR;
+
+void
+LocationsTest::addRemoveTest ()
+{
+	Locations* locs = _session->locations ();
+	locs->clear ();
+
+	Location* mark  = new Location (*_session, 100000, 100000, "mark", Location::IsMark);
+	Location* range = new Location (*_session, 200000, 300000, "range", Location::IsRangeMarker);
+	Location* loop  = new Location (*_session, 400000, 500000, "loop", Location::IsAutoLoop);
+
+	locs->add (mark);
+	locs->add (range);
+	locs->add (loop);
+
+	/* realtime lookup while the index is out of date */
+	CPPUNIT_ASSERT (locs->auto_loop_location () == loop);
+
+	CPPUNIT_ASSERT (locs->get_location_by_id (mark->id ()) == mark);
+	CPPUNIT_ASSERT (locs->get_location_by_id (range->id ()) == range);
+	CPPUNIT_ASSERT_EQUAL (uint32_t (1), locs->num_range_markers ());
+	CPPUNIT_ASSERT (locs->mark_at (100000) == mark);
+	CPPUNIT_ASSERT (locs->mark_at (100010, 20) == mark);
+	CPPUNIT_ASSERT_EQUAL (samplepos_t (200000), locs->first_mark_after (100000));
+	CPPUNIT_ASSERT_EQUAL (samplepos_t (300000), locs->first_mark_before (400000));
+	CPPUNIT_ASSERT_EQUAL (samplepos_t (400000), locs->first_mark_after (300000, true));
+
+	/* and using the index */
+	CPPUNIT_ASSERT (locs->auto_loop_location () == loop);
+
+	locs->remove (loop);
+	CPPUNIT_ASSERT (locs->auto_loop_location () == 0);
+	CPPUNIT_ASSERT_EQUAL (samplepos_t (-1), locs->first_mark_after (300000, true));
+
+	PBD::ID const id = mark->id ();
+	locs->remove (mark);
+	CPPUNIT_ASSERT (locs->get_location_by_id (id) == 0);
+	CPPUNIT_ASSERT (locs->mark_at (100000) == 0);
+	CPPUNIT_ASSERT_EQUAL (samplepos_t (200000), locs->first_mark_after (0));
+
+	locs->clear ();
+}
+
+void
+LocationsTest::modifyTest ()
+{
+	Locations* locs = _session->locations ();
+	locs->clear ();
+
+	Location* mark = new Location (*_session, 100000, 100000, "mark", Location::IsMark);
+	locs->add (mark);
+
+	CPPUNIT_ASSERT (locs->mark_at (100000) == mark);
+
+	mark->set_start (150000);
+
+	CPPUNIT_ASSERT (locs->mark_at (100000) == 0);
+	CPPUNIT_ASSERT (locs->mark_at (150000) == mark);
+
+	Location* loop = new Location (*_session, 400000, 500000, "loop");
+	locs->add (loop);
+	CPPUNIT_ASSERT (locs->auto_loop_location () == 0);
+
+	loop->set_auto_loop (true, this);
+	CPPUNIT_ASSERT_EQUAL (uint32_t (0), locs->num_range_markers ());
+	CPPUNIT_ASSERT (locs->auto_loop_location () == loop);
+
+	locs->clear ();
+}
+
+void
+LocationsTest::clearTest ()
+{
+	Locations* locs = _session->locations ();
+	locs->clear ();
+
+	Location* mark  = new Location (*_session, 100000, 100000, "mark", Location::IsMark);
+	Location* range = new Location (*_session, 200000, 300000, "range", Location::IsRangeMarker);
+	Location* loop  = new Location (*_session, 400000, 500000, "loop", Location::IsAutoLoop);
+
+	locs->add (mark);
+	locs->add (range);
+	locs->add (loop);
+
+	PBD::ID const mark_id  = mark->id ();
+	PBD::ID const range_id = range->id ();
+
+	/* build the index */
+	CPPUNIT_ASSERT_EQUAL (uint32_t (1), locs->num_range_markers ());
+
+	locs->clear_markers ();
+	CPPUNIT_ASSERT (locs->get_location_by_id (mark_id) == 0);
+	CPPUNIT_ASSERT (locs->mark_at (100000) == 0);
+	CPPUNIT_ASSERT (locs->get_location_by_id (range_id) == range);
+
+	locs->clear_ranges ();
+	CPPUNIT_ASSERT (locs->get_location_by_id (range_id) == 0);
+	CPPUNIT_ASSERT_EQUAL (uint32_t (0), locs->num_range_markers ());
+	/* the loop range is not removed by clear_ranges () */
+	CPPUNIT_ASSERT (locs->auto_loop_location () == loop);
+
+	locs->clear ();
+	CPPUNIT_ASSERT (locs->auto_loop_location () == 0);
+	CPPUNIT_ASSERT (locs->auto_punch_location () == 0);
+	CPPUNIT_ASSERT_EQUAL (samplepos_t (-1), locs->first_mark_after (0, true));
+}
+
+void
+LocationsTest::setStateTest ()
+{
+	Locations* locs = _session->locations ();
+	locs->clear ();
+
+	Location* mark = new Location (*_session, 100000, 100000, "mark", Location::IsMark);
+	Location* loop = new Location (*_session, 400000, 500000, "loop", Location::IsAutoLoop);
+
+	locs->add (mark);
+	locs->add (loop);
+
+	XMLNode* state = &locs->get_state ();
+
+	Location* range = new Location (*_session, 200000, 300000, "range", Location::IsRangeMarker);
+	locs->add (range);
+	PBD::ID const range_id = range->id ();
+
+	/* build the index */
+	CPPUNIT_ASSERT_EQUAL (uint32_t (1), locs->num_range_markers ());
+	CPPUNIT_ASSERT (locs->auto_loop_location () == loop);
+
+	CPPUNIT_ASSERT_EQUAL (0, locs->set_state (*state, PBD::Stateful::loading_state_version));
+	delete state;
+
+	/* locations that were present are re-used */
+	CPPUNIT_ASSERT (locs->get_location_by_id (mark->id ()) == mark);
+	CPPUNIT_ASSERT (locs->get_location_by_id (range_id) == 0);
+	CPPUNIT_ASSERT_EQUAL (uint32_t (0), locs->num_range_markers ());
+	CPPUNIT_ASSERT (locs->auto_loop_location () == loop);
+	CPPUNIT_ASSERT (locs->mark_at (100000) == mark);
+	CPPUNIT_ASSERT_EQUAL (samplepos_t (-1), locs->first_mark_after (100000));
+
+	locs->clear ();
+}
@@ -0,0 +1,36 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "test_needing_session.h"
+
+/** Tests for the lookup index of ARDOUR::Locations */
+class LocationsTest : public TestNeedingSession
+{
+	CPPUNIT_TEST_SUITE (LocationsTest);
+	CPPUNIT_TEST (addRemoveTest);
+	CPPUNIT_TEST (modifyTest);
+	CPPUNIT_TEST (clearTest);
+	CPPUNIT_TEST (setStateTest);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void addRemoveTest ();
+	void modifyTest ();
+	void clearTest ();
+	void setStateTest ();
+};
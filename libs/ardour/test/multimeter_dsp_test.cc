@@ -0,0 +1,130 @@
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+#include "ardour/iec1ppmdsp.h"
+#include "ardour/iec2ppmdsp.h"
+#include "ardour/kmeterdsp.h"
+#include "ardour/multimeterdsp.h"
+#include "ardour/vumeterdsp.h"
+
+#include "multimeter_dsp_test.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (MultimeterDSPTest);
+
+using namespace std;
+
+static void
+fill (vector<vector<float> >& data, int cycle)
+{
+	for (size_t c = 0; c < data.size (); ++c) {
+		/* channels at different levels, some silent, some clipping */
+		const float gain = (c % 5 == 0) ? 0.f : 1.5f * (1 + sinf (.05f * cycle + c));
+		for (size_t s = 0; s < data[c].size (); ++s) {
+			data[c][s] = gain * (2.f * rand () / (float)RAND_MAX - 1.f);
+		}
+	}
+}
+
+void
+MultimeterDSPTest::setUp ()
+{
+	Kmeterdsp::init (48000);
+	Iec1ppmdsp::init (48000);
+	Iec2ppmdsp::init (48000);
+	Vumeterdsp::init (48000);
+	Multimeterdsp::init (48000);
+	srand (1);
+}
+
+/* all meter types of all channels must read the same as the single
+ * channel meters, including a channel count that is not a multiple of
+ * Multimeterdsp::lanes, and buffer sizes that are not a multiple of 4.
+ */
+void
+MultimeterDSPTest::compareTest ()
+{
+	const uint32_t n_chan    = 2 * Multimeterdsp::lanes + 3;
+	const int      n_frames[] = { 64, 1023, 256, 1 };
+
+	vector<Kmeterdsp>  kmeter (n_chan);
+	vector<Iec1ppmdsp> iec1 (n_chan);
+	vector<Iec2ppmdsp> iec2 (n_chan);
+	vector<Vumeterdsp> vu (n_chan);
+
+	Multimeterdsp multi;
+	multi.set_channels (n_chan);
+
+	for (int i = 0; i < 200; ++i) {
+		const int n = n_frames[i % 4];
+
+		vector<vector<float> > data (n_chan, vector<float> (n));
+		vector<float const*>   ptr (n_chan);
+		vector<float>          peak (n_chan, 0);
+
+		fill (data, i);
+
+		for (uint32_t c = 0; c < n_chan; ++c) {
+			ptr[c] = &data[c][0];
+			kmeter[c].process (ptr[c], n);
+			iec1[c].process (ptr[c], n);
+			iec2[c].process (ptr[c], n);
+			vu[c].process (ptr[c], n);
+		}
+
+		multi.process (&ptr[0], &peak[0], n_chan, n, Multimeterdsp::All);
+
+		for (uint32_t c = 0; c < n_chan; ++c) {
+			float p = 0;
+			for (int s = 0; s < n; ++s) {
+				p = max (p, fabsf (data[c][s]));
+			}
+			CPPUNIT_ASSERT_DOUBLES_EQUAL (p, peak[c], 1e-7);
+		}
+
+		if (i % 3) {
+			continue;
+		}
+
+		for (uint32_t c = 0; c < n_chan; ++c) {
+			CPPUNIT_ASSERT_DOUBLES_EQUAL (kmeter[c].read (), multi.read (Multimeterdsp::KMeter, c), 1e-6);
+			CPPUNIT_ASSERT_DOUBLES_EQUAL (iec1[c].read (), multi.read (Multimeterdsp::IEC1, c), 1e-6);
+			CPPUNIT_ASSERT_DOUBLES_EQUAL (iec2[c].read (), multi.read (Multimeterdsp::IEC2, c), 1e-6);
+			CPPUNIT_ASSERT_DOUBLES_EQUAL (vu[c].read (), multi.read (Multimeterdsp::VU, c), 1e-6);
+		}
+	}
+}
+
+/* meter types that are not selected are not processed */
+void
+MultimeterDSPTest::partialTest ()
+{
+	const uint32_t n_chan   = Multimeterdsp::lanes + 1;
+	const int      n_frames = 512;
+
+	vector<Kmeterdsp>  kmeter (n_chan);
+	vector<Vumeterdsp> vu (n_chan);
+
+	Multimeterdsp multi;
+	multi.set_channels (n_chan);
+
+	vector<vector<float> > data (n_chan, vector<float> (n_frames));
+	vector<float const*>   ptr (n_chan);
+
+	for (int i = 0; i < 50; ++i) {
+		fill (data, i);
+		for (uint32_t c = 0; c < n_chan; ++c) {
+			ptr[c] = &data[c][0];
+			kmeter[c].process (ptr[c], n_frames);
+			vu[c].process (ptr[c], n_frames);
+		}
+		multi.process (&ptr[0], 0, n_chan, n_frames, Multimeterdsp::KMeter | Multimeterdsp::VU);
+	}
+
+	for (uint32_t c = 0; c < n_chan; ++c) {
+		CPPUNIT_ASSERT_DOUBLES_EQUAL (kmeter[c].read (), multi.read (Multimeterdsp::KMeter, c), 1e-6);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL (vu[c].read (), multi.read (Multimeterdsp::VU, c), 1e-6);
+		CPPUNIT_ASSERT_EQUAL (0.f, multi.read (Multimeterdsp::IEC1, c));
+		CPPUNIT_ASSERT_EQUAL (0.f, multi.read (Multimeterdsp::IEC2, c));
+	}
+}
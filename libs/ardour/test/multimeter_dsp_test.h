@@ -0,0 +1,17 @@
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class MultimeterDSPTest : public CppUnit::TestFixture
+{
+	CPPUNIT_TEST_SUITE (MultimeterDSPTest);
+	CPPUNIT_TEST (compareTest);
+	CPPUNIT_TEST (partialTest);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void setUp ();
+	void tearDown () {}
+
+	void compareTest ();
+	void partialTest ();
+};
@@ -1,7 +1,19 @@
+#include <ctime>
+#include <fstream>
 #include <iostream>
 
+#include <utime.h>
+
+#include <glib/gstdio.h>
+#include <glibmm/fileutils.h>
+#include <glibmm/miscutils.h>
+
+#include "pbd/xml++.h"
+
 #include "ardour/plugin_manager.h"
+#include "ardour/rc_configuration.h"
 #include "ardour/search_paths.h"
+#include "ardour/vst3_scan.h"
 
 #include "plugins_test.h"
 #include "test_util.h"
@@ -54,3 +66,115 @@ PluginsTest::test ()
 
 	stop_and_destroy_backend ();
 }
+
+
+#if defined VST3_SUPPORT && !defined __APPLE__ && !defined PLATFORM_WINDOWS
+
+/* a single-file VST3 module, and the cache-file that a successful scan produces */
+static std::string
+make_vst3_module (std::string const& dir, std::string const& name)
+{
+	std::string const module_path = Glib::build_filename (dir, name + ".vst3");
+	Glib::file_set_contents (module_path, "");
+
+	/* the cache-file has to be newer than the module */
+	struct utimbuf utb;
+	utb.actime = utb.modtime = time (0) - 60;
+	g_utime (module_path.c_str (), &utb);
+
+	XMLNode* root = new XMLNode ("VST3Cache");
+	root->set_property ("version", 1);
+	root->set_property ("bundle", module_path);
+	root->set_property ("module", module_path);
+
+	VST3Info nfo;
+	nfo.uid  = name;
+	nfo.name = name;
+	root->add_child_nocopy (nfo.state ());
+
+	XMLTree tree;
+	tree.set_root (root);
+	tree.write (module_path + ".v3i");
+
+	return module_path;
+}
+
+static void
+write_vst3_scanner (std::string const& script, std::string const& good, std::string const& crash)
+{
+	/* the fake scanner writes the cache-file for \p good, and crashes for \p crash */
+	std::ofstream f (script.c_str ());
+	f << "#!/bin/sh\n"
+	  << "case \"$3\" in\n"
+	  << "  '" << good << "') cp '" << good << ".v3i' '" << vst3_cache_file (good) << "' ;;\n"
+	  << "  '" << crash << "') kill -SEGV $$ ;;\n"
+	  << "esac\n";
+	f.close ();
+	g_chmod (script.c_str (), 0755);
+}
+
+static bool
+have_vst3 (std::string const& name)
+{
+	PluginInfoList const& plugs (PluginManager::instance ().vst3_plugin_info ());
+	for (PluginInfoList::const_iterator i = plugs.begin (); i != plugs.end (); ++i) {
+		if ((*i)->name == name) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void
+PluginsTest::test_vst3_scan ()
+{
+	std::string const dir = new_test_output_dir ("vst3_scan");
+
+	/* keep the user's cache and blacklist untouched */
+	g_setenv ("XDG_CACHE_HOME", Glib::build_filename (dir, "cache").c_str (), 1);
+
+	std::string const plugin_dir = Glib::build_filename (dir, "plugins");
+	g_mkdir_with_parents (plugin_dir.c_str (), 0755);
+
+	std::string const good   = make_vst3_module (plugin_dir, "Good");
+	std::string const crash  = make_vst3_module (plugin_dir, "Crash");
+	std::string const script = Glib::build_filename (dir, "vst3-scanner");
+
+	write_vst3_scanner (script, good, crash);
+
+	std::string const scanner_bin_path = PluginManager::vst3_scanner_bin_path;
+	std::string const plugin_path      = Config->get_plugin_path_vst3 ();
+
+	PluginManager::vst3_scanner_bin_path = script;
+	Config->set_plugin_path_vst3 (plugin_dir);
+
+	PluginManager& pm = PluginManager::instance ();
+
+	pm.refresh ();
+	CPPUNIT_ASSERT (have_vst3 ("Good"));
+	CPPUNIT_ASSERT (!have_vst3 ("Crash"));
+
+	/* a successful scan must not leave the module blacklisted */
+	pm.refresh (true);
+	CPPUNIT_ASSERT (have_vst3 ("Good"));
+
+	/* the module that crashed the scanner remains blacklisted,
+	 * and is not scanned again even if the scan would now succeed */
+	write_vst3_scanner (script, crash, good);
+	pm.refresh ();
+	CPPUNIT_ASSERT (have_vst3 ("Good"));
+	CPPUNIT_ASSERT (!have_vst3 ("Crash"));
+
+	PluginManager::vst3_scanner_bin_path = scanner_bin_path;
+	Config->set_plugin_path_vst3 (plugin_path);
+	g_unsetenv ("XDG_CACHE_HOME");
+}
+
+#else
+
+void
+PluginsTest::test_vst3_scan ()
+{
+}
+
+#endif
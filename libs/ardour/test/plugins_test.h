@@ -5,8 +5,10 @@ class PluginsTest : public CppUnit::TestFixture
 {
 	CPPUNIT_TEST_SUITE (PluginsTest);
 	CPPUNIT_TEST (test);
+	CPPUNIT_TEST (test_vst3_scan);
 	CPPUNIT_TEST_SUITE_END ();
 
 public:
 	void test ();
+	void test_vst3_scan ();
 };
@@ -0,0 +1,186 @@
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include <glib.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "pbd/malign.h"
+
+#include "ardour/buffer_arena.h"
+
+using namespace std;
+using namespace ARDOUR;
+
+/* compare per-buffer allocations (as BufferSet::ensure_buffers does)
+ * with buffers carved from a single BufferArena (ThreadBuffers).
+ *
+ * Each cycle, every processor reads from and mixes into buffers of the
+ * five per-thread buffer-sets. Cache and dTLB misses are read from
+ * Linux perf counters, if available.
+ *
+ * usage: buffer_arena [channels] [processors] [cycles] [buffer-size]
+ */
+
+class Counter
+{
+public:
+	Counter (uint32_t type, uint64_t config)
+		: _fd (-1)
+	{
+#ifdef __linux__
+		struct perf_event_attr pe;
+		memset (&pe, 0, sizeof (pe));
+		pe.type           = type;
+		pe.size           = sizeof (pe);
+		pe.config         = config;
+		pe.disabled       = 1;
+		pe.exclude_kernel = 1;
+		pe.exclude_hv     = 1;
+		_fd = syscall (__NR_perf_event_open, &pe, 0, -1, -1, 0);
+#endif
+	}
+
+	~Counter ()
+	{
+#ifdef __linux__
+		if (_fd >= 0) {
+			close (_fd);
+		}
+#endif
+	}
+
+	void start ()
+	{
+#ifdef __linux__
+		if (_fd >= 0) {
+			ioctl (_fd, PERF_EVENT_IOC_RESET, 0);
+			ioctl (_fd, PERF_EVENT_IOC_ENABLE, 0);
+		}
+#endif
+	}
+
+	/** @return event count since start (), -1 if not available */
+	int64_t stop ()
+	{
+#ifdef __linux__
+		int64_t cnt;
+		if (_fd >= 0) {
+			ioctl (_fd, PERF_EVENT_IOC_DISABLE, 0);
+			if (read (_fd, &cnt, sizeof (cnt)) == sizeof (cnt)) {
+				return cnt;
+			}
+		}
+#endif
+		return -1;
+	}
+
+private:
+	int _fd;
+};
+
+static const size_t n_sets = 5;
+
+static void
+run_cycle (vector<float*> const& bufs, uint32_t n_chn, uint32_t n_proc, uint32_t bufsize)
+{
+	for (uint32_t p = 0; p < n_proc; ++p) {
+		/* every processor uses a different set of channels, like routes with different I/O */
+		float* const* scratch = &bufs[((p % n_sets) * n_chn)];
+		float* const* mix     = &bufs[(((p + 1) % n_sets) * n_chn)];
+		const float   gain    = 0.5f + (p % 7) * .05f;
+
+		for (uint32_t c = 0; c < n_chn; ++c) {
+			float const* src = scratch[(c + p) % n_chn];
+			float*       dst = mix[c];
+			for (uint32_t i = 0; i < bufsize; ++i) {
+				dst[i] = dst[i] * .5f + src[i] * gain;
+			}
+		}
+	}
+}
+
+static void
+measure (char const* name, vector<float*> const& bufs, uint32_t n_chn, uint32_t n_proc, int cycles, uint32_t bufsize)
+{
+#ifdef __linux__
+	Counter cache (PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+	Counter dtlb (PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+#else
+	Counter cache (0, 0);
+	Counter dtlb (0, 0);
+#endif
+
+	/* warm up */
+	run_cycle (bufs, n_chn, n_proc, bufsize);
+
+	cache.start ();
+	dtlb.start ();
+	gint64 t0 = g_get_monotonic_time ();
+	for (int i = 0; i < cycles; ++i) {
+		run_cycle (bufs, n_chn, n_proc, bufsize);
+	}
+	gint64 t1 = g_get_monotonic_time ();
+	int64_t const n_cache = cache.stop ();
+	int64_t const n_dtlb  = dtlb.stop ();
+
+	cout << "  " << name << (t1 - t0) / (double) cycles << " us/cycle";
+	if (n_cache >= 0) {
+		cout << ", cache-misses/cycle: " << n_cache / (double) cycles;
+	}
+	if (n_dtlb >= 0) {
+		cout << ", dTLB-misses/cycle: " << n_dtlb / (double) cycles;
+	}
+	cout << "\n";
+}
+
+int
+main (int argc, char* argv[])
+{
+	uint32_t const n_chn   = argc > 1 ? atoi (argv[1]) : 64;
+	uint32_t const n_proc  = argc > 2 ? atoi (argv[2]) : 500;
+	int const      cycles  = argc > 3 ? atoi (argv[3]) : 1000;
+	uint32_t const bufsize = argc > 4 ? atoi (argv[4]) : 256;
+
+	size_t const n_bufs = n_sets * n_chn;
+
+	/* individually allocated buffers, interleaved with other
+	 * allocations, as happens during session load */
+	vector<float*> scattered (n_bufs);
+	vector<void*>  other (n_bufs);
+	for (size_t b = 0; b < n_bufs; ++b) {
+		cache_aligned_malloc ((void**) &scattered[b], bufsize * sizeof (float));
+		memset (scattered[b], 0, bufsize * sizeof (float));
+		other[b] = malloc (1024 + (rand () % 8192));
+	}
+
+	size_t const stride = BufferArena::align (bufsize * sizeof (float)) / sizeof (float);
+
+	BufferArena    arena (n_bufs * stride * sizeof (float), true);
+	vector<float*> arena_bufs (n_bufs);
+	for (size_t b = 0; b < n_bufs; ++b) {
+		arena_bufs[b] = arena.alloc<float> (stride);
+	}
+
+	cout << n_chn << " channels, " << n_proc << " processors, " << cycles << " cycles of " << bufsize << " samples\n"
+	     << "  arena: " << arena.size () / 1024 << " KiB, huge pages: " << (arena.huge_pages () ? "yes" : "no")
+	     << ", locked: " << (arena.locked () ? "yes" : "no") << "\n";
+
+	measure ("separate: ", scattered, n_chn, n_proc, cycles, bufsize);
+	measure ("arena:    ", arena_bufs, n_chn, n_proc, cycles, bufsize);
+
+	for (size_t b = 0; b < n_bufs; ++b) {
+		cache_aligned_free (scattered[b]);
+		free (other[b]);
+	}
+
+	return 0;
+}
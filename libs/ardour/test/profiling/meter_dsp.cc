@@ -0,0 +1,101 @@
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include <glib.h>
+
+#include "ardour/iec1ppmdsp.h"
+#include "ardour/iec2ppmdsp.h"
+#include "ardour/kmeterdsp.h"
+#include "ardour/multimeterdsp.h"
+#include "ardour/vumeterdsp.h"
+
+using namespace std;
+
+/* compare the per-channel meter DSP objects (as PeakMeter used them) with
+ * Multimeterdsp, processing all meter types of all channels, and check
+ * that both read the same values.
+ *
+ * usage: meter_dsp [channels] [cycles] [buffer-size]
+ */
+
+int
+main (int argc, char* argv[])
+{
+	const uint32_t n_chan   = argc > 1 ? atoi (argv[1]) : 512;
+	const int      n_cycles = argc > 2 ? atoi (argv[2]) : 1000;
+	const int      n_frames = argc > 3 ? atoi (argv[3]) : 1024;
+	const float    fsamp    = 48000;
+
+	Kmeterdsp::init (fsamp);
+	Iec1ppmdsp::init (fsamp);
+	Iec2ppmdsp::init (fsamp);
+	Vumeterdsp::init (fsamp);
+	Multimeterdsp::init (fsamp);
+
+	vector<Kmeterdsp>  kmeter (n_chan);
+	vector<Iec1ppmdsp> iec1 (n_chan);
+	vector<Iec2ppmdsp> iec2 (n_chan);
+	vector<Vumeterdsp> vu (n_chan);
+
+	Multimeterdsp multi;
+	multi.set_channels (n_chan);
+
+	vector<vector<float> > data (n_chan, vector<float> (n_frames));
+	vector<float const*>   ptr (n_chan);
+	vector<float>          peak (n_chan, 0);
+
+	for (uint32_t c = 0; c < n_chan; ++c) {
+		ptr[c] = &data[c][0];
+	}
+
+	gint64   t_single = 0;
+	gint64   t_multi  = 0;
+	uint64_t mismatch = 0;
+
+	for (int i = 0; i < n_cycles; ++i) {
+		for (uint32_t c = 0; c < n_chan; ++c) {
+			const float gain = .5f * (1 + sinf (.05f * i + c));
+			for (int s = 0; s < n_frames; ++s) {
+				data[c][s] = gain * (2.f * rand () / (float)RAND_MAX - 1.f);
+			}
+		}
+
+		gint64 t0 = g_get_monotonic_time ();
+		for (uint32_t c = 0; c < n_chan; ++c) {
+			kmeter[c].process (ptr[c], n_frames);
+			iec1[c].process (ptr[c], n_frames);
+			iec2[c].process (ptr[c], n_frames);
+			vu[c].process (ptr[c], n_frames);
+		}
+		gint64 t1 = g_get_monotonic_time ();
+		multi.process (&ptr[0], &peak[0], n_chan, n_frames, Multimeterdsp::All);
+		gint64 t2 = g_get_monotonic_time ();
+
+		t_single += t1 - t0;
+		t_multi  += t2 - t1;
+
+		/* read at GUI rate, every ~100ms */
+		if (i % 5) {
+			continue;
+		}
+
+		for (uint32_t c = 0; c < n_chan; ++c) {
+			const float d = fabsf (kmeter[c].read () - multi.read (Multimeterdsp::KMeter, c))
+			              + fabsf (iec1[c].read () - multi.read (Multimeterdsp::IEC1, c))
+			              + fabsf (iec2[c].read () - multi.read (Multimeterdsp::IEC2, c))
+			              + fabsf (vu[c].read () - multi.read (Multimeterdsp::VU, c));
+			if (d > 1e-6f) {
+				++mismatch;
+			}
+		}
+	}
+
+	cout << n_chan << " channels, " << n_cycles << " cycles of " << n_frames << " samples\n"
+	     << "single channel meters: " << t_single / (double)n_cycles << " us/cycle\n"
+	     << "multichannel meter:    " << t_multi / (double)n_cycles << " us/cycle\n"
+	     << "mismatching readings:  " << mismatch << "\n";
+
+	return mismatch > 0 ? 1 : 0;
+}
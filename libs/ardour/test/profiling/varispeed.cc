@@ -0,0 +1,114 @@
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include <glib.h>
+
+#include "zita-resampler/vmresampler.h"
+#include "zita-resampler/vmcresampler.h"
+
+#include "ardour/audio_port_resampler.h"
+
+using namespace std;
+using namespace ArdourZita;
+
+/* compare per-port VMResampler (AudioPort::_src) with the
+ * block-wise VMCResampler used by ARDOUR::AudioPortResampler.
+ *
+ * usage: varispeed [channels] [cycles] [buffer-size]
+ */
+
+static void
+fill (vector<vector<float> >& buf, int64_t pos)
+{
+	for (size_t c = 0; c < buf.size (); ++c) {
+		for (size_t i = 0; i < buf[c].size (); ++i) {
+			buf[c][i] = sinf ((pos + i) * .01f * (c + 1));
+		}
+	}
+}
+
+static double
+speed_at (int cycle)
+{
+	/* slow shuttle sweep 0.5 .. 2.5 */
+	return 0.5 + (cycle % 700) / 350.0;
+}
+
+int
+main (int argc, char* argv[])
+{
+	uint32_t const n_chn   = argc > 1 ? atoi (argv[1]) : 256;
+	int const      cycles  = argc > 2 ? atoi (argv[2]) : 2000;
+	uint32_t const bufsize = argc > 3 ? atoi (argv[3]) : 256;
+	uint32_t const max_blk = ARDOUR::AudioPortResampler::max_block_size;
+
+	uint32_t const qualities[] = { 8, 17, 32, 64 };
+
+	vector<vector<float> > inp (n_chn, vector<float> (bufsize));
+	vector<vector<float> > out (n_chn, vector<float> (bufsize * 3));
+
+	for (size_t q = 0; q < sizeof (qualities) / sizeof (uint32_t); ++q) {
+		uint32_t const hlen = qualities[q];
+
+		vector<VMResampler> vm (n_chn);
+		for (uint32_t c = 0; c < n_chn; ++c) {
+			vm[c].setup (hlen);
+			vm[c].set_rrfilt (10);
+		}
+
+		uint32_t const n_blocks = (n_chn + max_blk - 1) / max_blk;
+		uint32_t const blk_size = (n_chn + n_blocks - 1) / n_blocks;
+		vector<VMCResampler> vmc (n_blocks);
+		for (uint32_t b = 0; b < n_blocks; ++b) {
+			vmc[b].setup (hlen, min (blk_size, n_chn - b * blk_size));
+			vmc[b].set_rrfilt (10);
+		}
+
+		vector<float const*> ip (n_chn);
+		vector<float*>       op (n_chn);
+		for (uint32_t c = 0; c < n_chn; ++c) {
+			ip[c] = &inp[c][0];
+			op[c] = &out[c][0];
+		}
+
+		gint64 t_vm  = 0;
+		gint64 t_vmc = 0;
+
+		for (int i = 0; i < cycles; ++i) {
+			uint32_t const cnt = floor (bufsize * speed_at (i));
+			fill (inp, i * bufsize);
+
+			gint64 t0 = g_get_monotonic_time ();
+			for (uint32_t c = 0; c < n_chn; ++c) {
+				vm[c].inp_data  = &inp[c][0];
+				vm[c].inp_count = bufsize;
+				vm[c].out_data  = &out[c][0];
+				vm[c].out_count = cnt;
+				vm[c].set_rratio (cnt / (double)bufsize);
+				vm[c].process ();
+			}
+			gint64 t1 = g_get_monotonic_time ();
+			for (uint32_t b = 0; b < n_blocks; ++b) {
+				vmc[b].inp_list  = &ip[b * blk_size];
+				vmc[b].out_list  = &op[b * blk_size];
+				vmc[b].inp_count = bufsize;
+				vmc[b].out_count = cnt;
+				vmc[b].set_rratio (cnt / (double)bufsize);
+				vmc[b].process ();
+			}
+			gint64 t2 = g_get_monotonic_time ();
+
+			t_vm  += t1 - t0;
+			t_vmc += t2 - t1;
+		}
+
+		cout << "Quality " << hlen << ", " << n_chn << " channels, " << cycles << " cycles of " << bufsize << " samples\n"
+		     << "  VMResampler:  " << t_vm / 1000.0 << " ms (" << t_vm / (double) cycles << " us/cycle)\n"
+		     << "  VMCResampler: " << t_vmc / 1000.0 << " ms (" << t_vmc / (double) cycles << " us/cycle)\n"
+		     << "  speedup: " << (t_vmc > 0 ? t_vm / (double) t_vmc : 0) << "\n";
+	}
+
+	return 0;
+}
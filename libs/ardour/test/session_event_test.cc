@@ -0,0 +1,266 @@
+#include <cstdlib>
+#include <iterator>
+#include <set>
+#include <vector>
+
+#include "ardour/session_event.h"
+
+#include "session_event_test.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (SessionEventTest);
+
+using namespace std;
+using namespace ARDOUR;
+
+/* Rolls and processes events using SessionEventManager::process_events_at (),
+ * the same way as Session::process_with_events () */
+class TestEventManager : public SessionEventManager
+{
+public:
+	TestEventManager () : position (0), schedule_on_overwrite (false) {}
+
+	~TestEventManager () {
+		for (Events::iterator i = events.begin (); i != events.end (); ++i) {
+			delete *i;
+		}
+	}
+
+	void queue_event (SessionEvent* ev) {
+		merge_event (ev);
+	}
+
+	void set_next_event () {
+		next_event = first_event_at_or_after (position);
+	}
+
+	void process_event (SessionEvent* ev) {
+		processed.push_back (ev->action_sample);
+		processed_types.push_back (ev->type);
+		switch (ev->type) {
+		case SessionEvent::AutoLoop:
+			/* stays in the queue */
+			return;
+		case SessionEvent::RangeStop:
+			/* like Session::realtime_stop () clearing range events */
+			_clear_event_type (SessionEvent::AutoLoop);
+			break;
+		case SessionEvent::Overwrite:
+			if (schedule_on_overwrite) {
+				add_event (ev->action_sample, SessionEvent::Audition);
+			}
+			break;
+		default:
+			break;
+		}
+		if (!_remove_event (ev)) {
+			delete ev;
+		}
+	}
+
+	/* roll from the current position to \p end */
+	void roll (samplepos_t end) {
+		SessionEvent* ev = event_at (next_event);
+
+		while (ev && ev->action_sample < end) {
+			position = ev->action_sample;
+			process_events_at (position);
+			ev = event_at (first_event_at_or_after (position + 1));
+		}
+		position = end;
+		set_next_event ();
+	}
+
+	void locate (samplepos_t pos) {
+		position = pos;
+		set_next_event ();
+	}
+
+	bool sorted () const {
+		for (Events::size_type n = 1; n < events.size (); ++n) {
+			if (events[n - 1]->action_sample > events[n]->action_sample) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	size_t size () const { return events.size (); }
+	size_t capacity () const { return events.capacity (); }
+	SessionEvent* next () const { return event_at (next_event); }
+
+	using SessionEventManager::add_event;
+	using SessionEventManager::remove_event;
+	using SessionEventManager::replace_event;
+
+	samplepos_t               position;
+	vector<samplepos_t>       processed;
+	vector<SessionEvent::Type> processed_types;
+	bool                      schedule_on_overwrite;
+};
+
+void
+SessionEventTest::orderTest ()
+{
+	TestEventManager m;
+
+	m.add_event (300, SessionEvent::Overwrite);
+	m.add_event (100, SessionEvent::Overwrite);
+	m.add_event (200, SessionEvent::Overwrite);
+	m.add_event (200, SessionEvent::OverwriteAll);
+
+	CPPUNIT_ASSERT_EQUAL ((size_t) 4, m.size ());
+	CPPUNIT_ASSERT (m.sorted ());
+	CPPUNIT_ASSERT_EQUAL ((samplepos_t) 100, m.next ()->action_sample);
+
+	/* a second event of the same type at the same time is refused */
+	m.add_event (100, SessionEvent::Overwrite);
+	CPPUNIT_ASSERT_EQUAL ((size_t) 4, m.size ());
+
+	m.locate (150);
+	CPPUNIT_ASSERT_EQUAL ((samplepos_t) 200, m.next ()->action_sample);
+
+	m.remove_event (200, SessionEvent::Overwrite);
+	CPPUNIT_ASSERT_EQUAL ((size_t) 3, m.size ());
+	CPPUNIT_ASSERT_EQUAL ((samplepos_t) 200, m.next ()->action_sample);
+	CPPUNIT_ASSERT_EQUAL (SessionEvent::OverwriteAll, m.next ()->type);
+
+	m.roll (1000);
+	CPPUNIT_ASSERT_EQUAL ((size_t) 2, m.processed.size ());
+	CPPUNIT_ASSERT_EQUAL ((samplepos_t) 200, m.processed[0]);
+	CPPUNIT_ASSERT_EQUAL ((samplepos_t) 300, m.processed[1]);
+	CPPUNIT_ASSERT (!m.next ());
+
+	/* the event before the locate position is still pending */
+	m.locate (0);
+	CPPUNIT_ASSERT_EQUAL ((samplepos_t) 100, m.next ()->action_sample);
+}
+
+void
+SessionEventTest::replaceTest ()
+{
+	TestEventManager m;
+
+	m.add_event (100, SessionEvent::Overwrite);
+	m.add_event (500, SessionEvent::Overwrite);
+	m.replace_event (SessionEvent::AutoLoop, 400);
+	m.replace_event (SessionEvent::AutoLoop, 50);
+
+	CPPUNIT_ASSERT_EQUAL ((size_t) 3, m.size ());
+	CPPUNIT_ASSERT (m.sorted ());
+	CPPUNIT_ASSERT_EQUAL (SessionEvent::AutoLoop, m.next ()->type);
+
+	/* the loop event is processed on each pass, but not removed */
+	for (int i = 0; i < 3; ++i) {
+		m.locate (0);
+		m.roll (80);
+	}
+	CPPUNIT_ASSERT_EQUAL ((size_t) 3, m.processed.size ());
+	CPPUNIT_ASSERT_EQUAL ((size_t) 3, m.size ());
+
+	m.replace_event (SessionEvent::AutoLoop, 1000);
+	CPPUNIT_ASSERT (m.sorted ());
+	CPPUNIT_ASSERT_EQUAL ((size_t) 3, m.size ());
+}
+
+void
+SessionEventTest::sameSampleTest ()
+{
+	TestEventManager m;
+	m.schedule_on_overwrite = true;
+
+	/* queue order at sample 100: AutoLoop, RangeStop, Overwrite.
+	 * Processing the RangeStop removes the AutoLoop event in front of it,
+	 * which must not skip the Overwrite event.
+	 */
+	m.add_event (100, SessionEvent::Overwrite);
+	m.add_event (100, SessionEvent::RangeStop);
+	m.replace_event (SessionEvent::AutoLoop, 100);
+	CPPUNIT_ASSERT_EQUAL ((size_t) 3, m.size ());
+
+	m.roll (200);
+	CPPUNIT_ASSERT_EQUAL ((size_t) 3, m.processed_types.size ());
+	CPPUNIT_ASSERT_EQUAL (SessionEvent::AutoLoop, m.processed_types[0]);
+	CPPUNIT_ASSERT_EQUAL (SessionEvent::RangeStop, m.processed_types[1]);
+	CPPUNIT_ASSERT_EQUAL (SessionEvent::Overwrite, m.processed_types[2]);
+
+	/* the event scheduled by the Overwrite is pending, but was not processed */
+	CPPUNIT_ASSERT_EQUAL ((size_t) 1, m.size ());
+	m.locate (0);
+	CPPUNIT_ASSERT_EQUAL (SessionEvent::Audition, m.next ()->type);
+	m.roll (200);
+	CPPUNIT_ASSERT_EQUAL ((size_t) 0, m.size ());
+
+	/* queue order at sample 300: AutoLoop, Overwrite.
+	 * The Overwrite schedules an event in front of the AutoLoop event,
+	 * which must not be processed a second time.
+	 */
+	m.processed_types.clear ();
+	m.add_event (300, SessionEvent::Overwrite);
+	m.replace_event (SessionEvent::AutoLoop, 300);
+	m.roll (400);
+	CPPUNIT_ASSERT_EQUAL ((size_t) 2, m.processed_types.size ());
+	CPPUNIT_ASSERT_EQUAL (SessionEvent::AutoLoop, m.processed_types[0]);
+	CPPUNIT_ASSERT_EQUAL (SessionEvent::Overwrite, m.processed_types[1]);
+	CPPUNIT_ASSERT (m.sorted ());
+}
+
+void
+SessionEventTest::stressTest ()
+{
+	TestEventManager m;
+	multiset<samplepos_t> expected;
+	set<samplepos_t> used;
+	size_t const capacity = m.capacity ();
+
+	srand (42);
+
+	for (int iter = 0; iter < 20000; ++iter) {
+		int const op = rand () % 10;
+
+		if (op < 5 && expected.size () < 400) {
+			samplepos_t const when = rand () % 100000;
+			if (used.insert (when).second) {
+				m.add_event (when, SessionEvent::Overwrite);
+				expected.insert (when);
+			}
+		} else if (op < 8 && !expected.empty ()) {
+			/* remove a random pending event */
+			multiset<samplepos_t>::iterator i = expected.begin ();
+			advance (i, rand () % expected.size ());
+			m.remove_event (*i, SessionEvent::Overwrite);
+			used.erase (*i);
+			expected.erase (i);
+		} else if (op < 9) {
+			m.locate (rand () % 100000);
+		} else {
+			/* roll a bit, the processed events are removed */
+			samplepos_t const start = m.position;
+			samplepos_t const end = start + rand () % 5000;
+			m.processed.clear ();
+			m.roll (end);
+			for (vector<samplepos_t>::const_iterator p = m.processed.begin (); p != m.processed.end (); ++p) {
+				CPPUNIT_ASSERT (*p >= start && *p < end);
+				CPPUNIT_ASSERT (expected.find (*p) != expected.end ());
+				expected.erase (expected.find (*p));
+				used.erase (*p);
+			}
+			/* all events in the range were processed */
+			CPPUNIT_ASSERT (expected.lower_bound (start) == expected.lower_bound (end));
+		}
+
+		CPPUNIT_ASSERT_EQUAL (expected.size (), m.size ());
+		CPPUNIT_ASSERT (m.sorted ());
+
+		/* the next event is the first one at or after the current position */
+		multiset<samplepos_t>::const_iterator n = expected.lower_bound (m.position);
+		if (n == expected.end ()) {
+			CPPUNIT_ASSERT (!m.next ());
+		} else {
+			CPPUNIT_ASSERT (m.next ());
+			CPPUNIT_ASSERT_EQUAL (*n, m.next ()->action_sample);
+		}
+	}
+
+	/* the preallocated space was sufficient */
+	CPPUNIT_ASSERT_EQUAL (capacity, m.capacity ());
+}
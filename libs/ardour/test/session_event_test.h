@@ -0,0 +1,18 @@
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class SessionEventTest : public CppUnit::TestFixture
+{
+	CPPUNIT_TEST_SUITE (SessionEventTest);
+	CPPUNIT_TEST (orderTest);
+	CPPUNIT_TEST (replaceTest);
+	CPPUNIT_TEST (sameSampleTest);
+	CPPUNIT_TEST (stressTest);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void orderTest ();
+	void replaceTest ();
+	void sameSampleTest ();
+	void stressTest ();
+};
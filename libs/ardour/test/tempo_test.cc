@@ -635,3 +635,64 @@ TempoTest::tempoFundamentalsTest ()
 	CPPUNIT_ASSERT_DOUBLES_EQUAL (164.0, tE->quarter_notes_per_minute (), 1e-17);
 	CPPUNIT_ASSERT_DOUBLES_EQUAL (41.0, tE->pulses_per_minute (), 1e-17);
 }
+
+void
+TempoTest::sectionIndexTest ()
+{
+	int const sampling_rate = 48000;
+
+	TempoMap map (sampling_rate);
+	Meter meterA (4, 4);
+	map.replace_meter (map.first_meter(), meterA, BBT_Time (1, 1, 0), 0, AudioTime);
+
+	Tempo tempoA (120.0, 4.0, 60.0);
+	map.replace_tempo (map.first_tempo(), tempoA, 0.0, 0, AudioTime);
+	Tempo tempoB (60.0, 4.0, 240.0);
+	map.add_tempo (tempoB, 4.0, 0, MusicTime);
+	Tempo tempoC (90.0, 8.0);
+	map.add_tempo (tempoC, 0.0, 12 * sampling_rate, AudioTime);
+	Meter meterB (3, 4);
+	map.add_meter (meterB, BBT_Time (6, 1, 0), 0, MusicTime);
+	Meter meterC (7, 8);
+	map.add_meter (meterC, BBT_Time (12, 1, 0), 0, MusicTime);
+
+	CPPUNIT_ASSERT (map.fresh_index ());
+
+	/* lookups via the index must match the linear search of the section list */
+	for (samplepos_t s = 0; s < 60 * sampling_rate; s += 997) {
+		const double minute = map.minute_at_sample (s);
+
+		CPPUNIT_ASSERT_DOUBLES_EQUAL (map.pulse_at_minute_locked (map._metrics, minute) * 4.0, map.quarter_note_at_sample (s), 1e-12);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL (map.pulse_at_minute_locked (map._metrics, minute) * 4.0, map.quarter_note_at_sample_rt (s), 1e-12);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL (map.beat_at_minute_locked (map._metrics, minute), map.beat_at_sample (s), 1e-12);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL (map.tempo_at_minute_locked (map._metrics, minute).note_types_per_minute(), map.tempo_at_sample (s).note_types_per_minute(), 1e-12);
+		CPPUNIT_ASSERT_EQUAL (&map.tempo_section_at_minute_locked (map._metrics, minute), &map.tempo_section_at_sample (s));
+		CPPUNIT_ASSERT_EQUAL (&map.meter_section_at_minute_locked (map._metrics, minute), &map.meter_section_at_sample (s));
+		CPPUNIT_ASSERT_EQUAL (map.bbt_at_minute_locked (map._metrics, minute), map.bbt_at_sample (s));
+		CPPUNIT_ASSERT_EQUAL (map.bbt_at_minute_locked (map._metrics, minute), map.bbt_at_sample_rt (s));
+	}
+
+	for (double qn = 0.0; qn < 120.0; qn += 0.37) {
+		const double beat = map.beat_at_pulse_locked (map._metrics, qn / 4.0);
+		const BBT_Time bbt = map.bbt_at_pulse_locked (map._metrics, qn / 4.0);
+
+		CPPUNIT_ASSERT_DOUBLES_EQUAL (beat, map.beat_at_quarter_note (qn), 1e-12);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL (map.pulse_at_beat_locked (map._metrics, beat) * 4.0, map.quarter_note_at_beat (beat), 1e-12);
+		CPPUNIT_ASSERT_EQUAL (map.sample_at_minute (map.minute_at_pulse_locked (map._metrics, qn / 4.0)), map.sample_at_quarter_note (qn));
+		CPPUNIT_ASSERT_EQUAL (map.sample_at_minute (map.minute_at_beat_locked (map._metrics, beat)), map.sample_at_beat (beat));
+		CPPUNIT_ASSERT_EQUAL (bbt, map.bbt_at_quarter_note (qn));
+		CPPUNIT_ASSERT_EQUAL (map.bbt_at_beat_locked (map._metrics, beat), map.bbt_at_beat (beat));
+		CPPUNIT_ASSERT_DOUBLES_EQUAL (map.pulse_at_bbt_locked (map._metrics, bbt) * 4.0, map.quarter_note_at_bbt (bbt), 1e-12);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL (map.pulse_at_bbt_locked (map._metrics, bbt) * 4.0, map.quarter_note_at_bbt_rt (bbt), 1e-12);
+		CPPUNIT_ASSERT_EQUAL (&map.meter_section_at_beat_locked (map._metrics, beat), &map.meter_section_at_beat (beat));
+	}
+
+	/* removing a section invalidates the index until the map is recomputed */
+	const MeterSection& ms (map.meter_section_at_beat (40.0));
+	map.remove_meter (ms, false);
+	CPPUNIT_ASSERT (!map.fresh_index ());
+	CPPUNIT_ASSERT_EQUAL (BBT_Time (1, 1, 0), map.bbt_at_sample (0));
+
+	map.recompute_map (map._metrics);
+	CPPUNIT_ASSERT (map.fresh_index ());
+}
@@ -22,14 +22,17 @@
 #include <algorithm>
 
 #include "ardour/audioengine.h"
+#include "ardour/buffer_arena.h"
 #include "ardour/buffer_set.h"
+#include "ardour/rc_configuration.h"
 #include "ardour/thread_buffers.h"
 
 using namespace ARDOUR;
 using namespace std;
 
-ThreadBuffers::ThreadBuffers ()
-	: silent_buffers (new BufferSet)
+ThreadBuffers::ThreadBuffers (uint32_t i)
+	: id (i)
+	, silent_buffers (new BufferSet)
 	, scratch_buffers (new BufferSet)
 	, noinplace_buffers (new BufferSet)
 	, route_buffers (new BufferSet)
@@ -40,17 +43,69 @@ ThreadBuffers::ThreadBuffers ()
 	, scratch_automation_buffer (0)
 	, pan_automation_buffer (0)
 	, npan_buffers (0)
+	, _custom (0)
+	, _use_arena (Config->get_thread_buffer_arena ())
+	, _arena (0)
+	, _arena_n_audio (0)
+	, _arena_size (0)
 {
 }
 
 void
 ThreadBuffers::ensure_buffers (ChanCount howmany, size_t custom)
+{
+	Glib::Threads::Mutex::Lock lm (_lock);
+	ensure_buffers_locked (howmany, custom);
+}
+
+void
+ThreadBuffers::reallocate ()
+{
+	Glib::Threads::Mutex::Lock lm (_lock);
+
+	ChanCount howmany = scratch_buffers->available ();
+
+	delete silent_buffers;
+	delete scratch_buffers;
+	delete noinplace_buffers;
+	delete route_buffers;
+	delete mix_buffers;
+
+	silent_buffers    = new BufferSet;
+	scratch_buffers   = new BufferSet;
+	noinplace_buffers = new BufferSet;
+	route_buffers     = new BufferSet;
+	mix_buffers       = new BufferSet;
+
+	if (_arena) {
+		/* the automation buffers are part of the arena */
+		howmany.set_audio (max (howmany.n_audio (), npan_buffers));
+		npan_buffers = 0;
+		delete [] pan_automation_buffer;
+		pan_automation_buffer = 0;
+		delete _arena;
+		_arena = 0;
+	}
+
+	/* this also re-allocates the automation buffers */
+	ensure_buffers_locked (howmany, _custom);
+
+	if (!_use_arena && npan_buffers > 0) {
+		size_t audio_buffer_size = _custom > 0 ? _custom : AudioEngine::instance ()->raw_buffer_size (DataType::AUDIO) / sizeof (Sample);
+		allocate_pan_automation_buffers (audio_buffer_size, npan_buffers, true);
+	}
+}
+
+void
+ThreadBuffers::ensure_buffers_locked (ChanCount howmany, size_t custom)
 {
 	// std::cerr << "ThreadBuffers " << this << " resize buffers with count = " << howmany << std::endl;
 
 	/* this is all protected by the process lock in the Session
 	 */
 
+	_custom = custom;
+
 	/* we always need at least 1 midi buffer */
 	if (howmany.n_midi() < 1) {
 		howmany.set_midi(1);
@@ -73,6 +128,11 @@ ThreadBuffers::ensure_buffers (ChanCount howmany, size_t custom)
 				: _engine->raw_buffer_size (*t) / sizeof (Sample);
 		}
 
+		if (*t == DataType::AUDIO && _use_arena) {
+			ensure_arena (count, size, max (2U, howmany.n_audio ()));
+			continue;
+		}
+
 		scratch_buffers->ensure_buffers (*t, count, size);
 		noinplace_buffers->ensure_buffers (*t, count, size);
 		mix_buffers->ensure_buffers (*t, count, size);
@@ -80,6 +140,10 @@ ThreadBuffers::ensure_buffers (ChanCount howmany, size_t custom)
 		route_buffers->ensure_buffers (*t, count, size);
 	}
 
+	if (_use_arena) {
+		return;
+	}
+
 	size_t audio_buffer_size = custom > 0 ? custom : _engine->raw_buffer_size (DataType::AUDIO) / sizeof (Sample);
 
 	delete [] gain_automation_buffer;
@@ -122,3 +186,57 @@ ThreadBuffers::allocate_pan_automation_buffers (samplecnt_t nframes, uint32_t ho
 
 	npan_buffers = howmany;
 }
+
+/** Allocate all audio buffers and automation buffers of this thread
+ * from a single BufferArena, to keep the working set of a process thread
+ * on as few pages (and TLB entries) as possible.
+ *
+ * The arena is only replaced if more or larger buffers are needed.
+ * Called with the process lock held, or by the thread using the buffers.
+ */
+void
+ThreadBuffers::ensure_arena (size_t n_audio, size_t size, uint32_t n_pan)
+{
+	if (_arena && n_audio <= _arena_n_audio && size <= _arena_size && n_pan <= npan_buffers) {
+		return;
+	}
+
+	n_audio = max (n_audio, _arena_n_audio);
+	n_pan   = max (n_pan, npan_buffers);
+
+	/* start every buffer at a cache-line */
+	const size_t stride = BufferArena::align (size * sizeof (Sample)) / sizeof (Sample);
+
+	BufferSet* sets[] = { silent_buffers, scratch_buffers, noinplace_buffers, route_buffers, mix_buffers };
+	const size_t n_sets = sizeof (sets) / sizeof (BufferSet*);
+
+	const size_t bytes = n_sets * n_audio * stride * sizeof (Sample)
+	                   + (4 + n_pan) * stride * sizeof (gain_t);
+
+	BufferArena* arena = new BufferArena (bytes, Config->get_thread_buffer_huge_pages ());
+
+	for (size_t i = 0; i < n_sets; ++i) {
+		sets[i]->use_audio_memory (n_audio, stride, arena->alloc<Sample> (n_audio * stride));
+	}
+
+	gain_automation_buffer      = arena->alloc<gain_t> (stride);
+	trim_automation_buffer      = arena->alloc<gain_t> (stride);
+	send_gain_automation_buffer = arena->alloc<gain_t> (stride);
+	scratch_automation_buffer   = arena->alloc<gain_t> (stride);
+
+	delete [] pan_automation_buffer;
+	pan_automation_buffer = new pan_t*[n_pan];
+	for (uint32_t i = 0; i < n_pan; ++i) {
+		pan_automation_buffer[i] = arena->alloc<pan_t> (stride);
+	}
+	npan_buffers = n_pan;
+
+	assert (arena->used () <= arena->size ());
+
+	/* no buffer refers to the previous arena anymore */
+	delete _arena;
+
+	_arena         = arena;
+	_arena_n_audio = n_audio;
+	_arena_size    = size;
+}
@@ -0,0 +1,185 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <set>
+
+#include "pbd/compose.h"
+#include "pbd/cpus.h"
+#include "pbd/error.h"
+#include "pbd/pthread_utils.h"
+#include "pbd/string_convert.h"
+
+#include "ardour/rc_configuration.h"
+#include "ardour/thread_placement.h"
+
+#include "pbd/i18n.h"
+
+using namespace ARDOUR;
+using namespace PBD;
+using namespace std;
+
+Glib::Threads::Mutex ThreadPlacement::_lock;
+uint32_t             ThreadPlacement::_n_dsp = 0;
+
+static const char*
+role_name (ThreadPlacement::Role r)
+{
+	switch (r) {
+		case ThreadPlacement::DSP:
+			return _("DSP");
+		case ThreadPlacement::Butler:
+			return _("Butler");
+		case ThreadPlacement::Backend:
+			return _("Backend");
+		case ThreadPlacement::GUI:
+			return _("GUI");
+		default:
+			break;
+	}
+	return "";
+}
+
+vector<int>
+ThreadPlacement::configured_cpus (Role r)
+{
+	string spec;
+	switch (r) {
+		case DSP:
+			spec = Config->get_dsp_thread_cpus ();
+			break;
+		case Butler:
+			spec = Config->get_butler_thread_cpus ();
+			break;
+		case Backend:
+			spec = Config->get_backend_thread_cpus ();
+			break;
+		case GUI:
+			spec = Config->get_gui_thread_cpus ();
+			break;
+		default:
+			break;
+	}
+	if (spec.empty ()) {
+		return vector<int> ();
+	}
+
+	vector<int> cpus = parse_cpu_list (spec);
+	if (cpus.empty ()) {
+		warning << string_compose (_("Invalid CPU list for %1 threads: '%2'"), role_name (r), spec) << endmsg;
+		return cpus;
+	}
+
+	/* only use CPUs that are online, ordered by the topology */
+	vector<CPUInfo> topo = cpu_topology ();
+	vector<CPUInfo> avail;
+	for (vector<CPUInfo>::const_iterator i = topo.begin (); i != topo.end (); ++i) {
+		if (binary_search (cpus.begin (), cpus.end (), i->id)) {
+			avail.push_back (*i);
+		}
+	}
+
+	cpus.clear ();
+
+	if (r == DSP && Config->get_avoid_smt_siblings ()) {
+		/* first one CPU per physical core, then the remaining siblings */
+		set<pair<int, int> > cores;
+		vector<int>          siblings;
+		for (vector<CPUInfo>::const_iterator i = avail.begin (); i != avail.end (); ++i) {
+			if (cores.insert (make_pair (i->package, i->core)).second) {
+				cpus.push_back (i->id);
+			} else {
+				siblings.push_back (i->id);
+			}
+		}
+		cpus.insert (cpus.end (), siblings.begin (), siblings.end ());
+	} else {
+		for (vector<CPUInfo>::const_iterator i = avail.begin (); i != avail.end (); ++i) {
+			cpus.push_back (i->id);
+		}
+	}
+
+	if (cpus.empty ()) {
+		warning << string_compose (_("None of the CPUs configured for %1 threads is online"), role_name (r)) << endmsg;
+	}
+	return cpus;
+}
+
+bool
+ThreadPlacement::place (Role r)
+{
+	vector<int> cpus = configured_cpus (r);
+
+	if (cpus.empty ()) {
+		/* undo affinity inherited from the thread that created this one */
+		bool any = false;
+		for (int i = 0; i < NumRoles; ++i) {
+			any |= !configured_cpus ((Role)i).empty ();
+		}
+		if (any) {
+			vector<CPUInfo> topo = cpu_topology ();
+			for (vector<CPUInfo>::const_iterator i = topo.begin (); i != topo.end (); ++i) {
+				cpus.push_back (i->id);
+			}
+			pbd_set_thread_affinity (pthread_self (), cpus);
+		}
+		return false;
+	}
+
+	if (r == DSP) {
+		Glib::Threads::Mutex::Lock lm (_lock);
+		int cpu = cpus[_n_dsp++ % cpus.size ()];
+		cpus.clear ();
+		cpus.push_back (cpu);
+	}
+
+	int rv = pbd_set_thread_affinity (pthread_self (), cpus);
+	if (rv) {
+		warning << string_compose (_("Cannot set CPU affinity of %1 thread: %2"), role_name (r), strerror (rv)) << endmsg;
+		return false;
+	}
+	return true;
+}
+
+void
+ThreadPlacement::reset ()
+{
+	Glib::Threads::Mutex::Lock lm (_lock);
+	_n_dsp = 0;
+}
+
+string
+ThreadPlacement::describe (Role r)
+{
+	vector<int> cpus = configured_cpus (r);
+	if (cpus.empty ()) {
+		return string_compose (_("%1: any CPU"), role_name (r));
+	}
+
+	sort (cpus.begin (), cpus.end ());
+	string list;
+	for (vector<int>::const_iterator i = cpus.begin (); i != cpus.end (); ++i) {
+		list += (list.empty () ? "" : ",") + PBD::to_string (*i);
+	}
+
+	if (r == DSP && Config->get_avoid_smt_siblings ()) {
+		return string_compose (_("%1: CPUs %2, avoiding SMT siblings"), role_name (r), list);
+	}
+	return string_compose (_("%1: CPUs %2"), role_name (r), list);
+}
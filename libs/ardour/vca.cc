@@ -86,6 +86,8 @@ VCA::init ()
 	add_control (_solo_control);
 	add_control (_mute_control);
 
+	_gain_control->allocate_curve_cache (_session.get_block_size ());
+
 	return 0;
 }
 
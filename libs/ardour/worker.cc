@@ -20,38 +20,190 @@
 #include <stdlib.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <vector>
+
+#include <glibmm/threads.h>
 #include <glibmm/timer.h>
 
 #include "pbd/error.h"
-#include "pbd/compose.h"
+#include "pbd/cpus.h"
 #include "pbd/pthread_utils.h"
+#include "pbd/semutils.h"
 
+#include "ardour/rc_configuration.h"
 #include "ardour/worker.h"
 
 namespace ARDOUR {
 
+/** Threads executing the work of all threaded Workers.
+ *
+ * Scheduling work only wakes up the pool if the worker was idle, so
+ * a plugin that schedules many requests per cycle causes a single wakeup.
+ * The pool threads pick up pending workers round-robin.
+ *
+ * When all threads are busy, another thread is added, so that work that
+ * takes long (e.g. loading a sample) does not delay other plugins. The
+ * pool grows up to one thread per worker, since work of a given worker
+ * is never executed concurrently.
+ */
+class WorkerPool
+{
+public:
+	static WorkerPool& instance ();
+
+	void add (Worker*);
+	void remove (Worker*);
+
+	/** called by Worker::schedule (audio thread) */
+	void wakeup () { _sem.signal (); }
+
+private:
+	WorkerPool ();
+	void run ();
+	bool add_thread ();
+
+	static WorkerPool* _instance;
+
+	Glib::Threads::Mutex _lock;
+	std::vector<Worker*> _workers;
+	size_t               _next;
+	uint32_t             _n_threads;
+	uint32_t             _n_busy;
+	PBD::Semaphore       _sem;
+};
+
+WorkerPool* WorkerPool::_instance = 0;
+
+WorkerPool&
+WorkerPool::instance ()
+{
+	/* created by the first threaded Worker, in the GUI thread */
+	if (!_instance) {
+		_instance = new WorkerPool;
+	}
+	return *_instance;
+}
+
+WorkerPool::WorkerPool ()
+	: _next (0)
+	, _n_threads (0)
+	, _n_busy (0)
+	, _sem ("worker_pool", 0)
+{
+	uint32_t n_threads = Config->get_lv2_worker_threads ();
+	if (n_threads == 0) {
+		n_threads = hardware_concurrency ();
+	}
+	n_threads = std::max<uint32_t> (1, n_threads);
+
+	Glib::Threads::Mutex::Lock lm (_lock);
+	for (uint32_t n = 0; n < n_threads; ++n) {
+		if (!add_thread ()) {
+			break;
+		}
+	}
+}
+
+/* called with _lock held */
+bool
+WorkerPool::add_thread ()
+{
+	try {
+		Glib::Threads::Thread::create (sigc::mem_fun (*this, &WorkerPool::run));
+	} catch (...) {
+		PBD::error << "Worker: cannot create pool thread" << endmsg;
+		return false;
+	}
+	++_n_threads;
+	return true;
+}
+
+void
+WorkerPool::add (Worker* w)
+{
+	Glib::Threads::Mutex::Lock lm (_lock);
+	_workers.push_back (w);
+}
+
+void
+WorkerPool::remove (Worker* w)
+{
+	{
+		Glib::Threads::Mutex::Lock lm (_lock);
+		std::vector<Worker*>::iterator i = std::find (_workers.begin (), _workers.end (), w);
+		if (i != _workers.end ()) {
+			_workers.erase (i);
+		}
+	}
+
+	/* workers are only claimed while holding the lock,
+	 * wait for a pool thread that is still busy with it */
+	while (g_atomic_int_get (&w->_state) >= Worker::Running) {
+		Glib::usleep (1000);
+	}
+}
+
+void
+WorkerPool::run ()
+{
+	pthread_set_name ("LV2Worker");
+
+	void*  buf      = NULL;
+	size_t buf_size = 0;
+
+	while (true) {
+		_sem.wait ();
+
+		Worker* w = 0;
+
+		{
+			Glib::Threads::Mutex::Lock lm (_lock);
+			const size_t n_workers = _workers.size ();
+			for (size_t i = 0; i < n_workers; ++i) {
+				Worker* c = _workers[(_next + i) % n_workers];
+				if (g_atomic_int_compare_and_exchange (&c->_state, Worker::Pending, Worker::Running)) {
+					w     = c;
+					_next = (_next + i + 1) % n_workers;
+					break;
+				}
+			}
+
+			if (!w) {
+				continue;
+			}
+
+			/* keep a thread available for other workers */
+			if (++_n_busy == _n_threads && _n_threads < n_workers) {
+				add_thread ();
+			}
+		}
+
+		w->run (buf, buf_size);
+
+		Glib::Threads::Mutex::Lock lm (_lock);
+		--_n_busy;
+	}
+}
+
 Worker::Worker(Workee* workee, uint32_t ring_size, bool threaded)
 	: _workee(workee)
 	, _requests(threaded ? new PBD::RingBuffer<uint8_t>(ring_size) : NULL)
 	, _responses(new PBD::RingBuffer<uint8_t>(ring_size))
 	, _response((uint8_t*)malloc(ring_size))
-	, _sem(string_compose ("worker_semaphore%1", this).c_str(), 0)
-	, _thread(NULL)
-	, _exit(false)
 	, _synchronous(!threaded)
+	, _state(Idle)
+	, _pending_since(0)
 {
 	if (threaded) {
-		_thread = Glib::Threads::Thread::create(
-			sigc::mem_fun(*this, &Worker::run));
+		WorkerPool::instance ().add (this);
 	}
 }
 
 Worker::~Worker()
 {
-	_exit = true;
-	_sem.signal();
-	if (_thread) {
-		_thread->join();
+	if (_requests) {
+		WorkerPool::instance ().remove (this);
 	}
 	delete _responses;
 	delete _requests;
@@ -75,8 +227,27 @@ Worker::schedule(uint32_t size, const void* data)
 	if (_requests->write((const uint8_t*)data, size) != size) {
 		return false;
 	}
-	_sem.signal();
-	return true;
+
+	/* only wake up the pool if no wakeup is pending, and no pool thread
+	 * is going to check for more requests */
+	while (true) {
+		switch (g_atomic_int_get (&_state)) {
+			case Idle:
+				_pending_since = g_get_monotonic_time ();
+				if (g_atomic_int_compare_and_exchange (&_state, Idle, Pending)) {
+					WorkerPool::instance ().wakeup ();
+					return true;
+				}
+				break;
+			case Running:
+				if (g_atomic_int_compare_and_exchange (&_state, Running, RunningPending)) {
+					return true;
+				}
+				break;
+			default:
+				return true;
+		}
+	}
 }
 
 bool
@@ -135,57 +306,75 @@ Worker::emit_responses()
 	}
 }
 
+/** Process all pending requests (pool thread).
+ * @param buf scratch buffer of the calling thread, grown as needed
+ */
 void
-Worker::run()
+Worker::run(void*& buf, size_t& buf_size)
 {
-	pthread_set_name ("LV2Worker");
+	const gint64 latency = g_get_monotonic_time () - _pending_since;
+
+	{
+		/* stats are read by the GUI, pool threads are not realtime */
+		Glib::Threads::Mutex::Lock lm (_stats_lock);
+		++_stats.batches;
+		_stats.total_latency += latency;
+		_stats.max_latency    = std::max<uint64_t> (_stats.max_latency, latency);
+		_stats.max_queue      = std::max<uint32_t> (_stats.max_queue, _requests->read_space ());
+	}
 
-	void*  buf      = NULL;
-	size_t buf_size = 0;
 	while (true) {
-		_sem.wait();
-		if (_exit) {
-			free(buf);
-			return;
-		}
+		/* a message that is still being written is announced
+		 * by the writer once complete, see schedule() */
+		while (verify_message_completeness(_requests)) {
+			uint32_t size;
+			_requests->read((uint8_t*)&size, sizeof(size));
 
-		uint32_t size = _requests->read_space();
-		if (size < sizeof(size)) {
-			PBD::error << "Worker: no work-data on ring buffer" << endmsg;
-			continue;
-		}
-		while (!verify_message_completeness(_requests)) {
-			Glib::usleep(2000);
-			if (_exit) {
-				if (buf) free(buf);
-				return;
+			if (size > buf_size) {
+				buf = realloc(buf, size);
+				if (buf) {
+					buf_size = size;
+				} else {
+					PBD::fatal << "Worker: Error allocating memory" << endmsg;
+					abort(); /*NOTREACHED*/
+				}
 			}
-		}
-		if (_requests->read((uint8_t*)&size, sizeof(size)) < sizeof(size)) {
-			PBD::error << "Worker: Error reading size from request ring"
-			           << endmsg;
-			continue;
-		}
+			assert (buf || size == 0);
 
-		if (size > buf_size) {
-			buf = realloc(buf, size);
-			if (buf) {
-				buf_size = size;
-			} else {
-				PBD::fatal << "Worker: Error allocating memory" << endmsg;
-				abort(); /*NOTREACHED*/
+			if (_requests->read((uint8_t*)buf, size) < size) {
+				PBD::error << "Worker: Error reading body from request ring"
+				           << endmsg;
+				continue;  // TODO: This is probably fatal
 			}
+
+			_workee->work(*this, size, buf);
+
+			Glib::Threads::Mutex::Lock lm (_stats_lock);
+			++_stats.requests;
 		}
-		assert (buf);
 
-		if (_requests->read((uint8_t*)buf, size) < size) {
-			PBD::error << "Worker: Error reading body from request ring"
-			           << endmsg;
-			continue;  // TODO: This is probably fatal
+		/* the worker may be deleted once idle, see WorkerPool::remove */
+		if (g_atomic_int_compare_and_exchange (&_state, Running, Idle)) {
+			return;
 		}
 
-		_workee->work(*this, size, buf);
+		/* more work was scheduled meanwhile */
+		g_atomic_int_set (&_state, Running);
 	}
 }
 
+Worker::Stats
+Worker::stats () const
+{
+	Glib::Threads::Mutex::Lock lm (_stats_lock);
+	return _stats;
+}
+
+void
+Worker::clear_stats ()
+{
+	Glib::Threads::Mutex::Lock lm (_stats_lock);
+	_stats = Stats ();
+}
+
 } // namespace ARDOUR
@@ -0,0 +1,148 @@
+#include <sys/time.h>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include <cairomm/cairomm.h>
+
+#include "waveview/wave_view_raster.h"
+
+using namespace std;
+using namespace ArdourWaveView;
+
+/* Render the alpha masks of many waveview images, as
+ * WaveView::draw_image() does when scrolling through a large session:
+ * once by stroking one line per pixel column with cairo, and once using
+ * the WaveViewRaster.
+ *
+ * usage: render_waveforms [<number-of-tracks>] [<width>] [<height>]
+ */
+
+struct Tips {
+	double top;
+	double bot;
+};
+
+static void
+make_tips (vector<Tips>& tips, int track, double height)
+{
+	for (size_t i = 0; i < tips.size (); ++i) {
+		const double env = fabs (sin (i * 0.0013 * (track + 1)));
+		const double pmax = env * (0.5 + 0.5 * ((double) rand () / RAND_MAX));
+		const double pmin = -env * (0.5 + 0.5 * ((double) rand () / RAND_MAX));
+		tips[i].top = max (0.0, round ((1.0 - pmax) * 0.5 * height));
+		tips[i].bot = min (height, round ((1.0 - pmin) * 0.5 * height));
+	}
+}
+
+static Cairo::RefPtr<Cairo::ImageSurface>
+draw_cairo (vector<Tips> const& tips, int width, int height)
+{
+	Cairo::RefPtr<Cairo::ImageSurface> wave = Cairo::ImageSurface::create (Cairo::FORMAT_A8, width, height);
+	Cairo::RefPtr<Cairo::ImageSurface> outline = Cairo::ImageSurface::create (Cairo::FORMAT_A8, width, height);
+	Cairo::RefPtr<Cairo::Context> wave_context = Cairo::Context::create (wave);
+	Cairo::RefPtr<Cairo::Context> outline_context = Cairo::Context::create (outline);
+
+	wave_context->set_antialias (Cairo::ANTIALIAS_NONE);
+	outline_context->set_antialias (Cairo::ANTIALIAS_NONE);
+	wave_context->set_source_rgba (0, 0, 0, 1.0);
+	outline_context->set_source_rgba (0, 0, 0, 1.0);
+	wave_context->set_line_width (1.0);
+	outline_context->set_line_width (1.0);
+	wave_context->translate (0.5, 0.5);
+	outline_context->translate (0.5, 0.5);
+
+	for (int i = 0; i < width; ++i) {
+		wave_context->move_to (i, tips[i].top);
+		wave_context->line_to (i, tips[i].bot);
+		outline_context->move_to (i, tips[i].bot);
+		outline_context->rel_line_to (0, -1.0);
+		outline_context->move_to (i, tips[i].top);
+		outline_context->rel_line_to (0, 1.0);
+	}
+
+	wave_context->stroke ();
+	outline_context->stroke ();
+	wave->flush ();
+
+	return wave;
+}
+
+static Cairo::RefPtr<Cairo::ImageSurface>
+draw_raster (vector<Tips> const& tips, int width, int height)
+{
+	WaveViewRaster raster (width, height);
+
+	for (int i = 0; i < width; ++i) {
+		raster.vline (WaveViewRaster::Wave, i, tips[i].top, tips[i].bot);
+		raster.vline (WaveViewRaster::Outline, i, tips[i].bot, tips[i].bot - 1.0);
+		raster.vline (WaveViewRaster::Outline, i, tips[i].top, tips[i].top + 1.0);
+	}
+
+	Cairo::RefPtr<Cairo::ImageSurface> wave = Cairo::ImageSurface::create (Cairo::FORMAT_A8, width, height);
+	Cairo::RefPtr<Cairo::ImageSurface> outline = Cairo::ImageSurface::create (Cairo::FORMAT_A8, width, height);
+	raster.render (WaveViewRaster::Wave, wave);
+	raster.render (WaveViewRaster::Outline, outline);
+
+	return wave;
+}
+
+static double
+elapsed (timeval const& start, timeval const& stop)
+{
+	int sec = stop.tv_sec - start.tv_sec;
+	int usec = stop.tv_usec - start.tv_usec;
+	if (usec < 0) {
+		--sec;
+		usec += 1e6;
+	}
+	return sec + ((double) usec / 1e6);
+}
+
+int main (int argc, char* argv[])
+{
+	const int n_tracks = argc > 1 ? atoi (argv[1]) : 300;
+	const int width    = argc > 2 ? atoi (argv[2]) : 4096;
+	const int height   = argc > 3 ? atoi (argv[3]) : 100;
+
+	vector<vector<Tips> > tips (n_tracks, vector<Tips> (width));
+	for (int t = 0; t < n_tracks; ++t) {
+		make_tips (tips[t], t, height);
+	}
+
+	timeval start, stop;
+
+	gettimeofday (&start, 0);
+	for (int t = 0; t < n_tracks; ++t) {
+		draw_cairo (tips[t], width, height);
+	}
+	gettimeofday (&stop, 0);
+	const double t_cairo = elapsed (start, stop);
+
+	gettimeofday (&start, 0);
+	for (int t = 0; t < n_tracks; ++t) {
+		draw_raster (tips[t], width, height);
+	}
+	gettimeofday (&stop, 0);
+	const double t_raster = elapsed (start, stop);
+
+	/* both must produce the same mask */
+	Cairo::RefPtr<Cairo::ImageSurface> a = draw_cairo (tips[0], width, height);
+	Cairo::RefPtr<Cairo::ImageSurface> b = draw_raster (tips[0], width, height);
+	int mismatch = 0;
+	for (int y = 0; y < height; ++y) {
+		for (int x = 0; x < width; ++x) {
+			if (a->get_data ()[y * a->get_stride () + x] != b->get_data ()[y * b->get_stride () + x]) {
+				++mismatch;
+			}
+		}
+	}
+
+	cout << n_tracks << " waveforms, " << width << "x" << height << "\n"
+	     << "cairo:  " << t_cairo << "\n"
+	     << "raster: " << t_raster << "\n"
+	     << "mismatching pixels: " << mismatch << "\n";
+
+	return 0;
+}
@@ -33,6 +33,15 @@ public:
 
 	int do_command (std::string);
 	int do_file (std::string);
+
+	/** Compile the given script without running it.
+	 * @param bytecode set to the precompiled chunk, which can be run
+	 * in any LuaState using do_bytecode ()
+	 * @return 0 on success
+	 */
+	int compile (std::string const& cmd, std::string& bytecode);
+	int do_bytecode (std::string const& bytecode);
+
 	void collect_garbage ();
 	void collect_garbage_step (int debt = 0);
 	void tweak_rt_gc ();
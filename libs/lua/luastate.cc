@@ -71,6 +71,38 @@ LuaState::do_file (std::string fn) {
 	return result;
 }
 
+static int
+dump_writer (lua_State*, const void* p, size_t sz, void* ud) {
+	static_cast<std::string*> (ud)->append (static_cast<const char*> (p), sz);
+	return 0;
+}
+
+int
+LuaState::compile (std::string const& cmd, std::string& bytecode) {
+	int result = luaL_loadstring (L, cmd.c_str());
+	if (result != 0) {
+		print ("Error: " + std::string (lua_tostring (L, -1)));
+		lua_pop (L, 1);
+		return result;
+	}
+	bytecode.clear ();
+	result = lua_dump (L, &dump_writer, &bytecode, 0);
+	lua_pop (L, 1);
+	return result;
+}
+
+int
+LuaState::do_bytecode (std::string const& bytecode) {
+	int result = luaL_loadbufferx (L, bytecode.data(), bytecode.size(), "=bytecode", "b");
+	if (result == 0) {
+		result = lua_pcall (L, 0, LUA_MULTRET, 0);
+	}
+	if (result != 0) {
+		print ("Error: " + std::string (lua_tostring (L, -1)));
+	}
+	return result;
+}
+
 void
 LuaState::collect_garbage () {
 	lua_gc (L, LUA_GCCOLLECT, 0);
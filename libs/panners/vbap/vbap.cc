@@ -82,7 +82,7 @@ VBAPanner::Signal::resize_gains (uint32_t n)
 
 VBAPanner::VBAPanner (boost::shared_ptr<Pannable> p, boost::shared_ptr<Speakers> s)
 	: Panner (p)
-	, _speakers (new VBAPSpeakers (s))
+	, _speakers (VBAPSpeakers::get (s))
 {
 	_pannable->pan_azimuth_control->Changed.connect_same_thread (*this, boost::bind (&VBAPanner::update, this));
 	_pannable->pan_elevation_control->Changed.connect_same_thread (*this, boost::bind (&VBAPanner::update, this));
@@ -172,49 +172,33 @@ VBAPanner::compute_gains (double gains[3], int speaker_ids[3], int azi, int ele)
 	/* calculates gain factors using loudspeaker setup and given direction */
 	double    cartdir[3];
 	double    power;
-	int       i, j, k;
-	double    small_g;
-	double    big_sm_g, gtmp[3];
 	const int dimension = _speakers->dimension ();
 	assert (dimension == 2 || dimension == 3);
 
-	spherical_to_cartesian (azi, ele, 1.0, cartdir[0], cartdir[1], cartdir[2]);
-	big_sm_g = -100000.0;
-
 	gains[0] = gains[1] = gains[2] = 0;
 	speaker_ids[0] = speaker_ids[1] = speaker_ids[2] = 0;
 
-	for (i = 0; i < _speakers->n_tuples (); i++) {
-		small_g = 10000000.0;
+	/* the tuple search is cached by the speakers, only the gains are computed here */
+	const int i = _speakers->tuple_for_direction (azi, ele);
 
-		for (j = 0; j < dimension; j++) {
-			gtmp[j] = 0.0;
+	if (i >= 0) {
+		VBAPSpeakers::dvector const& m (_speakers->matrix (i));
 
-			for (k = 0; k < dimension; k++) {
-				gtmp[j] += cartdir[k] * _speakers->matrix (i)[j * dimension + k];
-			}
+		spherical_to_cartesian (azi, ele, 1.0, cartdir[0], cartdir[1], cartdir[2]);
 
-			if (gtmp[j] < small_g) {
-				small_g = gtmp[j];
+		for (int j = 0; j < dimension; j++) {
+			for (int k = 0; k < dimension; k++) {
+				gains[j] += cartdir[k] * m[j * dimension + k];
 			}
 		}
 
-		if (small_g > big_sm_g) {
-			big_sm_g = small_g;
-
-			gains[0] = gtmp[0];
-			gains[1] = gtmp[1];
-
-			speaker_ids[0] = _speakers->speaker_for_tuple (i, 0);
-			speaker_ids[1] = _speakers->speaker_for_tuple (i, 1);
+		speaker_ids[0] = _speakers->speaker_for_tuple (i, 0);
+		speaker_ids[1] = _speakers->speaker_for_tuple (i, 1);
 
-			if (_speakers->dimension () == 3) {
-				gains[2]       = gtmp[2];
-				speaker_ids[2] = _speakers->speaker_for_tuple (i, 2);
-			} else {
-				gains[2]       = 0.0;
-				speaker_ids[2] = -1;
-			}
+		if (dimension == 3) {
+			speaker_ids[2] = _speakers->speaker_for_tuple (i, 2);
+		} else {
+			speaker_ids[2] = -1;
 		}
 	}
 
@@ -227,6 +211,24 @@ VBAPanner::compute_gains (double gains[3], int speaker_ids[3], int azi, int ele)
 	}
 }
 
+/* Mix with a linear gain ramp. Unlike AudioBuffer::accumulate_with_ramped_gain_from
+ * the gain is computed from the sample index instead of being accumulated,
+ * which allows the compiler to vectorize the loop.
+ */
+static void
+mix_buffers_with_gain_ramp (Sample* dst, Sample const* src, pframes_t nframes, gain_t initial, gain_t target)
+{
+	if (initial == 0 && target == 0) {
+		return;
+	}
+
+	const gain_t delta = (target - initial) / nframes;
+
+	for (pframes_t n = 0; n < nframes; ++n) {
+		dst[n] += src[n] * (initial + n * delta);
+	}
+}
+
 void
 VBAPanner::distribute (BufferSet& inbufs, BufferSet& obufs, gain_t gain_coefficient, pframes_t nframes)
 {
@@ -328,7 +330,8 @@ VBAPanner::distribute_one (AudioBuffer& srcbuf, BufferSet& obufs, gain_t gain_co
 			 */
 
 			AudioBuffer& buf (obufs.get_audio (output));
-			buf.accumulate_with_ramped_gain_from (srcbuf.data (), nframes, signal->gains[output], pan, 0);
+			mix_buffers_with_gain_ramp (buf.data (), src, nframes, signal->gains[output], pan);
+			buf.set_written (true);
 			signal->gains[output] = pan;
 
 		} else {
@@ -345,7 +348,8 @@ VBAPanner::distribute_one (AudioBuffer& srcbuf, BufferSet& obufs, gain_t gain_co
 		if (outputs[o] == 1) {
 			/* take signal and deliver with a rapid fade out */
 			AudioBuffer& buf (obufs.get_audio (o));
-			buf.accumulate_with_ramped_gain_from (srcbuf.data (), nframes, signal->gains[o], 0.0, 0);
+			mix_buffers_with_gain_ramp (buf.data (), src, nframes, signal->gains[o], 0.0);
+			buf.set_written (true);
 			signal->gains[o] = 0.0;
 		}
 	}
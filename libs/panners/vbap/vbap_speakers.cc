@@ -45,6 +45,36 @@ using namespace std;
 
 const double VBAPSpeakers::MIN_VOL_P_SIDE_LGTH = 0.01;
 
+VBAPSpeakers::Instances VBAPSpeakers::_instances;
+Glib::Threads::Mutex    VBAPSpeakers::_instance_lock;
+
+boost::shared_ptr<VBAPSpeakers>
+VBAPSpeakers::get (boost::shared_ptr<Speakers> s)
+{
+	Glib::Threads::Mutex::Lock lm (_instance_lock);
+
+	for (Instances::iterator i = _instances.begin (); i != _instances.end ();) {
+		if (i->second.expired ()) {
+			_instances.erase (i++);
+		} else {
+			++i;
+		}
+	}
+
+	/* a live instance holds a reference to its Speakers, so the
+	 * address cannot have been reused by a different layout.
+	 */
+	boost::shared_ptr<VBAPSpeakers> vs;
+	Instances::iterator i = _instances.find (s.get ());
+	if (i != _instances.end () && (vs = i->second.lock ())) {
+		return vs;
+	}
+
+	vs.reset (new VBAPSpeakers (s));
+	_instances[s.get ()] = vs;
+	return vs;
+}
+
 VBAPSpeakers::VBAPSpeakers (boost::shared_ptr<Speakers> s)
 	: _dimension (2)
 	, _parent (s)
@@ -64,6 +94,8 @@ VBAPSpeakers::update ()
 
 	_speakers = _parent->speakers ();
 
+	_tuple_grid.assign (360 * 181, -2);
+
 	for (vector<Speaker>::const_iterator i = _speakers.begin (); i != _speakers.end (); ++i) {
 		if ((*i).angles ().ele != 0.0) {
 			dim = 3;
@@ -90,6 +122,54 @@ VBAPSpeakers::update ()
 	}
 }
 
+int
+VBAPSpeakers::tuple_for_direction (int azi, int ele) const
+{
+	azi = ((azi % 360) + 360) % 360;
+	ele = max (-90, min (90, ele));
+
+	gint* t = &_tuple_grid[(ele + 90) * 360 + azi];
+	gint  rv = g_atomic_int_get (t);
+	if (rv == -2) {
+		rv = find_tuple (azi, ele);
+		g_atomic_int_set (t, rv);
+	}
+	return rv;
+}
+
+/** find the tuple whose smallest gain is largest for the given direction */
+int
+VBAPSpeakers::find_tuple (int azi, int ele) const
+{
+	double cartdir[3];
+	double big_sm_g = -100000.0;
+	int    rv       = -1;
+
+	spherical_to_cartesian (azi, ele, 1.0, cartdir[0], cartdir[1], cartdir[2]);
+
+	for (int i = 0; i < n_tuples (); i++) {
+		dvector const& m (_matrices[i]);
+		double         small_g = 10000000.0;
+
+		for (int j = 0; j < _dimension; j++) {
+			double g = 0.0;
+			for (int k = 0; k < _dimension; k++) {
+				g += cartdir[k] * m[j * _dimension + k];
+			}
+			if (g < small_g) {
+				small_g = g;
+			}
+		}
+
+		if (small_g > big_sm_g) {
+			big_sm_g = small_g;
+			rv       = i;
+		}
+	}
+
+	return rv;
+}
+
 void
 VBAPSpeakers::choose_speaker_triplets (struct ls_triplet_chain** ls_triplets)
 {
@@ -19,10 +19,15 @@
 #ifndef __libardour_vbap_speakers_h__
 #define __libardour_vbap_speakers_h__
 
+#include <map>
 #include <string>
 #include <vector>
 
 #include <boost/utility.hpp>
+#include <boost/weak_ptr.hpp>
+
+#include <glib.h>
+#include <glibmm/threads.h>
 
 #include <pbd/signals.h>
 
@@ -36,11 +41,14 @@ class Speakers;
 class VBAPSpeakers : public boost::noncopyable
 {
 public:
-	VBAPSpeakers (boost::shared_ptr<Speakers>);
+	/** @return the VBAPSpeakers for the given speaker layout. Panners
+	 * of the same layout share a single instance (and its tuple cache).
+	 */
+	static boost::shared_ptr<VBAPSpeakers> get (boost::shared_ptr<Speakers>);
 
 	typedef std::vector<double> dvector;
 
-	const dvector matrix (int tuple) const
+	const dvector& matrix (int tuple) const
 	{
 		return _matrices[tuple];
 	}
@@ -60,6 +68,11 @@ public:
 		return _dimension;
 	}
 
+	/** @return the speaker tuple to use for the given direction in degrees,
+	 * or -1 if there is none. Lookups are cached on a 1 degree grid.
+	 */
+	int tuple_for_direction (int azi, int ele) const;
+
 	uint32_t n_speakers () const
 	{
 		return _speakers.size ();
@@ -73,6 +86,12 @@ public:
 	~VBAPSpeakers ();
 
 private:
+	VBAPSpeakers (boost::shared_ptr<Speakers>);
+
+	typedef std::map<Speakers const*, boost::weak_ptr<VBAPSpeakers> > Instances;
+	static Instances             _instances;
+	static Glib::Threads::Mutex  _instance_lock;
+
 	static const double         MIN_VOL_P_SIDE_LGTH;
 	int                         _dimension;
 	boost::shared_ptr<Speakers> _parent;
@@ -101,6 +120,11 @@ private:
 	std::vector<dvector> _matrices;       /* holds matrices for a given speaker combinations */
 	std::vector<tmatrix> _speaker_tuples; /* holds speakers IDs for a given combination */
 
+	/* tuple index for azimuth 0..359 and elevation -90..90, -2: not yet known.
+	 * Filled lazily (and atomically) by all panners using this layout.
+	 */
+	mutable std::vector<gint> _tuple_grid;
+
 	/* A struct for all loudspeakers */
 	struct ls_triplet_chain {
 		int                      ls_nos[3];
@@ -115,6 +139,7 @@ private:
 	static void   cross_prod (PBD::CartesianVector v1, PBD::CartesianVector v2, PBD::CartesianVector* res);
 
 	void update ();
+	int  find_tuple (int azi, int ele) const;
 	int  any_ls_inside_triplet (int a, int b, int c);
 	void add_ldsp_triplet (int i, int j, int k, struct ls_triplet_chain** ls_triplets);
 	int  lines_intersect (int i, int j, int k, int l);
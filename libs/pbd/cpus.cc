@@ -21,6 +21,8 @@
 #include "libpbd-config.h"
 #endif
 
+#include <algorithm>
+#include <cstdio>
 #include <stdlib.h>
 
 #ifdef __linux__
@@ -73,3 +75,133 @@ hardware_concurrency()
 	return 0;
 #endif
 }
+
+static bool
+parse_int (std::string const& str, int& val)
+{
+	char* end;
+	long  v = strtol (str.c_str (), &end, 10);
+	if (str.empty () || *end != '\0' || v < 0 || v > 65535) {
+		return false;
+	}
+	val = v;
+	return true;
+}
+
+std::vector<int>
+PBD::parse_cpu_list (std::string const& str)
+{
+	std::vector<int> rv;
+	std::string::size_type pos = 0;
+
+	while (pos < str.size ()) {
+		std::string::size_type end = str.find (',', pos);
+		if (end == std::string::npos) {
+			end = str.size ();
+		}
+		std::string range = str.substr (pos, end - pos);
+		pos = end + 1;
+
+		/* trim whitespace, including a trailing newline from sysfs */
+		range.erase (0, range.find_first_not_of (" \t\n"));
+		range.erase (range.find_last_not_of (" \t\n") + 1);
+		if (range.empty ()) {
+			continue;
+		}
+
+		int first, last;
+		std::string::size_type dash = range.find ('-');
+		if (dash == std::string::npos) {
+			if (!parse_int (range, first)) {
+				return std::vector<int> ();
+			}
+			last = first;
+		} else if (!parse_int (range.substr (0, dash), first) || !parse_int (range.substr (dash + 1), last)) {
+			return std::vector<int> ();
+		}
+
+		if (last < first) {
+			return std::vector<int> ();
+		}
+		for (int c = first; c <= last; ++c) {
+			rv.push_back (c);
+		}
+	}
+
+	std::sort (rv.begin (), rv.end ());
+	rv.erase (std::unique (rv.begin (), rv.end ()), rv.end ());
+	return rv;
+}
+
+#ifdef __linux__
+static bool
+read_sysfs (std::string const& path, std::string& rv)
+{
+	FILE* f = fopen (path.c_str (), "r");
+	if (!f) {
+		return false;
+	}
+	char buf[1024];
+	bool ok = fgets (buf, sizeof (buf), f) != 0;
+	fclose (f);
+	if (ok) {
+		rv = buf;
+	}
+	return ok;
+}
+
+static int
+read_sysfs_int (std::string const& path, int dflt)
+{
+	std::string s;
+	int         v;
+	if (!read_sysfs (path, s) || !parse_int (s.substr (0, s.find_first_of ("\n")), v)) {
+		return dflt;
+	}
+	return v;
+}
+#endif
+
+std::vector<PBD::CPUInfo>
+PBD::cpu_topology ()
+{
+	std::vector<CPUInfo> rv;
+
+#ifdef __linux__
+	std::string online;
+	if (read_sysfs ("/sys/devices/system/cpu/online", online)) {
+		std::vector<int> cpus = parse_cpu_list (online);
+		for (std::vector<int>::const_iterator i = cpus.begin (); i != cpus.end (); ++i) {
+			CPUInfo ci (*i);
+			char topo[128];
+			snprintf (topo, sizeof (topo), "/sys/devices/system/cpu/cpu%d/topology/", *i);
+			ci.core    = read_sysfs_int (std::string (topo) + "core_id", *i);
+			ci.package = read_sysfs_int (std::string (topo) + "physical_package_id", 0);
+			rv.push_back (ci);
+		}
+
+		for (int n = 0; n < 256; ++n) {
+			char        path[128];
+			std::string cpulist;
+			snprintf (path, sizeof (path), "/sys/devices/system/node/node%d/cpulist", n);
+			if (!read_sysfs (path, cpulist)) {
+				continue;
+			}
+			std::vector<int> cpus = parse_cpu_list (cpulist);
+			for (std::vector<CPUInfo>::iterator i = rv.begin (); i != rv.end (); ++i) {
+				if (std::binary_search (cpus.begin (), cpus.end (), i->id)) {
+					i->node = n;
+				}
+			}
+		}
+	}
+#endif
+
+	if (rv.empty ()) {
+		uint32_t n = hardware_concurrency ();
+		for (uint32_t i = 0; i < n; ++i) {
+			rv.push_back (CPUInfo (i));
+		}
+	}
+	return rv;
+}
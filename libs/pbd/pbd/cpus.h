@@ -20,9 +20,34 @@
 #define __libpbd_cpus_h__
 
 #include <stdint.h>
+#include <string>
+#include <vector>
 
 #include "pbd/libpbd_visibility.h"
 
 LIBPBD_API extern uint32_t hardware_concurrency ();
 
+namespace PBD {
+
+struct LIBPBD_API CPUInfo {
+	CPUInfo (int i) : id (i), core (i), package (0), node (0) {}
+	int id;      ///< logical CPU number
+	int core;    ///< physical core, shared by SMT siblings of the same package
+	int package; ///< physical package (socket)
+	int node;    ///< NUMA node
+};
+
+/** @return online CPUs and their topology. Where the topology cannot
+ * be determined (currently everywhere but Linux), every CPU is reported
+ * as separate core on a single node.
+ */
+LIBPBD_API extern std::vector<CPUInfo> cpu_topology ();
+
+/** Parse a CPU list as used by Linux' sysfs and taskset, e.g. "0-3,8,10-11".
+ * @return sorted list of CPU numbers, empty if the list is invalid
+ */
+LIBPBD_API extern std::vector<int> parse_cpu_list (std::string const&);
+
+}
+
 #endif /* __libpbd_cpus_h__ */
@@ -43,6 +43,7 @@
 #endif
 #include <signal.h>
 #include <string>
+#include <vector>
 #include <stdint.h>
 
 #include "pbd/libpbd_visibility.h"
@@ -85,6 +86,11 @@ LIBPBD_API int pbd_realtime_pthread_create (
 
 LIBPBD_API int  pbd_absolute_rt_priority (int policy, int priority);
 LIBPBD_API int  pbd_set_thread_priority (pthread_t, const int policy, int priority);
+
+/** Restrict the given thread to the given set of CPUs.
+ * @return 0 on success, an error number otherwise (ENOSYS if not supported)
+ */
+LIBPBD_API int  pbd_set_thread_affinity (pthread_t, std::vector<int> const& cpus);
 LIBPBD_API bool pbd_mach_set_realtime_policy (pthread_t thread_id, double period_ns);
 
 namespace PBD {
@@ -18,6 +18,7 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <cerrno>
 #include <cstring>
 #include <set>
 #include <stdint.h>
@@ -338,6 +339,26 @@ pbd_set_thread_priority (pthread_t thread, const int policy, int priority)
 	return pthread_setschedparam (thread, SCHED_FIFO, &param);
 }
 
+int
+pbd_set_thread_affinity (pthread_t thread, std::vector<int> const& cpus)
+{
+#if defined __linux__ && !defined PLATFORM_WINDOWS
+	cpu_set_t set;
+	CPU_ZERO (&set);
+	for (std::vector<int>::const_iterator i = cpus.begin (); i != cpus.end (); ++i) {
+		if (*i >= 0 && *i < CPU_SETSIZE) {
+			CPU_SET (*i, &set);
+		}
+	}
+	if (CPU_COUNT (&set) == 0) {
+		return EINVAL;
+	}
+	return pthread_setaffinity_np (thread, sizeof (set), &set);
+#else
+	return ENOSYS;
+#endif
+}
+
 bool
 pbd_mach_set_realtime_policy (pthread_t thread_id, double period_ns)
 {
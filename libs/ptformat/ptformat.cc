@@ -362,7 +362,6 @@ int
 PTFFormat::unxor(std::string const& path) {
 	FILE *fp;
 	unsigned char xxor[256];
-	unsigned char ct;
 	uint64_t i;
 	uint8_t xor_type;
 	uint8_t xor_value;
@@ -419,14 +418,23 @@ PTFFormat::unxor(std::string const& path) {
 
 	/* hexdump(xxor, xor_len); */
 
-	/* Read file and decrypt rest of file */
-	i = 0x14;
-	fseek(fp, i, SEEK_SET);
-	while (fread(&ct, 1, 1, fp) != 0) {
-		uint8_t xor_index = (xor_type == 0x01) ? i & 0xff : (i >> 12) & 0xff;
-		_ptfunxored[i++] = ct ^ xxor[xor_index];
+	/* Read rest of file at once, and decrypt it in place */
+	fseek(fp, 0x14, SEEK_SET);
+	if (fread(&_ptfunxored[0x14], 1, _len - 0x14, fp) != _len - 0x14) {
+		fclose(fp);
+		return -1;
 	}
 	fclose(fp);
+
+	if (xor_type == 0x01) {
+		for (i = 0x14; i < _len; i++) {
+			_ptfunxored[i] ^= xxor[i & 0xff];
+		}
+	} else {
+		for (i = 0x14; i < _len; i++) {
+			_ptfunxored[i] ^= xxor[(i >> 12) & 0xff];
+		}
+	}
 	return 0;
 }
 
@@ -549,13 +557,17 @@ PTFFormat::parse_block_at(uint32_t pos, struct block_t *block, struct block_t *p
 	block->offset = b.offset;
 	block->child.clear();
 
+	/* Children are parsed in place, rather than copying
+	 * the complete sub-tree of each child into its parent.
+	 */
 	for (i = 1; (i < block->block_size) && (pos + i + childjump < max); i += childjump ? childjump : 1) {
 		int p = pos + i;
-		struct block_t bchild;
 		childjump = 0;
-		if (parse_block_at(p, &bchild, block, level+1)) {
-			block->child.push_back(bchild);
-			childjump = bchild.block_size + 7;
+		block->child.push_back(block_t());
+		if (parse_block_at(p, &block->child.back(), block, level+1)) {
+			childjump = block->child.back().block_size + 7;
+		} else {
+			block->child.pop_back();
 		}
 	}
 	return true;
@@ -613,11 +625,14 @@ PTFFormat::parseblocks(void) {
 	uint32_t i = 20;
 
 	while (i < _len) {
-		struct block_t b;
+		blocks.push_back(block_t());
+		block_t& b = blocks.back();
 		if (parse_block_at(i, &b, NULL, 0)) {
-			blocks.push_back(b);
+			i += b.block_size ? b.block_size + 7 : 1;
+		} else {
+			blocks.pop_back();
+			i++;
 		}
-		i += b.block_size ? b.block_size + 7 : 1;
 	}
 }
 
@@ -860,6 +875,11 @@ PTFFormat::parse_region_info(uint32_t j, block_t& blk, region_t& r) {
 	r.midi = m;
 }
 
+static bool
+track_without_region(PTFFormat::track_t const& t) {
+	return t.reg.index == 65535;
+}
+
 bool
 PTFFormat::parserest(void) {
 	uint32_t i, j, count;
@@ -1049,14 +1069,7 @@ PTFFormat::parserest(void) {
 			}
 		}
 	}
-	for (std::vector<track_t>::iterator tr = _tracks.begin();
-			tr != _tracks.end(); /* noop */) {
-		if ((*tr).reg.index == 65535) {
-			tr = _tracks.erase(tr);
-		} else {
-			tr++;
-		}
-	}
+	_tracks.erase(std::remove_if(_tracks.begin(), _tracks.end(), track_without_region), _tracks.end());
 	return found;
 }
 
@@ -1274,13 +1287,6 @@ PTFFormat::parsemidi(void) {
 			}
 		}
 	}
-	for (std::vector<track_t>::iterator tr = _miditracks.begin();
-			tr != _miditracks.end(); /* noop */) {
-		if ((*tr).reg.index == 65535) {
-			tr = _miditracks.erase(tr);
-		} else {
-			tr++;
-		}
-	}
+	_miditracks.erase(std::remove_if(_miditracks.begin(), _miditracks.end(), track_without_region), _miditracks.end());
 	return true;
 }
@@ -126,6 +126,12 @@ public:
 	}
 
 	bool find_region(uint16_t index, region_t& rr) const {
+		/* regions are usually numbered in order */
+		if (index < _regions.size() && _regions[index].index == index) {
+			rr = _regions[index];
+			return true;
+		}
+
 		std::vector<region_t>::const_iterator begin = _regions.begin();
 		std::vector<region_t>::const_iterator finish = _regions.end();
 		std::vector<region_t>::const_iterator found;
@@ -155,6 +161,11 @@ public:
 	}
 
 	bool find_midiregion(uint16_t index, region_t& rr) const {
+		if (index < _midiregions.size() && _midiregions[index].index == index) {
+			rr = _midiregions[index];
+			return true;
+		}
+
 		std::vector<region_t>::const_iterator begin = _midiregions.begin();
 		std::vector<region_t>::const_iterator finish = _midiregions.end();
 		std::vector<region_t>::const_iterator found;
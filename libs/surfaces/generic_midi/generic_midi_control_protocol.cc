@@ -45,6 +45,7 @@
 #include "pbd/types_convert.h"
 #include "pbd/xml++.h"
 
+#include "midi++/parser.h"
 #include "midi++/port.h"
 
 #include "ardour/async_midi_port.h"
@@ -79,6 +80,8 @@ GenericMidiControlProtocol::GenericMidiControlProtocol (Session& s)
 	, _motorised (false)
 	, _threshold (10)
 	, gui (0)
+	, _dispatch (new MIDIDispatchTable)
+	, _dispatch_stats_reset (0)
 {
 	boost::shared_ptr<ARDOUR::Port> inp;
 	boost::shared_ptr<ARDOUR::Port> outp;
@@ -110,6 +113,11 @@ GenericMidiControlProtocol::GenericMidiControlProtocol (Session& s)
 
 	session->BundleAddedOrRemoved ();
 
+	/* route incoming channel messages to bindings, this is
+	 * emitted by the parser in our event loop thread.
+	 */
+	_input_port->parser()->any.connect_same_thread (dispatch_connection, boost::bind (&GenericMidiControlProtocol::midi_dispatch, this, _1, _2, _3, _4));
+
 	do_feedback = false;
 	_feedback_interval = 10000; // microseconds
 	last_feedback_time = 0;
@@ -146,6 +154,8 @@ GenericMidiControlProtocol::GenericMidiControlProtocol (Session& s)
 
 GenericMidiControlProtocol::~GenericMidiControlProtocol ()
 {
+	dispatch_connection.disconnect ();
+
 	if (_input_port) {
 		DEBUG_TRACE (DEBUG::GenericMidi, string_compose ("unregistering input port %1\n", boost::shared_ptr<ARDOUR::Port>(_input_port)->name()));
 		Glib::Threads::Mutex::Lock em (AudioEngine::instance()->process_lock());
@@ -162,6 +172,7 @@ GenericMidiControlProtocol::~GenericMidiControlProtocol ()
 	}
 
 	drop_all ();
+	free_retired ();
 	tear_down_gui ();
 }
 
@@ -255,29 +266,34 @@ GenericMidiControlProtocol::drop_all ()
 	Glib::Threads::Mutex::Lock lm (pending_lock);
 	Glib::Threads::Mutex::Lock lm2 (controllables_lock);
 
+	begin_dispatch_batch ();
+
 	for (MIDIControllables::iterator i = controllables.begin(); i != controllables.end(); ++i) {
-		delete *i;
+		retire (*i);
 	}
 	controllables.clear ();
 
 	for (MIDIPendingControllables::iterator i = pending_controllables.begin(); i != pending_controllables.end(); ++i) {
 		(*i)->connection.disconnect();
 		if ((*i)->own_mc) {
-			delete (*i)->mc;
+			retire ((*i)->mc);
 		}
 		delete *i;
 	}
 	pending_controllables.clear ();
 
 	for (MIDIFunctions::iterator i = functions.begin(); i != functions.end(); ++i) {
-		delete *i;
+		retire (*i);
 	}
 	functions.clear ();
 
 	for (MIDIActions::iterator i = actions.begin(); i != actions.end(); ++i) {
-		delete *i;
+		retire (*i);
 	}
 	actions.clear ();
+
+	end_dispatch_batch ();
+	_dispatch.flush ();
 }
 
 void
@@ -286,9 +302,11 @@ GenericMidiControlProtocol::drop_bindings ()
 	DEBUG_TRACE (DEBUG::GenericMidi, "Drop bindings, leave learned\n");
 	Glib::Threads::Mutex::Lock lm2 (controllables_lock);
 
+	begin_dispatch_batch ();
+
 	for (MIDIControllables::iterator i = controllables.begin(); i != controllables.end(); ) {
 		if (!(*i)->learned()) {
-			delete *i;
+			retire (*i);
 			i = controllables.erase (i);
 		} else {
 			++i;
@@ -296,10 +314,12 @@ GenericMidiControlProtocol::drop_bindings ()
 	}
 
 	for (MIDIFunctions::iterator i = functions.begin(); i != functions.end(); ++i) {
-		delete *i;
+		retire (*i);
 	}
 	functions.clear ();
 
+	end_dispatch_batch ();
+
 	_current_binding = "";
 	_bank_size = 0;
 	_current_bank = 0;
@@ -437,7 +457,7 @@ GenericMidiControlProtocol::start_learning (boost::weak_ptr <Controllable> wc)
 		tmp = i;
 		++tmp;
 		if ((*i)->get_controllable() == c) {
-			delete (*i);
+			retire (*i);
 			controllables.erase (i);
 		}
 		i = tmp;
@@ -454,7 +474,7 @@ GenericMidiControlProtocol::start_learning (boost::weak_ptr <Controllable> wc)
 			if (((*i)->mc)->get_controllable() == c) {
 				(*i)->connection.disconnect();
 				if ((*i)->own_mc) {
-					delete (*i)->mc;
+					retire ((*i)->mc);
 				}
 				delete *i;
 				i = pending_controllables.erase (i);
@@ -544,7 +564,7 @@ GenericMidiControlProtocol::stop_learning (boost::weak_ptr<PBD::Controllable> wc
 		}
 	}
 
-	delete dptr;
+	retire (dptr);
 }
 
 void
@@ -563,7 +583,7 @@ GenericMidiControlProtocol::check_used_event (int pos, int control_number)
 		if ( (existingBinding->get_control_type() & 0xf0 ) == (pos & 0xf0) && (existingBinding->get_control_channel() & 0xf ) == channel ) {
 			if ( ((int) existingBinding->get_control_additional() == (int) value) || ((pos & 0xf0) == MIDI::pitchbend)) {
 				DEBUG_TRACE (DEBUG::GenericMidi, "checking: found match, delete old binding.\n");
-				delete existingBinding;
+				retire (existingBinding);
 				iter = controllables.erase (iter);
 			} else {
 				++iter;
@@ -578,7 +598,7 @@ GenericMidiControlProtocol::check_used_event (int pos, int control_number)
 		if ( (existingBinding->get_control_type() & 0xf0 ) == (pos & 0xf0) && (existingBinding->get_control_channel() & 0xf ) == channel ) {
 			if ( ((int) existingBinding->get_control_additional() == (int) value) || ((pos & 0xf0) == MIDI::pitchbend)) {
 				DEBUG_TRACE (DEBUG::GenericMidi, "checking: found match, delete old binding.\n");
-				delete existingBinding;
+				retire (existingBinding);
 				iter = functions.erase (iter);
 			} else {
 				++iter;
@@ -593,7 +613,7 @@ GenericMidiControlProtocol::check_used_event (int pos, int control_number)
 		if ( (existingBinding->get_control_type() & 0xf0 ) == (pos & 0xf0) && (existingBinding->get_control_channel() & 0xf ) == channel ) {
 			if ( ((int) existingBinding->get_control_additional() == (int) value) || ((pos & 0xf0) == MIDI::pitchbend)) {
 				DEBUG_TRACE (DEBUG::GenericMidi, "checking: found match, delete old binding.\n");
-				delete existingBinding;
+				retire (existingBinding);
 				iter = actions.erase (iter);
 			} else {
 				++iter;
@@ -693,7 +713,7 @@ GenericMidiControlProtocol::set_state (const XMLNode& node, int version)
 		for (MIDIPendingControllables::iterator i = pending_controllables.begin(); i != pending_controllables.end(); ++i) {
 			(*i)->connection.disconnect();
 			if ((*i)->own_mc) {
-				delete (*i)->mc;
+				retire ((*i)->mc);
 			}
 			delete *i;
 		}
@@ -744,7 +764,7 @@ GenericMidiControlProtocol::set_state (const XMLNode& node, int version)
 								controllables.push_back (mc);
 							} else {
 								warning << string_compose ("Generic MIDI control: Failed to set state for Control ID: %1\n", id.to_s());
-								delete mc;
+								retire (mc);
 							}
 
 						} else {
@@ -807,6 +827,8 @@ GenericMidiControlProtocol::load_bindings (const string& xmlpath)
 
 	drop_all ();
 
+	begin_dispatch_batch ();
+
 	DEBUG_TRACE (DEBUG::GenericMidi, "Loading bindings\n");
 	for (citer = children.begin(); citer != children.end(); ++citer) {
 
@@ -861,6 +883,8 @@ GenericMidiControlProtocol::load_bindings (const string& xmlpath)
 
 	reset_controllables ();
 
+	end_dispatch_batch ();
+
 	return 0;
 }
 
@@ -1615,6 +1639,310 @@ GenericMidiControlProtocol::maybe_start_touch (boost::shared_ptr<Controllable> c
 }
 
 
+void
+GenericMidiControlProtocol::add_binding (MIDIDispatchTable& table, uint32_t key, MIDIBinding const& b)
+{
+	MIDIBindings& bindings (table[key]);
+	if (std::find (bindings.begin (), bindings.end (), b) == bindings.end ()) {
+		bindings.push_back (b);
+	}
+}
+
+void
+GenericMidiControlProtocol::remove_binding (MIDIDispatchTable& table, uint32_t key, MIDIBinding const& b)
+{
+	MIDIDispatchTable::iterator i = table.find (key);
+	if (i == table.end ()) {
+		return;
+	}
+	i->second.erase (std::remove (i->second.begin (), i->second.end (), b), i->second.end ());
+	if (i->second.empty ()) {
+		table.erase (i);
+	}
+}
+
+void
+GenericMidiControlProtocol::add_dispatch (uint32_t key, MIDIBinding const& b)
+{
+	Glib::Threads::Mutex::Lock lm (_dispatch_batch_lock);
+	if (_dispatch_batch) {
+		add_binding (*_dispatch_batch, key, b);
+		return;
+	}
+
+	RCUWriter<MIDIDispatchTable> writer (_dispatch);
+	boost::shared_ptr<MIDIDispatchTable> table = writer.get_copy ();
+	add_binding (*table, key, b);
+}
+
+void
+GenericMidiControlProtocol::remove_dispatch (uint32_t key, MIDIBinding const& b)
+{
+	Glib::Threads::Mutex::Lock lm (_dispatch_batch_lock);
+	if (_dispatch_batch) {
+		remove_binding (*_dispatch_batch, key, b);
+		return;
+	}
+
+	{
+		/* common case: nothing to remove, skip copying the table */
+		boost::shared_ptr<MIDIDispatchTable const> table = _dispatch.reader ();
+		MIDIDispatchTable::const_iterator i = table->find (key);
+		if (i == table->end () || std::find (i->second.begin (), i->second.end (), b) == i->second.end ()) {
+			return;
+		}
+	}
+
+	RCUWriter<MIDIDispatchTable> writer (_dispatch);
+	boost::shared_ptr<MIDIDispatchTable> table = writer.get_copy ();
+	remove_binding (*table, key, b);
+}
+
+void
+GenericMidiControlProtocol::begin_dispatch_batch ()
+{
+	Glib::Threads::Mutex::Lock lm (_dispatch_batch_lock);
+	_dispatch_batch.reset (new MIDIDispatchTable (*_dispatch.reader ()));
+}
+
+void
+GenericMidiControlProtocol::end_dispatch_batch ()
+{
+	Glib::Threads::Mutex::Lock lm (_dispatch_batch_lock);
+	{
+		RCUWriter<MIDIDispatchTable> writer (_dispatch);
+		writer.get_copy ()->swap (*_dispatch_batch);
+	}
+	_dispatch_batch.reset ();
+
+	/* objects dropped during the batch are only unreachable now */
+	_retired.insert (_retired.end (), _batch_retired.begin (), _batch_retired.end ());
+	_batch_retired.clear ();
+}
+
+void
+GenericMidiControlProtocol::retire (MIDIControllable* mc)
+{
+	if (!mc) {
+		return;
+	}
+	mc->midi_forget ();
+	retire (MIDIBinding (mc));
+}
+
+void
+GenericMidiControlProtocol::retire (MIDIInvokable* mi)
+{
+	if (!mi) {
+		return;
+	}
+	mi->midi_forget ();
+	retire (MIDIBinding (mi));
+}
+
+void
+GenericMidiControlProtocol::retire (MIDIBinding const& b)
+{
+	Glib::Threads::Mutex::Lock lm (_dispatch_batch_lock);
+	if (_dispatch_batch) {
+		_batch_retired.push_back (b);
+	} else {
+		_retired.push_back (b);
+	}
+}
+
+void
+GenericMidiControlProtocol::free_retired ()
+{
+	MIDIBindings r;
+	{
+		Glib::Threads::Mutex::Lock lm (_dispatch_batch_lock);
+		if (_retired.empty ()) {
+			return;
+		}
+		r.swap (_retired);
+	}
+	/* the destructors unbind again, which takes _dispatch_batch_lock */
+	for (MIDIBindings::const_iterator i = r.begin (); i != r.end (); ++i) {
+		delete i->mc;
+		delete i->mi;
+	}
+}
+
+void
+GenericMidiControlProtocol::bind_dispatch (MIDIControllable* mc, MIDI::channel_t chn, MIDI::eventType ev, MIDI::byte additional, bool momentary)
+{
+	switch (ev) {
+	case MIDI::off:
+	case MIDI::on:
+		add_dispatch (dispatch_key (chn, ev, additional), MIDIBinding (mc));
+		/* momentary notes toggle between on and off */
+		if (momentary) {
+			add_dispatch (dispatch_key (chn, ev == MIDI::on ? MIDI::off : MIDI::on, additional), MIDIBinding (mc));
+		}
+		break;
+	case MIDI::controller:
+	case MIDI::program:
+		add_dispatch (dispatch_key (chn, ev, additional), MIDIBinding (mc));
+		break;
+	case MIDI::pitchbend:
+		add_dispatch (dispatch_key (chn, ev, 0), MIDIBinding (mc));
+		break;
+	default:
+		break;
+	}
+}
+
+void
+GenericMidiControlProtocol::bind_dispatch (MIDIInvokable* mi, MIDI::channel_t chn, MIDI::eventType ev, MIDI::byte additional)
+{
+	switch (ev) {
+	case MIDI::off:
+	case MIDI::on:
+	case MIDI::controller:
+	case MIDI::program:
+		add_dispatch (dispatch_key (chn, ev, additional), MIDIBinding (mi));
+		break;
+	default:
+		break;
+	}
+}
+
+void
+GenericMidiControlProtocol::unbind_dispatch (MIDIControllable* mc, MIDI::channel_t chn, MIDI::eventType ev, MIDI::byte additional)
+{
+	switch (ev) {
+	case MIDI::off:
+	case MIDI::on:
+		remove_dispatch (dispatch_key (chn, MIDI::on, additional), MIDIBinding (mc));
+		remove_dispatch (dispatch_key (chn, MIDI::off, additional), MIDIBinding (mc));
+		break;
+	case MIDI::controller:
+	case MIDI::program:
+		remove_dispatch (dispatch_key (chn, ev, additional), MIDIBinding (mc));
+		break;
+	case MIDI::pitchbend:
+		remove_dispatch (dispatch_key (chn, ev, 0), MIDIBinding (mc));
+		break;
+	default:
+		break;
+	}
+}
+
+void
+GenericMidiControlProtocol::unbind_dispatch (MIDIInvokable* mi, MIDI::channel_t chn, MIDI::eventType ev, MIDI::byte additional)
+{
+	remove_dispatch (dispatch_key (chn, ev, additional), MIDIBinding (mi));
+}
+
+void
+GenericMidiControlProtocol::midi_dispatch (MIDI::Parser& p, MIDI::byte* msg, size_t len, samplecnt_t)
+{
+	if (len < 2) {
+		return;
+	}
+
+	MIDI::eventType ev    = MIDI::eventType (msg[0] & 0xf0);
+	MIDI::channel_t chn   = msg[0] & 0x0f;
+	MIDI::byte      number = msg[1];
+
+	switch (ev) {
+	case MIDI::on:
+		if (len < 3) {
+			return;
+		}
+		/* same as MIDI::Parser::signal(): velocity 0 is a note-off */
+		if (msg[2] == 0) {
+			ev = MIDI::off;
+		}
+		break;
+	case MIDI::off:
+	case MIDI::controller:
+		if (len < 3) {
+			return;
+		}
+		break;
+	case MIDI::program:
+		break;
+	case MIDI::pitchbend:
+		if (len < 3) {
+			return;
+		}
+		number = 0;
+		break;
+	default:
+		return;
+	}
+
+	if (g_atomic_int_compare_and_exchange (&_dispatch_stats_reset, 1, 0)) {
+		_dispatch_stats.reset ();
+	}
+
+	_dispatch_stats.start ();
+
+	boost::shared_ptr<MIDIDispatchTable const> table = _dispatch.reader ();
+	MIDIDispatchTable::const_iterator i = table->find (dispatch_key (chn, ev, number));
+
+	if (i != table->end ()) {
+		MIDI::EventTwoBytes* tb = (MIDI::EventTwoBytes*) &msg[1];
+
+		for (MIDIBindings::const_iterator b = i->second.begin (); b != i->second.end (); ++b) {
+			if (b->mc) {
+				switch (ev) {
+				case MIDI::on:
+					b->mc->midi_sense_note_on (p, tb);
+					break;
+				case MIDI::off:
+					b->mc->midi_sense_note_off (p, tb);
+					break;
+				case MIDI::controller:
+					b->mc->midi_sense_controller (p, tb);
+					break;
+				case MIDI::program:
+					b->mc->midi_sense_program_change (p, msg[1]);
+					break;
+				case MIDI::pitchbend:
+					b->mc->midi_sense_pitchbend (p, (msg[2] << 7) | msg[1]);
+					break;
+				default:
+					break;
+				}
+			} else if (b->mi) {
+				switch (ev) {
+				case MIDI::on:
+					b->mi->midi_sense_note_on (p, tb);
+					break;
+				case MIDI::off:
+					b->mi->midi_sense_note_off (p, tb);
+					break;
+				case MIDI::controller:
+					b->mi->midi_sense_controller (p, tb);
+					break;
+				case MIDI::program:
+					b->mi->midi_sense_program_change (p, msg[1]);
+					break;
+				default:
+					break;
+				}
+			}
+		}
+	}
+
+	_dispatch_stats.update ();
+}
+
+bool
+GenericMidiControlProtocol::get_dispatch_stats (uint64_t& min, uint64_t& max, double& avg, double& dev) const
+{
+	return _dispatch_stats.get_stats (min, max, avg, dev);
+}
+
+void
+GenericMidiControlProtocol::clear_dispatch_stats ()
+{
+	g_atomic_int_set (&_dispatch_stats_reset, 1);
+}
+
 void
 GenericMidiControlProtocol::start_midi_handling ()
 {
@@ -1654,6 +1982,11 @@ GenericMidiControlProtocol::midi_input_handler (Glib::IOCondition ioc, boost::we
 
 	if (ioc & IO_IN) {
 
+		/* no parser signal is being handled now, so bindings that were
+		 * removed from the dispatch table can no longer be in use.
+		 */
+		free_retired ();
+
 		port->clear ();
 		DEBUG_TRACE (DEBUG::GenericMidi, string_compose ("data available on %1\n", boost::shared_ptr<MIDI::Port>(port)->name()));
 		samplepos_t now = session->engine().sample_time();
@@ -23,10 +23,16 @@
 #define ardour_generic_midi_control_protocol_h
 
 #include <list>
+#include <vector>
 #include <glibmm/threads.h>
+#include <boost/unordered_map.hpp>
 
 #define ABSTRACT_UI_EXPORTS
 #include "pbd/abstract_ui.h"
+#include "pbd/rcu.h"
+#include "pbd/timing.h"
+
+#include "midi++/types.h"
 
 #include "ardour/types.h"
 #include "ardour/port.h"
@@ -44,12 +50,14 @@ namespace ARDOUR {
 }
 
 namespace MIDI {
+	class Parser;
 	class Port;
 }
 
 class MIDIControllable;
 class MIDIFunction;
 class MIDIAction;
+class MIDIInvokable;
 
 struct GenericMIDIRequest : public BaseUI::BaseRequestObject {
 public:
@@ -127,6 +135,18 @@ public:
 
 	PBD::Signal0<void> ConnectionChange;
 
+	/* Incoming channel messages are routed directly to the bindings
+	 * that use them, looked up by (channel, message type, number).
+	 */
+	void bind_dispatch (MIDIControllable*, MIDI::channel_t, MIDI::eventType, MIDI::byte, bool momentary);
+	void bind_dispatch (MIDIInvokable*, MIDI::channel_t, MIDI::eventType, MIDI::byte);
+	void unbind_dispatch (MIDIControllable*, MIDI::channel_t, MIDI::eventType, MIDI::byte);
+	void unbind_dispatch (MIDIInvokable*, MIDI::channel_t, MIDI::eventType, MIDI::byte);
+
+	/** time spent routing an incoming message to its binding(s), in microseconds */
+	bool get_dispatch_stats (uint64_t& min, uint64_t& max, double& avg, double& dev) const;
+	void clear_dispatch_stats ();
+
 private:
 	boost::shared_ptr<ARDOUR::Bundle> _input_bundle;
 	boost::shared_ptr<ARDOUR::Bundle> _output_bundle;
@@ -149,6 +169,56 @@ private:
 	typedef std::list<MIDIAction*> MIDIActions;
 	MIDIActions actions;
 
+	struct MIDIBinding {
+		MIDIBinding (MIDIControllable* c) : mc (c), mi (0) {}
+		MIDIBinding (MIDIInvokable* i) : mc (0), mi (i) {}
+
+		bool operator== (MIDIBinding const& other) const {
+			return mc == other.mc && mi == other.mi;
+		}
+
+		MIDIControllable* mc;
+		MIDIInvokable*    mi;
+	};
+
+	typedef std::vector<MIDIBinding> MIDIBindings;
+	typedef boost::unordered_map<uint32_t, MIDIBindings> MIDIDispatchTable;
+
+	static uint32_t dispatch_key (MIDI::channel_t chn, MIDI::eventType ev, MIDI::byte number) {
+		return ((uint32_t) ev << 16) | ((uint32_t) (chn & 0xf) << 8) | number;
+	}
+
+	void add_dispatch (uint32_t key, MIDIBinding const&);
+	void remove_dispatch (uint32_t key, MIDIBinding const&);
+	static void add_binding (MIDIDispatchTable&, uint32_t key, MIDIBinding const&);
+	static void remove_binding (MIDIDispatchTable&, uint32_t key, MIDIBinding const&);
+	void midi_dispatch (MIDI::Parser&, MIDI::byte*, size_t, ARDOUR::samplecnt_t);
+
+	/* while loading a map, bindings are added to a private copy of
+	 * the table, which is published once all of them are bound */
+	void begin_dispatch_batch ();
+	void end_dispatch_batch ();
+
+	/* midi_dispatch() may still be using a binding after it was removed
+	 * from the table. Instead of deleting it, it is unbound and retired;
+	 * retired bindings are deleted by the event loop thread before it
+	 * parses the next input. Objects retired during a batch are only
+	 * retired once the batch is published.
+	 */
+	void retire (MIDIControllable*);
+	void retire (MIDIInvokable*);
+	void retire (MIDIBinding const&);
+	void free_retired ();
+
+	SerializedRCUManager<MIDIDispatchTable> _dispatch;
+	boost::shared_ptr<MIDIDispatchTable>    _dispatch_batch;
+	Glib::Threads::Mutex                    _dispatch_batch_lock; ///< also protects _retired, _batch_retired
+	MIDIBindings                            _retired;
+	MIDIBindings                            _batch_retired;
+	PBD::ScopedConnection dispatch_connection;
+	PBD::TimingStats      _dispatch_stats;
+	volatile gint         _dispatch_stats_reset;
+
 	struct MIDIPendingControllable {
 		MIDIControllable* mc;
 		bool own_mc;
@@ -18,12 +18,16 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <cmath>
 #include <iostream>
 #include <list>
 #include <string>
 #include <vector>
 #include <algorithm>
 
+#include <glibmm/main.h>
+
+#include <gtkmm/button.h>
 #include <gtkmm/comboboxtext.h>
 #include <gtkmm/label.h>
 #include <gtkmm/box.h>
@@ -65,11 +69,17 @@ private:
 	Gtk::ComboBox input_combo;
 	Gtk::ComboBox output_combo;
 
+	Gtk::Label  dispatch_label;
+	Gtk::Button dispatch_reset_button;
+	sigc::connection dispatch_stats_connection;
+
 	void binding_changed ();
 	void bank_changed ();
 	void motorised_changed ();
 	void threshold_changed ();
 	void toggle_feedback_enable ();
+	bool update_dispatch_stats ();
+	void reset_dispatch_stats ();
 
 	void update_port_combos ();
 	PBD::ScopedConnection connection_change_connection;
@@ -238,8 +248,25 @@ GMCPGUI::GMCPGUI (GenericMidiControlProtocol& p)
 	threshold_spinner.show ();
 	label->show ();
 
+	label = manage (new Label (_("Dispatch time:")));
+	label->set_alignment (0, 0.5);
+	dispatch_label.set_alignment (0, 0.5);
+	dispatch_reset_button.set_label (_("Reset"));
+	dispatch_reset_button.signal_clicked().connect (sigc::mem_fun (*this, &GMCPGUI::reset_dispatch_stats));
+	Gtkmm2ext::UI::instance()->set_tip (dispatch_label, _("Time spent routing incoming MIDI messages to the bindings that use them"));
+	HBox* hbox = manage (new HBox);
+	hbox->set_spacing (6);
+	hbox->pack_start (dispatch_label, true, true);
+	hbox->pack_start (dispatch_reset_button, false, false);
+	table->attach (*label, 0, 1, n, n + 1);
+	table->attach (*hbox, 1, 2, n, n + 1);
+	++n;
+
 	pack_start (*table, false, false);
 
+	update_dispatch_stats ();
+	dispatch_stats_connection = Glib::signal_timeout().connect (sigc::mem_fun (*this, &GMCPGUI::update_dispatch_stats), 1000);
+
 	binding_changed ();
 
 	/* update the port connection combos */
@@ -253,6 +280,28 @@ GMCPGUI::GMCPGUI (GenericMidiControlProtocol& p)
 
 GMCPGUI::~GMCPGUI ()
 {
+	dispatch_stats_connection.disconnect ();
+}
+
+bool
+GMCPGUI::update_dispatch_stats ()
+{
+	uint64_t min, max;
+	double   avg, dev;
+
+	if (cp.get_dispatch_stats (min, max, avg, dev)) {
+		dispatch_label.set_text (string_compose (_("avg: %1  max: %2 [us]"), rint (avg * 10.) / 10., max));
+	} else {
+		dispatch_label.set_text ("-");
+	}
+	return true;
+}
+
+void
+GMCPGUI::reset_dispatch_stats ()
+{
+	cp.clear_dispatch_stats ();
+	dispatch_label.set_text ("-");
 }
 
 void
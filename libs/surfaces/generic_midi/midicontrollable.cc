@@ -107,6 +107,7 @@ MIDIControllable::midi_forget ()
 	   our existing event + type information.
 	*/
 
+	_surface->unbind_dispatch (this, control_channel, control_type, control_additional);
 	midi_sense_connection[0].disconnect ();
 	midi_sense_connection[1].disconnect ();
 	midi_learn_connection.disconnect ();
@@ -619,50 +620,35 @@ MIDIControllable::bind_midi (channel_t chn, eventType ev, MIDI::byte additional)
 	control_channel = chn;
 	control_additional = additional;
 
-	int chn_i = chn;
+	/* incoming messages are routed to us by the surface's dispatch table */
+	_surface->bind_dispatch (this, chn, ev, additional, _momentary);
+
 	switch (ev) {
 	case MIDI::off:
-		_parser.channel_note_off[chn_i].connect_same_thread (midi_sense_connection[0], boost::bind (&MIDIControllable::midi_sense_note_off, this, _1, _2));
-
-		/* if this is a togglee, connect to noteOn as well,
-		   and we'll toggle back and forth between the two.
-		*/
-
-		if (_momentary) {
-			_parser.channel_note_on[chn_i].connect_same_thread (midi_sense_connection[1], boost::bind (&MIDIControllable::midi_sense_note_on, this, _1, _2));
-		}
-
 		_control_description = "MIDI control: NoteOff";
 		break;
 
 	case MIDI::on:
-		_parser.channel_note_on[chn_i].connect_same_thread (midi_sense_connection[0], boost::bind (&MIDIControllable::midi_sense_note_on, this, _1, _2));
-		if (_momentary) {
-			_parser.channel_note_off[chn_i].connect_same_thread (midi_sense_connection[1], boost::bind (&MIDIControllable::midi_sense_note_off, this, _1, _2));
-		}
 		_control_description = "MIDI control: NoteOn";
 		break;
 
 	case MIDI::controller:
-		_parser.channel_controller[chn_i].connect_same_thread (midi_sense_connection[0], boost::bind (&MIDIControllable::midi_sense_controller, this, _1, _2));
 		snprintf (buf, sizeof (buf), "MIDI control: Controller %d", control_additional);
 		_control_description = buf;
 		break;
 
 	case MIDI::program:
-		_parser.channel_program_change[chn_i].connect_same_thread (midi_sense_connection[0], boost::bind (&MIDIControllable::midi_sense_program_change, this, _1, _2));
 		_control_description = "MIDI control: ProgramChange";
 		break;
 
 	case MIDI::pitchbend:
-		_parser.channel_pitchbend[chn_i].connect_same_thread (midi_sense_connection[0], boost::bind (&MIDIControllable::midi_sense_pitchbend, this, _1, _2));
 		_control_description = "MIDI control: Pitchbend";
 		break;
 
 	default:
 		break;
 	}
-	DEBUG_TRACE (DEBUG::GenericMidi, string_compose ("Controlable: bind_midi: %1 on Channel %2 value %3 \n", _control_description, chn_i + 1, (int) additional));
+	DEBUG_TRACE (DEBUG::GenericMidi, string_compose ("Controlable: bind_midi: %1 on Channel %2 value %3 \n", _control_description, (int) chn + 1, (int) additional));
 }
 
 MIDI::byte*
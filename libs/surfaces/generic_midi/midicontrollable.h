@@ -115,6 +115,7 @@ public:
 	int lookup_controllable();
 
 private:
+	friend class GenericMidiControlProtocol; // dispatches incoming messages
 
 	int max_value_for_type () const;
 
@@ -16,6 +16,7 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <cassert>
 #include <cstring>
 
 #include "midi++/port.h"
@@ -26,7 +27,11 @@
 using namespace MIDI;
 
 MIDIInvokable::MIDIInvokable (MIDI::Parser& p)
-	: _parser (p)
+	: _ui (0)
+	, _parser (p)
+	, control_type (MIDI::none)
+	, control_additional (0)
+	, control_channel (0)
 {
 	data_size = 0;
 	data = 0;
@@ -34,9 +39,25 @@ MIDIInvokable::MIDIInvokable (MIDI::Parser& p)
 
 MIDIInvokable::~MIDIInvokable ()
 {
+	midi_forget ();
 	delete [] data;
 }
 
+void
+MIDIInvokable::midi_forget ()
+{
+	/* stop listening for incoming messages, but retain
+	   our existing event + type information.
+	*/
+
+	midi_sense_connection[0].disconnect ();
+	midi_sense_connection[1].disconnect ();
+
+	if (_ui) {
+		_ui->unbind_dispatch (this, control_channel, control_type, control_additional);
+	}
+}
+
 int
 MIDIInvokable::init (GenericMidiControlProtocol& ui, const std::string& name, MIDI::byte* msg_data, size_t data_sz)
 {
@@ -123,31 +144,26 @@ MIDIInvokable::bind_midi (channel_t chn, eventType ev, MIDI::byte additional)
 	midi_sense_connection[0].disconnect ();
 	midi_sense_connection[1].disconnect ();
 
+	if (_ui) {
+		_ui->unbind_dispatch (this, control_channel, control_type, control_additional);
+	}
+
 	control_type = ev;
 	control_channel = chn;
 	control_additional = additional;
 
-	int chn_i = chn;
-
 	/* incoming MIDI is parsed by Ardour' MidiUI event loop/thread, and we want our handlers to execute in that context, so we use
 	   Signal::connect_same_thread() here.
 	*/
 
 	switch (ev) {
 	case MIDI::off:
-		_parser.channel_note_off[chn_i].connect_same_thread (midi_sense_connection[0], boost::bind (&MIDIInvokable::midi_sense_note_off, this, _1, _2));
-		break;
-
 	case MIDI::on:
-		_parser.channel_note_on[chn_i].connect_same_thread (midi_sense_connection[0], boost::bind (&MIDIInvokable::midi_sense_note_on, this, _1, _2));
-		break;
-
 	case MIDI::controller:
-		_parser.channel_controller[chn_i].connect_same_thread (midi_sense_connection[0], boost::bind (&MIDIInvokable::midi_sense_controller, this, _1, _2));
-		break;
-
 	case MIDI::program:
-		_parser.channel_program_change[chn_i].connect_same_thread (midi_sense_connection[0], boost::bind (&MIDIInvokable::midi_sense_program_change, this, _1, _2));
+		/* channel messages are routed to us by the surface's dispatch table */
+		assert (_ui);
+		_ui->bind_dispatch (this, chn, ev, additional);
 		break;
 
 	case MIDI::sysex:
@@ -46,11 +46,14 @@ class MIDIInvokable : public PBD::Stateful
 	MIDI::Parser& get_parser() { return _parser; }
 
 	void bind_midi (MIDI::channel_t, MIDI::eventType, MIDI::byte);
+	void midi_forget ();
 	MIDI::channel_t get_control_channel () { return control_channel; }
 	MIDI::eventType get_control_type () { return control_type; }
 	MIDI::byte get_control_additional () { return control_additional; }
 
   protected:
+	friend class GenericMidiControlProtocol; // dispatches incoming messages
+
 	GenericMidiControlProtocol* _ui;
 	std::string     _invokable_name;
 	MIDI::Parser&     _parser;
@@ -118,6 +118,8 @@ OSC::OSC (Session& s, uint32_t port)
 	, bank_dirty (false)
 	, observer_busy (true)
 	, scrub_speed (0)
+	, feedback_rate (0)
+	, feedback_bundles (true)
 	, gui (0)
 {
 	_instance = this;
@@ -323,6 +325,8 @@ OSC::stop ()
 		surface_destroy (sur);
 	}
 	_surface.clear();
+	flush_feedback ();
+	_feedback.clear ();
 
 	/* stop main loop */
 	if (local_server) {
@@ -396,6 +400,7 @@ OSC::surface_destroy (OSCSurface* sur)
 		}
 	}
 	sur->observers.clear();
+	_feedback.reset (sur->remote_url);
 }
 
 
@@ -419,6 +424,9 @@ OSC::register_callbacks()
 
 #define REGISTER_CALLBACK(serv,path,types, function) lo_server_add_method (serv, path, types, OSC::_ ## function, this)
 
+		// must be first, so that it sees all messages
+		lo_server_add_method (serv, 0, 0, _feedback_input, this);
+
 		// Some controls have optional "f" for feedback or touchosc
 		// http://hexler.net/docs/touchosc-controls-reference
 
@@ -796,9 +804,9 @@ OSC::send_current_value (const char* path, lo_arg** argv, int argc, lo_message m
 	OSCSurface *sur = get_surface(get_address (msg));
 
 	if (sur->feedback[14]) {
-		lo_send_message (get_address (msg), X_("/reply"), reply);
+		_feedback.reply (get_address (msg), X_("/reply"), reply);
 	} else {
-		lo_send_message (get_address (msg), X_("#reply"), reply);
+		_feedback.reply (get_address (msg), X_("#reply"), reply);
 	}
 	lo_message_free (reply);
 }
@@ -809,6 +817,14 @@ OSC::_catchall (const char *path, const char *types, lo_arg **argv, int argc, vo
 	return ((OSC*)user_data)->catchall (path, types, argv, argc, data);
 }
 
+int
+OSC::_feedback_input (const char *path, const char *types, lo_arg **argv, int argc, void *data, void *user_data)
+{
+	/* the surface may have changed the value locally, don't assume it still has what was sent last */
+	((OSC*)user_data)->_feedback.invalidate (lo_message_get_source ((lo_message) data), path);
+	return 1; /* pass on to the actual handler */
+}
+
 int
 OSC::catchall (const char *path, const char* types, lo_arg **argv, int argc, lo_message msg)
 {
@@ -1141,6 +1157,9 @@ OSC::session_loaded (Session& s)
 void
 OSC::session_exported (std::string path, std::string name)
 {
+	/* not surface feedback: a one-shot notification for an external
+	 * application listening on a fixed port, which is not an OSC client
+	 */
 	lo_address listener = lo_address_new (NULL, "7770");
 	lo_send (listener, X_("/session/exported"), "ss", path.c_str(), name.c_str());
 	lo_address_free (listener);
@@ -1275,9 +1294,9 @@ OSC::routes_list (lo_message msg)
 				lo_message_add_int32 (reply, s->rec_enable_control()->get_value());
 			}
 			if (sur->feedback[14]) {
-				lo_send_message (get_address (msg), X_("/reply"), reply);
+				_feedback.reply (get_address (msg), X_("/reply"), reply);
 			} else {
-				lo_send_message (get_address (msg), X_("#reply"), reply);
+				_feedback.reply (get_address (msg), X_("#reply"), reply);
 			}
 			lo_message_free (reply);
 		}
@@ -1297,9 +1316,9 @@ OSC::routes_list (lo_message msg)
 	}
 
 	if (sur->feedback[14]) {
-		lo_send_message (get_address (msg), X_("/reply"), reply);
+		_feedback.reply (get_address (msg), X_("/reply"), reply);
 	} else {
-		lo_send_message (get_address (msg), X_("#reply"), reply);
+		_feedback.reply (get_address (msg), X_("#reply"), reply);
 	}
 
 	lo_message_free (reply);
@@ -1358,6 +1377,14 @@ OSC::get_surfaces ()
 		PBD::info << string_compose ("	Personal monitor flag %1,   Aux master: %2,   Number of sends: %3\n", sur->cue, sur->aux, sur->sends.size());
 		PBD::info << string_compose ("	Linkset: %1   Device Id: %2\n", sur->linkset, sur->linkid);
 	}
+	std::map<std::string, OSCFeedback::Stats> fbs (_feedback.stats ());
+	PBD::info << string_compose ("\nFeedback (%1 clients, limit: %2 msg/s, bundles: %3):\n", fbs.size(), feedback_rate, feedback_bundles);
+	for (std::map<std::string, OSCFeedback::Stats>::const_iterator i = fbs.begin(); i != fbs.end(); ++i) {
+		OSCFeedback::Stats const& st (i->second);
+		PBD::info << string_compose ("\n  Client: %1\n", i->first);
+		PBD::info << string_compose ("	Queued: %1   Coalesced: %2   Unchanged: %3   Deferred ticks: %4\n", st.queued, st.coalesced, st.unchanged, st.deferred);
+		PBD::info << string_compose ("	Sent: %1 messages in %2 datagrams, %3 bytes\n", st.sent, st.bundles, st.bytes);
+	}
 	PBD::info << string_compose ("\nList of LinkSets (%1):\n", link_sets.size());
 	std::map<uint32_t, LinkSet>::iterator it;
 	for (it = link_sets.begin(); it != link_sets.end(); it++) {
@@ -1925,7 +1952,7 @@ OSC::surface_parse (const char *path, const char* types, lo_arg **argv, int argc
 					lo_message_add_int32 (reply, (int) linkset);
 					lo_message_add_int32 (reply, (int) linkid);
 					lo_message_add_int32 (reply, (int) port);
-					lo_send_message (get_address (msg), X_("/set_surface"), reply);
+					_feedback.reply (get_address (msg), X_("/set_surface"), reply);
 					lo_message_free (reply);
 					return 0;
 				}
@@ -2274,6 +2301,9 @@ OSC::get_surface (lo_address addr , bool quiet)
 void
 OSC::global_feedback (OSCSurface* sur)
 {
+	// the surface expects a complete update
+	_feedback.reset (sur->remote_url);
+
 	OSCGlobalObserver* o = sur->global_obs;
 	if (o) {
 		delete o;
@@ -2412,7 +2442,7 @@ OSC::_recalcbanks ()
 			// This surface uses /strip/list tell it routes have changed
 			lo_message reply;
 			reply = lo_message_new ();
-			lo_send_message (addr, X_("/strip/list"), reply);
+			_feedback.reply (addr, X_("/strip/list"), reply);
 			lo_message_free (reply);
 		} else {
 			strip_feedback (sur, false);
@@ -2554,16 +2584,14 @@ OSC::bank_leds (OSCSurface* s)
 		} else {
 			lo_message_add_int32 (reply, 1);
 		}
-		lo_send_message (addr, X_("/bank_up"), reply);
-		lo_message_free (reply);
+		_feedback.queue (addr, X_("/bank_up"), X_("/bank_up"), reply);
 		reply = lo_message_new ();
 		if (bank > 1) {
 			lo_message_add_int32 (reply, 1);
 		} else {
 			lo_message_add_int32 (reply, 0);
 		}
-		lo_send_message (addr, X_("/bank_down"), reply);
-		lo_message_free (reply);
+		_feedback.queue (addr, X_("/bank_down"), X_("/bank_down"), reply);
 	}
 }
 
@@ -3197,7 +3225,7 @@ OSC::transport_sample (lo_message msg)
 	lo_message reply = lo_message_new ();
 	lo_message_add_int64 (reply, pos);
 
-	lo_send_message (get_address (msg), X_("/transport_frame"), reply);
+	_feedback.reply (get_address (msg), X_("/transport_frame"), reply);
 
 	lo_message_free (reply);
 }
@@ -3214,7 +3242,7 @@ OSC::transport_speed (lo_message msg)
 	lo_message reply = lo_message_new ();
 	lo_message_add_double (reply, ts);
 
-	lo_send_message (get_address (msg), X_("/transport_speed"), reply);
+	_feedback.reply (get_address (msg), X_("/transport_speed"), reply);
 
 	lo_message_free (reply);
 }
@@ -3231,7 +3259,7 @@ OSC::record_enabled (lo_message msg)
 	lo_message reply = lo_message_new ();
 	lo_message_add_int32 (reply, re);
 
-	lo_send_message (get_address (msg), X_("/record_enabled"), reply);
+	_feedback.reply (get_address (msg), X_("/record_enabled"), reply);
 
 	lo_message_free (reply);
 }
@@ -3459,7 +3487,7 @@ OSC::send_group_list (lo_address addr)
 		RouteGroup *rg = *i;
 		lo_message_add_string (reply, rg->name().c_str());
 	}
-	lo_send_message (addr, X_("/group/list"), reply);
+	_feedback.reply (addr, X_("/group/list"), reply);
 	lo_message_free (reply);
 	return 0;
 }
@@ -3560,7 +3588,7 @@ OSC::master_set_pan_stereo_position (float position, lo_message msg)
 		lo_message reply = lo_message_new ();
 		lo_message_add_float (reply, endposition);
 
-		lo_send_message (get_address (msg), X_("/master/pan_stereo_position"), reply);
+		_feedback.reply (get_address (msg), X_("/master/pan_stereo_position"), reply);
 		lo_message_free (reply);
 	}
 
@@ -3729,7 +3757,7 @@ OSC::route_get_sends(lo_message msg) {
 	}
 	// if used dedicated message path to identify this reply in async operation.
 	// Naming it #reply wont help the client to identify the content.
-	lo_send_message(get_address (msg), X_("/strip/sends"), reply);
+	_feedback.reply (get_address (msg), X_("/strip/sends"), reply);
 
 	lo_message_free(reply);
 
@@ -3793,7 +3821,7 @@ OSC::route_get_receives(lo_message msg) {
 
 	// I have used a dedicated message path to identify this reply in async operation.
 	// Naming it #reply wont help the client to identify the content.
-	lo_send_message(get_address (msg), X_("/strip/receives"), reply);
+	_feedback.reply (get_address (msg), X_("/strip/receives"), reply);
 	lo_message_free(reply);
 	return 0;
 }
@@ -5621,7 +5649,7 @@ OSC::route_plugin_list (int ssid, lo_message msg) {
 		piid++;
 	}
 
-	lo_send_message (get_address (msg), X_("/strip/plugin/list"), reply);
+	_feedback.reply (get_address (msg), X_("/strip/plugin/list"), reply);
 	lo_message_free (reply);
 	return 0;
 }
@@ -5741,14 +5769,14 @@ OSC::route_plugin_descriptor (int ssid, int piid, lo_message msg) {
 			lo_message_add_double (reply, 0);
 		}
 
-		lo_send_message (get_address (msg), X_("/strip/plugin/descriptor"), reply);
+		_feedback.reply (get_address (msg), X_("/strip/plugin/descriptor"), reply);
 		lo_message_free (reply);
 	}
 
 	lo_message reply = lo_message_new ();
 	lo_message_add_int32 (reply, ssid);
 	lo_message_add_int32 (reply, piid);
-	lo_send_message (get_address (msg), X_("/strip/plugin/descriptor_end"), reply);
+	_feedback.reply (get_address (msg), X_("/strip/plugin/descriptor_end"), reply);
 	lo_message_free (reply);
 
 	return 0;
@@ -6277,7 +6305,6 @@ OSC::periodic (void)
 		return true;
 	}
 	if (!tick) {
-		Glib::usleep(100); // let flurry of signals subside
 		if (global_init) {
 			for (uint32_t it = 0; it < _surface.size(); it++) {
 				OSCSurface* sur = &_surface[it];
@@ -6291,6 +6318,7 @@ OSC::periodic (void)
 			bank_dirty = false;
 			tick = true;
 		}
+		flush_feedback ();
 		return true;
 	}
 
@@ -6338,9 +6366,17 @@ OSC::periodic (void)
 			x++;
 		}
 	}
+	flush_feedback ();
 	return true;
 }
 
+void
+OSC::flush_feedback ()
+{
+	/* periodic () runs at 10Hz */
+	_feedback.flush (feedback_rate > 0 ? std::max<uint32_t> (1, feedback_rate / 10) : 0, feedback_bundles);
+}
+
 XMLNode&
 OSC::get_state ()
 {
@@ -6354,6 +6390,8 @@ OSC::get_state ()
 	node.set_property (X_("gainmode"), default_gainmode);
 	node.set_property (X_("send-page-size"), default_send_size);
 	node.set_property (X_("plug-page-size"), default_plugin_size);
+	node.set_property (X_("feedback-rate"), feedback_rate);
+	node.set_property (X_("feedback-bundles"), feedback_bundles);
 	return node;
 }
 
@@ -6376,6 +6414,8 @@ OSC::set_state (const XMLNode& node, int version)
 	node.get_property (X_("gainmode"), default_gainmode);
 	node.get_property (X_("send-page-size"), default_send_size);
 	node.get_property (X_("plugin-page-size"), default_plugin_size);
+	node.get_property (X_("feedback-rate"), feedback_rate);
+	node.get_property (X_("feedback-bundles"), feedback_bundles);
 
 	global_init = true;
 	tick = false;
@@ -6900,24 +6940,16 @@ OSC::cue_send_enable (uint32_t id, float state, lo_message msg)
 int
 OSC::float_message (string path, float val, lo_address addr)
 {
-	_lo_lock.lock ();
-
-	lo_message reply;
-	reply = lo_message_new ();
+	lo_message reply = lo_message_new ();
 	lo_message_add_float (reply, (float) val);
 
-	lo_send_message (addr, path.c_str(), reply);
-	Glib::usleep(1);
-	lo_message_free (reply);
-	_lo_lock.unlock ();
-
+	_feedback.queue (addr, path, path, reply);
 	return 0;
 }
 
 int
 OSC::float_message_with_id (std::string path, uint32_t ssid, float value, bool in_line, lo_address addr)
 {
-	_lo_lock.lock ();
 	lo_message msg = lo_message_new ();
 	if (in_line) {
 		path = string_compose ("%1/%2", path, ssid);
@@ -6926,34 +6958,31 @@ OSC::float_message_with_id (std::string path, uint32_t ssid, float value, bool i
 	}
 	lo_message_add_float (msg, value);
 
-	lo_send_message (addr, path.c_str(), msg);
-	Glib::usleep(1);
-	lo_message_free (msg);
-	_lo_lock.unlock ();
+	_feedback.queue (addr, path, in_line ? path : string_compose ("%1 %2", path, ssid), msg);
 	return 0;
 }
 
+/* takes ownership of msg */
 int
-OSC::int_message (string path, int val, lo_address addr)
+OSC::message (string path, lo_message msg, lo_address addr)
 {
-	_lo_lock.lock ();
+	_feedback.queue (addr, path, path, msg);
+	return 0;
+}
 
-	lo_message reply;
-	reply = lo_message_new ();
+int
+OSC::int_message (string path, int val, lo_address addr)
+{
+	lo_message reply = lo_message_new ();
 	lo_message_add_int32 (reply, (float) val);
 
-	lo_send_message (addr, path.c_str(), reply);
-	Glib::usleep(1);
-	lo_message_free (reply);
-	_lo_lock.unlock ();
-
+	_feedback.queue (addr, path, path, reply);
 	return 0;
 }
 
 int
 OSC::int_message_with_id (std::string path, uint32_t ssid, int value, bool in_line, lo_address addr)
 {
-	_lo_lock.lock ();
 	lo_message msg = lo_message_new ();
 	if (in_line) {
 		path = string_compose ("%1/%2", path, ssid);
@@ -6962,47 +6991,32 @@ OSC::int_message_with_id (std::string path, uint32_t ssid, int value, bool in_li
 	}
 	lo_message_add_int32 (msg, value);
 
-	lo_send_message (addr, path.c_str(), msg);
-	Glib::usleep(1);
-	lo_message_free (msg);
-	_lo_lock.unlock ();
+	_feedback.queue (addr, path, in_line ? path : string_compose ("%1 %2", path, ssid), msg);
 	return 0;
 }
 
 int
 OSC::text_message (string path, string val, lo_address addr)
 {
-	_lo_lock.lock ();
-
-	lo_message reply;
-	reply = lo_message_new ();
+	lo_message reply = lo_message_new ();
 	lo_message_add_string (reply, val.c_str());
 
-	lo_send_message (addr, path.c_str(), reply);
-	Glib::usleep(1);
-	lo_message_free (reply);
-	_lo_lock.unlock ();
-
+	_feedback.queue (addr, path, path, reply);
 	return 0;
 }
 
 int
 OSC::text_message_with_id (std::string path, uint32_t ssid, std::string val, bool in_line, lo_address addr)
 {
-	_lo_lock.lock ();
 	lo_message msg = lo_message_new ();
 	if (in_line) {
 		path = string_compose ("%1/%2", path, ssid);
 	} else {
 		lo_message_add_int32 (msg, ssid);
 	}
-
 	lo_message_add_string (msg, val.c_str());
 
-	lo_send_message (addr, path.c_str(), msg);
-	Glib::usleep(1);
-	lo_message_free (msg);
-	_lo_lock.unlock ();
+	_feedback.queue (addr, path, in_line ? path : string_compose ("%1 %2", path, ssid), msg);
 	return 0;
 }
 
@@ -46,6 +46,8 @@
 #include "ardour/plugin.h"
 #include "control_protocol/control_protocol.h"
 
+#include "osc_feedback.h"
+
 #include "pbd/i18n.h"
 
 class OSCControllable;
@@ -92,14 +94,14 @@ class OSC : public ARDOUR::ControlProtocol, public AbstractUI<OSCUIRequest>
 	int set_active (bool yn);
 	bool get_active () const;
 
-	// generic osc send
-	Glib::Threads::Mutex _lo_lock;
+	// generic osc send, queued as feedback
 	int float_message (std::string, float value, lo_address addr);
 	int int_message (std::string, int value, lo_address addr);
 	int text_message (std::string path, std::string val, lo_address addr);
 	int float_message_with_id (std::string, uint32_t ssid, float value, bool in_line, lo_address addr);
 	int int_message_with_id (std::string, uint32_t ssid, int value, bool in_line, lo_address addr);
 	int text_message_with_id (std::string path, uint32_t ssid, std::string val, bool in_line, lo_address addr);
+	int message (std::string path, lo_message msg, lo_address addr);
 
 	int send_group_list (lo_address addr);
 
@@ -261,6 +263,10 @@ class OSC : public ARDOUR::ControlProtocol, public AbstractUI<OSCUIRequest>
 	void get_surfaces ();
 	std::string get_remote_port () { return remote_port; }
 	void set_remote_port (std::string pt) { remote_port = pt; }
+	uint32_t get_feedback_rate () const { return feedback_rate; }
+	void set_feedback_rate (uint32_t r) { feedback_rate = r; }
+	bool get_feedback_bundles () const { return feedback_bundles; }
+	void set_feedback_bundles (bool yn) { feedback_bundles = yn; }
 
   protected:
         void thread_init ();
@@ -295,6 +301,9 @@ class OSC : public ARDOUR::ControlProtocol, public AbstractUI<OSCUIRequest>
 	double scrub_place;		// place of play head at latest jog/scrub wheel tick
 	int64_t scrub_time;		// when did the wheel move last?
 	bool global_init;
+	OSCFeedback _feedback;	// all messages to surfaces: queued state feedback and direct query replies
+	uint32_t feedback_rate;	// max. feedback messages per second and surface, 0: unlimited
+	bool feedback_bundles;	// send feedback as OSC bundles
 	boost::shared_ptr<ARDOUR::Stripable> _select;	// which stripable out of /surface/stripables is gui selected
 
 	void register_callbacks ();
@@ -327,6 +336,7 @@ class OSC : public ARDOUR::ControlProtocol, public AbstractUI<OSCUIRequest>
 
 	int catchall (const char *path, const char *types, lo_arg **argv, int argc, void *data);
 	static int _catchall (const char *path, const char *types, lo_arg **argv, int argc, void *data, void *user_data);
+	static int _feedback_input (const char *path, const char *types, lo_arg **argv, int argc, void *data, void *user_data);
 
 	int set_automation (const char *path, const char* types, lo_arg **argv, int argc, lo_message msg);
 	int touch_detect (const char *path, const char* types, lo_arg **argv, int argc, lo_message msg);
@@ -823,6 +833,7 @@ class OSC : public ARDOUR::ControlProtocol, public AbstractUI<OSCUIRequest>
 	int cancel_all_solos ();
 	int osc_toggle_roll (bool ret2strt);
 	bool periodic (void);
+	void flush_feedback ();
 	sigc::connection periodic_connection;
 	PBD::ScopedConnectionList session_connections;
 
@@ -0,0 +1,257 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <cstdlib>
+#include <cstring>
+
+#include "osc_feedback.h"
+
+using namespace std;
+using namespace ArdourSurface;
+
+/* "#bundle\0" and the timetag */
+static const size_t bundle_header_size = 16;
+
+OSCFeedback::Client::Client (lo_address a)
+	: addr (a)
+{
+}
+
+OSCFeedback::Client::~Client ()
+{
+	for (vector<Pending>::const_iterator i = pending.begin (); i != pending.end (); ++i) {
+		lo_message_free (i->msg);
+	}
+	lo_address_free (addr);
+}
+
+OSCFeedback::OSCFeedback ()
+{
+}
+
+OSCFeedback::~OSCFeedback ()
+{
+	clear ();
+}
+
+OSCFeedback::Client*
+OSCFeedback::client (lo_address addr)
+{
+	char* u = lo_address_get_url (addr);
+	string url (u);
+	free (u);
+
+	Clients::iterator c = _clients.find (url);
+	if (c == _clients.end ()) {
+		/* observers free their address independently */
+		c = _clients.insert (make_pair (url, new Client (lo_address_new_from_url (url.c_str ())))).first;
+	}
+	return c->second;
+}
+
+void
+OSCFeedback::queue (lo_address addr, string const& path, string const& key, lo_message msg)
+{
+	Glib::Threads::Mutex::Lock lm (_lock);
+
+	Client* cl = client (addr);
+	++cl->stats.queued;
+
+	map<string, size_t>::const_iterator i = cl->index.find (key);
+	if (i != cl->index.end ()) {
+		Pending& p (cl->pending[i->second]);
+		lo_message_free (p.msg);
+		p.msg  = msg;
+		p.path = path;
+		++cl->stats.coalesced;
+		return;
+	}
+
+	cl->index[key] = cl->pending.size ();
+	cl->pending.push_back (Pending (path, key, msg));
+}
+
+void
+OSCFeedback::flush (uint32_t max_messages, bool bundle)
+{
+	Glib::Threads::Mutex::Lock lm (_lock);
+	for (Clients::const_iterator c = _clients.begin (); c != _clients.end (); ++c) {
+		flush_client (c->second, max_messages, bundle);
+	}
+}
+
+void
+OSCFeedback::flush_client (Client* cl, uint32_t max_messages, bool bundle)
+{
+	if (cl->pending.empty ()) {
+		return;
+	}
+
+	lo_timetag tt;
+	lo_timetag_now (&tt);
+
+	lo_bundle b      = 0;
+	size_t    b_size = 0;
+	uint32_t  n_sent = 0;
+	size_t    n_done = 0;
+
+	for (; n_done < cl->pending.size (); ++n_done) {
+		Pending& p (cl->pending[n_done]);
+
+		size_t len = lo_message_length (p.msg, p.path.c_str ());
+		string data (len, '\0');
+		lo_message_serialise (p.msg, p.path.c_str (), &data[0], &len);
+
+		map<string, string>::iterator ls = cl->last_sent.find (p.key);
+		if (ls != cl->last_sent.end () && ls->second == data) {
+			++cl->stats.unchanged;
+			lo_message_free (p.msg);
+			p.msg = 0;
+			continue;
+		}
+
+		if (max_messages > 0 && n_sent == max_messages) {
+			++cl->stats.deferred;
+			break;
+		}
+
+		cl->last_sent[p.key] = data;
+		++cl->stats.sent;
+		++n_sent;
+
+		if (b && b_size + 4 + len > max_bundle_size) {
+			send_bundle (cl, b, b_size);
+			b = 0;
+		}
+
+		if (!bundle || bundle_header_size + 4 + len > max_bundle_size) {
+			lo_send_message (cl->addr, p.path.c_str (), p.msg);
+			lo_message_free (p.msg);
+			p.msg = 0;
+			++cl->stats.bundles;
+			cl->stats.bytes += len;
+			continue;
+		}
+
+		if (!b) {
+			b      = lo_bundle_new (tt);
+			b_size = bundle_header_size;
+		}
+
+		/* the bundle takes ownership of the message, the path must remain valid until it is sent */
+		lo_bundle_add_message (b, p.path.c_str (), p.msg);
+		p.msg   = 0;
+		b_size += 4 + len;
+	}
+
+	if (b) {
+		send_bundle (cl, b, b_size);
+	}
+
+	/* keep messages that exceeded the rate-limit for the next tick */
+	cl->pending.erase (cl->pending.begin (), cl->pending.begin () + n_done);
+	cl->index.clear ();
+	for (size_t i = 0; i < cl->pending.size (); ++i) {
+		cl->index[cl->pending[i].key] = i;
+	}
+}
+
+void
+OSCFeedback::reply (lo_address addr, const char* path, lo_message msg)
+{
+	Glib::Threads::Mutex::Lock lm (_lock);
+
+	Client* cl = client (addr);
+
+	/* the reply supersedes whatever feedback was last sent for this path */
+	const size_t len = strlen (path);
+	map<string, string>& ls (cl->last_sent);
+	for (map<string, string>::iterator i = ls.lower_bound (path); i != ls.end () && !i->first.compare (0, len, path);) {
+		ls.erase (i++);
+	}
+
+	lo_send_message (addr, path, msg);
+
+	++cl->stats.sent;
+	++cl->stats.bundles;
+	cl->stats.bytes += lo_message_length (msg, path);
+}
+
+void
+OSCFeedback::send_bundle (Client* cl, lo_bundle b, size_t size)
+{
+	lo_send_bundle (cl->addr, b);
+	lo_bundle_free_messages (b);
+	++cl->stats.bundles;
+	cl->stats.bytes += size;
+}
+
+void
+OSCFeedback::reset (string const& url)
+{
+	Glib::Threads::Mutex::Lock lm (_lock);
+	Clients::const_iterator c = _clients.find (url);
+	if (c != _clients.end ()) {
+		c->second->last_sent.clear ();
+	}
+}
+
+void
+OSCFeedback::invalidate (lo_address addr, const char* path)
+{
+	const char* host = lo_address_get_hostname (addr);
+	if (!host || !path) {
+		return;
+	}
+	const size_t len = strlen (path);
+
+	Glib::Threads::Mutex::Lock lm (_lock);
+
+	/* replies may go to a different port than the one the message came from */
+	for (Clients::const_iterator c = _clients.begin (); c != _clients.end (); ++c) {
+		const char* h = lo_address_get_hostname (c->second->addr);
+		if (!h || strcmp (h, host)) {
+			continue;
+		}
+		map<string, string>& ls (c->second->last_sent);
+		for (map<string, string>::iterator i = ls.lower_bound (path); i != ls.end () && !i->first.compare (0, len, path);) {
+			ls.erase (i++);
+		}
+	}
+}
+
+void
+OSCFeedback::clear ()
+{
+	Glib::Threads::Mutex::Lock lm (_lock);
+	for (Clients::const_iterator c = _clients.begin (); c != _clients.end (); ++c) {
+		delete c->second;
+	}
+	_clients.clear ();
+}
+
+map<string, OSCFeedback::Stats>
+OSCFeedback::stats () const
+{
+	map<string, Stats> rv;
+	Glib::Threads::Mutex::Lock lm (_lock);
+	for (Clients::const_iterator c = _clients.begin (); c != _clients.end (); ++c) {
+		rv[c->first] = c->second->stats;
+	}
+	return rv;
+}
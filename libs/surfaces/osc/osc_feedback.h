@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __osc_oscfeedback_h__
+#define __osc_oscfeedback_h__
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <stdint.h>
+
+#include <lo/lo.h>
+
+#include <glibmm/threads.h>
+
+namespace ArdourSurface {
+
+/** Per client queue of feedback messages.
+ *
+ * Observers queue values as they change. Once per OSC::periodic() tick the
+ * queue is flushed: a value that was changed several times during a tick
+ * is only sent once, values that the client already has are not sent at all,
+ * and the remaining messages are packed into timestamped bundles that fit
+ * into a single UDP datagram.
+ *
+ * Replies to explicit queries by a client bypass the queue, see reply ().
+ */
+class OSCFeedback
+{
+public:
+	OSCFeedback ();
+	~OSCFeedback ();
+
+	struct Stats {
+		Stats () : queued (0), coalesced (0), unchanged (0), sent (0), bundles (0), bytes (0), deferred (0) {}
+		uint64_t queued;    ///< messages handed to queue ()
+		uint64_t coalesced; ///< replaced by a later value in the same tick
+		uint64_t unchanged; ///< dropped, the client already has this value
+		uint64_t sent;      ///< messages sent
+		uint64_t bundles;   ///< datagrams sent
+		uint64_t bytes;     ///< payload bytes sent
+		uint64_t deferred;  ///< ticks at which the rate limit was hit
+	};
+
+	/** Queue a message for the client at \p addr.
+	 * @param key identifies the value, a pending message with the same key is replaced.
+	 * The message is owned by the queue after this call.
+	 */
+	void queue (lo_address addr, std::string const& path, std::string const& key, lo_message msg);
+
+	/** Send a reply to a query of the client at \p addr right away.
+	 *
+	 * Replies are not coalesced, de-duplicated or rate-limited: the client
+	 * asked for them, expects an answer even if the value did not change,
+	 * and multi-message replies (lists, plugin descriptors) rely on their
+	 * order. Cached values of \p path are forgotten, so that subsequent
+	 * feedback is not wrongly considered unchanged.
+	 * The message remains owned by the caller.
+	 */
+	void reply (lo_address addr, const char* path, lo_message msg);
+
+	/** Send pending messages to all clients.
+	 * @param max_messages per client limit, 0: unlimited. Messages exceeding
+	 * the limit remain queued for the next call.
+	 * @param bundle pack messages into bundles
+	 */
+	void flush (uint32_t max_messages, bool bundle);
+
+	/** Forget the values sent to the given client, they will all be re-sent
+	 * if queued again. This is needed whenever a surface is (re)initialized.
+	 */
+	void reset (std::string const& url);
+
+	/** The client at \p addr sent a message to \p path, and may have changed
+	 * its local state of matching controls.
+	 */
+	void invalidate (lo_address addr, const char* path);
+
+	/** drop all clients, pending messages are discarded */
+	void clear ();
+
+	std::map<std::string, Stats> stats () const;
+
+	/** max. size of a bundle, below a typical ethernet MTU minus IP/UDP headers */
+	static const size_t max_bundle_size = 1400;
+
+private:
+	struct Pending {
+		Pending (std::string const& p, std::string const& k, lo_message m) : path (p), key (k), msg (m) {}
+		std::string path;
+		std::string key;
+		lo_message  msg;
+	};
+
+	struct Client {
+		Client (lo_address a);
+		~Client ();
+
+		lo_address                         addr;
+		std::vector<Pending>               pending;
+		std::map<std::string, size_t>      index;     ///< key -> position in pending
+		std::map<std::string, std::string> last_sent; ///< key -> serialized message
+		Stats                              stats;
+	};
+
+	typedef std::map<std::string, Client*> Clients;
+
+	Client* client (lo_address);
+	void flush_client (Client*, uint32_t max_messages, bool bundle);
+	void send_bundle (Client*, lo_bundle, size_t);
+
+	mutable Glib::Threads::Mutex _lock;
+	Clients                      _clients;
+};
+
+} // namespace
+
+#endif /* __osc_oscfeedback_h__ */
@@ -56,6 +56,7 @@ OSCRouteObserver::OSCRouteObserver (OSC& o, uint32_t ss, ArdourSurface::OSC::OSC
 	,_last_trim (-1.0)
 	,_init (true)
 	,_expand (2048)
+	,_tick_busy (false)
 {
 	addr = lo_address_new_from_url (sur->remote_url.c_str());
 	gainmode = sur->gainmode;
@@ -63,6 +63,7 @@ OSCSelectObserver::OSCSelectObserver (OSC& o, ARDOUR::Session& s, ArdourSurface:
 	,_init (true)
 	,eq_bands (0)
 	,_expand (2048)
+	,_tick_busy (false)
 {
 	session = &s;
 	addr = lo_address_new_from_url 	(sur->remote_url.c_str());
@@ -1183,6 +1184,5 @@ OSCSelectObserver::slaved_changed (boost::shared_ptr<VCA> vca, bool state)
 			lo_message_add_string (reply, name.c_str());
 		}
 	}
-	lo_send_message (addr, X_("/select/vcas"), reply);
-	lo_message_free (reply);
+	_osc.message (X_("/select/vcas"), reply, addr);
 }
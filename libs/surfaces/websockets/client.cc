@@ -16,6 +16,7 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <algorithm>
 #include <sstream>
 
 #include "client.h"
@@ -58,6 +59,59 @@ ClientContext::update_state (const NodeState& node_state)
 	_state.insert (node_state);
 }
 
+void
+ClientContext::queue_output (const NodeState& node_state)
+{
+	if (_binary_meter && node_state.node () == Node::strip_meter
+	    && node_state.n_addr () == 1 && node_state.n_val () == 1) {
+		_meters[node_state.nth_addr (0)] = static_cast<double> (node_state.nth_val (0));
+		return;
+	}
+
+	OutputIndex::iterator it = _output_idx.find (node_state);
+
+	if (it != _output_idx.end ()) {
+		*it->second = NodeStateMessage (node_state);
+		return;
+	}
+
+	_output_buf.push_back (NodeStateMessage (node_state));
+	_output_idx[node_state] = --_output_buf.end ();
+}
+
+void
+ClientContext::pop_output ()
+{
+	_output_idx.erase (_output_buf.front ().state ());
+	_output_buf.pop_front ();
+}
+
+void
+ClientContext::set_options (const NodeState& node_state)
+{
+	for (int i = 0; i < node_state.n_val (); i++) {
+		TypedValue val = node_state.nth_val (i);
+
+		switch (val.type ()) {
+			case TypedValue::String: {
+				std::string opt = static_cast<std::string> (val);
+				if (opt == "batch") {
+					_batch = true;
+				} else if (opt == "binary_meter") {
+					_binary_meter = true;
+				}
+				break;
+			}
+			case TypedValue::Int:
+				/* max. size of a batch frame in bytes */
+				_max_frame_size = std::max (1024, static_cast<int> (val));
+				break;
+			default:
+				break;
+		}
+	}
+}
+
 std::string
 ClientContext::debug_str ()
 {
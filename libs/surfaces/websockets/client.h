@@ -21,6 +21,9 @@
 
 #include <set>
 #include <list>
+#include <map>
+
+#include <boost/unordered_map.hpp>
 
 #include "message.h"
 #include "state.h"
@@ -35,7 +38,10 @@ class ClientContext
 {
 public:
 	ClientContext (Client wsi)
-	    : _wsi (wsi){};
+	    : _wsi (wsi)
+	    , _batch (false)
+	    , _binary_meter (false)
+	    , _max_frame_size (default_max_frame_size){};
 	virtual ~ClientContext (){};
 
 	Client wsi () const
@@ -46,13 +52,50 @@ public:
 	bool has_state (const NodeState&);
 	void update_state (const NodeState&);
 
+	/* queue a state for sending, a pending state of the same
+	 * node and address is replaced */
+	void queue_output (const NodeState&);
+	void pop_output ();
+
 	ClientOutputBuffer& output_buf ()
 	{
 		return _output_buf;
 	}
 
+	/* strip meters for clients using binary_meter, by strip id */
+	typedef std::map<uint32_t, float> MeterMap;
+
+	MeterMap& pending_meters ()
+	{
+		return _meters;
+	}
+
+	/* protocol options, set by the client using Node::protocol */
+	bool batch () const
+	{
+		return _batch;
+	}
+	bool binary_meter () const
+	{
+		return _binary_meter;
+	}
+	size_t max_frame_size () const
+	{
+		return _max_frame_size;
+	}
+
+	void set_options (const NodeState&);
+
+	/* re-used for writing frames */
+	std::string& frame ()
+	{
+		return _frame;
+	}
+
 	std::string debug_str ();
 
+	static const size_t default_max_frame_size = 65536;
+
 private:
 	Client _wsi;
 
@@ -60,6 +103,15 @@ private:
 	ClientState                 _state;
 
 	ClientOutputBuffer _output_buf;
+
+	typedef boost::unordered_map<NodeState, ClientOutputBuffer::iterator> OutputIndex;
+	OutputIndex                                                           _output_idx;
+
+	MeterMap    _meters;
+	bool        _batch;
+	bool        _binary_meter;
+	size_t      _max_frame_size;
+	std::string _frame;
 };
 
 } // namespace ArdourSurface
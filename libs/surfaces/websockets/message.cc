@@ -20,10 +20,11 @@
 #include <iostream>
 #endif
 
-#include <boost/lexical_cast.hpp>
-#include <boost/property_tree/json_parser.hpp>
-#include <boost/property_tree/ptree.hpp>
-#include <sstream>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+#include <glib.h>
 
 #include "message.h"
 #include "json.h"
@@ -36,160 +37,443 @@
 
 using namespace ArdourSurface;
 
-namespace pt = boost::property_tree;
+namespace {
 
-NodeStateMessage::NodeStateMessage (const NodeState& state)
-    : _valid (true)
-    , _state (state)
+/* Minimal pull parser for the subset of JSON used by the protocol,
+ * reads directly from the receive buffer. */
+class JSONReader
 {
-	_write = state.n_val () > 0;
+public:
+	JSONReader (const char* buf, size_t len)
+	    : _p (buf)
+	    , _end (buf + len)
+	{
+	}
+
+	bool at_end ()
+	{
+		skip_ws ();
+		return _p == _end;
+	}
+
+	bool peek (char c)
+	{
+		skip_ws ();
+		return _p < _end && *_p == c;
+	}
+
+	bool expect (char c)
+	{
+		if (!peek (c)) {
+			return false;
+		}
+		++_p;
+		return true;
+	}
+
+	bool read_string (std::string&);
+	bool read_value (TypedValue&);
+	bool skip_value ();
+
+private:
+	void skip_ws ()
+	{
+		while (_p < _end && (*_p == ' ' || *_p == '\t' || *_p == '\n' || *_p == '\r')) {
+			++_p;
+		}
+	}
+
+	bool read_literal (const char* lit)
+	{
+		size_t n = strlen (lit);
+		if ((size_t) (_end - _p) < n || strncmp (_p, lit, n)) {
+			return false;
+		}
+		_p += n;
+		return true;
+	}
+
+	bool read_hex4 (uint32_t&);
+	bool read_number (TypedValue&);
+
+	const char* _p;
+	const char* _end;
+};
+
+bool
+JSONReader::read_hex4 (uint32_t& cp)
+{
+	if (_end - _p < 4) {
+		return false;
+	}
+	cp = 0;
+	for (int i = 0; i < 4; ++i, ++_p) {
+		int v = g_ascii_xdigit_value (*_p);
+		if (v < 0) {
+			return false;
+		}
+		cp = (cp << 4) | v;
+	}
+	return true;
+}
+
+bool
+JSONReader::read_string (std::string& s)
+{
+	if (!expect ('"')) {
+		return false;
+	}
+
+	s.clear ();
+
+	while (_p < _end) {
+		char c = *_p++;
+
+		if (c == '"') {
+			return true;
+		} else if (c != '\\') {
+			s += c;
+			continue;
+		} else if (_p == _end) {
+			return false;
+		}
+
+		switch (*_p++) {
+			case '"':  s += '"';  break;
+			case '\\': s += '\\'; break;
+			case '/':  s += '/';  break;
+			case 'b':  s += '\b'; break;
+			case 'f':  s += '\f'; break;
+			case 'n':  s += '\n'; break;
+			case 'r':  s += '\r'; break;
+			case 't':  s += '\t'; break;
+			case 'u': {
+				uint32_t cp;
+				if (!read_hex4 (cp)) {
+					return false;
+				}
+				if (cp >= 0xd800 && cp < 0xdc00) {
+					/* surrogate pair */
+					uint32_t lo;
+					if (!read_literal ("\\u") || !read_hex4 (lo) || lo < 0xdc00 || lo > 0xdfff) {
+						return false;
+					}
+					cp = 0x10000 + ((cp - 0xd800) << 10) + (lo - 0xdc00);
+				}
+				char utf8[6];
+				s.append (utf8, g_unichar_to_utf8 (cp, utf8));
+				break;
+			}
+			default:
+				return false;
+		}
+	}
+
+	return false;
+}
+
+bool
+JSONReader::read_number (TypedValue& v)
+{
+	char buf[64];
+	size_t n = 0;
+	bool integral = true;
+
+	while (_p < _end && n < sizeof (buf) - 1) {
+		char c = *_p;
+		if (c == '.' || c == 'e' || c == 'E') {
+			integral = false;
+		} else if (!(c == '-' || c == '+' || (c >= '0' && c <= '9'))) {
+			break;
+		}
+		buf[n++] = c;
+		++_p;
+	}
+
+	if (n == 0) {
+		return false;
+	}
+
+	buf[n] = '\0';
+	char* end;
+
+	if (integral) {
+		long l = strtol (buf, &end, 10);
+		if (*end == '\0' && l >= std::numeric_limits<int>::min () && l <= std::numeric_limits<int>::max ()) {
+			v = TypedValue (static_cast<int> (l));
+			return true;
+		}
+	}
+
+	double d = g_ascii_strtod (buf, &end);
+	if (*end != '\0') {
+		return false;
+	}
+
+	if (d >= JSON_INF) {
+		d = std::numeric_limits<double>::infinity ();
+	} else if (d <= -JSON_INF) {
+		d = -std::numeric_limits<double>::infinity ();
+	}
+
+	v = TypedValue (d);
+	return true;
 }
 
-NodeStateMessage::NodeStateMessage (void* buf, size_t len)
-    : _valid (false)
-    , _write (false)
+bool
+JSONReader::read_value (TypedValue& v)
 {
-	try {
-		std::string s (static_cast<char*> (buf), len);
+	skip_ws ();
 
-		std::istringstream is (s);
-		pt::ptree          root;
-		pt::read_json (is, root);
+	if (_p == _end) {
+		return false;
+	}
 
-		_state = NodeState (root.get<std::string> ("node"));
+	switch (*_p) {
+		case '"': {
+			std::string s;
+			if (!read_string (s)) {
+				return false;
+			}
+			v = TypedValue (s);
+			return true;
+		}
+		case 't':
+			v = TypedValue (true);
+			return read_literal ("true");
+		case 'f':
+			v = TypedValue (false);
+			return read_literal ("false");
+		case 'n':
+			v = TypedValue ();
+			return read_literal ("null");
+		default:
+			return read_number (v);
+	}
+}
 
-		pt::ptree addr = root.get_child ("addr", pt::ptree ());
+bool
+JSONReader::skip_value ()
+{
+	if (expect ('[')) {
+		if (expect (']')) {
+			return true;
+		}
+		do {
+			if (!skip_value ()) {
+				return false;
+			}
+		} while (expect (','));
+		return expect (']');
+	}
 
-		for (pt::ptree::iterator it = addr.begin (); it != addr.end (); ++it) {
-			// throws if datatype not uint32_t
-			_state.add_addr (boost::lexical_cast<uint32_t> (it->second.data ()));
+	if (expect ('{')) {
+		if (expect ('}')) {
+			return true;
 		}
+		do {
+			std::string key;
+			if (!read_string (key) || !expect (':') || !skip_value ()) {
+				return false;
+			}
+		} while (expect (','));
+		return expect ('}');
+	}
 
-		pt::ptree val = root.get_child ("val", pt::ptree ());
+	TypedValue v;
+	return read_value (v);
+}
+
+/* {"node":"...","addr":[...],"val":[...]}, unknown keys are ignored */
+bool
+read_node_state (JSONReader& r, NodeState& state)
+{
+	bool has_node = false;
+
+	if (!r.expect ('{')) {
+		return false;
+	}
+
+	if (r.expect ('}')) {
+		return false;
+	}
 
-		for (pt::ptree::iterator it = val.begin (); it != val.end (); ++it) {
-			std::string val = it->second.data ();
+	std::string key;
 
-			try {
-				_state.add_val (boost::lexical_cast<int> (val));
-			} catch (const boost::bad_lexical_cast&) {
-				try {
-					double d = boost::lexical_cast<double> (val);
-					if (d >= JSON_INF) {
-						d = std::numeric_limits<double>::infinity ();
-					} else if (d <= -JSON_INF) {
-						d = -std::numeric_limits<double>::infinity ();
+	do {
+		if (!r.read_string (key) || !r.expect (':')) {
+			return false;
+		}
+
+		if (key == "node") {
+			std::string node;
+			if (!r.read_string (node)) {
+				return false;
+			}
+			NodeState s (node);
+			for (int i = 0; i < state.n_addr (); ++i) {
+				s.add_addr (state.nth_addr (i));
+			}
+			for (int i = 0; i < state.n_val (); ++i) {
+				s.add_val (state.nth_val (i));
+			}
+			state    = s;
+			has_node = true;
+		} else if (key == "addr") {
+			if (!r.expect ('[')) {
+				return false;
+			}
+			if (!r.expect (']')) {
+				do {
+					TypedValue v;
+					if (!r.read_value (v) || v.type () != TypedValue::Int || static_cast<int> (v) < 0) {
+						return false;
 					}
-					_state.add_val (d);
-				} catch (const boost::bad_lexical_cast&) {
-					if (val == "false") {
-						_state.add_val (false);
-					} else if (val == "true") {
-						_state.add_val (true);
-					} else {
-						_state.add_val (val);
+					state.add_addr (static_cast<uint32_t> (static_cast<int> (v)));
+				} while (r.expect (','));
+				if (!r.expect (']')) {
+					return false;
+				}
+			}
+		} else if (key == "val") {
+			if (!r.expect ('[')) {
+				return false;
+			}
+			if (!r.expect (']')) {
+				do {
+					TypedValue v;
+					if (!r.read_value (v)) {
+						return false;
 					}
+					state.add_val (v);
+				} while (r.expect (','));
+				if (!r.expect (']')) {
+					return false;
 				}
 			}
+		} else if (!r.skip_value ()) {
+			return false;
 		}
+	} while (r.expect (','));
+
+	return r.expect ('}') && has_node;
+}
+
+} // namespace
+
+NodeStateMessage::NodeStateMessage (const NodeState& state)
+    : _valid (true)
+    , _state (state)
+{
+	_write = state.n_val () > 0;
+}
+
+bool
+NodeStateMessage::parse (const void* buf, size_t len, std::vector<NodeStateMessage>& msgs)
+{
+	JSONReader r (static_cast<const char*> (buf), len);
 
-		if (_state.n_val () > 0) {
-			_write = true;
+	if (!r.expect ('[')) {
+		NodeState state;
+		if (!read_node_state (r, state) || !r.at_end ()) {
+			return false;
 		}
+		msgs.push_back (NodeStateMessage (state));
+		return true;
+	}
 
-		_valid = true;
+	if (!r.expect (']')) {
+		do {
+			NodeState state;
+			if (!read_node_state (r, state)) {
+				return false;
+			}
+			msgs.push_back (NodeStateMessage (state));
+		} while (r.expect (','));
 
-	} catch (const std::exception& exc) {
-#ifndef NDEBUG
-		std::cerr << "cannot parse message - " << exc.what () << std::endl;
-#endif
+		if (!r.expect (']')) {
+			return false;
+		}
 	}
+
+	return r.at_end ();
 }
 
-size_t
-NodeStateMessage::serialize (void* buf, size_t len) const
+void
+NodeStateMessage::serialize (std::string& out) const
 {
 	// boost json writes all values as strings, we do not want that
 
-	if (len == 0) {
-		return -1;
-	}
-
-	std::stringstream ss;
+	char buf[G_ASCII_DTOSTR_BUF_SIZE];
 
-	ss << "{\"node\":\"" << _state.node () << "\"";
+	out += "{\"node\":\"";
+	out += _state.node ();
+	out += '"';
 
 	int n_addr = _state.n_addr ();
 
 	if (n_addr > 0) {
-		ss << ",\"addr\":[";
+		out += ",\"addr\":[";
 
 		for (int i = 0; i < n_addr; i++) {
 			if (i > 0) {
-				ss << ',';
+				out += ',';
 			}
 
-			ss << _state.nth_addr (i);
+			snprintf (buf, sizeof (buf), "%u", _state.nth_addr (i));
+			out += buf;
 		}
 
-		ss << "]";
+		out += ']';
 	}
 
 	int n_val = _state.n_val ();
 
 	if (n_val > 0) {
-		ss << ",\"val\":[";
+		out += ",\"val\":[";
 
 		for (int i = 0; i < n_val; i++) {
 			if (i > 0) {
-				ss << ',';
+				out += ',';
 			}
 
 			TypedValue val = _state.nth_val (i);
 
 			switch (val.type ()) {
 				case TypedValue::Empty:
-					ss << "null";
+					out += "null";
 					break;
 				case TypedValue::Bool:
-					ss << (static_cast<bool> (val) ? "true" : "false");
+					out += static_cast<bool> (val) ? "true" : "false";
 					break;
 				case TypedValue::Int:
-					ss << static_cast<int> (val);
+					snprintf (buf, sizeof (buf), "%d", static_cast<int> (val));
+					out += buf;
 					break;
 				case TypedValue::Double: {
 					double d = static_cast<double> (val);
 					if (d == std::numeric_limits<double>::infinity ()) {
-						ss << JSON_INF_STR;
+						out += JSON_INF_STR;
 					} else if (d == -std::numeric_limits<double>::infinity ()) {
-						ss << "-" JSON_INF_STR;
+						out += "-" JSON_INF_STR;
 					} else {
-						ss << d;
+						/* locale independent */
+						out += g_ascii_formatd (buf, sizeof (buf), "%g", d);
 					}
 					break;
 				}
 				case TypedValue::String:
-					ss << '"' << WebSocketsJSON::escape (static_cast<std::string> (val)) << '"';
+					out += '"';
+					out += WebSocketsJSON::escape (static_cast<std::string> (val));
+					out += '"';
 					break;
 				default:
 					break;
 			}
 		}
 
-		ss << "]";
+		out += ']';
 	}
 
-	ss << '}';
-
-	std::string s     = ss.str ();
-	const char* cs    = s.c_str ();
-	size_t      cs_sz = strlen (cs);
-
-	if (len < cs_sz) {
-		return -1;
-	}
-
-	memcpy (buf, cs, cs_sz);
-
-	return cs_sz;
+	out += '}';
 }
@@ -19,6 +19,9 @@
 #ifndef _ardour_surface_websockets_message_h_
 #define _ardour_surface_websockets_message_h_
 
+#include <string>
+#include <vector>
+
 #include "state.h"
 
 namespace ArdourSurface {
@@ -27,9 +30,13 @@ class NodeStateMessage
 {
 public:
 	NodeStateMessage (const NodeState& state);
-	NodeStateMessage (void*, size_t);
 
-	size_t serialize (void*, size_t) const;
+	/* parse a single message or a batch (JSON array of messages),
+	 * returns false if the text is not valid */
+	static bool parse (const void*, size_t, std::vector<NodeStateMessage>&);
+
+	/* append the JSON representation */
+	void serialize (std::string&) const;
 
 	bool is_valid () const
 	{
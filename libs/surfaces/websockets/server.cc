@@ -20,6 +20,8 @@
 #include <iostream>
 #endif
 
+#include <cstring>
+
 #include "dispatcher.h"
 #include "server.h"
 
@@ -194,7 +196,7 @@ WebsocketsServer::update_client (Client wsi, const NodeState& state, bool force)
 	if (force || !it->second.has_state (state)) {
 		/* write to client only if state was updated */
 		it->second.update_state (state);
-		it->second.output_buf ().push_back (NodeStateMessage (state));
+		it->second.queue_output (state);
 		lws_callback_on_writable (wsi);
 	}
 }
@@ -230,28 +232,45 @@ WebsocketsServer::del_client (Client wsi)
 int
 WebsocketsServer::recv_client (Client wsi, void* buf, size_t len)
 {
-	NodeStateMessage msg (buf, len);
-	if (!msg.is_valid ()) {
-		return 1;
-	}
-
+	std::vector<NodeStateMessage> msgs;
+	if (!NodeStateMessage::parse (buf, len, msgs)) {
 #ifndef NDEBUG
-	std::cerr << "RX " << msg.state ().debug_str () << std::endl;
+		std::cerr << "cannot parse message" << std::endl;
 #endif
+		return 1;
+	}
 
 	ClientContextMap::iterator it = _client_ctx.find (wsi);
 	if (it == _client_ctx.end ()) {
 		return 1;
 	}
 
-	/* avoid echo */
-	it->second.update_state (msg.state ());
+	for (std::vector<NodeStateMessage>::const_iterator msg = msgs.begin (); msg != msgs.end (); ++msg) {
+#ifndef NDEBUG
+		std::cerr << "RX " << msg->state ().debug_str () << std::endl;
+#endif
+		if (msg->state ().node () == Node::protocol) {
+			it->second.set_options (msg->state ());
+			continue;
+		}
+
+		/* avoid echo */
+		it->second.update_state (msg->state ());
 
-	dispatcher ().dispatch (wsi, msg);
+		dispatcher ().dispatch (wsi, *msg);
+	}
 
 	return 0;
 }
 
+static void
+append_le32 (std::string& s, uint32_t v)
+{
+	for (int i = 0; i < 4; ++i) {
+		s += static_cast<char> ((v >> (8 * i)) & 0xff);
+	}
+}
+
 int
 WebsocketsServer::write_client (Client wsi)
 {
@@ -260,31 +279,70 @@ WebsocketsServer::write_client (Client wsi)
 		return 1;
 	}
 
-	ClientOutputBuffer& pending = it->second.output_buf ();
-	if (pending.empty ()) {
+	ClientContext& ctx = it->second;
+
+	ClientOutputBuffer&      pending = ctx.output_buf ();
+	ClientContext::MeterMap& meters  = ctx.pending_meters ();
+
+	if (pending.empty () && meters.empty ()) {
 		return 0;
 	}
 
 	/* one lws_write() call per LWS_CALLBACK_SERVER_WRITEABLE callback */
 
-	NodeStateMessage msg = pending.front ();
-	pending.pop_front ();
-
-	unsigned char out_buf[1024];
-	int len = msg.serialize (out_buf + LWS_PRE, 1024 - LWS_PRE);
-
-	if (len > 0) {
+	std::string& frame = ctx.frame ();
+	frame.assign (LWS_PRE, '\0');
+
+	enum lws_write_protocol mode = LWS_WRITE_TEXT;
+
+	if (!meters.empty ()) {
+		/* binary strip meters, all values little-endian:
+		 * uint8_t type (1), 3 bytes padding, then for each strip
+		 * uint32_t strip id, float32 level [dBFS] */
+		frame += static_cast<char> (1);
+		frame.append (3, '\0');
+		for (ClientContext::MeterMap::const_iterator m = meters.begin (); m != meters.end (); ++m) {
+			uint32_t level;
+			memcpy (&level, &m->second, sizeof (level));
+			append_le32 (frame, m->first);
+			append_le32 (frame, level);
+		}
+		meters.clear ();
+		mode = LWS_WRITE_BINARY;
+	} else if (!ctx.batch ()) {
 #ifndef NDEBUG
-		std::cerr << "TX " << msg.state ().debug_str () << std::endl;
+		std::cerr << "TX " << pending.front ().state ().debug_str () << std::endl;
 #endif
-		if (lws_write (wsi, out_buf + LWS_PRE, len, LWS_WRITE_TEXT) != len) {
-			return 1;
-		}
+		pending.front ().serialize (frame);
+		ctx.pop_output ();
 	} else {
-		PBD::error << "ArdourWebsockets: cannot serialize message" << endmsg;
+		/* as many states as fit into one frame, but at least one */
+		frame += '[';
+		while (!pending.empty ()) {
+			const size_t mark = frame.size ();
+			if (mark > LWS_PRE + 1) {
+				frame += ',';
+			}
+			pending.front ().serialize (frame);
+			if (mark > LWS_PRE + 1 && frame.size () + 1 - LWS_PRE > ctx.max_frame_size ()) {
+				frame.resize (mark);
+				break;
+			}
+#ifndef NDEBUG
+			std::cerr << "TX " << pending.front ().state ().debug_str () << std::endl;
+#endif
+			ctx.pop_output ();
+		}
+		frame += ']';
+	}
+
+	const int len = frame.size () - LWS_PRE;
+
+	if (lws_write (wsi, reinterpret_cast<unsigned char*> (&frame[LWS_PRE]), len, mode) != len) {
+		return 1;
 	}
 
-	if (!pending.empty ()) {
+	if (!pending.empty () || !meters.empty ()) {
 		lws_callback_on_writable (wsi);
 	}
 
@@ -46,6 +46,7 @@ namespace Node
 	const std::string transport_time                 = "transport_time";
 	const std::string transport_roll                 = "transport_roll";
 	const std::string transport_record               = "transport_record";
+	const std::string protocol                       = "protocol";
 } // namespace Node
 
 typedef std::vector<uint32_t>   AddressVector;
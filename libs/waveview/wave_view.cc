@@ -49,6 +49,7 @@
 
 #include "waveview/wave_view.h"
 #include "waveview/wave_view_private.h"
+#include "waveview/wave_view_raster.h"
 
 #ifdef __APPLE__
 #define Rect ArdourCanvas::Rect
@@ -460,15 +461,19 @@ WaveView::draw_absent_image (Cairo::RefPtr<Cairo::ImageSurface>& image, PeakData
 	context->fill ();
 }
 
-struct ImageSet {
-	Cairo::RefPtr<Cairo::ImageSurface> wave;
-	Cairo::RefPtr<Cairo::ImageSurface> outline;
-	Cairo::RefPtr<Cairo::ImageSurface> clip;
-	Cairo::RefPtr<Cairo::ImageSurface> zero;
+static void
+composite_mask (Cairo::RefPtr<Cairo::Context> context, WaveViewRaster const& raster, WaveViewRaster::Mask m)
+{
+	if (raster.empty (m)) {
+		return;
+	}
 
-	ImageSet() :
-		wave (0), outline (0), clip (0), zero (0) {}
-};
+	Cairo::RefPtr<Cairo::ImageSurface> mask = Cairo::ImageSurface::create (Cairo::FORMAT_A8, raster.width (), raster.height ());
+	raster.render (m, mask);
+
+	context->mask (mask, 0, 0);
+	context->fill ();
+}
 
 void
 WaveView::draw_image (Cairo::RefPtr<Cairo::ImageSurface>& image, PeakData* peaks, int n_peaks,
@@ -476,22 +481,6 @@ WaveView::draw_image (Cairo::RefPtr<Cairo::ImageSurface>& image, PeakData* peaks
 {
 	const double height = image->get_height();
 
-	ImageSet images;
-
-	images.wave = Cairo::ImageSurface::create (Cairo::FORMAT_A8, n_peaks, height);
-	images.outline = Cairo::ImageSurface::create (Cairo::FORMAT_A8, n_peaks, height);
-	images.clip = Cairo::ImageSurface::create (Cairo::FORMAT_A8, n_peaks, height);
-	images.zero = Cairo::ImageSurface::create (Cairo::FORMAT_A8, n_peaks, height);
-
-	Cairo::RefPtr<Cairo::Context> wave_context = Cairo::Context::create (images.wave);
-	Cairo::RefPtr<Cairo::Context> outline_context = Cairo::Context::create (images.outline);
-	Cairo::RefPtr<Cairo::Context> clip_context = Cairo::Context::create (images.clip);
-	Cairo::RefPtr<Cairo::Context> zero_context = Cairo::Context::create (images.zero);
-	wave_context->set_antialias (Cairo::ANTIALIAS_NONE);
-	outline_context->set_antialias (Cairo::ANTIALIAS_NONE);
-	clip_context->set_antialias (Cairo::ANTIALIAS_NONE);
-	zero_context->set_antialias (Cairo::ANTIALIAS_NONE);
-
 	boost::scoped_array<LineTips> tips (new LineTips[n_peaks]);
 
 	/* Clip level nominally set to -0.9dBFS to account for inter-sample
@@ -602,26 +591,11 @@ WaveView::draw_image (Cairo::RefPtr<Cairo::ImageSurface>& image, PeakData* peaks
 		return;
 	}
 
-	Color alpha_one = rgba_to_color (0, 0, 0, 1.0);
-
-	set_source_rgba (wave_context, alpha_one);
-	set_source_rgba (outline_context, alpha_one);
-	set_source_rgba (clip_context, alpha_one);
-	set_source_rgba (zero_context, alpha_one);
+	/* the masks are rasterized directly, using the same single-pixel
+	 * lines that cairo would stroke */
+	WaveViewRaster raster (n_peaks, height);
 
-	/* ensure single-pixel lines */
-
-	wave_context->set_line_width (1.0);
-	wave_context->translate (0.5, 0.5);
-
-	outline_context->set_line_width (1.0);
-	outline_context->translate (0.5, 0.5);
-
-	clip_context->set_line_width (1.0);
-	clip_context->translate (0.5, 0.5);
-
-	zero_context->set_line_width (1.0);
-	zero_context->translate (0.5, 0.5);
+	typedef WaveViewRaster R;
 
 	/* the height of the clip-indicator should be at most 7 pixels,
 	 * or 5% of the height of the waveview item.
@@ -635,7 +609,7 @@ WaveView::draw_image (Cairo::RefPtr<Cairo::ImageSurface>& image, PeakData* peaks
 	   pixel. This makes the rendering less efficient but it is the only
 	   way I can see to do this correctly.
 
-	   To avoid constant source swapping and stroking, we draw the components separately
+	   To avoid constant source swapping, we draw the components separately
 	   onto four alpha only image surfaces for use as a mask.
 
 	   With only 1 pixel of spread between the top and bottom of the line,
@@ -661,27 +635,20 @@ WaveView::draw_image (Cairo::RefPtr<Cairo::ImageSurface>& image, PeakData* peaks
 			/* waveform line */
 
 			if (tips[i].spread >= 1.0) {
-				wave_context->move_to (i, tips[i].top);
-				wave_context->line_to (i, tips[i].bot);
+				raster.vline (R::Wave, i, tips[i].top, tips[i].bot);
 			}
 
 			/* clip indicator */
 
 			if (_global_show_waveform_clipping && (tips[i].clip_max || tips[i].clip_min)) {
-				clip_context->move_to (i, tips[i].top);
 				/* clip-indicating upper terminal line */
-				clip_context->rel_line_to (0, min (clip_height, ceil(tips[i].spread + .5)));
+				raster.vline (R::Clip, i, tips[i].top, tips[i].top + min (clip_height, ceil(tips[i].spread + .5)));
 			} else {
-				outline_context->move_to (i, tips[i].top);
 				/* normal upper terminal dot */
-				outline_context->rel_line_to (0, -1.0);
+				raster.vline (R::Outline, i, tips[i].top, tips[i].top - 1.0);
 			}
 		}
 
-		wave_context->stroke ();
-		clip_context->stroke ();
-		outline_context->stroke ();
-
 	} else {
 		const int height_zero = floor(height * .5);
 
@@ -690,22 +657,17 @@ WaveView::draw_image (Cairo::RefPtr<Cairo::ImageSurface>& image, PeakData* peaks
 			/* waveform line */
 
 			if (tips[i].spread >= 2.0) {
-				wave_context->move_to (i, tips[i].top);
-				wave_context->line_to (i, tips[i].bot);
+				raster.vline (R::Wave, i, tips[i].top, tips[i].bot);
 			}
 
 			/* draw square waves and other discontiguous points clearly */
 			if (i > 0) {
 				if (tips[i-1].top + 2 < tips[i].top) {
-					wave_context->move_to (i-1, tips[i-1].top);
-					wave_context->line_to (i-1, (tips[i].bot + tips[i-1].top)/2);
-					wave_context->move_to (i, (tips[i].bot + tips[i-1].top)/2);
-					wave_context->line_to (i, tips[i].top);
+					raster.vline (R::Wave, i-1, tips[i-1].top, (tips[i].bot + tips[i-1].top)/2);
+					raster.vline (R::Wave, i, (tips[i].bot + tips[i-1].top)/2, tips[i].top);
 				} else if (tips[i-1].bot > tips[i].bot + 2) {
-					wave_context->move_to (i-1, tips[i-1].bot);
-					wave_context->line_to (i-1, (tips[i].top + tips[i-1].bot)/2);
-					wave_context->move_to (i, (tips[i].top + tips[i-1].bot)/2);
-					wave_context->line_to (i, tips[i].bot);
+					raster.vline (R::Wave, i-1, tips[i-1].bot, (tips[i].top + tips[i-1].bot)/2);
+					raster.vline (R::Wave, i, (tips[i].top + tips[i-1].bot)/2, tips[i].bot);
 				}
 			}
 
@@ -714,24 +676,21 @@ WaveView::draw_image (Cairo::RefPtr<Cairo::ImageSurface>& image, PeakData* peaks
 			bool const show_zero_line = req->image->props.show_zero;
 
 			if (show_zero_line && ((tips[i].spread >= 5.0) || (tips[i].top > height_zero ) || (tips[i].bot < height_zero)) ) {
-				zero_context->move_to (i, height_zero);
-				zero_context->rel_line_to (1.0, 0);
+				raster.dot (R::Zero, i, height_zero);
 			}
 
 			if (tips[i].spread > 1.0) {
 				bool clipped = false;
 				/* outline/clip indicators */
 				if (_global_show_waveform_clipping && tips[i].clip_max) {
-					clip_context->move_to (i, tips[i].top);
 					/* clip-indicating upper terminal line */
-					clip_context->rel_line_to (0, min (clip_height, ceil(tips[i].spread + 0.5)));
+					raster.vline (R::Clip, i, tips[i].top, tips[i].top + min (clip_height, ceil(tips[i].spread + 0.5)));
 					clipped = true;
 				}
 
 				if (_global_show_waveform_clipping && tips[i].clip_min) {
-					clip_context->move_to (i, tips[i].bot);
 					/* clip-indicating lower terminal line */
-					clip_context->rel_line_to (0, - min (clip_height, ceil(tips[i].spread + 0.5)));
+					raster.vline (R::Clip, i, tips[i].bot, tips[i].bot - min (clip_height, ceil(tips[i].spread + 0.5)));
 					clipped = true;
 				}
 
@@ -740,21 +699,18 @@ WaveView::draw_image (Cairo::RefPtr<Cairo::ImageSurface>& image, PeakData* peaks
 					   implies 3 or more pixels (so that we see 1
 					   white pixel in the middle).
 					*/
-					outline_context->move_to (i, tips[i].bot);
 					/* normal lower terminal dot; line moves up */
-					outline_context->rel_line_to (0, -1.0);
+					raster.vline (R::Outline, i, tips[i].bot, tips[i].bot - 1.0);
 
-					outline_context->move_to (i, tips[i].top);
 					/* normal upper terminal dot, line moves down */
-					outline_context->rel_line_to (0, 1.0);
+					raster.vline (R::Outline, i, tips[i].top, tips[i].top + 1.0);
 				}
 			} else {
 				bool clipped = false;
 				/* outline/clip indicator */
 				if (_global_show_waveform_clipping && (tips[i].clip_max || tips[i].clip_min)) {
-					clip_context->move_to (i, tips[i].top);
 					/* clip-indicating upper / lower terminal line */
-					clip_context->rel_line_to (0, 1.0);
+					raster.vline (R::Clip, i, tips[i].top, tips[i].top + 1.0);
 					clipped = true;
 				}
 
@@ -767,16 +723,10 @@ WaveView::draw_image (Cairo::RefPtr<Cairo::ImageSurface>& image, PeakData* peaks
 					 * that the span is 1.0 (whether it is
 					 * zero or 1.0)
 					 */
-					wave_context->move_to (i, tips[i].top);
-					wave_context->rel_line_to (0, 1.0);
+					raster.vline (R::Wave, i, tips[i].top, tips[i].top + 1.0);
 				}
 			}
 		}
-
-		wave_context->stroke ();
-		outline_context->stroke ();
-		clip_context->stroke ();
-		zero_context->stroke ();
 	}
 
 	if (req->stopped()) {
@@ -831,20 +781,16 @@ WaveView::draw_image (Cairo::RefPtr<Cairo::ImageSurface>& image, PeakData* peaks
 		return;
 	}
 
-	context->mask (images.wave, 0, 0);
-	context->fill ();
+	composite_mask (context, raster, WaveViewRaster::Wave);
 
 	set_source_rgba (context, req->image->props.outline_color);
-	context->mask (images.outline, 0, 0);
-	context->fill ();
+	composite_mask (context, raster, WaveViewRaster::Outline);
 
 	set_source_rgba (context, req->image->props.clip_color);
-	context->mask (images.clip, 0, 0);
-	context->fill ();
+	composite_mask (context, raster, WaveViewRaster::Clip);
 
 	set_source_rgba (context, req->image->props.zero_color);
-	context->mask (images.zero, 0, 0);
-	context->fill ();
+	composite_mask (context, raster, WaveViewRaster::Zero);
 }
 
 samplecnt_t
@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#include <cairomm/surface.h>
+
+#include "waveview/wave_view_raster.h"
+
+using namespace ArdourWaveView;
+
+WaveViewRaster::WaveViewRaster (int width, int height)
+	: _width (std::max (0, width))
+	, _height (std::max (0, height))
+{
+	for (int m = 0; m < NumMasks; ++m) {
+		_spans[m].count.resize (_width, 0);
+	}
+}
+
+void
+WaveViewRaster::vline (Mask m, int x, double y0, double y1)
+{
+	if (x < 0 || x >= _width) {
+		return;
+	}
+
+	/* A 1px stroke at x + .5 covers [x, x + 1], and its end-points at
+	 * y + .5 are rounded to the nearest pixel boundary, half-way cases
+	 * rounding down. For a given y that is the same as ceil (y).
+	 */
+	int32_t s = (int32_t) ceil (std::min (y0, y1));
+	int32_t e = (int32_t) ceil (std::max (y0, y1));
+
+	s = std::max (s, (int32_t) 0);
+	e = std::min (e, (int32_t) _height);
+
+	if (s >= e) {
+		return;
+	}
+
+	Spans& sp (_spans[m]);
+	const int k = sp.count[x];
+
+	if (k == max_spans) {
+		/* should not happen, merge into the last span */
+		assert (0);
+		sp.start[k - 1][x] = std::min (sp.start[k - 1][x], s);
+		sp.end[k - 1][x]   = std::max (sp.end[k - 1][x], e);
+	} else {
+		if (k == sp.used) {
+			/* allocate on demand, most masks only need a single span */
+			sp.start[k].resize (_width, 0);
+			sp.end[k].resize (_width, 0);
+			++sp.used;
+		}
+		sp.start[k][x] = s;
+		sp.end[k][x]   = e;
+		++sp.count[x];
+	}
+
+	if (sp.ymin == sp.ymax) {
+		sp.ymin = s;
+		sp.ymax = e;
+	} else {
+		sp.ymin = std::min (sp.ymin, s);
+		sp.ymax = std::max (sp.ymax, e);
+	}
+}
+
+static void
+fill_row (uint8_t* __restrict row, int32_t const* __restrict start, int32_t const* __restrict end, int32_t y, int n)
+{
+	/* branch-free, so that this can be vectorized */
+	for (int x = 0; x < n; ++x) {
+		row[x] |= (uint8_t) -(int32_t)((start[x] <= y) & (y < end[x]));
+	}
+}
+
+void
+WaveViewRaster::render (Mask m, Cairo::RefPtr<Cairo::ImageSurface> surface) const
+{
+	Spans const& sp (_spans[m]);
+
+	if (sp.used == 0) {
+		return;
+	}
+
+	assert (surface->get_format () == Cairo::FORMAT_A8);
+
+	surface->flush ();
+
+	unsigned char* data = surface->get_data ();
+	const int stride    = surface->get_stride ();
+	const int n         = std::min (_width, surface->get_width ());
+	const int32_t ymax  = std::min (sp.ymax, (int32_t) surface->get_height ());
+
+	for (int32_t y = sp.ymin; y < ymax; ++y) {
+		uint8_t* row = data + y * stride;
+		for (int k = 0; k < sp.used; ++k) {
+			fill_row (row, &sp.start[k][0], &sp.end[k][0], y, n);
+		}
+	}
+
+	surface->mark_dirty ();
+}
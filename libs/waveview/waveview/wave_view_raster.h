@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _WAVEVIEW_WAVE_VIEW_RASTER_H_
+#define _WAVEVIEW_WAVE_VIEW_RASTER_H_
+
+#include <stdint.h>
+#include <vector>
+
+#include <cairomm/refptr.h>
+
+#include "waveview/visibility.h"
+
+namespace Cairo {
+	class ImageSurface;
+}
+
+namespace ArdourWaveView {
+
+/** Rasterizer for the alpha masks of a WaveView image.
+ *
+ * A waveform image consists of 1px wide vertical lines, one or more per
+ * pixel column. Rather than stroking each of them with cairo, the lines are
+ * collected as per-column spans, and the A8 masks are filled row by row.
+ * The inner loop runs over contiguous columns and is vectorized by the
+ * compiler. Cairo is only used to composite the masks.
+ *
+ * The result is identical to stroking the same lines with a line-width of 1,
+ * ANTIALIAS_NONE and butt caps on a context that is translated by (.5, .5).
+ */
+class LIBWAVEVIEW_API WaveViewRaster
+{
+public:
+	enum Mask {
+		Wave = 0,
+		Outline,
+		Clip,
+		Zero,
+		NumMasks
+	};
+
+	WaveViewRaster (int width, int height);
+
+	/** Add a vertical line to column \p x, from \p y0 to \p y1.
+	 * This is equivalent to move_to (x, y0), line_to (x, y1).
+	 */
+	void vline (Mask m, int x, double y0, double y1);
+
+	/** Set the pixel at \p x, \p y */
+	void dot (Mask m, int x, int y) {
+		vline (m, x, y, y + 1);
+	}
+
+	/** @return true if nothing was added to the given mask */
+	bool empty (Mask m) const {
+		return _spans[m].used == 0;
+	}
+
+	/** Fill the given mask into an A8 surface of the same size. Pixels are
+	 * only ever set, so the surface is expected to be clear.
+	 */
+	void render (Mask m, Cairo::RefPtr<Cairo::ImageSurface>) const;
+
+	int width () const { return _width; }
+	int height () const { return _height; }
+
+	/* per column: the main line, and discontinuity lines to and from
+	 * the neighbouring columns */
+	static const int max_spans = 3;
+
+private:
+	struct Spans {
+		Spans () : used (0), ymin (0), ymax (0) {}
+
+		std::vector<int32_t> start[max_spans];
+		std::vector<int32_t> end[max_spans];
+		std::vector<uint8_t> count;
+
+		int     used;
+		int32_t ymin;
+		int32_t ymax;
+	};
+
+	int   _width;
+	int   _height;
+	Spans _spans[NumMasks];
+};
+
+} /* namespace */
+
+#endif
@@ -0,0 +1,338 @@
+// ----------------------------------------------------------------------------
+//
+//  Copyright (C) 2006-2013 Fons Adriaensen <fons@linuxaudio.org>
+//  Copyright (C) 2026 agent <agent@local>
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// ----------------------------------------------------------------------------
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+
+#include "zita-resampler/vmcresampler.h"
+
+using namespace ArdourZita;
+
+VMCResampler::VMCResampler (void)
+	: inp_list (0)
+	, out_list (0)
+	, _table (0)
+	, _nchan (0)
+	, _buff  (0)
+	, _c1 (0)
+	, _c2 (0)
+	, _acc (0)
+{
+	reset ();
+}
+
+VMCResampler::~VMCResampler (void)
+{
+	clear ();
+}
+
+int
+VMCResampler::setup (unsigned int hlen, unsigned int nchan)
+{
+	if ((hlen < 8) || (hlen > 96)) return 1;
+	return setup (hlen, nchan, 1.0 - 2.6 / hlen);
+}
+
+int
+VMCResampler::setup (unsigned int hlen, unsigned int nchan, double frel)
+{
+	unsigned int       h, k, n;
+	double             s;
+	Resampler_table    *T = 0;
+
+	if (!nchan) return 1;
+
+	n = NPHASE;
+	s = n;
+	h = hlen;
+	k = 250;
+	T = Resampler_table::create (frel, h, n);
+	clear ();
+	if (T) {
+		_table = T;
+		_nchan = nchan;
+		_buff  = new float [(2 * h - 1 + k) * nchan];
+		_c1 = new float [2 * h];
+		_c2 = new float [2 * h];
+		_acc = new float [nchan];
+		_inmax = k;
+		_pstep = s;
+		_qstep = s;
+		_wstep = 1;
+		return reset ();
+	}
+	else return 1;
+}
+
+void
+VMCResampler::clear (void)
+{
+	Resampler_table::destroy (_table);
+	delete[] _buff;
+	delete[] _c1;
+	delete[] _c2;
+	delete[] _acc;
+	_buff  = 0;
+	_c1 = 0;
+	_c2 = 0;
+	_acc = 0;
+	_table = 0;
+	_nchan = 0;
+	_inmax = 0;
+	_pstep = 0;
+	_qstep = 0;
+	_wstep = 1;
+	reset ();
+}
+
+void
+VMCResampler::set_phase (double p)
+{
+	if (!_table) return;
+	_phase = (p - floor (p)) * _table->_np;
+}
+
+void
+VMCResampler::set_rrfilt (double t)
+{
+	if (!_table) return;
+	_wstep =  (t < 1) ? 1 : 1 - exp (-1 / t);
+}
+
+double
+VMCResampler::set_rratio (double r)
+{
+	if (!_table) return 0;
+	if (r > 16.0) r = 16.0;
+	if (r < 0.02) r = 0.02;
+
+	_qstep = _table->_np / r;
+
+	if (_qstep < 4.) {
+		_qstep = 4.;
+	}
+	if (_qstep > 2. * _table->_np * _table->_hl) {
+		_qstep = 2. * _table->_np * _table->_hl;
+	}
+	return _table->_np / _qstep;
+}
+
+double
+VMCResampler::inpdist (void) const
+{
+	if (!_table) return 0;
+	return (int)(_table->_hl + 1 - _nread) - _phase / _table->_np;
+}
+
+int
+VMCResampler::inpsize (void) const
+{
+	if (!_table) return 0;
+	return 2 * _table->_hl;
+}
+
+int
+VMCResampler::reset (void)
+{
+	if (!_table) return 1;
+
+	inp_count = 0;
+	out_count = 0;
+	_index = 0;
+	_phase = 0;
+	_nread = 2 * _table->_hl;
+
+	memset (_buff, 0, sizeof(float) * (_nread + 249) * _nchan);
+	_nread -= _table->_hl - 1;
+	return 0;
+}
+
+void
+VMCResampler::reset_channel (unsigned int c)
+{
+	if (!_table || c >= _nchan) return;
+	const unsigned int nf = 2 * _table->_hl - 1 + _inmax;
+	for (unsigned int i = 0; i < nf; ++i) {
+		_buff[i * _nchan + c] = 0;
+	}
+}
+
+bool
+VMCResampler::copy_state (VMCResampler const& other)
+{
+	if (!_table || !other._table || _table->_hl != other._table->_hl) {
+		return false;
+	}
+	_index = other._index;
+	_nread = other._nread;
+	_phase = other._phase;
+	_pstep = other._pstep;
+	_qstep = other._qstep;
+	_wstep = other._wstep;
+	return true;
+}
+
+bool
+VMCResampler::copy_channel (unsigned int c, VMCResampler const& other, unsigned int oc)
+{
+	if (!_table || !other._table || _table->_hl != other._table->_hl) {
+		return false;
+	}
+	if (c >= _nchan || oc >= other._nchan) {
+		return false;
+	}
+	const unsigned int nf = 2 * _table->_hl - 1 + _inmax;
+	for (unsigned int i = 0; i < nf; ++i) {
+		_buff[i * _nchan + c] = other._buff[i * other._nchan + oc];
+	}
+	return true;
+}
+
+int
+VMCResampler::process (void)
+{
+	unsigned int   in, nr, n, ip, op;
+	double         ph, dp;
+	float          *p1, *p2;
+
+	if (!_table) return 1;
+
+	const int hl = _table->_hl;
+	const unsigned int np = _table->_np;
+	const unsigned int nc = _nchan;
+	in = _index;
+	nr = _nread;
+	ph = _phase;
+	dp = _pstep;
+	n = 2 * hl - nr;
+	ip = 0;
+	op = 0;
+
+#if 1
+	/* optimized full-cycle no-resampling */
+	if (dp == np && _qstep == np && nr == 1 && inp_count == out_count && out_count >= n) {
+		const unsigned int h1 = hl - 1;
+		const unsigned int head = out_count - h1;
+		const unsigned int tail = out_count - n;
+
+		for (unsigned int c = 0; c < nc; ++c) {
+			float const* src = inp_list[c];
+			float*       dst = out_list[c];
+			float const* b   = &_buff[(in + hl) * nc + c];
+			for (unsigned int i = 0; i < h1; ++i) {
+				dst[i] = b[i * nc];
+			}
+			memcpy (&dst[h1], src, head * sizeof (float));
+		}
+		for (unsigned int i = 0; i < n; ++i) {
+			float* b = &_buff[i * nc];
+			for (unsigned int c = 0; c < nc; ++c) {
+				b[c] = inp_list[c][tail + i];
+			}
+		}
+		_index = 0;
+		inp_count = 0;
+		out_count = 0;
+		return 0;
+	}
+#endif
+
+	p1 = _buff + in * nc;
+	p2 = p1 + n * nc;
+
+	while (out_count) {
+		if (nr) {
+			if (inp_count == 0) break;
+			for (unsigned int c = 0; c < nc; ++c) {
+				p2[c] = inp_list[c][ip];
+			}
+			++ip;
+			nr--;
+			p2 += nc;
+			inp_count--;
+		} else {
+			if (dp == np) {
+				float const* b = p1 + hl * nc;
+				for (unsigned int c = 0; c < nc; ++c) {
+					out_list[c][op] = b[c];
+				}
+			} else {
+				const unsigned int k = (unsigned int) ph;
+				const float bb = (float)(ph - k);
+				const float aa = 1.0f - bb;
+				float const* cq1 = _table->_ctab + hl * k;
+				float const* cq2 = _table->_ctab + hl * (np - k);
+				for (int i = 0; i < hl; i++) {
+					_c1 [i] = aa * cq1 [i] + bb * cq1 [i + hl];
+					_c2 [i] = aa * cq2 [i] + bb * cq2 [i - hl];
+				}
+
+				for (unsigned int c = 0; c < nc; ++c) {
+					_acc[c] = 1e-25f;
+				}
+				for (int i = 0; i < hl; i++) {
+					const float c1 = _c1[i];
+					const float c2 = _c2[i];
+					float const* q1 = p1 + i * nc;
+					float const* q2 = p2 - (i + 1) * nc;
+					for (unsigned int c = 0; c < nc; ++c) {
+						_acc[c] += q1[c] * c1 + q2[c] * c2;
+					}
+				}
+				for (unsigned int c = 0; c < nc; ++c) {
+					out_list[c][op] = _acc[c] - 1e-25f;
+				}
+			}
+			++op;
+			out_count--;
+
+			const double dd = _qstep - dp;
+			if (fabs (dd) < 1e-12) {
+				dp = _qstep;
+			} else {
+				dp += _wstep * dd;
+			}
+			ph += dp;
+
+			if (ph >= np) {
+				nr = (unsigned int) floor (ph / np);
+				ph -= nr * np;
+				in += nr;
+				p1 += nr * nc;
+				if (in >= _inmax) {
+					n = (2 * hl - nr);
+					memcpy (_buff, p1, n * nc * sizeof (float));
+					in = 0;
+					p1 = _buff;
+					p2 = p1 + n * nc;
+				}
+			}
+		}
+	}
+	_index = in;
+	_nread = nr;
+	_phase = ph;
+	_pstep = dp;
+
+	return 0;
+}
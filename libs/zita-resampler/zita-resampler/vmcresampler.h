@@ -0,0 +1,94 @@
+// ----------------------------------------------------------------------------
+//
+//  Copyright (C) 2006-2012 Fons Adriaensen <fons@linuxaudio.org>
+//  Copyright (C) 2026 agent <agent@local>
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+// ----------------------------------------------------------------------------
+
+
+#ifndef _ZITA_VMCRESAMPLER_H_
+#define _ZITA_VMCRESAMPLER_H_
+
+#include "zita-resampler/zresampler_visibility.h"
+#include "zita-resampler/resampler-table.h"
+
+namespace ArdourZita {
+
+/* Multi-channel variant of VMResampler.
+ *
+ * All channels share a single ratio and phase. The filter coefficients
+ * are interpolated once per output sample, and the history of all channels
+ * is stored interleaved, so that the inner loop of the filter runs across
+ * channels and can be vectorized by the compiler.
+ *
+ * Input and output are non-interleaved: inp_list and out_list point to
+ * an array of nchan buffers each. Unlike VMResampler::process(), the
+ * buffer pointers are not modified; inp_count and out_count are decremented
+ * by the number of samples that were consumed and produced, respectively.
+ */
+class LIBZRESAMPLER_API VMCResampler
+{
+public:
+	VMCResampler (void);
+	~VMCResampler (void);
+
+	int  setup (unsigned int hlen, unsigned int nchan);
+	int  setup (unsigned int hlen, unsigned int nchan, double frel);
+
+	void   clear (void);
+	int    reset (void);
+	void   reset_channel (unsigned int c);
+	int    nchan (void) const { return _nchan; }
+	int    inpsize (void) const;
+	double inpdist (void) const;
+	int    process (void);
+
+	void   set_phase (double p);
+	void   set_rrfilt (double t);
+	double set_rratio (double r);
+
+	/* copy the history of channel \p c of \p other to channel \p c of this
+	 * resampler. Both must have been set up using the same filter length */
+	bool   copy_channel (unsigned int c, VMCResampler const& other, unsigned int oc);
+	/* copy phase, ratio and position, but not the history */
+	bool   copy_state (VMCResampler const& other);
+
+	unsigned int         inp_count;
+	unsigned int         out_count;
+	float const* const  *inp_list;
+	float* const        *out_list;
+
+private:
+	enum { NPHASE = 256 };
+
+	Resampler_table     *_table;
+	unsigned int         _nchan;
+	unsigned int         _inmax;
+	unsigned int         _index;
+	unsigned int         _nread;
+	double               _phase;
+	double               _pstep;
+	double               _qstep;
+	double               _wstep;
+	float               *_buff;
+	float               *_c1;
+	float               *_c2;
+	float               *_acc;
+};
+
+};
+
+#endif
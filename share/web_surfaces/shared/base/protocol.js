@@ -31,9 +31,13 @@ export const StateNode = Object.freeze({
 	TRANSPORT_TEMPO                : 'transport_tempo',
 	TRANSPORT_TIME                 : 'transport_time',
 	TRANSPORT_ROLL                 : 'transport_roll',
-	TRANSPORT_RECORD               : 'transport_record'
+	TRANSPORT_RECORD               : 'transport_record',
+	PROTOCOL                       : 'protocol'
 });
 
+// Frame type of binary strip meters, see the binary_meter protocol option
+const BINARY_STRIP_METER = 1;
+
 export class Message {
 
 	constructor (node, addr, val) {
@@ -61,6 +65,35 @@ export class Message {
 		return new Message(rawMsg.node, rawMsg.addr || [], rawMsg.val);
 	}
 
+	// A frame holds a single message or, with the batch option, an array of them
+	static fromFrame (data) {
+		if (data instanceof ArrayBuffer) {
+			return Message.fromBinary(data);
+		}
+
+		const raw = JSON.parse(data);
+
+		if (Array.isArray(raw)) {
+			return raw.map(rawMsg => new Message(rawMsg.node, rawMsg.addr || [], rawMsg.val));
+		} else {
+			return [new Message(raw.node, raw.addr || [], raw.val)];
+		}
+	}
+
+	static fromBinary (buffer) {
+		const view = new DataView(buffer);
+		const msgs = [];
+
+		if (view.getUint8(0) == BINARY_STRIP_METER) {
+			for (let offset = 4; offset + 8 <= view.byteLength; offset += 8) {
+				msgs.push(new Message(StateNode.STRIP_METER, [view.getUint32(offset, true)],
+					[view.getFloat32(offset + 4, true)]));
+			}
+		}
+
+		return msgs;
+	}
+
 	toJsonText () {
 		let val = [];
 